@@ -29,6 +29,8 @@
 
 // Project-specific includes
 #include "sysmon.h"
+#include "sysmon_alert.h"
+#include "sysmon_bench.h"
 #include "sysmon_stack.h"
 
 // ESP-IDF includes
@@ -72,6 +74,16 @@
  *     ESP_LOGI(LOG_TAG, "sysmon_init: no-op (sysmon component disabled)");
  *     return ESP_OK;
  * }
+ *
+ * esp_err_t sysmon_alert_add(const sysmon_alert_rule_t *rule, sysmon_alert_callback_t callback, void *arg,
+ *                            int *rule_id)
+ * {
+ *     (void)rule;
+ *     (void)callback;
+ *     (void)arg;
+ *     (void)rule_id;
+ *     return ESP_OK;
+ * }
  */
 
 // LED strip setup
@@ -429,6 +441,11 @@ void app_main(void)
         ESP_LOGE("MAIN", "WiFi connection failed: %s (0x%x)", esp_err_to_name(wifi_err), wifi_err);
     }
 
+#if CONFIG_SYSMON_BENCHMARK
+    // Replay benchmark of the sampler and endpoint writers (must run before sysmon_init())
+    sysmon_bench_run();
+#endif
+
     esp_err_t sysmon_err = sysmon_init();
     if (sysmon_err != ESP_OK)
     {
@@ -460,6 +477,18 @@ void app_main(void)
     ESP_LOGI(LOG_TAG, "Demo sine wave task created");
     sysmon_stack_register(demo_sine_wave_task_handle, DEMO_SINE_WAVE_TASK_STACK_SIZE);
 
+    // Alert when the sine wave load stays near its peak (logged and listed on /alerts)
+    const sysmon_alert_rule_t sine_load_rule =
+    {
+        .name      = "sine load high",
+        .metric    = SYSMON_ALERT_TASK_CPU,
+        .task      = "demo_sine_task",
+        .op        = SYSMON_ALERT_GT,
+        .threshold = 60.0f,
+        .hold_ms   = 3000
+    };
+    sysmon_alert_add(&sine_load_rule, NULL, NULL, NULL);
+
     // Create demo task manager
     TaskHandle_t demo_task_manager_handle = NULL;
     BaseType_t demo_task_manager_result = xTaskCreate(
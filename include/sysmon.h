@@ -1,5 +1,8 @@
 #pragma once
 
+// Project-specific includes
+#include "sysmon_index.h"
+
 // ESP-IDF includes
 #include "esp_err.h"
 #include "esp_http_server.h"
@@ -33,6 +36,50 @@ extern "C" {
 #define CONFIG_SYSMON_SAMPLE_COUNT 60
 #endif
 
+#ifndef CONFIG_SYSMON_HISTORY_IN_PSRAM
+#define CONFIG_SYSMON_HISTORY_IN_PSRAM 0
+#endif
+
+#ifndef CONFIG_SYSMON_COMPACT_HISTORY
+#define CONFIG_SYSMON_COMPACT_HISTORY 0
+#endif
+
+#ifndef CONFIG_SYSMON_MONITOR_STACK_SIZE
+#define CONFIG_SYSMON_MONITOR_STACK_SIZE 6144
+#endif
+
+#ifndef CONFIG_SYSMON_TRACE_HOOKS
+#define CONFIG_SYSMON_TRACE_HOOKS 0
+#endif
+
+#ifndef CONFIG_SYSMON_TRACE_MAX_TASKS
+#define CONFIG_SYSMON_TRACE_MAX_TASKS 64
+#endif
+
+#ifndef CONFIG_SYSMON_TRACE_SCHED_STATS
+#define CONFIG_SYSMON_TRACE_SCHED_STATS 0
+#endif
+
+#ifndef CONFIG_SYSMON_ISR_MONITOR
+#define CONFIG_SYSMON_ISR_MONITOR 0
+#endif
+
+#ifndef CONFIG_SYSMON_ISR_MAX_HANDLERS
+#define CONFIG_SYSMON_ISR_MAX_HANDLERS 32
+#endif
+
+#ifndef CONFIG_SYSMON_TASK_HEAP_ACCOUNTING
+#define CONFIG_SYSMON_TASK_HEAP_ACCOUNTING 0
+#endif
+
+#ifndef CONFIG_SYSMON_TASK_HEAP_MAX_TASKS
+#define CONFIG_SYSMON_TASK_HEAP_MAX_TASKS 64
+#endif
+
+#ifndef CONFIG_SYSMON_TASK_HEAP_MAX_BLOCKS
+#define CONFIG_SYSMON_TASK_HEAP_MAX_BLOCKS 2048
+#endif
+
 #ifndef CONFIG_SYSMON_HTTPD_SERVER_PORT
 #define CONFIG_SYSMON_HTTPD_SERVER_PORT 8080
 #endif
@@ -41,36 +88,294 @@ extern "C" {
 #define CONFIG_SYSMON_HTTPD_CTRL_PORT   32768
 #endif
 
+#ifndef CONFIG_SYSMON_HTTPD_TASK_CORE
+#define CONFIG_SYSMON_HTTPD_TASK_CORE -1
+#endif
+
+#ifndef CONFIG_SYSMON_HTTPD_TASK_PRIORITY
+#define CONFIG_SYSMON_HTTPD_TASK_PRIORITY 5
+#endif
+
+#ifndef CONFIG_SYSMON_HTTPD_STACK_SIZE
+#define CONFIG_SYSMON_HTTPD_STACK_SIZE 4096
+#endif
+
+#ifndef CONFIG_SYSMON_HTTPD_MAX_SOCKETS
+#define CONFIG_SYSMON_HTTPD_MAX_SOCKETS 7
+#endif
+
+#ifndef CONFIG_SYSMON_HTTP_BUILD_SLICE_MS
+#define CONFIG_SYSMON_HTTP_BUILD_SLICE_MS 0
+#endif
+
+#ifndef CONFIG_SYSMON_HTTP_CHUNK_SIZE
+#define CONFIG_SYSMON_HTTP_CHUNK_SIZE   1024
+#endif
+
+#ifndef CONFIG_SYSMON_PUSH_MAX_CLIENTS
+#define CONFIG_SYSMON_PUSH_MAX_CLIENTS  4
+#endif
+
+#ifndef CONFIG_SYSMON_CPU_SAMPLING_PHASE_MS
+#define CONFIG_SYSMON_CPU_SAMPLING_PHASE_MS 0
+#endif
+
+#ifndef CONFIG_SYSMON_LIGHT_SAMPLING
+#define CONFIG_SYSMON_LIGHT_SAMPLING 0
+#endif
+
+#ifndef CONFIG_SYSMON_STACK_SCAN_INTERVAL
+#define CONFIG_SYSMON_STACK_SCAN_INTERVAL 10
+#endif
+
+#ifndef CONFIG_SYSMON_SELF_PROFILE
+#define CONFIG_SYSMON_SELF_PROFILE 0
+#endif
+
+#ifndef CONFIG_SYSMON_BENCHMARK
+#define CONFIG_SYSMON_BENCHMARK 0
+#endif
+
+#ifndef CONFIG_SYSMON_PERSIST_HISTORY
+#define CONFIG_SYSMON_PERSIST_HISTORY 0
+#endif
+
+#ifndef CONFIG_SYSMON_PERSIST_SAMPLES
+#define CONFIG_SYSMON_PERSIST_SAMPLES 60
+#endif
+
+#ifndef CONFIG_SYSMON_PERSIST_TASKS
+#define CONFIG_SYSMON_PERSIST_TASKS 6
+#endif
+
+#ifndef CONFIG_SYSMON_ALERT_MAX_RULES
+#define CONFIG_SYSMON_ALERT_MAX_RULES 8
+#endif
+
+#ifndef CONFIG_SYSMON_ALERT_LOG_SIZE
+#define CONFIG_SYSMON_ALERT_LOG_SIZE 32
+#endif
+
+#ifndef CONFIG_SYSMON_BURST_CAPTURE
+#define CONFIG_SYSMON_BURST_CAPTURE 0
+#endif
+
+#ifndef CONFIG_SYSMON_BURST_INTERVAL_MS
+#define CONFIG_SYSMON_BURST_INTERVAL_MS 10
+#endif
+
+#ifndef CONFIG_SYSMON_BURST_SAMPLES
+#define CONFIG_SYSMON_BURST_SAMPLES 500
+#endif
+
+#ifndef CONFIG_SYSMON_BURST_MAX_TASKS
+#define CONFIG_SYSMON_BURST_MAX_TASKS 16
+#endif
+
+#ifndef CONFIG_SYSMON_BURST_CPU_THRESHOLD
+#define CONFIG_SYSMON_BURST_CPU_THRESHOLD 0
+#endif
+
+#ifndef CONFIG_SYSMON_BURST_DRAM_FREE_THRESHOLD
+#define CONFIG_SYSMON_BURST_DRAM_FREE_THRESHOLD 0
+#endif
+
+#ifndef CONFIG_SYSMON_HEAP_CAPS_INTERVAL
+#define CONFIG_SYSMON_HEAP_CAPS_INTERVAL 10
+#endif
+
+#ifndef CONFIG_SYSMON_UDP_EXPORT
+#define CONFIG_SYSMON_UDP_EXPORT 0
+#endif
+
+#ifndef CONFIG_SYSMON_UDP_EXPORT_HOST
+#define CONFIG_SYSMON_UDP_EXPORT_HOST ""
+#endif
+
+#ifndef CONFIG_SYSMON_UDP_EXPORT_PORT
+#define CONFIG_SYSMON_UDP_EXPORT_PORT 5170
+#endif
+
+#ifndef CONFIG_SYSMON_UDP_EXPORT_BATCH
+#define CONFIG_SYSMON_UDP_EXPORT_BATCH 10
+#endif
+
+#ifndef CONFIG_SYSMON_UDP_EXPORT_MAX_BYTES
+#define CONFIG_SYSMON_UDP_EXPORT_MAX_BYTES 1400
+#endif
+
+#ifndef CONFIG_SYSMON_ROLLUP_DEPTH
+#define CONFIG_SYSMON_ROLLUP_DEPTH 60
+#endif
+
+#ifndef CONFIG_SYSMON_HARDWARE_REFRESH_S
+#define CONFIG_SYSMON_HARDWARE_REFRESH_S 30
+#endif
 
-#define SYSMON_MONITOR_STACK_SIZE  4096
+
+#define SYSMON_MONITOR_STACK_SIZE  CONFIG_SYSMON_MONITOR_STACK_SIZE
 #define SYSMON_MONITOR_PRIORITY    7
 #define SYSMON_MONITOR_CORE        0
 
 #define SYSMON_MAX_TRACKED_TASKS        256
+#define SYSMON_CORE_COUNT               portNUM_PROCESSORS
 #define SYSMON_ZERO_THRESHOLD           0.0001f
 
+// Accepted range for sysmon_config_t.history_depth
+#define SYSMON_HISTORY_MIN_DEPTH        10
+#define SYSMON_HISTORY_MAX_DEPTH        3600
+
+// Rollup tiers (see sysmon_rollup.h): tier 0 buckets hold 10 samples, tier 1 buckets hold 6 tier 0 buckets
+#define SYSMON_ROLLUP_TIERS             2
+#define SYSMON_ROLLUP_TIER0_SAMPLES     10
+#define SYSMON_ROLLUP_TIER1_BUCKETS     6
+
+// Ready-to-run latency histogram per task (see sysmon_trace.h): bucket i < 8 us * 4^i, last bucket open
+#define SYSMON_TRACE_LATENCY_BUCKETS    8
+
+// Lifetime CPU usage histogram per task (see sysmon_task_stats.h): 0.5 % buckets below 10 %, 2.5 % above
+#define SYSMON_TASK_STATS_BUCKETS       56
+
 // Strong reference to the actual embedded symbols present in your build
 // Note that ESP IDF strips the directory names from the final symbol name, no subfolders
+// sysmon.css and sysmon.js are the bundles tools/compress_www.py concatenates from www/css and www/js
 extern const uint8_t _binary_index_html_start[];
 extern const uint8_t _binary_index_html_end[];
-extern const uint8_t _binary_sysmon_theme_color_vars_css_start[];
-extern const uint8_t _binary_sysmon_theme_color_vars_css_end[];
-extern const uint8_t _binary_sysmon_theme_utility_classes_css_start[];
-extern const uint8_t _binary_sysmon_theme_utility_classes_css_end[];
-extern const uint8_t _binary_sysmon_theme_css_start[];
-extern const uint8_t _binary_sysmon_theme_css_end[];
-extern const uint8_t _binary_config_js_start[];
-extern const uint8_t _binary_config_js_end[];
-extern const uint8_t _binary_theme_js_start[];
-extern const uint8_t _binary_theme_js_end[];
-extern const uint8_t _binary_utils_js_start[];
-extern const uint8_t _binary_utils_js_end[];
-extern const uint8_t _binary_charts_js_start[];
-extern const uint8_t _binary_charts_js_end[];
-extern const uint8_t _binary_table_js_start[];
-extern const uint8_t _binary_table_js_end[];
-extern const uint8_t _binary_app_js_start[];
-extern const uint8_t _binary_app_js_end[];
+extern const uint8_t _binary_sysmon_css_start[];
+extern const uint8_t _binary_sysmon_css_end[];
+extern const uint8_t _binary_sysmon_js_start[];
+extern const uint8_t _binary_sysmon_js_end[];
+
+// Build-time gzip variants of the same files (see tools/compress_www.py)
+extern const uint8_t _binary_index_html_gz_start[];
+extern const uint8_t _binary_index_html_gz_end[];
+extern const uint8_t _binary_sysmon_css_gz_start[];
+extern const uint8_t _binary_sysmon_css_gz_end[];
+extern const uint8_t _binary_sysmon_js_gz_start[];
+extern const uint8_t _binary_sysmon_js_gz_end[];
+
+/**
+ * @brief Element types of the per-task history columns (see _history_encode_cpu()).
+ *
+ * With CONFIG_SYSMON_COMPACT_HISTORY, CPU samples are hundredths of a percent and
+ * stack samples are counts of SYSMON_COMPACT_STACK_UNIT bytes, 16 bits each.
+ */
+#if CONFIG_SYSMON_COMPACT_HISTORY
+typedef uint16_t sysmon_cpu_sample_t;
+typedef uint16_t sysmon_stack_sample_t;
+#define SYSMON_COMPACT_STACK_UNIT       4U
+#else
+typedef float sysmon_cpu_sample_t;
+typedef uint32_t sysmon_stack_sample_t;
+#endif
+
+/**
+ * @brief Running min/max/sum of the open (not yet closed) rollup bucket.
+ */
+typedef struct
+{
+    float min;
+    float max;
+    float sum;
+} RollupAccumulator;
+
+/**
+ * @brief Closed rollup bucket of a percentage series, in hundredths of a percent.
+ */
+typedef struct
+{
+    uint16_t min;
+    uint16_t avg;
+    uint16_t max;
+} RollupPercentBucket;
+
+/**
+ * @brief Closed rollup bucket of a byte count series.
+ */
+typedef struct
+{
+    uint32_t min;
+    uint32_t avg;
+    uint32_t max;
+} RollupBytesBucket;
+
+/**
+ * @brief Per-task rollup tiers (see sysmon_rollup.h).
+ *
+ * Members:
+ * - cpu_acc       : Open bucket of the CPU usage series, per tier.
+ * - stack_max_acc : Open bucket maximum of the stack usage series, per tier.
+ * - acc_inputs    : Number of inputs added to the open bucket so far, per tier (0 until the first one).
+ * - cpu           : Closed CPU usage buckets (cyclic, indexed by bucket number), per tier.
+ * - stack_max     : Closed stack usage bucket maxima in bytes (cyclic), per tier.
+ */
+typedef struct
+{
+    RollupAccumulator cpu_acc[SYSMON_ROLLUP_TIERS];
+    uint32_t stack_max_acc[SYSMON_ROLLUP_TIERS];
+    uint32_t acc_inputs[SYSMON_ROLLUP_TIERS];
+    RollupPercentBucket cpu[SYSMON_ROLLUP_TIERS][CONFIG_SYSMON_ROLLUP_DEPTH];
+    uint32_t stack_max[SYSMON_ROLLUP_TIERS][CONFIG_SYSMON_ROLLUP_DEPTH];
+} TaskRollup;
+
+/**
+ * @brief Lifetime statistics of one task entry (see sysmon_task_stats.h).
+ *
+ * Members:
+ * - samples         : Samples fed since the entry was created (0: the fields below are unset).
+ * - cpu_max         : Highest CPU usage of a sample.
+ * - stack_min_free  : Lowest stack high water mark seen, in bytes (stack never used).
+ * - cpu_buckets     : CPU usage histogram (see _task_stats_cpu_percentile()).
+ */
+typedef struct
+{
+    uint32_t samples;
+    float cpu_max;
+    uint32_t stack_min_free;
+    uint16_t cpu_buckets[SYSMON_TASK_STATS_BUCKETS];
+} TaskStats;
+
+/**
+ * @brief System-wide percentage series kept in the rollup tiers.
+ */
+typedef enum
+{
+    SYSMON_ROLLUP_CPU = 0,
+    SYSMON_ROLLUP_CORE0,                                          // Core n is SYSMON_ROLLUP_CORE0 + n
+    SYSMON_ROLLUP_DRAM_USED_PCT = SYSMON_ROLLUP_CORE0 + SYSMON_CORE_COUNT,
+    SYSMON_ROLLUP_PSRAM_USED_PCT,
+    SYSMON_ROLLUP_DRAM_FRAG_PCT,
+    SYSMON_ROLLUP_PERCENT_SERIES
+} sysmon_rollup_percent_t;
+
+/**
+ * @brief System-wide byte count series kept in the rollup tiers.
+ */
+typedef enum
+{
+    SYSMON_ROLLUP_DRAM_FREE = 0,
+    SYSMON_ROLLUP_DRAM_MIN_FREE,
+    SYSMON_ROLLUP_DRAM_LARGEST,
+    SYSMON_ROLLUP_PSRAM_FREE,
+    SYSMON_ROLLUP_BYTES_SERIES
+} sysmon_rollup_bytes_t;
+
+/**
+ * @brief System-wide rollup tiers (see sysmon_rollup.h).
+ *
+ * Members:
+ * - percent_acc : Open buckets of the percentage series, per tier.
+ * - bytes_acc   : Open buckets of the byte count series, per tier.
+ * - percent     : Closed percentage buckets (cyclic, indexed by bucket number), per tier and series.
+ * - bytes       : Closed byte count buckets (cyclic), per tier and series.
+ */
+typedef struct
+{
+    RollupAccumulator percent_acc[SYSMON_ROLLUP_TIERS][SYSMON_ROLLUP_PERCENT_SERIES];
+    RollupAccumulator bytes_acc[SYSMON_ROLLUP_TIERS][SYSMON_ROLLUP_BYTES_SERIES];
+    RollupPercentBucket percent[SYSMON_ROLLUP_TIERS][SYSMON_ROLLUP_PERCENT_SERIES][CONFIG_SYSMON_ROLLUP_DEPTH];
+    RollupBytesBucket bytes[SYSMON_ROLLUP_TIERS][SYSMON_ROLLUP_BYTES_SERIES][CONFIG_SYSMON_ROLLUP_DEPTH];
+} SysMonRollup;
 
 /**
  * @brief Stores usage samples and statistics for a single tracked FreeRTOS task.
@@ -81,9 +386,16 @@ extern const uint8_t _binary_app_js_end[];
  *
  * Members                       : 
  * - task_name                   : Fixed-length buffer holding the task name (matches t->pcTaskName from TaskStatus_t).
- * - usage_percent_history       : Array of per-sample CPU usage percentages for this task (cyclic buffer).
- * - stack_usage_bytes_history   : Array of per-sample stack usage in bytes (cyclic buffer).
- * - stack_usage_percent_history : Array of per-sample stack usage as a percentage of stack_size_bytes (cyclic buffer).
+ * - handle                      : FreeRTOS handle of the task currently bound to this entry (key in SysMonState.task_index).
+ * - name_ordinal                : 0 for the first live task with this name, 1.. for later duplicates (JSON key "name#2", ...).
+ * - usage_percent_history       : Per-sample CPU usage of this task, encoded (cyclic buffer in the history arena).
+ * - stack_usage_bytes_history   : Per-sample stack usage, encoded (cyclic buffer in the history arena).
+ *                                 Stack percentages are derived from it and stack_size_bytes on read.
+ * - heap_live_history           : Per-sample live heap bytes (cyclic buffer in the history arena; NULL without
+ *                                 CONFIG_SYSMON_TASK_HEAP_ACCOUNTING).
+ * - usage_percent               : CPU usage percentage of the latest sample.
+ * - stack_used_bytes            : Stack usage in bytes of the latest sample (0 if the stack is not registered).
+ * - stack_used_percent          : Stack usage percentage of the latest sample (0 if the stack is not registered).
  * - write_index                 : Index for the next write into the rolling history buffers.
  * - is_active                   : Whether this entry represents a currently observed (alive) task.
  * - consecutive_zero_samples    : Number of consecutive samples this task's usage was zero (used to time out deleted tasks).
@@ -95,17 +407,45 @@ extern const uint8_t _binary_app_js_end[];
  * - stack_size_bytes            : Stack size in bytes (as registered, see sysmon_stack API).
  * - core_id                     : The core number this task is running/pinned to (from TaskStatus_t.xCoreID).
  * - prev_run_time_ticks         : Logical copy of previous ulRunTimeCounter for this task since the last sample, used for delta calculations.
+ * - core_trace_valid            : Whether the per-core fields below hold trace hook data (see sysmon_trace.h).
+ * - prev_core_run_time          : Per-core run time reported by the trace hooks at the previous sample.
+ * - core_usage_percent          : CPU usage of this task on each core in the latest sample.
+ * - migrations                  : Core migrations counted by the trace hooks since the task was first traced.
+ * - heap_valid                  : Whether the heap fields below hold accounting data (see sysmon_alloc.h).
+ * - heap_live_bytes             : Heap bytes allocated by this task and not yet freed.
+ * - heap_live_blocks            : Heap blocks allocated by this task and not yet freed.
+ * - heap_alloc_count            : Allocations made by this task, cumulative (wraps).
+ * - heap_alloc_bytes            : Bytes allocated by this task, cumulative (wraps).
+ * - heap_sample_allocs          : Allocations made by this task during the latest sample interval.
+ * - heap_sample_alloc_bytes     : Bytes allocated by this task during the latest sample interval.
+ * - sched_valid                 : Whether the scheduling fields below hold trace hook data (CONFIG_SYSMON_TRACE_SCHED_STATS).
+ * - prev_sched_switches         : Switch-in count reported by the trace hooks at the previous sample.
+ * - prev_ready_total_us         : Ready-to-run latency sum reported by the trace hooks at the previous sample.
+ * - prev_ready_count            : Ready-to-run latencies measured by the trace hooks up to the previous sample.
+ * - sched_switches              : Times the task was switched in during the latest sample interval.
+ * - ready_avg_us                : Average ready-to-run latency during the latest sample interval (microseconds).
+ * - ready_max_us                : Longest ready-to-run latency during the latest sample interval (microseconds).
+ * - ready_max_lifetime_us       : Longest ready-to-run latency since the entry was created (microseconds).
+ * - ready_hist                  : Ready-to-run latency histogram of the bound task since it was first traced (see sysmon_trace.h).
+ * - rollup                      : Downsampled CPU and stack history (min/avg/max buckets, see sysmon_rollup.h), in the history arena.
+ * - stats                       : Lifetime CPU histogram, CPU maximum and stack minimum (see sysmon_task_stats.h).
  *
- * The time series buffers have length = CONFIG_SYSMON_SAMPLE_COUNT and are maintained as circular buffers.
+ * The time series buffers have length = SysMonState.history_depth and are maintained as circular buffers.
+ * They live in the history arena (see sysmon_history.h) and are bound to the entry's slot, so the entry
+ * itself only holds metadata.
  * This structure is filled, tracked, and used internally by sysmon.c and exposed to JSON and telemetry handlers.
  */
 
 typedef struct
 {
     char task_name[24];
-    float usage_percent_history[CONFIG_SYSMON_SAMPLE_COUNT];
-    uint32_t stack_usage_bytes_history[CONFIG_SYSMON_SAMPLE_COUNT];
-    float stack_usage_percent_history[CONFIG_SYSMON_SAMPLE_COUNT];
+    TaskHandle_t handle;
+    uint8_t name_ordinal;
+    sysmon_cpu_sample_t *usage_percent_history;
+    sysmon_stack_sample_t *stack_usage_bytes_history;
+    float usage_percent;
+    uint32_t stack_used_bytes;
+    float stack_used_percent;
     int write_index;
     bool is_active;
     int consecutive_zero_samples;
@@ -117,6 +457,29 @@ typedef struct
     uint32_t stack_size_bytes;
     int core_id;
     uint32_t prev_run_time_ticks;
+    bool core_trace_valid;
+    uint32_t prev_core_run_time[SYSMON_CORE_COUNT];
+    float core_usage_percent[SYSMON_CORE_COUNT];
+    uint32_t migrations;
+    uint32_t *heap_live_history;
+    bool heap_valid;
+    uint32_t heap_live_bytes;
+    uint32_t heap_live_blocks;
+    uint32_t heap_alloc_count;
+    uint32_t heap_alloc_bytes;
+    uint32_t heap_sample_allocs;
+    uint32_t heap_sample_alloc_bytes;
+    bool sched_valid;
+    uint32_t prev_sched_switches;
+    uint32_t prev_ready_total_us;
+    uint32_t prev_ready_count;
+    uint32_t sched_switches;
+    uint32_t ready_avg_us;
+    uint32_t ready_max_us;
+    uint32_t ready_max_lifetime_us;
+    uint32_t ready_hist[SYSMON_TRACE_LATENCY_BUCKETS];
+    TaskRollup *rollup;
+    TaskStats stats;
 } TaskUsageSample;
 
 /**
@@ -130,24 +493,55 @@ typedef struct
  * - httpd                : Handle to the HTTP server providing sysmon telemetry endpoints.
  * - tasks                : Array of per-task usage samples (TaskUsageSample), dynamically allocated.
  * - task_status          : Array of TaskStatus_t used to query live FreeRTOS task states.
- * - task_capacity        : Capacity of the allocated tasks/task_status arrays (number of slots).
+ * - task_capacity        : Capacity of the allocated tasks array (number of slots).
+ * - task_status_capacity : Capacity of task_status (at least task_capacity; grows ahead of tasks while
+ *                          a grown tasks array waits for its hand-off).
+ * - task_index           : Hash index from TaskHandle_t to slot in tasks (sampler task only).
  * - prev_total_run_time  : Snapshot of the previous global runtime tick count (for usage delta calculation).
+ * - idle_task_handles    : Idle task handle per core (looked up once when the sampler starts).
+ * - prev_idle_ticks      : Idle task run time per core at the previous sample (for per-core usage deltas).
  * - monitor_task_handle  : RTOS task handle for the main sysmon monitor task.
+ * - task_binds           : Number of task handle bindings so far; changes whenever a task is
+ *                          discovered or re-created (sampler task only, see sysmon_alert.h).
  *
+ * - history_depth        : Length of every ring buffer below and of the per-task histories (set at sysmon_init()).
  * - cpu_overall_percent  : Ring buffer of overall CPU usage percentages.
- * - cpu_core_percent     : Ring buffer of per-core CPU usage percentages.
+ * - cpu_core_percent     : Ring buffer of CPU usage percentages, per core (SYSMON_CORE_COUNT cores).
+ * - isr_core_percent     : Ring buffer of interrupt load percentages, per core (CONFIG_SYSMON_ISR_MONITOR,
+ *                          NULL otherwise; see sysmon_isr.h).
  * - dram_free            : Ring buffer of DRAM free bytes.
  * - dram_min_free        : Ring buffer of DRAM minimum free bytes.
  * - dram_largest_block   : Ring buffer of DRAM largest free block sizes.
  * - dram_total           : Ring buffer of total DRAM available.
  * - dram_used_percent    : Ring buffer of DRAM usage percent.
+ * - dram_frag_percent    : Ring buffer of the DRAM fragmentation index (see _heap_frag_percent()).
  * - psram_free           : Ring buffer of PSRAM free bytes.
  * - psram_total          : Ring buffer of PSRAM total bytes.
  * - psram_used_percent   : Ring buffer of PSRAM usage percent.
+ * - sample_time_us       : Ring buffer of sample start times (esp_timer_get_time(), microseconds since boot).
+ * - sample_jitter_us     : Ring buffer of sample start jitter (actual minus scheduled start, microseconds).
+ *   The ring buffers are columns of the history arena (see sysmon_history.h).
+ * - rollup               : Downsampled system-wide series (min/avg/max buckets, see sysmon_rollup.h).
  *
  * - series_write_index   : Ring buffer write head for time-series data.
  * - psram_seen           : True if PSRAM is detected on this platform/session.
  * - log_decimator        : Used for periodic logging throttling.
+ * - sample_overruns      : Number of samples that started late because the previous one ran past its slot.
+ * - sample_skipped       : Number of sample slots dropped entirely because the sampler fell a full period behind.
+ * - sample_jitter_max_us : Largest absolute start jitter seen since boot (microseconds).
+ * - stack_scan_age       : Samples since the latest full (stack scanning) sample; 0 if the latest sample was one.
+ * - scanned_generation   : Task generation (see _trace_task_generation()) read before the latest full sample.
+ * - core_switches        : Context switches per core during the latest sample interval (CONFIG_SYSMON_TRACE_SCHED_STATS).
+ * - prev_core_switches   : Per-core context switch counters of the trace hooks at the previous sample.
+ * - sched_interval_us    : Length of the interval core_switches and the per-task scheduling fields cover (0 before
+ *                          the second sample).
+ * - sched_prev_time_us   : Timestamp of the previous sample, for sched_interval_us.
+ *
+ * - sample_seq           : Sequence lock counter; odd while the sampler is writing a sample, sample_seq / 2
+ *                          is the sequence number of the latest published sample (see sysmon_snapshot.h).
+ * - reader_count         : Number of HTTP readers currently holding a view of the tasks array.
+ * - retired_tasks        : Previous tasks array, kept alive until the last of its readers releases its view.
+ * - retired_readers      : Number of HTTP readers still holding a view of retired_tasks.
  *
  * The structure is owned and manipulated exclusively by sysmon.c, but its
  * reference is provided by extern for certain operations in other modules.
@@ -158,41 +552,111 @@ typedef struct
     TaskUsageSample *tasks;
     TaskStatus_t *task_status;
     int task_capacity;
+    int task_status_capacity;
+    sysmon_index_t task_index;
     uint32_t prev_total_run_time;
+    TaskHandle_t idle_task_handles[SYSMON_CORE_COUNT];
+    uint32_t prev_idle_ticks[SYSMON_CORE_COUNT];
     TaskHandle_t monitor_task_handle;
+    uint32_t task_binds;
 
-    // Lightweight time series (length = CONFIG_SYSMON_SAMPLE_COUNT)
-    float cpu_overall_percent[CONFIG_SYSMON_SAMPLE_COUNT];
-    float cpu_core_percent[2][CONFIG_SYSMON_SAMPLE_COUNT];
-    uint32_t dram_free[CONFIG_SYSMON_SAMPLE_COUNT];
-    uint32_t dram_min_free[CONFIG_SYSMON_SAMPLE_COUNT];
-    uint32_t dram_largest_block[CONFIG_SYSMON_SAMPLE_COUNT];
-    uint32_t dram_total[CONFIG_SYSMON_SAMPLE_COUNT];
-    float dram_used_percent[CONFIG_SYSMON_SAMPLE_COUNT];
-    uint32_t psram_free[CONFIG_SYSMON_SAMPLE_COUNT];
-    uint32_t psram_total[CONFIG_SYSMON_SAMPLE_COUNT];
-    float psram_used_percent[CONFIG_SYSMON_SAMPLE_COUNT];
+    // Lightweight time series (length = history_depth, in the history arena)
+    int history_depth;
+    float *cpu_overall_percent;
+    float *cpu_core_percent[SYSMON_CORE_COUNT];
+    float *isr_core_percent[SYSMON_CORE_COUNT];
+    uint32_t *dram_free;
+    uint32_t *dram_min_free;
+    uint32_t *dram_largest_block;
+    uint32_t *dram_total;
+    float *dram_used_percent;
+    float *dram_frag_percent;
+    uint32_t *psram_free;
+    uint32_t *psram_total;
+    float *psram_used_percent;
+    int64_t *sample_time_us;
+    int32_t *sample_jitter_us;
+    SysMonRollup rollup;
 
     int series_write_index;
     bool psram_seen;
     int log_decimator;
+
+    // Sampler schedule statistics
+    uint32_t sample_overruns;
+    uint32_t sample_skipped;
+    int32_t sample_jitter_max_us;
+    uint32_t stack_scan_age;
+    uint32_t scanned_generation;
+
+    // Scheduler trace counters (see sysmon_trace.h)
+    uint32_t core_switches[SYSMON_CORE_COUNT];
+    uint32_t prev_core_switches[SYSMON_CORE_COUNT];
+    uint32_t sched_interval_us;
+    int64_t sched_prev_time_us;
+
+    // Reader/writer publication state (owned by sysmon_snapshot.c)
+    uint32_t sample_seq;
+    int reader_count;
+    TaskUsageSample *retired_tasks;
+    int retired_readers;
 } SysMonState;
 
 // Shared module state (defined in sysmon.c)
 extern SysMonState self;
 
+/**
+ * @brief Runtime configuration passed to sysmon_init_with_config().
+ *
+ * Members:
+ * - history_depth    : Samples kept per history series (SYSMON_HISTORY_MIN_DEPTH .. SYSMON_HISTORY_MAX_DEPTH).
+ * - history_in_psram : Place the history arena in PSRAM when available (falls back to internal RAM).
+ */
+typedef struct
+{
+    uint16_t history_depth;
+    bool history_in_psram;
+} sysmon_config_t;
+
+/**
+ * @brief Default configuration (history depth and placement from Kconfig).
+ */
+#define SYSMON_CONFIG_DEFAULT()                                 \
+    {                                                           \
+        .history_depth    = CONFIG_SYSMON_SAMPLE_COUNT,         \
+        .history_in_psram = CONFIG_SYSMON_HISTORY_IN_PSRAM,     \
+    }
+
 /**
  * @brief Initialize System Monitor: start HTTP server on port 81 and task monitor.
  *
+ * Equivalent to sysmon_init_with_config() with SYSMON_CONFIG_DEFAULT().
+ *
  * @return ESP_OK on success, error code otherwise.
  */
 esp_err_t sysmon_init(void);
 
+/**
+ * @brief Initialize System Monitor with a runtime configuration.
+ *
+ * @param config Configuration (NULL for SYSMON_CONFIG_DEFAULT()).
+ * @return ESP_OK on success, ESP_ERR_INVALID_ARG for an out-of-range history depth,
+ *         error code otherwise.
+ */
+esp_err_t sysmon_init_with_config(const sysmon_config_t *config);
+
 /**
  * @brief Stop System Monitor and free resources.
  */
 void sysmon_deinit(void);
 
+/**
+ * @brief Discard the cached /hardware info so the next request re-reads it from flash.
+ *
+ * Call after something changes the partition contents, e.g. an OTA update.
+ */
+void sysmon_refresh_hardware_info(void);
+
 #ifdef __cplusplus
 }
 #endif
@@ -0,0 +1,177 @@
+/**
+ * @file sysmon_alert.h
+ * @brief Threshold alert rules evaluated by the sampler.
+ *
+ * Watching "task X above 80% CPU for 5 s" or "largest DRAM block below 10 KB"
+ * from a server means polling /telemetry over the network, which is slow and
+ * fails exactly when the network does. Alert rules are evaluated on the
+ * device instead, at the end of every sample, in O(rules):
+ *
+ *   - Each rule compares one metric of the latest sample (a task's CPU,
+ *     stack or heap figure, or a system-wide CPU or memory figure) with a
+ *     threshold. The value is read from the sampler's own latest-sample state,
+ *     never from the history.
+ *   - The rule fires when the comparison has held for hold_ms, measured on
+ *     sample timestamps (so hold_ms 0 fires on the first matching sample),
+ *     and clears on the first sample where it no longer holds.
+ *   - Task rules name the task by its key ("name", or "name#2" for a later
+ *     task sharing the name). The rule remembers the task's entry, so a
+ *     lookup only scans the task entries again after a task was discovered
+ *     or re-created. A rule whose task does not exist does not hold (and
+ *     clears if it had fired).
+ *
+ * Each fire and clear is logged, appended to a ring of the latest
+ * CONFIG_SYSMON_ALERT_LOG_SIZE events and passed to the rule's callback.
+ * Callbacks run on the sampler task: keep them short and do not block (post
+ * to a queue or set an event group bit instead). GET /alerts returns the
+ * rules with their state and the event ring.
+ *
+ * Rules can be added and removed at any time, before or after sysmon_init();
+ * the table holds CONFIG_SYSMON_ALERT_MAX_RULES rules (0 disables alerts).
+ */
+
+#pragma once
+
+// Project-specific includes
+#include "sysmon_json_stream.h"
+
+// ESP-IDF includes
+#include "esp_err.h"
+
+// System includes
+#include <stdbool.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Metric compared by a rule.
+ */
+typedef enum
+{
+    SYSMON_ALERT_TASK_CPU = 0,          ///< Task CPU usage (%)
+    SYSMON_ALERT_TASK_STACK_PERCENT,    ///< Task stack usage (%, registered stacks only)
+    SYSMON_ALERT_TASK_STACK_FREE,       ///< Task stack never used since creation (bytes)
+    SYSMON_ALERT_TASK_HEAP,             ///< Task live heap (bytes, needs CONFIG_SYSMON_TASK_HEAP_ACCOUNTING)
+    SYSMON_ALERT_CPU,                   ///< Overall CPU usage (%)
+    SYSMON_ALERT_CORE_CPU,              ///< CPU usage of one core (%)
+    SYSMON_ALERT_DRAM_FREE,             ///< Free internal heap (bytes)
+    SYSMON_ALERT_DRAM_MIN_FREE,         ///< Lowest free internal heap since boot (bytes)
+    SYSMON_ALERT_DRAM_LARGEST,          ///< Largest free internal heap block (bytes)
+    SYSMON_ALERT_DRAM_FRAG_PERCENT,     ///< Internal heap fragmentation index (%)
+    SYSMON_ALERT_DRAM_USED_PERCENT,     ///< Internal heap usage (%)
+    SYSMON_ALERT_PSRAM_FREE,            ///< Free PSRAM (bytes, only with PSRAM)
+    SYSMON_ALERT_METRIC_COUNT
+} sysmon_alert_metric_t;
+
+/**
+ * @brief Comparison of a rule: the rule holds when "value <op> threshold".
+ */
+typedef enum
+{
+    SYSMON_ALERT_GT = 0,    ///< value >  threshold
+    SYSMON_ALERT_GE,        ///< value >= threshold
+    SYSMON_ALERT_LT,        ///< value <  threshold
+    SYSMON_ALERT_LE         ///< value <= threshold
+} sysmon_alert_op_t;
+
+/**
+ * @brief Alert rule.
+ *
+ * Members:
+ * - name      : Label for logs and /alerts (copied; NULL for "rule<id>").
+ * - metric    : Metric to compare.
+ * - task      : Task key for the task metrics (copied; ignored otherwise).
+ * - core      : Core for SYSMON_ALERT_CORE_CPU (ignored otherwise).
+ * - op        : Comparison.
+ * - threshold : Threshold, in the metric's unit.
+ * - hold_ms   : How long the comparison must hold before the rule fires.
+ */
+typedef struct
+{
+    const char *name;
+    sysmon_alert_metric_t metric;
+    const char *task;
+    int core;
+    sysmon_alert_op_t op;
+    float threshold;
+    uint32_t hold_ms;
+} sysmon_alert_rule_t;
+
+/**
+ * @brief Fire or clear of a rule.
+ *
+ * Members:
+ * - rule_id      : Rule (from sysmon_alert_add()).
+ * - name         : Rule label.
+ * - fired        : true when the rule fired, false when it cleared.
+ * - value        : Metric value of the sample (0 if the task was not found).
+ * - threshold    : Threshold of the rule.
+ * - timestamp_us : Timestamp of the sample (esp_timer_get_time() at its start).
+ * - seq          : Sequence number of the sample.
+ */
+typedef struct
+{
+    int rule_id;
+    char name[24];
+    bool fired;
+    float value;
+    float threshold;
+    int64_t timestamp_us;
+    uint32_t seq;
+} sysmon_alert_event_t;
+
+/**
+ * @brief Alert callback, called on the sampler task (must not block).
+ *
+ * @param event Fire or clear that just happened.
+ * @param arg Argument passed to sysmon_alert_add().
+ */
+typedef void (*sysmon_alert_callback_t)(const sysmon_alert_event_t *event, void *arg);
+
+/**
+ * @brief Add an alert rule.
+ *
+ * @param rule Rule (copied).
+ * @param callback Called on every fire and clear (NULL for log and /alerts only).
+ * @param arg Argument for the callback.
+ * @param rule_id Output: rule ID for sysmon_alert_remove() (may be NULL).
+ * @return ESP_OK on success, ESP_ERR_INVALID_ARG for a bad rule, ESP_ERR_NO_MEM
+ *         if the rule table is full, ESP_ERR_NOT_SUPPORTED if alerts are disabled.
+ */
+esp_err_t sysmon_alert_add(const sysmon_alert_rule_t *rule, sysmon_alert_callback_t callback, void *arg,
+                           int *rule_id);
+
+/**
+ * @brief Remove an alert rule.
+ *
+ * The callback is not called for the rule once this returns, except for a
+ * call the sampler had already started.
+ *
+ * @param rule_id Rule ID from sysmon_alert_add().
+ * @return ESP_OK on success, ESP_ERR_NOT_FOUND for an unknown rule ID.
+ */
+esp_err_t sysmon_alert_remove(int rule_id);
+
+/**
+ * @brief Evaluate every rule on the sample just published (sampler task only).
+ *
+ * Call after _snapshot_write_end().
+ *
+ * @param timestamp_us Timestamp of the sample.
+ */
+void _alert_evaluate(int64_t timestamp_us);
+
+/**
+ * @brief Write the rules and the event ring (/alerts).
+ *
+ * @param stream Chunked response writer.
+ * @return ESP_OK on success, or the first error raised while streaming.
+ */
+esp_err_t _write_alerts_json(json_stream_t *stream);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,107 @@
+/**
+ * @file sysmon_alloc.h
+ * @brief Per-task heap accounting from the heap allocation hooks.
+ *
+ * The system-wide DRAM series show that memory is leaking, not who holds it.
+ * With CONFIG_SYSMON_TASK_HEAP_ACCOUNTING (requires CONFIG_HEAP_USE_HOOKS),
+ * this module defines esp_heap_trace_alloc_hook() / esp_heap_trace_free_hook()
+ * and keeps, for the task that made each allocation:
+ *   - live bytes and blocks: allocated by the task and not yet freed, by
+ *     whichever task frees them;
+ *   - cumulative allocation count and bytes, from which the sampler derives
+ *     the allocation rate per sample.
+ *
+ * The free hook only receives the pointer, so every allocation is recorded in
+ * a fixed block table (CONFIG_SYSMON_TASK_HEAP_MAX_BLOCKS entries: address,
+ * size and owner). Both tables are static, keyed by address with a bounded
+ * probe window, claimed with compare-and-swap and updated with atomic adds:
+ * the hooks never allocate, lock or walk the heap, which keeps the cost at a
+ * few dozen instructions per malloc()/free(). Allocations that find no room
+ * are not recorded and counted as untracked; their free is ignored.
+ *
+ * When a task is deleted, the sampler retires its entry: the task's blocks
+ * still live are reported as held by exited tasks until they are freed.
+ *
+ * Limitations: allocations from interrupts and before the scheduler starts
+ * are counted as untracked; if a block is freed and its address reused by
+ * another core before the free hook ran, the new block may be accounted as
+ * freed. Without CONFIG_SYSMON_TASK_HEAP_ACCOUNTING, the read functions
+ * report no data.
+ */
+
+#pragma once
+
+// ESP-IDF includes
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+
+// System includes
+#include <stdbool.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Heap counters of one task.
+ *
+ * Members:
+ * - live_bytes  : Bytes allocated by the task and not yet freed.
+ * - live_blocks : Blocks allocated by the task and not yet freed.
+ * - alloc_count : Allocations made by the task (cumulative, wraps).
+ * - alloc_bytes : Bytes allocated by the task (cumulative, wraps).
+ */
+typedef struct
+{
+    uint32_t live_bytes;
+    uint32_t live_blocks;
+    uint32_t alloc_count;
+    uint32_t alloc_bytes;
+} sysmon_alloc_stats_t;
+
+/**
+ * @brief Accounting totals outside of the live tasks.
+ *
+ * Members:
+ * - exited_bytes     : Bytes still allocated by tasks that were deleted.
+ * - exited_blocks    : Blocks still allocated by tasks that were deleted.
+ * - untracked_allocs : Allocations not recorded (block or task table full, interrupt context).
+ */
+typedef struct
+{
+    uint32_t exited_bytes;
+    uint32_t exited_blocks;
+    uint32_t untracked_allocs;
+} sysmon_alloc_summary_t;
+
+/**
+ * @brief Read the heap counters of a task (sampler task only).
+ *
+ * @param handle Task handle.
+ * @param out Output counters.
+ * @return true if the task has allocated since its entry was claimed, false if
+ *         it has not, the task table is full or accounting is disabled.
+ */
+bool _alloc_read_task(TaskHandle_t handle, sysmon_alloc_stats_t *out);
+
+/**
+ * @brief Retire the entry of a deleted task (sampler task only).
+ *
+ * Its live blocks move to the exited totals; a new task created at the same
+ * address gets a fresh entry.
+ *
+ * @param handle Handle of the deleted task.
+ */
+void _alloc_task_exited(TaskHandle_t handle);
+
+/**
+ * @brief Read the totals outside of the live tasks.
+ *
+ * @param out Output totals (all zero if accounting is disabled).
+ */
+void _alloc_read_summary(sysmon_alloc_summary_t *out);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,164 @@
+/**
+ * @file sysmon_bench.h
+ * @brief On-target replay benchmark of the sampler and serialization hot paths.
+ *
+ * With CONFIG_SYSMON_BENCHMARK, sysmon_bench_run() measures what one sample
+ * and one response cost as the task count grows, without flashing a firmware
+ * with that many real tasks. For each point of a sweep (10 to 256 tasks) it:
+ *   - builds a recorded uxTaskGetSystemState() snapshot of synthetic tasks
+ *     (distinct run time and stack figures, one task deleted and re-created
+ *     every 8 samples) whose handles point at zeroed, never scheduled TCBs;
+ *   - replays twice the history depth of samples through the sampler's own
+ *     per-task pass (_update_task_history(), _process_deleted_tasks()) and
+ *     series update, so every ring has wrapped;
+ *   - runs each endpoint writer (/tasks, /history, /history.bin, /telemetry,
+ *     /metrics, /heap) into a counting stream that discards its chunks.
+ *
+ * Per point it reports the mean and worst time per sample, the allocations
+ * made per sample (from the heap hooks, with CONFIG_SYSMON_TASK_HEAP_ACCOUNTING),
+ * the heap kept by the task arrays and history, the peak heap use over the
+ * whole run (ESP-IDF 5.1 and later; older versions poll the free size between
+ * steps) and, per writer, the mean build time and document size.
+ *
+ * The replay owns the sampler state: run it before sysmon_init() (or after
+ * sysmon_deinit()); it returns ESP_ERR_INVALID_STATE while the sampler task
+ * runs. Everything it allocated is freed before it returns. Sample sequence
+ * numbers keep counting from the replayed samples. Without
+ * CONFIG_SYSMON_BENCHMARK the functions return ESP_ERR_NOT_SUPPORTED.
+ */
+
+#pragma once
+
+// ESP-IDF includes
+#include "esp_err.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+
+// System includes
+#include <stdbool.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Endpoint writers measured by the benchmark, in report order.
+ */
+typedef enum
+{
+    SYSMON_BENCH_TASKS = 0,      ///< /tasks
+    SYSMON_BENCH_HISTORY,        ///< /history
+    SYSMON_BENCH_HISTORY_BIN,    ///< /history.bin
+    SYSMON_BENCH_TELEMETRY,      ///< /telemetry
+    SYSMON_BENCH_METRICS,        ///< /metrics
+    SYSMON_BENCH_HEAP,           ///< /heap
+    SYSMON_BENCH_WRITER_COUNT
+} sysmon_bench_writer_t;
+
+/**
+ * @brief Cost of one endpoint writer.
+ *
+ * Members:
+ * - build_ns : Mean time to write the document (nanoseconds).
+ * - bytes    : Document size in bytes.
+ * - error    : Result of the last run (ESP_OK on success).
+ */
+typedef struct
+{
+    uint32_t build_ns;
+    uint32_t bytes;
+    esp_err_t error;
+} sysmon_bench_build_t;
+
+/**
+ * @brief Result of one sweep point.
+ *
+ * Members:
+ * - task_count     : Synthetic tasks in the replayed snapshot.
+ * - samples        : Samples replayed.
+ * - sample_ns      : Mean time per sample (nanoseconds).
+ * - sample_max_ns  : Longest sample (nanoseconds).
+ * - allocs_valid   : True if alloc_count and alloc_bytes were measured (heap hooks enabled).
+ * - alloc_count    : Allocations made by the replayed samples (all samples).
+ * - alloc_bytes    : Bytes allocated by the replayed samples (all samples).
+ * - retained_bytes : Heap held after the replay (task arrays, handle index and history arena).
+ * - peak_bytes     : Most heap in use above the starting point, replay and writers included.
+ * - builds         : Cost per writer (sysmon_bench_writer_t order).
+ */
+typedef struct
+{
+    uint16_t task_count;
+    uint32_t samples;
+    uint32_t sample_ns;
+    uint32_t sample_max_ns;
+    bool allocs_valid;
+    uint32_t alloc_count;
+    uint32_t alloc_bytes;
+    uint32_t retained_bytes;
+    uint32_t peak_bytes;
+    sysmon_bench_build_t builds[SYSMON_BENCH_WRITER_COUNT];
+} sysmon_bench_result_t;
+
+/**
+ * @brief Replay one sweep point.
+ *
+ * @param task_count Synthetic tasks (1 .. SYSMON_MAX_TRACKED_TASKS).
+ * @param samples Samples to replay (0 for twice the history depth).
+ * @param out Output result.
+ * @return ESP_OK on success, ESP_ERR_INVALID_ARG for a bad task count,
+ *         ESP_ERR_INVALID_STATE while the sampler runs, ESP_ERR_NO_MEM on
+ *         allocation failure, ESP_ERR_NOT_SUPPORTED without CONFIG_SYSMON_BENCHMARK.
+ */
+esp_err_t sysmon_bench_run_point(uint16_t task_count, uint32_t samples, sysmon_bench_result_t *out);
+
+/**
+ * @brief Replay the default sweep (10, 32, 64, 128 and 256 tasks) and log a report.
+ *
+ * @return ESP_OK if every point ran, error code of the first failing point otherwise.
+ */
+esp_err_t sysmon_bench_run(void);
+
+/**
+ * @brief Endpoint of a writer, for reports.
+ *
+ * @param writer Writer.
+ * @return URI ("/tasks", "/history", ...).
+ */
+const char *sysmon_bench_writer_name(sysmon_bench_writer_t writer);
+
+/**
+ * @brief Prepare the sampler state for a replay (implemented in sysmon.c).
+ *
+ * Allocates the history arena for the default configuration if sysmon_init()
+ * has not.
+ *
+ * @return ESP_OK on success, ESP_ERR_INVALID_STATE while the sampler task runs,
+ *         error code of _history_init() otherwise.
+ */
+esp_err_t _sampler_replay_begin(void);
+
+/**
+ * @brief Run steps 1 and 3-7 of a sample on recorded task states (implemented in sysmon.c).
+ *
+ * Stands in for uxTaskGetSystemState(): the states are copied into the task
+ * status array, then processed and published exactly as a live sample.
+ *
+ * @param task_states Recorded task states.
+ * @param num_tasks Number of entries in task_states.
+ * @param total_run_time Total runtime counter of the sample.
+ * @return true if the sample was published, false on allocation failure.
+ */
+bool _sampler_replay_sample(const TaskStatus_t *task_states, UBaseType_t num_tasks, uint32_t total_run_time);
+
+/**
+ * @brief Release everything a replay allocated (implemented in sysmon.c).
+ *
+ * Frees the task arrays, the handle index and the history arena, and clears
+ * the rollup tiers, so sysmon_init() starts from scratch.
+ */
+void _sampler_replay_end(void);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,147 @@
+/**
+ * @file sysmon_burst.h
+ * @brief High-rate burst capture of run time counters, on demand or on a threshold.
+ *
+ * The sampler's interval (100 ms and up) averages away the short CPU spikes
+ * that make control loops miss their deadlines. With CONFIG_SYSMON_BURST_CAPTURE,
+ * a capture samples the run time counters every CONFIG_SYSMON_BURST_INTERVAL_MS
+ * for CONFIG_SYSMON_BURST_SAMPLES samples into a buffer preallocated at
+ * sysmon_init(), from an esp_timer callback. A capture starts:
+ *   - on POST /burst;
+ *   - when a sample's overall CPU usage reaches CONFIG_SYSMON_BURST_CPU_THRESHOLD
+ *     percent, or its free internal heap drops to CONFIG_SYSMON_BURST_DRAM_FREE_THRESHOLD
+ *     bytes (0 disables either). A threshold triggers once when it is crossed
+ *     and re-arms when the value is back on the other side.
+ *
+ * Each burst sample records the total run time and each core's idle run time
+ * since the previous one, the free internal heap and the run time of up to
+ * CONFIG_SYSMON_BURST_MAX_TASKS tasks (the busiest ones of the latest sample
+ * that a fresh task scan at the start still finds, idle tasks excluded). The
+ * tick reads run time counters like the light sample (no stack scan, scheduler
+ * running) and takes no lock. Once a task is created or deleted during a
+ * capture (the task generation of the trace hooks changed), a tracked handle
+ * may be stale, so the task columns stop there while the system columns go
+ * on. Without CONFIG_SYSMON_TRACE_HOOKS there is no way to tell, so a capture
+ * has no task columns.
+ *
+ * The normal sampler and its history are untouched. A completed capture is
+ * kept until the next one starts; a capture does not start while one runs or
+ * is being downloaded. GET /burst reports the state, GET /burst.bin returns
+ * the samples recorded so far, in the /history.bin column format (see
+ * sysmon_history_bin.h):
+ *
+ *   header  : "SMBC", u8 version (1), varint sample_count, varint interval_us,
+ *             u8 trigger (sysmon_burst_trigger_t), varint start_us
+ *             (esp_timer_get_time() at the start), varint sequence (latest
+ *             sampler sample at the start)
+ *   columns : "burst/timeUs" (end of each slice, from start_us),
+ *             "burst/total" (run time of the slice), "burst/idle<N>" (idle
+ *             run time of core N), "burst/dramFree", then "task/<key>/runTime"
+ *             per tracked task (fewer samples if the task set changed)
+ *   end     : varint 0
+ *
+ * Core N was busy 100 * (1 - idle<N> / total) percent of a slice; task T ran
+ * 100 * runTime / total percent of it. Without CONFIG_SYSMON_BURST_CAPTURE,
+ * /burst reports {"enabled": false} and /burst.bin an empty capture.
+ */
+
+#pragma once
+
+// Project-specific includes
+#include "sysmon_json_stream.h"
+
+// ESP-IDF includes
+#include "esp_err.h"
+#include "esp_http_server.h"
+
+// System includes
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Format version written after the "SMBC" magic.
+ */
+#define SYSMON_BURST_VERSION 1
+
+/**
+ * @brief What started a capture.
+ */
+typedef enum
+{
+    SYSMON_BURST_TRIGGER_HTTP = 0,    ///< POST /burst
+    SYSMON_BURST_TRIGGER_CPU,         ///< Overall CPU usage reached the threshold
+    SYSMON_BURST_TRIGGER_DRAM_FREE    ///< Free internal heap dropped to the threshold
+} sysmon_burst_trigger_t;
+
+/**
+ * @brief Allocate the capture buffer and create the capture timer.
+ *
+ * @return ESP_OK on success (or if burst capture is disabled or already set up), error code otherwise.
+ */
+esp_err_t _burst_start(void);
+
+/**
+ * @brief Stop a running capture and free the capture buffer.
+ *
+ * Waits for a tick already in progress to return before the buffer is freed.
+ * Call after the HTTP server is stopped.
+ */
+void _burst_stop(void);
+
+/**
+ * @brief Start a capture.
+ *
+ * @param trigger What started it.
+ * @return ESP_OK if the capture started, ESP_ERR_INVALID_STATE while a capture
+ *         runs or is downloaded, ESP_ERR_NOT_SUPPORTED if burst capture is disabled.
+ */
+esp_err_t _burst_trigger(sysmon_burst_trigger_t trigger);
+
+/**
+ * @brief Start a capture if a threshold was crossed (sampler task only).
+ *
+ * Call after _snapshot_write_end().
+ *
+ * @param overall_usage Overall CPU usage of the sample just published.
+ * @param dram_free Free internal heap of the sample just published.
+ */
+void _burst_check(float overall_usage, uint32_t dram_free);
+
+/**
+ * @brief Register the POST /burst handler.
+ *
+ * @param server Running HTTP server.
+ * @return ESP_OK on success (or if burst capture is disabled), error code otherwise.
+ */
+esp_err_t _burst_register(httpd_handle_t server);
+
+/**
+ * @brief Number of URI handlers _burst_register() adds (for httpd_config_t.max_uri_handlers).
+ *
+ * @return 1 with burst capture, 0 otherwise.
+ */
+size_t _burst_handler_count(void);
+
+/**
+ * @brief Write the capture state (/burst).
+ *
+ * @param stream Chunked response writer.
+ * @return ESP_OK on success, or the first error raised while streaming.
+ */
+esp_err_t _write_burst_json(json_stream_t *stream);
+
+/**
+ * @brief Write the samples of the latest capture (/burst.bin).
+ *
+ * @param stream Chunked response writer (headers already set by the caller).
+ * @return ESP_OK on success, or the first error raised while streaming.
+ */
+esp_err_t _write_burst_bin(json_stream_t *stream);
+
+#ifdef __cplusplus
+}
+#endif
@@ -9,8 +9,12 @@
 
 #pragma once
 
+// Project-specific includes
+#include "sysmon_json_stream.h"
+#include "sysmon_profile.h"
+
 // ESP-IDF includes
-#include "cJSON.h"
+#include "esp_err.h"
 
 // System includes
 #include <stdint.h>
@@ -21,46 +25,99 @@ extern "C" {
 
 /**
  * @brief Configuration structure for static file handlers.
+ *
+ * start/end delimit the raw file (TEXT embedding, trailing NUL included),
+ * gzip_start/gzip_end its build-time gzip variant. etag and etag_gzip are
+ * strong ETags (quoted) for the two representations.
  */
 typedef struct
 {
     const char *uri;
     const uint8_t *start;
     const uint8_t *end;
+    const uint8_t *gzip_start;
+    const uint8_t *gzip_end;
+    const char *etag;
+    const char *etag_gzip;
 } static_file_config_t;
 
 /**
  * @brief Configuration structure for JSON endpoint handlers.
+ *
+ * write_json streams the response in chunks.
+ * content_type overrides the JSON content type for streamed non-JSON bodies.
+ * profile is the build phase the response is recorded under (see sysmon_profile.h).
  */
 typedef struct
 {
     const char *uri;
-    cJSON *(*create_json)(void);
+    esp_err_t (*write_json)(json_stream_t *stream);
+    const char *content_type;
+    sysmon_profile_phase_t profile;
 } json_handler_config_t;
 
 /**
  * @brief Macro to simplify binary file entry configuration.
  *
+ * Requires sysmon_www_etags.h (generated by tools/compress_www.py).
+ *
  * @param uri_path URI path for the static file
  * @param name Base name of the binary symbol (e.g., "index_html" for _binary_index_html_start)
  */
 #define STATIC_FILE_ENTRY(uri_path, name) \
     { \
-        .uri   = uri_path, \
-        .start = _binary_##name##_start, \
-        .end   = _binary_##name##_end \
+        .uri        = uri_path, \
+        .start      = _binary_##name##_start, \
+        .end        = _binary_##name##_end, \
+        .gzip_start = _binary_##name##_gz_start, \
+        .gzip_end   = _binary_##name##_gz_end, \
+        .etag       = SYSMON_WWW_ETAG_##name, \
+        .etag_gzip  = SYSMON_WWW_ETAG_GZIP_##name \
     }
 
 /**
- * @brief Macro to simplify JSON endpoint entry configuration.
+ * @brief Macro to simplify streaming JSON endpoint entry configuration.
  *
  * @param uri_path URI path for the JSON endpoint
- * @param create_json_func Function pointer to JSON creation function
+ * @param write_json_func Function pointer to streaming JSON writer function
+ * @param profile_phase Build phase for self-profiling (SYSMON_PROFILE_*_BUILD)
+ */
+#define JSON_STREAM_ENTRY(uri_path, write_json_func, profile_phase) \
+    { \
+        .uri        = uri_path, \
+        .write_json = write_json_func, \
+        .profile    = profile_phase \
+    }
+
+/**
+ * @brief Macro to simplify streaming binary endpoint entry configuration.
+ *
+ * @param uri_path URI path for the binary endpoint
+ * @param write_func Function pointer to streaming writer function
+ * @param profile_phase Build phase for self-profiling (SYSMON_PROFILE_*_BUILD)
+ */
+#define BINARY_STREAM_ENTRY(uri_path, write_func, profile_phase) \
+    { \
+        .uri          = uri_path, \
+        .write_json   = write_func, \
+        .content_type = "application/octet-stream", \
+        .profile      = profile_phase \
+    }
+
+/**
+ * @brief Macro to simplify streaming text endpoint entry configuration.
+ *
+ * @param uri_path URI path for the text endpoint
+ * @param write_func Function pointer to streaming writer function
+ * @param type Content type of the response
+ * @param profile_phase Build phase for self-profiling (SYSMON_PROFILE_*_BUILD)
  */
-#define JSON_ENDPOINT_ENTRY(uri_path, create_json_func) \
+#define TEXT_STREAM_ENTRY(uri_path, write_func, type, profile_phase) \
     { \
-        .uri         = uri_path, \
-        .create_json = create_json_func \
+        .uri          = uri_path, \
+        .write_json   = write_func, \
+        .content_type = type, \
+        .profile      = profile_phase \
     }
 
 #ifdef __cplusplus
@@ -0,0 +1,72 @@
+/**
+ * @file sysmon_export.h
+ * @brief Batched UDP export of recent samples to a fleet collector.
+ *
+ * With CONFIG_SYSMON_UDP_EXPORT, an exporter task sends every
+ * CONFIG_SYSMON_UDP_EXPORT_BATCH samples, read back from the series rings,
+ * as one datagram to CONFIG_SYSMON_UDP_EXPORT_HOST:PORT. Devices push, so
+ * collection works behind NAT and the radio wakes once per batch instead of
+ * once per poll. The sampler only notifies the task; encoding and sending
+ * never delay a sample.
+ *
+ * Datagram layout (varints are unsigned LEB128):
+ *
+ *   header  : "SMUD", u8 version (1), 6 bytes device MAC (Wi-Fi station),
+ *             varint first_seq, varint count, varint interval_ms,
+ *             varint time_us (esp_timer_get_time() of the first sample)
+ *   columns : count samples per column, in the /history.bin column format
+ *             (see sysmon_history_bin.h): "sys/jitterUs", "sys/cpu",
+ *             "sys/core<N>", "sys/dramFree", "sys/dramMinFree",
+ *             "sys/dramLargest", "sys/psramFree", then "task/<key>/cpu" and
+ *             (registered tasks) "task/<key>/stack"
+ *   end     : varint 0, varint omitted_tasks
+ *
+ * Sample i has sequence number first_seq + i and was taken at about
+ * time_us + i * interval_ms * 1000 + (jitterUs[i] - jitterUs[0]). Datagrams
+ * are limited to CONFIG_SYSMON_UDP_EXPORT_MAX_BYTES; tasks whose columns no
+ * longer fit are left out and counted in omitted_tasks. If the exporter
+ * falls behind (e.g. while the network is down), samples older than the
+ * history depth are lost; first_seq tells the collector about the gap.
+ *
+ * The buffers and the socket are allocated once when the exporter starts.
+ * Without CONFIG_SYSMON_UDP_EXPORT the functions are no-ops.
+ */
+
+#pragma once
+
+// ESP-IDF includes
+#include "esp_err.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Format version written after the "SMUD" magic.
+ */
+#define SYSMON_EXPORT_VERSION 1
+
+/**
+ * @brief Start the exporter task (after the history arena is allocated).
+ *
+ * @return ESP_OK on success (or if the exporter is disabled or already running), error code otherwise.
+ */
+esp_err_t _export_start(void);
+
+/**
+ * @brief Wake the exporter when a batch is complete (sampler task only).
+ *
+ * Call after _snapshot_write_end().
+ */
+void _export_notify(void);
+
+/**
+ * @brief Stop the exporter task and release its buffers and socket (after the sampler stopped).
+ *
+ * Waits for the task to finish its datagram and exit on its own.
+ */
+void _export_stop(void);
+
+#ifdef __cplusplus
+}
+#endif
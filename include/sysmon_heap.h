@@ -0,0 +1,147 @@
+/**
+ * @file sysmon_heap.h
+ * @brief Per-capability heap statistics and free block size histograms.
+ *
+ * The per-sample memory series only cover the internal heap as a whole and
+ * PSRAM. Allocation failures, however, usually come from a single capability
+ * running short (DMA-capable memory, 32-bit or executable internal RAM) or
+ * from fragmentation. Every CONFIG_SYSMON_HEAP_CAPS_INTERVAL samples the
+ * sampler records, per capability (see SYSMON_HEAP_CAPS_*):
+ *   - total, free, largest free block and minimum free bytes and the block
+ *     counts, from heap_caps_get_info();
+ *   - the fragmentation index, 100 * (1 - largest free block / free bytes),
+ *     0 for a single free block and close to 100 when free memory is spread
+ *     over many small blocks;
+ *   - a histogram of free block sizes in powers of two, from heap_caps_walk()
+ *     (ESP-IDF 5.3 and later; older versions report no histogram).
+ *
+ * Both heap_caps_get_info() and heap_caps_walk() walk every block with the
+ * heap locked, blocking allocations from other tasks meanwhile, which is why
+ * the scan is rate-limited and done after the sample is published. Served by
+ * /heap; the internal heap's fragmentation index is also kept per sample
+ * (dramFragPct in /history).
+ */
+
+#pragma once
+
+// ESP-IDF includes
+#include "esp_err.h"
+
+// System includes
+#include <stdbool.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Capabilities with their own statistics, in report order.
+ */
+typedef enum
+{
+    SYSMON_HEAP_CAPS_INTERNAL = 0,   ///< MALLOC_CAP_INTERNAL
+    SYSMON_HEAP_CAPS_DMA,            ///< MALLOC_CAP_DMA
+    SYSMON_HEAP_CAPS_SPIRAM,         ///< MALLOC_CAP_SPIRAM
+    SYSMON_HEAP_CAPS_32BIT,          ///< MALLOC_CAP_32BIT
+    SYSMON_HEAP_CAPS_EXEC,           ///< MALLOC_CAP_EXEC
+    SYSMON_HEAP_CAPS_COUNT
+} sysmon_heap_caps_t;
+
+/**
+ * @brief Number of free block size histogram buckets.
+ *
+ * Bucket 0 counts blocks below 32 bytes, bucket n (1..14) blocks of
+ * 2^(n+4) to 2^(n+5)-1 bytes and the last bucket blocks of 512 KB and more.
+ */
+#define SYSMON_HEAP_HISTOGRAM_BUCKETS 16
+
+/**
+ * @brief Statistics of one capability.
+ *
+ * Members:
+ * - total_bytes      : Total size of the heaps with the capability.
+ * - free_bytes       : Free bytes.
+ * - largest_free     : Largest free block.
+ * - minimum_free     : Lowest free bytes since boot.
+ * - allocated_blocks : Number of allocated blocks.
+ * - free_blocks      : Number of free blocks.
+ * - frag_percent     : Fragmentation index (see the file description).
+ * - free_histogram   : Free block counts per size bucket.
+ */
+typedef struct
+{
+    uint32_t total_bytes;
+    uint32_t free_bytes;
+    uint32_t largest_free;
+    uint32_t minimum_free;
+    uint32_t allocated_blocks;
+    uint32_t free_blocks;
+    float frag_percent;
+    uint32_t free_histogram[SYSMON_HEAP_HISTOGRAM_BUCKETS];
+} sysmon_heap_caps_stats_t;
+
+/**
+ * @brief Latest per-capability heap scan.
+ *
+ * Members:
+ * - caps          : Statistics per capability (sysmon_heap_caps_t order).
+ * - sequence      : Sample sequence number the scan followed (0 before the first scan).
+ * - scan_us       : Duration of the scan (microseconds).
+ * - has_histogram : True if free_histogram was filled (heap_caps_walk() available).
+ */
+typedef struct
+{
+    sysmon_heap_caps_stats_t caps[SYSMON_HEAP_CAPS_COUNT];
+    uint32_t sequence;
+    uint32_t scan_us;
+    bool has_histogram;
+} sysmon_heap_report_t;
+
+/**
+ * @brief Fragmentation index of a heap.
+ *
+ * @param free_bytes Free bytes.
+ * @param largest_free Largest free block.
+ * @return 100 * (1 - largest_free / free_bytes), or 0 without free memory.
+ */
+float _heap_frag_percent(uint32_t free_bytes, uint32_t largest_free);
+
+/**
+ * @brief Scan the per-capability statistics if a scan is due (sampler task only).
+ *
+ * Call after _snapshot_write_end(), so the heap walk does not extend the
+ * window in which HTTP readers retry.
+ *
+ * @param sequence Sequence number of the sample just published.
+ * @return true if a scan was done.
+ */
+bool _heap_caps_sample(uint32_t sequence);
+
+/**
+ * @brief Copy the latest per-capability scan.
+ *
+ * @param out Output report.
+ * @return true if a scan is available, false if disabled or not yet scanned.
+ */
+bool _heap_caps_read(sysmon_heap_report_t *out);
+
+/**
+ * @brief JSON name of a capability.
+ *
+ * @param caps Capability.
+ * @return Name ("internal", "dma", "spiram", "32bit", "exec").
+ */
+const char *_heap_caps_name(sysmon_heap_caps_t caps);
+
+/**
+ * @brief Lower bound of a histogram bucket.
+ *
+ * @param bucket Bucket index.
+ * @return Smallest block size counted in the bucket (bytes).
+ */
+uint32_t _heap_histogram_lower_bytes(int bucket);
+
+#ifdef __cplusplus
+}
+#endif
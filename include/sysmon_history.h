@@ -0,0 +1,151 @@
+/**
+ * @file sysmon_history.h
+ * @brief Column-wise history arena for the per-sample rings.
+ *
+ * The per-sample history lives outside the task and state structs, in an
+ * arena sized at sysmon_init() for the configured depth (sysmon_config_t):
+ *
+ *   - System-wide series: one allocation holding one contiguous column per
+ *     metric (history_depth elements each); the SysMonState ring pointers
+ *     point into it.
+ *   - Per-task series: pages of SYSMON_HISTORY_PAGE_SLOTS task slots. A page
+ *     holds one contiguous column per metric (slot-major, history_depth
+ *     elements per slot) plus the slots' rollup tiers. Pages are allocated as
+ *     the task array grows and never move, so growing the task array only
+ *     copies metadata; TaskUsageSample holds pointers into its slot's columns.
+ *
+ * Per-task samples are stored as sysmon_cpu_sample_t / sysmon_stack_sample_t
+ * (16-bit fixed point with CONFIG_SYSMON_COMPACT_HISTORY) and converted with
+ * the _history_encode_*() / _history_decode_*() helpers below; stack
+ * percentages are not stored but derived from the bytes on read.
+ *
+ * With history_in_psram, the arena is placed in PSRAM when available and falls
+ * back to internal RAM otherwise. Only the sampler task allocates or writes
+ * the arena; readers copy from it under the snapshot sequence lock.
+ */
+
+#pragma once
+
+// Project-specific includes
+#include "sysmon.h"
+
+// ESP-IDF includes
+#include "esp_err.h"
+
+// System includes
+#include <stdbool.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Task slots per history page.
+ */
+#define SYSMON_HISTORY_PAGE_SLOTS 4
+
+/**
+ * @brief Maximum number of history pages (enough for SYSMON_MAX_TRACKED_TASKS slots).
+ */
+#define SYSMON_HISTORY_MAX_PAGES ((SYSMON_MAX_TRACKED_TASKS + SYSMON_HISTORY_PAGE_SLOTS - 1) / SYSMON_HISTORY_PAGE_SLOTS)
+
+/**
+ * @brief Allocate the system-wide history columns and set the history depth.
+ *
+ * @param depth Samples per series.
+ * @param prefer_psram Place the arena in PSRAM when available.
+ * @return ESP_OK on success, ESP_ERR_INVALID_ARG for an unsupported depth,
+ *         ESP_ERR_NO_MEM on allocation failure.
+ */
+esp_err_t _history_init(int depth, bool prefer_psram);
+
+/**
+ * @brief Free all history pages and the system-wide columns (called during sysmon_deinit).
+ */
+void _history_cleanup(void);
+
+/**
+ * @brief Make sure task slots [0, capacity) are backed by history pages (sampler task only).
+ *
+ * @param capacity Number of task slots needed.
+ * @return true on success, false on allocation failure (existing pages are kept).
+ */
+bool _history_reserve_slots(int capacity);
+
+/**
+ * @brief Point a task entry's history columns and rollup at the storage of a slot.
+ *
+ * @param task Task entry (in the array that will hold it at index slot).
+ * @param slot Slot index (must be reserved).
+ */
+void _history_bind_slot(TaskUsageSample *task, int slot);
+
+/**
+ * @brief Zero a task entry's history columns and rollup tiers (sampler task only).
+ *
+ * @param task Bound task entry.
+ */
+void _history_clear_slot(TaskUsageSample *task);
+
+/**
+ * @brief Get the history storage allocated so far, by memory type.
+ *
+ * @param internal_bytes Output: bytes in internal RAM (may be NULL).
+ * @param psram_bytes Output: bytes in PSRAM (may be NULL).
+ */
+void _history_memory_usage(size_t *internal_bytes, size_t *psram_bytes);
+
+/**
+ * @brief Encode a CPU usage percentage as a history sample.
+ *
+ * @param percent CPU usage in percent.
+ * @return Sample (hundredths of a percent, saturating, in compact mode).
+ */
+sysmon_cpu_sample_t _history_encode_cpu(float percent);
+
+/**
+ * @brief Decode a CPU history sample.
+ *
+ * @param sample Sample from a usage_percent_history column.
+ * @return CPU usage in percent.
+ */
+float _history_decode_cpu(sysmon_cpu_sample_t sample);
+
+/**
+ * @brief Encode a stack usage in bytes as a history sample.
+ *
+ * @param bytes Stack usage in bytes.
+ * @return Sample (SYSMON_COMPACT_STACK_UNIT units rounded up, saturating, in compact mode).
+ */
+sysmon_stack_sample_t _history_encode_stack(uint32_t bytes);
+
+/**
+ * @brief Decode a stack history sample.
+ *
+ * @param sample Sample from a stack_usage_bytes_history column.
+ * @return Stack usage in bytes.
+ */
+uint32_t _history_decode_stack(sysmon_stack_sample_t sample);
+
+/**
+ * @brief Decode a whole CPU history column.
+ *
+ * @param column Column of count samples.
+ * @param out Output percentages (count elements).
+ * @param count Number of samples.
+ */
+void _history_decode_cpu_column(const sysmon_cpu_sample_t *column, float *out, int count);
+
+/**
+ * @brief Decode a whole stack history column.
+ *
+ * @param column Column of count samples.
+ * @param out Output byte counts (count elements).
+ * @param count Number of samples.
+ */
+void _history_decode_stack_column(const sysmon_stack_sample_t *column, uint32_t *out, int count);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,113 @@
+/**
+ * @file sysmon_history_bin.h
+ * @brief Compact binary encoding of the sample history (/history.bin).
+ *
+ * The history is sent as a list of named columns. Each column holds one
+ * series, oldest sample first, quantized to fixed point and delta encoded
+ * as zigzag varints. Layout (all varints are unsigned LEB128):
+ *
+ *   header : "SMHB", u8 version (2), varint seq, varint sample_count, varint interval_ms
+ *   column : varint name_len, name (UTF-8), u8 decimals, varint count,
+ *            zigzag varint q[0], zigzag varint (q[i] - q[i-1]) for i = 1..count-1
+ *   end    : varint 0 (a zero-length name)
+ *
+ * seq is the sequence number of the newest sample (as in /telemetry) and
+ * sample_count the number of samples held, at most the history depth (fewer
+ * until the rings have filled). Every column ends at sample seq. The system
+ * columns hold sample_count samples, copied together as of one sample; a task
+ * column holds fewer if the sampler overwrote its oldest samples meanwhile.
+ *
+ * A decoded value is q / 10^decimals. Column names are "sys/<series>" for
+ * system-wide series and "task/<key>/<series>" for per-task series, where
+ * <key> is the same task key used by the JSON endpoints. The decoder lives in www/js/utils.js.
+ *
+ * The column encoders are also used by the UDP exporter (sysmon_export.h),
+ * whose datagrams carry a range of recent samples in the same column format.
+ */
+
+#pragma once
+
+// Project-specific includes
+#include "sysmon_json_stream.h"
+
+// ESP-IDF includes
+#include "esp_err.h"
+
+// System includes
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Format version written after the "SMHB" magic.
+ */
+#define SYSMON_HISTORY_BIN_VERSION 2
+
+/**
+ * @brief Write the binary history for all system-wide series and monitored tasks.
+ *
+ * @param stream Chunked response writer (headers already set by the caller).
+ * @return ESP_OK on success, or the first error raised while streaming.
+ */
+esp_err_t _write_history_bin(json_stream_t *stream);
+
+/**
+ * @brief Write an unsigned LEB128 varint.
+ *
+ * @param stream Chunked response writer.
+ * @param value Value to encode.
+ */
+void _history_bin_put_varint(json_stream_t *stream, uint64_t value);
+
+/**
+ * @brief Write samples of a float ring buffer as a fixed-point delta column, oldest sample first.
+ *
+ * @param stream Chunked response writer.
+ * @param name Column name.
+ * @param ring Ring buffer (self.history_depth elements).
+ * @param first Index of the first (oldest) sample to write.
+ * @param count Number of samples to write (at most self.history_depth).
+ * @param decimals Fixed-point decimals (0-2).
+ */
+void _history_bin_put_float_column(json_stream_t *stream, const char *name, const float *ring,
+                                   int first, uint32_t count, uint8_t decimals);
+
+/**
+ * @brief Write samples of a uint32_t ring buffer as an integer delta column, oldest sample first.
+ *
+ * @param stream Chunked response writer.
+ * @param name Column name.
+ * @param ring Ring buffer (self.history_depth elements).
+ * @param first Index of the first (oldest) sample to write.
+ * @param count Number of samples to write (at most self.history_depth).
+ */
+void _history_bin_put_uint_column(json_stream_t *stream, const char *name, const uint32_t *ring,
+                                  int first, uint32_t count);
+
+/**
+ * @brief Write samples of an int32_t ring buffer as an integer delta column, oldest sample first.
+ *
+ * @param stream Chunked response writer.
+ * @param name Column name.
+ * @param ring Ring buffer (self.history_depth elements).
+ * @param first Index of the first (oldest) sample to write.
+ * @param count Number of samples to write (at most self.history_depth).
+ */
+void _history_bin_put_int_column(json_stream_t *stream, const char *name, const int32_t *ring,
+                                 int first, uint32_t count);
+
+/**
+ * @brief Write a plain uint32_t array as an integer delta column.
+ *
+ * @param stream Chunked response writer.
+ * @param name Column name.
+ * @param values Samples, oldest first.
+ * @param count Number of samples to write.
+ */
+void _history_bin_put_uint_array(json_stream_t *stream, const char *name, const uint32_t *values, uint32_t count);
+
+#ifdef __cplusplus
+}
+#endif
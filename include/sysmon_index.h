@@ -0,0 +1,114 @@
+/**
+ * @file sysmon_index.h
+ * @brief Open-addressing hash index keyed by task handle.
+ *
+ * This header declares a small linear-probing hash map from a pointer key
+ * (TaskHandle_t) to a 32-bit value. It is shared by the sampler (handle to
+ * task slot) and the stack registry (handle to stack size), so per-task
+ * lookups are O(1) instead of a scan over every slot.
+ *
+ * The index never allocates on its own; callers provide zeroed entry tables,
+ * so lookups and updates are safe inside critical sections.
+ */
+
+#pragma once
+
+// System includes
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief One index slot; a NULL key marks an empty slot.
+ */
+typedef struct
+{
+    const void *key;
+    uint32_t value;
+} sysmon_index_entry_t;
+
+/**
+ * @brief Hash index state.
+ *
+ * Members:
+ * - entries  : Slot table (capacity is a power of two).
+ * - capacity : Number of slots in entries.
+ * - count    : Number of occupied slots.
+ */
+typedef struct
+{
+    sysmon_index_entry_t *entries;
+    uint32_t capacity;
+    uint32_t count;
+} sysmon_index_t;
+
+/**
+ * @brief Get the slot table size needed to hold a number of keys at <= 50% load.
+ *
+ * @param items Number of keys the index must hold.
+ * @return Power-of-two slot count.
+ */
+uint32_t _index_capacity_for(uint32_t items);
+
+/**
+ * @brief Check whether the index must grow before holding a number of keys.
+ *
+ * @param index Index to check.
+ * @param items Number of keys the index must hold.
+ * @return true if a larger table is required.
+ */
+bool _index_needs_grow(const sysmon_index_t *index, uint32_t items);
+
+/**
+ * @brief Move all keys into a new slot table.
+ *
+ * @param index Index to rehash.
+ * @param entries Zeroed slot table (ownership is transferred to the index).
+ * @param capacity Number of slots in entries (power of two, larger than index->count).
+ * @return Previous slot table, to be freed by the caller (may be NULL).
+ */
+sysmon_index_entry_t *_index_rehash(sysmon_index_t *index, sysmon_index_entry_t *entries, uint32_t capacity);
+
+/**
+ * @brief Look up a key.
+ *
+ * @param index Index to search.
+ * @param key Key to find (non-NULL).
+ * @param value Output: stored value (may be NULL).
+ * @return true if the key is present.
+ */
+bool _index_find(const sysmon_index_t *index, const void *key, uint32_t *value);
+
+/**
+ * @brief Insert a key or update its value.
+ *
+ * @param index Index to update.
+ * @param key Key to insert (non-NULL).
+ * @param value Value to store.
+ * @return true on success, false if the table is full.
+ */
+bool _index_insert(sysmon_index_t *index, const void *key, uint32_t value);
+
+/**
+ * @brief Remove a key (no-op if absent).
+ *
+ * @param index Index to update.
+ * @param key Key to remove.
+ */
+void _index_remove(sysmon_index_t *index, const void *key);
+
+/**
+ * @brief Detach and return the slot table, leaving an empty index.
+ *
+ * @param index Index to reset.
+ * @return Slot table to be freed by the caller (may be NULL).
+ */
+sysmon_index_entry_t *_index_release(sysmon_index_t *index);
+
+#ifdef __cplusplus
+}
+#endif
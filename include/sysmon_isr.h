@@ -0,0 +1,73 @@
+/**
+ * @file sysmon_isr.h
+ * @brief Interrupt load per core from wrapped interrupt handlers.
+ *
+ * FreeRTOS charges the time spent in an interrupt to whichever task it
+ * interrupted, usually the idle task, so a core busy with SPI, I2S or GPIO
+ * interrupts looks idle in the per-core CPU usage. With
+ * CONFIG_SYSMON_ISR_MONITOR, the linker redirects esp_intr_alloc(),
+ * esp_intr_alloc_intrstatus() and esp_intr_free() (-Wl,--wrap) to this module,
+ * which registers a shim in place of every C handler. The shim reads the CPU
+ * cycle counter around the real handler and adds the cycles:
+ *
+ *   - to the handler's entry: call count, cycles and the longest call (per
+ *     sample interval). A nested interrupt's time also counts in the handler
+ *     it interrupted;
+ *   - to its core's interrupt time, outermost interrupts only, so nested
+ *     interrupts are counted once.
+ *
+ * Only this core's interrupts write its counters, and a handler runs on the
+ * core that allocated it, so the shim takes no lock. Handler entries live in a
+ * static table of CONFIG_SYSMON_ISR_MAX_HANDLERS entries, claimed at allocation
+ * and released by esp_intr_free(); handlers allocated while the table is full
+ * run unwrapped and are counted as untracked.
+ *
+ * Not seen: high-level (level 4 and above) interrupts, which have no C handler,
+ * handlers installed without esp_intr_alloc() (e.g. xt_set_interrupt_handler()),
+ * and the interrupt vector's own entry and exit. Cycles are converted with the
+ * CPU frequency at the end of each sample, so loads are approximate while
+ * dynamic frequency scaling changes it.
+ *
+ * Every sample, the sampler turns the counters into each core's interrupt load
+ * (percent of the interval), kept as its own series next to the per-core CPU
+ * usage (/telemetry summary.cpu.isr, /history?since= isr0, isr1, ...), and into
+ * per-handler load, call rate and longest call (/interrupts).
+ */
+
+#pragma once
+
+// Project-specific includes
+#include "sysmon.h"
+#include "sysmon_json_stream.h"
+
+// ESP-IDF includes
+#include "esp_err.h"
+
+// System includes
+#include <stdbool.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Turn the interrupt counters into the interrupt load of the latest interval (sampler task only).
+ *
+ * @param timestamp_us Timestamp of the sample.
+ * @param isr_percent Output: interrupt load per core (0 for the first sample).
+ * @return true on success, false if interrupt monitoring is disabled (isr_percent is zeroed).
+ */
+bool _isr_sample(int64_t timestamp_us, float isr_percent[SYSMON_CORE_COUNT]);
+
+/**
+ * @brief Write the per-handler interrupt statistics (/interrupts).
+ *
+ * @param stream Chunked response writer.
+ * @return ESP_OK on success, or the first error raised while streaming.
+ */
+esp_err_t _write_interrupts_json(json_stream_t *stream);
+
+#ifdef __cplusplus
+}
+#endif
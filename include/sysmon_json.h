@@ -8,40 +8,87 @@
 
 #pragma once
 
+// Project-specific includes
+#include "sysmon_json_stream.h"
+
 // ESP-IDF includes
-#include "cJSON.h"
+#include "esp_err.h"
 
 #ifdef __cplusplus
 extern "C" {
 #endif
 
 /**
- * @brief Build task metadata JSON object for all monitored tasks.
+ * @brief Write task metadata JSON object for all monitored tasks.
+ *
+ * @param stream Streaming JSON writer (headers already set by the caller).
+ * @return ESP_OK on success, or the first error raised while streaming.
+ */
+esp_err_t _write_tasks_json(json_stream_t *stream);
+
+/**
+ * @brief Write JSON object tracing task usage history for all monitored tasks.
+ *
+ * @param stream Streaming JSON writer (headers already set by the caller).
+ * @return ESP_OK on success, or the first error raised while streaming.
+ */
+esp_err_t _write_history_json(json_stream_t *stream);
+
+/**
+ * @brief Write hardware information JSON object with chip, memory, partition and system info.
+ *
+ * @param stream Streaming JSON writer (headers already set by the caller).
+ * @return ESP_OK on success, or the first error raised while streaming.
+ */
+esp_err_t _write_hardware_json(json_stream_t *stream);
+
+/**
+ * @brief Build the /hardware cache (called from sysmon_init before the HTTP server starts).
+ *
+ * Reads the chip info, partition table, app image sizes and flash size once so
+ * that /hardware requests do not touch flash.
+ *
+ * @return ESP_OK on success, ESP_ERR_NO_MEM on allocation failure.
+ */
+esp_err_t _hardware_cache_init(void);
+
+/**
+ * @brief Free the /hardware cache (called from sysmon_deinit after the HTTP server stops).
+ */
+void _hardware_cache_cleanup(void);
+
+/**
+ * @brief Write a complete telemetry JSON object summarizing CPU/memory and current registered task usage.
  *
- * @return Pointer to root cJSON object (must be freed by caller), or NULL on oom.
+ * @param stream Streaming JSON writer (headers already set by the caller).
+ * @return ESP_OK on success, or the first error raised while streaming.
  */
-cJSON *_create_tasks_json(void);
+esp_err_t _write_telemetry_json(json_stream_t *stream);
 
 /**
- * @brief Build JSON object tracing task usage history for all monitored tasks.
+ * @brief Write the telemetry, task metadata and history delta in one response (/bundle).
  *
- * @return Root cJSON object, or NULL on allocation failure.
+ * @param stream Streaming JSON writer (headers already set by the caller).
+ * @return ESP_OK on success, ESP_ERR_INVALID_ARG for an unknown part or projection
+ *         parameter, or the first error raised while streaming.
  */
-cJSON *_create_history_json(void);
+esp_err_t _write_bundle_json(json_stream_t *stream);
 
 /**
- * @brief Create hardware information JSON object with static chip and system info.
+ * @brief Write the sysmon self-profiling JSON object (/sysmon/self, see sysmon_profile.h).
  *
- * @return Hardware info JSON object, or NULL on allocation failure.
+ * @param stream Streaming JSON writer (headers already set by the caller).
+ * @return ESP_OK on success, or the first error raised while streaming.
  */
-cJSON *_create_hardware_json(void);
+esp_err_t _write_self_json(json_stream_t *stream);
 
 /**
- * @brief Build a complete telemetry JSON object summarizing CPU/memory and current registered task usage.
+ * @brief Write the per-capability heap statistics JSON object (/heap, see sysmon_heap.h).
  *
- * @return Root cJSON object, or NULL on allocation failure.
+ * @param stream Streaming JSON writer (headers already set by the caller).
+ * @return ESP_OK on success, or the first error raised while streaming.
  */
-cJSON *_create_telemetry_json(void);
+esp_err_t _write_heap_json(json_stream_t *stream);
 
 #ifdef __cplusplus
 }
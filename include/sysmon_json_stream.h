@@ -0,0 +1,229 @@
+/**
+ * @file sysmon_json_stream.h
+ * @brief Streaming JSON writer for sysmon HTTP endpoints.
+ *
+ * This header declares a small JSON writer that formats values directly into
+ * a fixed-size chunk buffer and flushes it with httpd_resp_send_chunk() as it
+ * fills. The writer itself needs only the chunk buffer, independent of task
+ * count or history depth, and no heap nodes are created per value; what an
+ * endpoint copies on top of it is up to its writer (most copy one task at a
+ * time, /history copies a task's whole history). The same
+ * writer can also format a whole document into memory (json_stream_init_memory()),
+ * for payloads that are built once and sent to several clients.
+ */
+
+#pragma once
+
+// ESP-IDF includes
+#include "esp_err.h"
+#include "esp_http_server.h"
+
+// System includes
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Maximum object/array nesting depth supported by the writer.
+ */
+#define JSON_STREAM_MAX_DEPTH 32
+
+/**
+ * @brief State of a streaming JSON response.
+ *
+ * Members:
+ * - request        : HTTP request the chunks are sent to (NULL discards flushed bytes and only counts them).
+ * - buffer         : Caller-owned chunk buffer.
+ * - capacity       : Size of the chunk buffer in bytes.
+ * - length         : Number of pending bytes in the chunk buffer.
+ * - bytes_sent     : Total number of bytes flushed so far.
+ * - send_us        : Time spent in httpd_resp_send_chunk() so far (microseconds).
+ * - slice_us       : Building time after which a flush sleeps for one tick (0 never sleeps, set by the caller).
+ * - slice_start_us : Start of the current building slice (esp_timer_get_time()).
+ * - slice_send_us  : send_us at the start of the current slice (sending does not count as building).
+ * - first_mask     : One bit per nesting level, set while the next element at that level is the first.
+ * - depth          : Current nesting depth.
+ * - after_key      : True when a key was just written and the next value must not be preceded by a comma.
+ * - in_memory      : True if the buffer must hold the whole document (nothing is sent; overflow is an error).
+ * - error          : Sticky error; once set, all further writes are ignored.
+ */
+typedef struct
+{
+    httpd_req_t *request;
+    char *buffer;
+    size_t capacity;
+    size_t length;
+    size_t bytes_sent;
+    int64_t send_us;
+    int64_t slice_us;
+    int64_t slice_start_us;
+    int64_t slice_send_us;
+    uint32_t first_mask;
+    uint8_t depth;
+    bool after_key;
+    bool in_memory;
+    esp_err_t error;
+} json_stream_t;
+
+/**
+ * @brief Initialize a streaming JSON writer.
+ *
+ * @param stream Writer state to initialize.
+ * @param request HTTP request that receives the chunks.
+ * @param buffer Chunk buffer (owned by caller, must outlive the writer).
+ * @param capacity Size of the chunk buffer in bytes (at least 64).
+ * @return ESP_OK on success, ESP_ERR_INVALID_ARG on bad parameters.
+ */
+esp_err_t json_stream_init(json_stream_t *stream, httpd_req_t *request, char *buffer, size_t capacity);
+
+/**
+ * @brief Initialize a writer that formats a whole document into memory.
+ *
+ * The document is complete once the last value is closed: stream->length bytes
+ * of buffer hold it (not NUL-terminated). If it does not fit, stream->error is
+ * set to ESP_ERR_NO_MEM. json_stream_finish() is not needed.
+ *
+ * @param stream Writer state to initialize.
+ * @param buffer Document buffer (owned by caller, must outlive the writer).
+ * @param capacity Size of the buffer in bytes (at least 64).
+ * @return ESP_OK on success, ESP_ERR_INVALID_ARG on bad parameters.
+ */
+esp_err_t json_stream_init_memory(json_stream_t *stream, char *buffer, size_t capacity);
+
+/**
+ * @brief Flush pending bytes and terminate the chunked response.
+ *
+ * @param stream Writer state.
+ * @return ESP_OK if the whole response was sent, otherwise the first error encountered.
+ *
+ * The terminating chunk is only sent if no error occurred, so a failed response
+ * never reaches the client as complete.
+ */
+esp_err_t json_stream_finish(json_stream_t *stream);
+
+/**
+ * @brief Send any buffered bytes as a chunk without terminating the response.
+ *
+ * @param stream Writer state.
+ */
+void json_stream_flush(json_stream_t *stream);
+
+/**
+ * @brief Append raw, already-formatted JSON text (no separator handling).
+ *
+ * @param stream Writer state.
+ * @param data Bytes to append.
+ * @param len Number of bytes.
+ */
+void json_stream_raw(json_stream_t *stream, const char *data, size_t len);
+
+/**
+ * @brief Drop everything an in-memory writer appended after an earlier length.
+ *
+ * Clears an ESP_ERR_NO_MEM overflow, so a caller can leave out a part that
+ * does not fit and go on with the rest. Only for raw (non-JSON) documents, as
+ * the nesting state is not restored.
+ *
+ * @param stream Writer state (from json_stream_init_memory()).
+ * @param length Earlier stream->length to return to.
+ */
+void json_stream_rewind(json_stream_t *stream, size_t length);
+
+/**
+ * @brief Open a JSON object ('{') at the current position.
+ *
+ * @param stream Writer state.
+ */
+void json_stream_object_begin(json_stream_t *stream);
+
+/**
+ * @brief Close the innermost JSON object ('}').
+ *
+ * @param stream Writer state.
+ */
+void json_stream_object_end(json_stream_t *stream);
+
+/**
+ * @brief Open a JSON array ('[') at the current position.
+ *
+ * @param stream Writer state.
+ */
+void json_stream_array_begin(json_stream_t *stream);
+
+/**
+ * @brief Close the innermost JSON array (']').
+ *
+ * @param stream Writer state.
+ */
+void json_stream_array_end(json_stream_t *stream);
+
+/**
+ * @brief Write an object key; the next write is its value.
+ *
+ * @param stream Writer state.
+ * @param key Key string (escaped as needed).
+ */
+void json_stream_key(json_stream_t *stream, const char *key);
+
+/**
+ * @brief Write scalar values (array elements, or the value after json_stream_key()).
+ *
+ * Strings are escaped per RFC 8259; NULL strings are written as null.
+ *
+ * @param stream Writer state.
+ * @param value Value to write.
+ */
+void json_stream_string(json_stream_t *stream, const char *value);
+void json_stream_uint(json_stream_t *stream, uint32_t value);
+void json_stream_uint64(json_stream_t *stream, uint64_t value);
+void json_stream_int(json_stream_t *stream, int32_t value);
+void json_stream_bool(json_stream_t *stream, bool value);
+void json_stream_null(json_stream_t *stream);
+
+/**
+ * @brief Write a number rounded to a fixed number of decimals, trailing zeros trimmed.
+ *
+ * Formatting is done with integer arithmetic, so it works with newlib nano formatting
+ * and is cheaper than printf("%f"). Non-finite values, and values whose magnitude
+ * scaled by 10^decimals reaches about 9.2e18 (beyond the integer range), are written as null.
+ *
+ * @param stream Writer state.
+ * @param value Value to write.
+ * @param decimals Number of decimal places (0-6).
+ */
+void json_stream_fixed(json_stream_t *stream, double value, int decimals);
+
+/**
+ * @brief Write an already-serialized JSON value (e.g. a cached cJSON_PrintUnformatted() string).
+ *
+ * Unlike json_stream_raw(), the value takes part in separator handling. The
+ * text is copied verbatim and must be valid JSON; NULL is written as null.
+ *
+ * @param stream Writer state.
+ * @param json NUL-terminated JSON text.
+ */
+void json_stream_value_raw(json_stream_t *stream, const char *json);
+
+/**
+ * @brief Object member helpers: write a key followed by its value.
+ *
+ * @param stream Writer state.
+ * @param key Member key.
+ * @param value Member value.
+ */
+void json_stream_add_string(json_stream_t *stream, const char *key, const char *value);
+void json_stream_add_uint(json_stream_t *stream, const char *key, uint32_t value);
+void json_stream_add_uint64(json_stream_t *stream, const char *key, uint64_t value);
+void json_stream_add_int(json_stream_t *stream, const char *key, int32_t value);
+void json_stream_add_bool(json_stream_t *stream, const char *key, bool value);
+void json_stream_add_null(json_stream_t *stream, const char *key);
+void json_stream_add_fixed(json_stream_t *stream, const char *key, double value, int decimals);
+void json_stream_add_value_raw(json_stream_t *stream, const char *key, const char *json);
+
+#ifdef __cplusplus
+}
+#endif
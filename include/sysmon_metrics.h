@@ -0,0 +1,62 @@
+/**
+ * @file sysmon_metrics.h
+ * @brief OpenMetrics text exposition of the latest sample (/metrics).
+ *
+ * /metrics serves the latest published sample in the OpenMetrics text format
+ * (which Prometheus scrapes natively), so devices can be scraped directly
+ * without a translating proxy. Lines are formatted straight into the chunk
+ * buffer of the streaming writer and sent with chunked transfer encoding; no
+ * cJSON tree or intermediate document is built.
+ *
+ * Metric families (all prefixed "sysmon_"):
+ *   - cpu_usage_ratio{core}, cpu_overall_usage_ratio       : CPU usage (0..1).
+ *   - heap_free_bytes{region}, heap_total_bytes{region}    : DRAM ("dram") and,
+ *     when present, PSRAM ("psram").
+ *   - heap_largest_free_block_bytes{region="dram"},
+ *     heap_min_free_bytes{region="dram"}                   : DRAM fragmentation
+ *     and low-water mark.
+ *   - task_cpu_usage_ratio{task}                           : Per-task CPU usage.
+ *   - task_stack_used_bytes{task}, task_stack_free_bytes{task},
+ *     task_stack_size_bytes{task}                          : Per-task stack (the
+ *     size only for registered tasks).
+ *   - task_priority{task}                                  : Current priority.
+ *   - samples_total, sample_overruns_total,
+ *     sample_skipped_total                                 : Sampler counters.
+ *
+ * Task labels use the same keys as the JSON endpoints ("app_main", "name#2"
+ * for duplicate names). OpenMetrics requires each family to be contiguous, so
+ * the task families are written one after the other, each from its own pass
+ * over the snapshot through a single reusable row; a scrape needs the same
+ * memory whatever the number of tasks.
+ * Floating point values are written in fixed point, so the output does not
+ * depend on printf float support (CONFIG_NEWLIB_NANO_FORMAT).
+ */
+
+#pragma once
+
+// Project-specific includes
+#include "sysmon_json_stream.h"
+
+// ESP-IDF includes
+#include "esp_err.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Content type of the /metrics response.
+ */
+#define SYSMON_METRICS_CONTENT_TYPE "application/openmetrics-text; version=1.0.0; charset=utf-8"
+
+/**
+ * @brief Write the latest sample in the OpenMetrics text format.
+ *
+ * @param stream Chunked response writer (headers already set by the caller).
+ * @return ESP_OK on success, or the first error raised while streaming.
+ */
+esp_err_t _write_metrics_text(json_stream_t *stream);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,76 @@
+/**
+ * @file sysmon_persist.h
+ * @brief Latest samples kept across resets in RTC memory.
+ *
+ * The history lives in ordinary RAM and is lost on every reset, including
+ * the watchdog resets and panics whose cause it would explain. With
+ * CONFIG_SYSMON_PERSIST_HISTORY the sampler also mirrors the latest
+ * CONFIG_SYSMON_PERSIST_SAMPLES samples into a ring in RTC_NOINIT memory,
+ * which survives software resets, panics, watchdog resets and deep sleep
+ * (not power loss). Nothing is written to flash.
+ *
+ * Each sample is one compact record of 28 bytes plus 2 per core and 6 per
+ * task (68 bytes with the defaults on a dual-core chip):
+ *   - sequence number, sample time (ms since boot), overall and per-core
+ *     CPU usage (hundredths of a percent), free, minimum free and largest
+ *     free internal heap block, free PSRAM;
+ *   - for the CONFIG_SYSMON_PERSIST_TASKS tasks with the highest CPU or
+ *     stack usage of the sample: CPU usage (hundredths of a percent), stack
+ *     usage (percent, registered stacks only) and stack never used (bytes).
+ *     Task keys are kept in a small name table in the same region, so a
+ *     record only stores a one-byte reference.
+ *
+ * A record is written field by field, then sealed with a checksum, and only
+ * then counted, so a reset in the middle of a write loses at most that
+ * sample. At the first sysmon_init() after a reset the ring is checked
+ * (magic, layout, checksums), copied to the heap together with the reset
+ * reason and cleared for the new boot. /history?boot=previous serves the
+ * copy; after a power-on reset there is no previous boot.
+ */
+
+#pragma once
+
+// Project-specific includes
+#include "sysmon_json_stream.h"
+
+// ESP-IDF includes
+#include "esp_err.h"
+
+// System includes
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Recover the previous boot's samples and start a new ring.
+ *
+ * Only the first call after a reset recovers; later calls (after
+ * sysmon_deinit()) keep the recovered copy and keep appending to the ring.
+ *
+ * @return ESP_OK on success (or if persistence is disabled), ESP_ERR_NO_MEM if
+ *         the recovered samples could not be copied (the ring is still restarted).
+ */
+esp_err_t _persist_start(void);
+
+/**
+ * @brief Append the sample just published to the ring (sampler task only).
+ *
+ * Call after _snapshot_write_end().
+ *
+ * @param timestamp_us Timestamp of the sample.
+ */
+void _persist_record(int64_t timestamp_us);
+
+/**
+ * @brief Write the previous boot's samples (/history?boot=previous).
+ *
+ * @param stream Chunked response writer.
+ * @return ESP_OK on success, or the first error raised while streaming.
+ */
+esp_err_t _write_persist_json(json_stream_t *stream);
+
+#ifdef __cplusplus
+}
+#endif
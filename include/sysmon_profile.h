@@ -0,0 +1,187 @@
+/**
+ * @file sysmon_profile.h
+ * @brief Self-profiling of the sysmon sampler phases and HTTP handlers.
+ *
+ * With CONFIG_SYSMON_SELF_PROFILE, sysmon times its own hot paths with
+ * esp_timer_get_time() and records, per phase, the call count, min/avg/max
+ * duration, a histogram for percentiles and the change of free heap across
+ * the phase. Served by /sysmon/self and shown in the dashboard, so the
+ * monitor's overhead can be checked on the actual firmware.
+ *
+ * Phases:
+ *   - Sampler (sampler task): the whole sample and each of its steps.
+ *   - HTTP (HTTP server task): each JSON/binary endpoint, split into building
+ *     the response and sending it (time spent in httpd_resp_send_chunk()),
+ *     and sending live telemetry frames to WebSocket subscribers.
+ *
+ * Histogram buckets are half an octave wide (bucket bounds grow by about
+ * 1.41x), so percentiles are upper bounds within that factor. Bucket counts
+ * are 16-bit and halved together when one saturates, which keeps the shape
+ * while favouring recent calls; count, min, max and averages cover all calls.
+ *
+ * Heap deltas are free heap before minus free heap after a phase (positive
+ * means the phase left memory allocated). The free heap is global, so
+ * allocations by other tasks during a phase show up as noise.
+ *
+ * Without CONFIG_SYSMON_SELF_PROFILE the functions are no-ops and
+ * _profile_read() reports no data.
+ */
+
+#pragma once
+
+// System includes
+#include <stdbool.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Number of duration histogram buckets per phase (1 us .. about 16 s).
+ */
+#define SYSMON_PROFILE_BUCKETS 48
+
+/**
+ * @brief Profiled phases.
+ *
+ * The send phase of an HTTP endpoint directly follows its build phase.
+ */
+typedef enum
+{
+    SYSMON_PROFILE_SAMPLE = 0,           ///< Whole sample (sampler steps 1-10)
+    SYSMON_PROFILE_CAPACITY,             ///< _ensure_task_storage_capacity()
+    SYSMON_PROFILE_TASK_STATES,          ///< Task state sampling (uxTaskGetSystemState() or the light read)
+    SYSMON_PROFILE_TASK_UPDATE,          ///< Per-task update loop and deleted task processing
+    SYSMON_PROFILE_MEMORY,               ///< _collect_memory_stats()
+    SYSMON_PROFILE_SERIES,               ///< Series buffers, rollups and sample publication
+    SYSMON_PROFILE_PUSH,                 ///< Serializing a live telemetry frame and queuing its send
+    SYSMON_PROFILE_HEAP_CAPS,            ///< Per-capability heap scan (only samples that scan)
+    SYSMON_PROFILE_ALERTS,               ///< Alert rule evaluation
+    SYSMON_PROFILE_TASKS_BUILD,          ///< /tasks
+    SYSMON_PROFILE_TASKS_SEND,
+    SYSMON_PROFILE_HISTORY_BUILD,        ///< /history
+    SYSMON_PROFILE_HISTORY_SEND,
+    SYSMON_PROFILE_HISTORY_BIN_BUILD,    ///< /history.bin
+    SYSMON_PROFILE_HISTORY_BIN_SEND,
+    SYSMON_PROFILE_TELEMETRY_BUILD,      ///< /telemetry
+    SYSMON_PROFILE_TELEMETRY_SEND,
+    SYSMON_PROFILE_HARDWARE_BUILD,       ///< /hardware
+    SYSMON_PROFILE_HARDWARE_SEND,
+    SYSMON_PROFILE_METRICS_BUILD,        ///< /metrics
+    SYSMON_PROFILE_METRICS_SEND,
+    SYSMON_PROFILE_HEAP_BUILD,           ///< /heap
+    SYSMON_PROFILE_HEAP_SEND,
+    SYSMON_PROFILE_BURST_BUILD,          ///< /burst
+    SYSMON_PROFILE_BURST_SEND,
+    SYSMON_PROFILE_BURST_BIN_BUILD,      ///< /burst.bin
+    SYSMON_PROFILE_BURST_BIN_SEND,
+    SYSMON_PROFILE_ALERTS_BUILD,         ///< /alerts
+    SYSMON_PROFILE_ALERTS_SEND,
+    SYSMON_PROFILE_INTERRUPTS_BUILD,     ///< /interrupts
+    SYSMON_PROFILE_INTERRUPTS_SEND,
+    SYSMON_PROFILE_BUNDLE_BUILD,         ///< /bundle
+    SYSMON_PROFILE_BUNDLE_SEND,
+    SYSMON_PROFILE_SELF_BUILD,           ///< /sysmon/self
+    SYSMON_PROFILE_SELF_SEND,
+    SYSMON_PROFILE_PUSH_SEND,            ///< Sending a live telemetry frame to all subscribers
+    SYSMON_PROFILE_PHASE_COUNT
+} sysmon_profile_phase_t;
+
+/**
+ * @brief Start of a profiled phase.
+ *
+ * Members:
+ * - start_us   : esp_timer_get_time() at the start.
+ * - free_bytes : Free heap at the start.
+ */
+typedef struct
+{
+    int64_t start_us;
+    uint32_t free_bytes;
+} sysmon_profile_mark_t;
+
+/**
+ * @brief Statistics of one phase.
+ *
+ * Members:
+ * - count            : Number of recorded calls.
+ * - min_us           : Shortest duration (microseconds).
+ * - max_us           : Longest duration (microseconds).
+ * - total_us         : Sum of all durations (microseconds).
+ * - heap_delta_total : Sum of all heap deltas (bytes).
+ * - heap_delta_max   : Largest heap delta (bytes).
+ * - buckets          : Duration histogram (see _profile_percentile_us()).
+ */
+typedef struct
+{
+    uint32_t count;
+    uint32_t min_us;
+    uint32_t max_us;
+    uint64_t total_us;
+    int64_t heap_delta_total;
+    int32_t heap_delta_max;
+    uint16_t buckets[SYSMON_PROFILE_BUCKETS];
+} sysmon_profile_stats_t;
+
+/**
+ * @brief Mark the start of a phase.
+ *
+ * @param mark Output: start time and free heap.
+ */
+void _profile_begin(sysmon_profile_mark_t *mark);
+
+/**
+ * @brief Record a phase that started at mark.
+ *
+ * @param phase Phase.
+ * @param mark Start of the phase (from _profile_begin()).
+ */
+void _profile_end(sysmon_profile_phase_t phase, const sysmon_profile_mark_t *mark);
+
+/**
+ * @brief Record an HTTP response split into build and send time.
+ *
+ * @param build_phase Build phase of the endpoint (its send phase follows it).
+ * @param mark Start of the response (from _profile_begin()).
+ * @param send_us Part of the response time spent sending.
+ */
+void _profile_end_response(sysmon_profile_phase_t build_phase, const sysmon_profile_mark_t *mark, int64_t send_us);
+
+/**
+ * @brief Copy the statistics of a phase.
+ *
+ * @param phase Phase.
+ * @param out Output statistics.
+ * @return true on success, false if profiling is disabled or phase is invalid.
+ */
+bool _profile_read(sysmon_profile_phase_t phase, sysmon_profile_stats_t *out);
+
+/**
+ * @brief Time of the first recorded phase.
+ *
+ * @return esp_timer_get_time() of the first record, 0 if nothing was recorded yet.
+ */
+int64_t _profile_started_us(void);
+
+/**
+ * @brief Estimate a duration percentile from a phase histogram.
+ *
+ * @param stats Phase statistics.
+ * @param per_mille Percentile in thousandths (e.g. 990 for p99).
+ * @return Upper bound of the bucket holding the percentile, capped at max_us (0 without calls).
+ */
+uint32_t _profile_percentile_us(const sysmon_profile_stats_t *stats, uint32_t per_mille);
+
+/**
+ * @brief JSON location of a phase.
+ *
+ * @param phase Phase.
+ * @param group Output: URI of the endpoint, or NULL for sampler phases.
+ * @return Key of the phase within its group.
+ */
+const char *_profile_phase_name(sysmon_profile_phase_t phase, const char **group);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,61 @@
+/**
+ * @file sysmon_push.h
+ * @brief Live telemetry push to WebSocket subscribers.
+ *
+ * Clients that open a WebSocket on /telemetry/ws receive every new sample as
+ * a text frame holding the same JSON document as /telemetry. The sampler
+ * serializes each sample once, into a shared buffer, and queues a single work
+ * item on the HTTP server task that sends it to all subscribers. The sampler
+ * never waits on a socket: if the previous frame is still being sent, the new
+ * sample is skipped for push (clients catch up with /history?since=).
+ *
+ * Requires CONFIG_HTTPD_WS_SUPPORT; without it the functions are no-ops and
+ * the dashboard keeps polling /telemetry.
+ */
+
+#pragma once
+
+// ESP-IDF includes
+#include "esp_err.h"
+#include "esp_http_server.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief URI of the telemetry WebSocket.
+ */
+#define SYSMON_PUSH_URI "/telemetry/ws"
+
+/**
+ * @brief Register the telemetry WebSocket handler.
+ *
+ * @param server Running HTTP server.
+ * @return ESP_OK on success (or if WebSocket support is disabled), error code otherwise.
+ */
+esp_err_t _push_register(httpd_handle_t server);
+
+/**
+ * @brief Number of URI handlers _push_register() adds (for httpd_config_t.max_uri_handlers).
+ *
+ * @return 1 with WebSocket support, 0 otherwise.
+ */
+size_t _push_handler_count(void);
+
+/**
+ * @brief Send the sample just published to all subscribers (sampler task only).
+ *
+ * Call after _snapshot_write_end(). Returns immediately if there are no
+ * subscribers or the previous frame is still in flight.
+ */
+void _push_publish(void);
+
+/**
+ * @brief Forget all subscribers and free the frame buffer (after httpd_stop()).
+ */
+void _push_cleanup(void);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,81 @@
+/**
+ * @file sysmon_rollup.h
+ * @brief Downsampled (min/avg/max) history tiers for long lookback.
+ *
+ * Next to the per-sample rings, the sampler keeps SYSMON_ROLLUP_TIERS cascading
+ * rings of CONFIG_SYSMON_ROLLUP_DEPTH buckets each. A tier 0 bucket summarizes
+ * SYSMON_ROLLUP_TIER0_SAMPLES samples, a tier 1 bucket summarizes
+ * SYSMON_ROLLUP_TIER1_BUCKETS tier 0 buckets (10 s and 1 min buckets with the
+ * default 1 s interval). Buckets are fed incrementally, one sample at a time,
+ * and each bucket stores the minimum, average and maximum of its inputs.
+ *
+ * Buckets are aligned to sample sequence numbers: bucket n of a tier (n >= 1)
+ * covers samples ((n - 1) * N, n * N], N = _rollup_samples_per_bucket(tier),
+ * and is stored at ring index (n - 1) % CONFIG_SYSMON_ROLLUP_DEPTH. A sample
+ * copy with sequence S therefore holds the closed buckets up to S / N.
+ *
+ * Per task, CPU usage keeps min/avg/max and stack usage keeps its maximum (the
+ * value that matters for overflow and leak trends), to bound per-task memory.
+ * A task that appears mid-bucket summarizes only the samples since it appeared,
+ * so its first buckets cover fewer inputs than N.
+ *
+ * All functions are called by the sampler task only, between
+ * _snapshot_write_begin() and _snapshot_write_end().
+ */
+
+#pragma once
+
+// Project-specific includes
+#include "sysmon.h"
+
+// System includes
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Add the current sample of one task to its open tier 0 bucket.
+ *
+ * @param rollup Rollup state of the task.
+ * @param cpu_percent CPU usage of the task in this sample.
+ * @param stack_used_bytes Stack usage of the task in this sample (0 if unregistered).
+ */
+void _rollup_feed_task(TaskRollup *rollup, float cpu_percent, uint32_t stack_used_bytes);
+
+/**
+ * @brief Add the current system-wide sample to the open tier 0 buckets.
+ *
+ * @param percent Values of the percentage series (indexed by sysmon_rollup_percent_t).
+ * @param bytes Values of the byte count series (indexed by sysmon_rollup_bytes_t).
+ */
+void _rollup_feed_system(const float percent[SYSMON_ROLLUP_PERCENT_SERIES],
+                         const uint32_t bytes[SYSMON_ROLLUP_BYTES_SERIES]);
+
+/**
+ * @brief Close the buckets that end with the current sample and cascade them into the next tier.
+ *
+ * Call once per sample, after all tasks and the system series have been fed.
+ */
+void _rollup_end_sample(void);
+
+/**
+ * @brief Number of samples summarized by one bucket of a tier.
+ *
+ * @param tier Tier index (0 .. SYSMON_ROLLUP_TIERS - 1).
+ * @return Samples per bucket.
+ */
+uint32_t _rollup_samples_per_bucket(int tier);
+
+/**
+ * @brief Find the tier whose buckets span a given duration.
+ *
+ * @param bucket_ms Bucket duration in milliseconds.
+ * @return Tier index, or -1 if no tier matches.
+ */
+int _rollup_tier_for_bucket_ms(uint32_t bucket_ms);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,271 @@
+/**
+ * @file sysmon_snapshot.h
+ * @brief Lock-free publication of sampler state to HTTP readers.
+ *
+ * The sampler task is the only writer of SysMonState. Each sample is wrapped
+ * in a sequence lock (self.sample_seq is odd while a sample is being written),
+ * and readers copy what they need and retry if the sequence changed. Readers
+ * never block the sampler. The number of published samples (sample_seq / 2)
+ * doubles as the sample sequence number exposed to clients.
+ *
+ * The task array itself is pinned by readers through a view: while a view of
+ * it is held, a task array replaced by the sampler is retired instead of freed
+ * and released by the last of its readers, so a handler can never touch freed
+ * memory. Readers are counted per array, so views taken after the replacement
+ * do not keep the retired array alive.
+ * The per-task history columns live in the history arena, whose pages never
+ * move while sysmon runs, so old and new arrays point at the same columns.
+ * Since a retired array's metadata is frozen while those columns keep moving,
+ * the slot readers always copy the slot of the current array.
+ */
+
+#pragma once
+
+// Project-specific includes
+#include "sysmon.h"
+
+// System includes
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Reader view of the task array, valid between acquire and release.
+ *
+ * Members:
+ * - tasks         : Task array pinned for the lifetime of the view.
+ * - task_capacity : Number of slots in tasks.
+ * - depth         : History depth (elements per history column).
+ */
+typedef struct
+{
+    const TaskUsageSample *tasks;
+    int task_capacity;
+    int depth;
+} sysmon_view_t;
+
+/**
+ * @brief History columns of a task slot, for _snapshot_read_task_window().
+ */
+typedef enum
+{
+    SNAPSHOT_COLUMN_CPU = 0,    ///< usage_percent_history (sysmon_cpu_sample_t)
+    SNAPSHOT_COLUMN_STACK,      ///< stack_usage_bytes_history (sysmon_stack_sample_t)
+    SNAPSHOT_COLUMN_HEAP        ///< heap_live_history (uint32_t)
+} sysmon_snapshot_column_t;
+
+/**
+ * @brief Parts of a task slot copied by _snapshot_read_task() besides the metadata.
+ */
+#define SNAPSHOT_COPY_HISTORY (1U << 0)  ///< Per-sample history columns
+#define SNAPSHOT_COPY_ROLLUP  (1U << 1)  ///< Rollup tiers
+
+/**
+ * @brief Copy of the most recent system-wide sample (one ring buffer slot).
+ */
+typedef struct
+{
+    float cpu_overall_percent;
+    float cpu_core_percent[SYSMON_CORE_COUNT];
+    float isr_core_percent[SYSMON_CORE_COUNT];
+    uint32_t dram_free;
+    uint32_t dram_min_free;
+    uint32_t dram_largest_block;
+    uint32_t dram_total;
+    float dram_used_percent;
+    float dram_frag_percent;
+    uint32_t psram_free;
+    uint32_t psram_total;
+    float psram_used_percent;
+    bool psram_seen;
+    int64_t timestamp_us;
+    int32_t jitter_us;
+    int32_t jitter_max_us;
+    uint32_t overruns;
+    uint32_t skipped;
+    uint32_t stack_scan_age;
+    uint32_t core_switches[SYSMON_CORE_COUNT];
+    uint32_t sched_interval_us;
+    uint32_t sequence;
+} SysMonSeriesSample;
+
+/**
+ * @brief Mark the start of a sample update (sampler task only).
+ */
+void _snapshot_write_begin(void);
+
+/**
+ * @brief Publish the sample written since _snapshot_write_begin() (sampler task only).
+ */
+void _snapshot_write_end(void);
+
+/**
+ * @brief Get the sequence number the sample being written will be published under (sampler task only).
+ *
+ * @return Sequence number of the current sample (valid between write begin and end).
+ */
+uint32_t _snapshot_write_sequence(void);
+
+/**
+ * @brief Replace the task array with a larger one (sampler task only).
+ *
+ * The old array is freed immediately if no reader holds a view of it, otherwise
+ * it is retired and freed by the last of its readers to release its view.
+ *
+ * @param new_tasks New task array (ownership is transferred).
+ * @param new_capacity Number of slots in new_tasks.
+ * @return true if the array was replaced, false if a previously retired array
+ *         is still pinned by a reader (caller keeps ownership of new_tasks).
+ */
+bool _snapshot_replace_tasks(TaskUsageSample *new_tasks, int new_capacity);
+
+/**
+ * @brief Free the task array and any retired array (called during sysmon_deinit).
+ */
+void _snapshot_cleanup(void);
+
+/**
+ * @brief Pin the current task array for reading.
+ *
+ * @param view Output view; must be released with _snapshot_release_view().
+ */
+void _snapshot_acquire_view(sysmon_view_t *view);
+
+/**
+ * @brief Release a view obtained from _snapshot_acquire_view().
+ *
+ * @param view View to release (cleared on return).
+ */
+void _snapshot_release_view(sysmon_view_t *view);
+
+/**
+ * @brief Get the sequence number of the latest published sample.
+ *
+ * @return Number of samples published since boot (0 before the first sample).
+ */
+uint32_t _snapshot_read_sequence(void);
+
+/**
+ * @brief Allocate a reader-owned task copy for _snapshot_read_task().
+ *
+ * The copy owns buffers for the requested parts (in the same allocation);
+ * the pointers of parts not requested are NULL and those parts are not copied.
+ *
+ * @param parts SNAPSHOT_COPY_* flags.
+ * @return Task copy (release with free()), or NULL on allocation failure.
+ */
+TaskUsageSample *_snapshot_alloc_task(uint32_t parts);
+
+/**
+ * @brief Copy one task slot as of a single published sample.
+ *
+ * Copies the metadata, plus the history columns and rollup tiers for which
+ * out has buffers (see _snapshot_alloc_task()).
+ *
+ * @param view Pinned view.
+ * @param index Slot index (0 .. view->task_capacity - 1).
+ * @param out Output copy of the slot (from _snapshot_alloc_task()).
+ * @param sequence Output: sequence number of the newest sample in the copy (may be NULL).
+ * @return true if the slot holds an active task, false otherwise.
+ */
+bool _snapshot_read_task(const sysmon_view_t *view, int index, TaskUsageSample *out, uint32_t *sequence);
+
+/**
+ * @brief Copy only the name of one task slot, to decide whether to copy the whole slot.
+ *
+ * @param view Pinned view.
+ * @param index Slot index (0 .. view->task_capacity - 1).
+ * @param name Output: task name (at least sizeof(TaskUsageSample.task_name) bytes).
+ * @param name_ordinal Output: duplicate ordinal of the name (see _get_task_display_key()).
+ * @return true if the slot holds an active task, false otherwise.
+ */
+bool _snapshot_read_task_name(const sysmon_view_t *view, int index, char *name, uint8_t *name_ordinal);
+
+/**
+ * @brief Copy the most recent published system-wide sample.
+ *
+ * @param out Output sample.
+ */
+void _snapshot_read_series(SysMonSeriesSample *out);
+
+/**
+ * @brief Copy one system-wide ring buffer (e.g. self.dram_free) as of a single published sample.
+ *
+ * @param ring Ring buffer of self (self.history_depth elements).
+ * @param element_size Size of one element in bytes.
+ * @param out Output buffer (self.history_depth * element_size bytes).
+ * @param write_index Output: ring write index at that sample (index of the oldest element).
+ * @param sequence Output: sequence number of the newest element (may be NULL).
+ */
+void _snapshot_read_ring(const void *ring, size_t element_size, void *out, int *write_index, uint32_t *sequence);
+
+/**
+ * @brief Copy the newest samples of several system-wide ring buffers as of a single published sample.
+ *
+ * All rings are copied in the same sequence-locked read, so the copies hold the
+ * same samples.
+ *
+ * @param rings Ring buffers of self (self.history_depth elements each; NULL ones are copied as zeros).
+ * @param ring_count Number of rings.
+ * @param element_size Size of one element in bytes (the same for every ring).
+ * @param count Number of newest samples to copy per ring (at most the samples published so far
+ *              and self.history_depth).
+ * @param out Output buffer (ring_count * count elements): ring after ring, oldest sample first.
+ * @param sequence Output: sequence number of the newest sample copied.
+ */
+void _snapshot_read_rings(const void *const rings[], int ring_count, size_t element_size, int count,
+                          void *out, uint32_t *sequence);
+
+/**
+ * @brief Copy samples first .. first + count - 1 of a system-wide ring buffer as of a single published sample.
+ *
+ * Lets a reader walk a ring in windows of its own size instead of copying all of
+ * it. Samples are addressed by sequence number, so windows copied at different
+ * samples still line up; a sample overwritten since is not copied.
+ *
+ * @param ring Ring buffer of self (self.history_depth elements, may be NULL).
+ * @param element_size Size of one element in bytes.
+ * @param first Sequence number of the first sample (at most the latest published one).
+ * @param count Number of samples, up to the latest published one.
+ * @param out Output buffer (count * element_size bytes), oldest sample first.
+ * @return Number of leading samples no longer held by the ring (count if ring is NULL).
+ */
+int _snapshot_read_ring_window(const void *ring, size_t element_size, uint32_t first, int count, void *out);
+
+/**
+ * @brief Copy samples first .. first + count - 1 of one task's history column as of a single published sample.
+ *
+ * Same as _snapshot_read_ring_window() for the column of a task slot. The slot is
+ * read through the current task array (slot numbers and columns survive its growth),
+ * and only while it still holds the task identified by task_id.
+ *
+ * @param view Pinned view (keeps the arrays alive).
+ * @param index Slot index (0 .. view->task_capacity - 1).
+ * @param task_id Task the slot must hold (TaskUsageSample.task_id of an earlier copy).
+ * @param column Column to copy.
+ * @param first Sequence number of the first sample (at most the latest published one).
+ * @param count Number of samples, up to the latest published one.
+ * @param out Output buffer (count elements of the column's type), oldest sample first.
+ * @return Number of leading samples no longer held (count if the slot holds another
+ *         task or has no such column).
+ */
+int _snapshot_read_task_window(const sysmon_view_t *view, int index, UBaseType_t task_id,
+                               sysmon_snapshot_column_t column, uint32_t first, int count, void *out);
+
+/**
+ * @brief Copy a block of sampler state (e.g. one rollup ring) as of a single published sample.
+ *
+ * @param source Memory inside self.
+ * @param size Number of bytes to copy.
+ * @param out Output buffer (size bytes).
+ * @param sequence Output: sequence number of the sample the copy belongs to (may be NULL).
+ */
+void _snapshot_read_block(const void *source, size_t size, void *out, uint32_t *sequence);
+
+#ifdef __cplusplus
+}
+#endif
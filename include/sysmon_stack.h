@@ -4,6 +4,7 @@
 #include "freertos/FreeRTOS.h"
 
 // System includes
+#include <stdbool.h>
 #include <stdint.h>
 
 #ifdef __cplusplus
@@ -31,6 +32,27 @@ void sysmon_stack_register(TaskHandle_t task_handle, uint32_t stack_size_bytes);
  */
 bool sysmon_stack_get_size(TaskHandle_t task_handle, uint32_t *stack_size_bytes);
 
+/**
+ * @brief Get the number of stack registrations so far (sampler task only).
+ *
+ * A change tells the sampler to refresh the stack sizes cached in its task slots.
+ *
+ * @return Registration count (wraps).
+ */
+uint32_t _stack_generation(void);
+
+/**
+ * @brief Drop the registration of a task that no longer exists (sampler task only).
+ *
+ * The registration is only dropped if no task registered since generation was
+ * read: a task registering in between may be a new task at the same address.
+ *
+ * @param task_handle Handle the deleted task had.
+ * @param generation _stack_generation() read before the last scan that still saw the task.
+ * @return true if the handle has no registration left, false if it was kept.
+ */
+bool _stack_forget(TaskHandle_t task_handle, uint32_t generation);
+
 /**
  * @brief Clean up stack records (called during sysmon_deinit).
  */
@@ -0,0 +1,59 @@
+/**
+ * @file sysmon_task_stats.h
+ * @brief Lifetime per-task CPU percentiles and stack minimum.
+ *
+ * The history rings only reach back history_depth samples, so questions like
+ * "what is this task's p99 CPU usage over the whole run" or "how close did its
+ * stack ever get to overflowing" would need the client to collect /history for
+ * the whole run. Instead, the sampler keeps per task entry, at constant memory
+ * (about 124 bytes):
+ *
+ *   - a histogram of the task's per-sample CPU usage, with 0.5 % wide buckets
+ *     below 10 % and 2.5 % wide buckets above (SYSMON_TASK_STATS_BUCKETS, so
+ *     percentiles of mostly idle tasks stay meaningful);
+ *   - the highest CPU usage of a sample and the lowest stack high water mark
+ *     (stack never used, in bytes) seen.
+ *
+ * Bucket counts are 16-bit and halved together when one saturates, which keeps
+ * the shape of the distribution (as for the self-profiling histograms). A
+ * percentile is the upper bound of the bucket holding it, capped at the maximum,
+ * so it never understates the usage.
+ *
+ * The statistics belong to the task entry: they start when a task is first
+ * discovered and continue when a task with the same key is re-created. /tasks
+ * reports them as cpuP50, cpuP95, cpuP99, cpuMax, stackMinFree and statSamples.
+ */
+
+#pragma once
+
+// Project-specific includes
+#include "sysmon.h"
+
+// System includes
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Add the current sample of one task (sampler task only).
+ *
+ * @param stats Statistics of the task entry.
+ * @param cpu_percent CPU usage of the task in this sample.
+ * @param stack_free_bytes Stack high water mark of the task in bytes.
+ */
+void _task_stats_feed(TaskStats *stats, float cpu_percent, uint32_t stack_free_bytes);
+
+/**
+ * @brief Estimate a CPU usage percentile from a task's histogram.
+ *
+ * @param stats Statistics of the task entry.
+ * @param per_mille Percentile in thousandths (e.g. 990 for p99).
+ * @return Upper bound of the bucket holding the percentile, capped at cpu_max (0 without samples).
+ */
+float _task_stats_cpu_percentile(const TaskStats *stats, uint32_t per_mille);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,153 @@
+/**
+ * @file sysmon_trace.h
+ * @brief Per-core task run time and core migrations from FreeRTOS trace hooks.
+ *
+ * FreeRTOS only reports one cumulative run time counter per task, so a task
+ * without core affinity cannot be attributed to the core that carried it.
+ * With CONFIG_SYSMON_TRACE_HOOKS, the scheduler's switch-in/switch-out trace
+ * macros (see sysmon_trace_hooks.h) time every slice in the run time counter
+ * units (portGET_RUN_TIME_COUNTER_VALUE()) and add it to the task's counter
+ * for that core; a switch-in on another core than the previous one counts
+ * as a migration.
+ *
+ * The hooks keep a fixed table sized for CONFIG_SYSMON_TRACE_MAX_TASKS tasks,
+ * keyed by TCB, entries claimed with atomic compare-and-swap and released when the
+ * task is deleted, so they never allocate or lock. The sampler reads the
+ * counters of each task once per sample and turns them into per-core deltas.
+ * A slice is accounted when it ends, so a task's current slice shows up in
+ * the next sample.
+ *
+ * With CONFIG_SYSMON_TRACE_SCHED_STATS, the hooks also count context switches
+ * (switch-ins) per core and per task, and time each task's ready-to-run
+ * latency: from the moment a new, blocked or suspended task is moved to the
+ * ready list (from any core or ISR) to its next switch-in, in microseconds of
+ * esp_timer_get_time() so both ends use the same clock on every core. A task
+ * that is preempted stays ready without being moved, so the wait after a
+ * preemption is not measured. Latencies go into a per-task histogram of
+ * SYSMON_TRACE_LATENCY_BUCKETS buckets, each 4 times wider than the previous
+ * (below 8, 32, 128, 512 us, 2, 8, 32 ms and above), plus a running sum and
+ * maximum. Per-core counters are only written by their own core and per-task
+ * counters by the core the task is switched in on, so they need no lock; the
+ * ready timestamp, set from any core, is swapped atomically.
+ *
+ * The create and delete hooks count a task generation, so light sampling and
+ * burst capture can tell whether task handles kept from an earlier read are
+ * still valid (see _trace_task_generation()).
+ *
+ * Without CONFIG_SYSMON_TRACE_HOOKS, the read functions report no data.
+ */
+
+#pragma once
+
+// Project-specific includes
+#include "sysmon.h"
+
+// ESP-IDF includes
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+
+// System includes
+#include <stdbool.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Scheduling counters of one task (CONFIG_SYSMON_TRACE_SCHED_STATS).
+ *
+ * Members:
+ * - switches       : Switch-ins, cumulative (wraps).
+ * - ready_total_us : Sum of the measured ready-to-run latencies in microseconds (wraps).
+ * - ready_max_us   : Longest ready-to-run latency since the previous read (reset by the read).
+ * - ready_buckets  : Measured ready-to-run latencies per histogram bucket, cumulative.
+ */
+typedef struct
+{
+    uint32_t switches;
+    uint32_t ready_total_us;
+    uint32_t ready_max_us;
+    uint32_t ready_buckets[SYSMON_TRACE_LATENCY_BUCKETS];
+} sysmon_trace_sched_t;
+
+/**
+ * @brief Read a task's cumulative per-core run time and migration count (sampler task only).
+ *
+ * @param handle Task handle.
+ * @param run_time Output: run time per core, in run time counter units (wraps).
+ * @param migrations Output: number of switch-ins on a different core than the previous one.
+ * @return true if the task is tracked, false if tracing is disabled or the table is full.
+ */
+bool _trace_read_task(TaskHandle_t handle, uint32_t run_time[SYSMON_CORE_COUNT], uint32_t *migrations);
+
+/**
+ * @brief Number of switch-ins of tasks that found the trace table full.
+ *
+ * @return Untracked switch-in count since boot (0 if tracing is disabled).
+ */
+uint32_t _trace_untracked_switches(void);
+
+/**
+ * @brief Read the task generation counter.
+ *
+ * A task handle kept since an earlier read is still valid if the generation has
+ * not changed since (any task creation or deletion changes it). Read the run time
+ * of such handles with _trace_task_run_time(), which checks the generation before
+ * each handle is used.
+ *
+ * @param generation Output: number of task creations and deletions since boot (wraps).
+ * @return true on success, false if tracing is disabled.
+ */
+bool _trace_task_generation(uint32_t *generation);
+
+/**
+ * @brief Read the run time counter of a kept task handle if it is still valid.
+ *
+ * The generation is checked before the handle is used and again after the read,
+ * like a sequence lock: the delete hook counts it before the kernel frees the TCB,
+ * so a task deleted on another core in between (possibly read after its TCB was
+ * freed) changes it and the value is discarded. Suspending the scheduler around
+ * a batch of reads keeps the window short, but only on the calling core.
+ *
+ * @param handle Task handle kept since generation was read.
+ * @param generation Task generation read when the handle was obtained.
+ * @param run_time Output: run time counter of the task.
+ * @return true if read, false if the generation changed (handle possibly stale)
+ *         or tracing is disabled.
+ */
+bool _trace_task_run_time(TaskHandle_t handle, uint32_t generation, uint32_t *run_time);
+
+/**
+ * @brief Read and reset a task's scheduling counters (sampler task only).
+ *
+ * @param handle Task handle.
+ * @param sched Output: counters of the task; ready_max_us starts over after the read.
+ * @return true if the task is tracked, false if the scheduling statistics are disabled
+ *         or the task is not in the trace table.
+ */
+bool _trace_read_sched(TaskHandle_t handle, sysmon_trace_sched_t *sched);
+
+/**
+ * @brief Read the per-core context switch counters.
+ *
+ * @param switches Output: switch-ins per core since boot (wraps).
+ * @return true on success, false if the scheduling statistics are disabled.
+ */
+bool _trace_read_core_switches(uint32_t switches[SYSMON_CORE_COUNT]);
+
+/**
+ * @brief Estimate a ready-to-run latency percentile from a histogram.
+ *
+ * @param buckets Latency histogram (see sysmon_trace_sched_t).
+ * @param max_us Longest latency the histogram holds (bounds the last bucket).
+ * @param per_mille Percentile in thousandths (e.g. 990 for p99).
+ * @return Upper bound of the bucket holding the percentile in microseconds, capped at max_us
+ *         (0 without latencies).
+ */
+uint32_t _trace_latency_percentile_us(const uint32_t buckets[SYSMON_TRACE_LATENCY_BUCKETS], uint32_t max_us,
+                                      uint32_t per_mille);
+
+#ifdef __cplusplus
+}
+#endif
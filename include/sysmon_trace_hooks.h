@@ -0,0 +1,90 @@
+/**
+ * @file sysmon_trace_hooks.h
+ * @brief FreeRTOS trace macro definitions for per-core task accounting.
+ *
+ * With CONFIG_SYSMON_TRACE_HOOKS, the component CMakeLists force-includes this
+ * header into the FreeRTOS sources (-include), so the kernel picks these
+ * definitions up in place of its empty trace macros. The macros only expand
+ * inside the kernel (tasks.c), where the current TCB array is in scope; the
+ * same array is used by the SystemView port.
+ *
+ * The create and delete macros bump a task generation counter, so code holding
+ * task handles across samples can tell whether any task came or went.
+ *
+ * With CONFIG_SYSMON_TRACE_SCHED_STATS, the move-to-ready macro is defined too,
+ * so the hooks can time how long a task waits between being made ready and
+ * running. The re-added-to-ready macro (a ready task whose priority changed)
+ * is defined empty, so a priority change does not restart that wait.
+ *
+ * Keep this header free of anything but declarations: it is seen by every
+ * FreeRTOS source, including the assembly ones.
+ */
+
+#pragma once
+
+#ifndef __ASSEMBLER__
+
+#include "esp_idf_version.h"
+#include "sdkconfig.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Trace hook: a task was switched in on the calling core (scheduler context).
+ *
+ * @param tcb TCB (task handle) of the task switched in.
+ */
+void sysmon_trace_task_switched_in(void *tcb);
+
+/**
+ * @brief Trace hook: a task is being switched out on the calling core (scheduler context).
+ *
+ * @param tcb TCB (task handle) of the task switched out.
+ */
+void sysmon_trace_task_switched_out(void *tcb);
+
+/**
+ * @brief Trace hook: a task was created.
+ *
+ * @param tcb TCB (task handle) of the new task.
+ */
+void sysmon_trace_task_created(void *tcb);
+
+/**
+ * @brief Trace hook: a task is being deleted.
+ *
+ * @param tcb TCB (task handle) of the deleted task.
+ */
+void sysmon_trace_task_deleted(void *tcb);
+
+/**
+ * @brief Trace hook: a task was moved to the ready list (scheduler or ISR context, any core).
+ *
+ * @param tcb TCB (task handle) of the task made ready.
+ */
+void sysmon_trace_task_ready(void *tcb);
+
+#ifdef __cplusplus
+}
+#endif
+
+// Current TCB of the calling core (only valid inside the kernel)
+#if ESP_IDF_VERSION >= ESP_IDF_VERSION_VAL(5, 2, 0)
+#define SYSMON_TRACE_CURRENT_TCB() ((void *)pxCurrentTCBs[xPortGetCoreID()])
+#else
+#define SYSMON_TRACE_CURRENT_TCB() ((void *)pxCurrentTCB[xPortGetCoreID()])
+#endif
+
+#define traceTASK_SWITCHED_IN()     sysmon_trace_task_switched_in(SYSMON_TRACE_CURRENT_TCB())
+#define traceTASK_SWITCHED_OUT()    sysmon_trace_task_switched_out(SYSMON_TRACE_CURRENT_TCB())
+#define traceTASK_CREATE(pxNewTCB)  sysmon_trace_task_created((void *)(pxNewTCB))
+#define traceTASK_DELETE(pxTCB)     sysmon_trace_task_deleted((void *)(pxTCB))
+
+#if CONFIG_SYSMON_TRACE_SCHED_STATS
+#define traceMOVED_TASK_TO_READY_STATE(pxTCB)   sysmon_trace_task_ready((void *)(pxTCB))
+#define traceREADDED_TASK_TO_READY_STATE(pxTCB)
+#endif
+
+#endif  // __ASSEMBLER__
@@ -3,8 +3,8 @@
  * @brief Utility functions for sysmon HTTP module.
  *
  * This header declares utility functions used across the sysmon HTTP
- * subsystem for content type detection, task name formatting, and JSON
- * cleanup operations.
+ * subsystem for content type detection, task name formatting, query
+ * parameter parsing, and JSON cleanup operations.
  */
 
 #pragma once
@@ -12,9 +12,11 @@
 // ESP-IDF includes
 #include "cJSON.h"
 #include "esp_err.h"
+#include "esp_http_server.h"
 
 // System includes
 #include <stdarg.h>
+#include <stdbool.h>
 #include <stddef.h>
 #include <stdint.h>
 
@@ -30,6 +32,17 @@ extern "C" {
  */
 const char *_get_task_display_name(const char *task_name);
 
+/**
+ * @brief Get the JSON key for a task, telling apart tasks that share a name.
+ *
+ * @param task_name Original task name.
+ * @param name_ordinal 0 for the first task with this name, 1.. for duplicates.
+ * @param buffer Scratch buffer for the suffixed key.
+ * @param buffer_size Size of the buffer.
+ * @return Display name, or "name#N" (N = name_ordinal + 1) for duplicates.
+ */
+const char *_get_task_display_key(const char *task_name, uint8_t name_ordinal, char *buffer, size_t buffer_size);
+
 /**
  * @brief Determine content type from URI path.
  *
@@ -38,6 +51,48 @@ const char *_get_task_display_name(const char *task_name);
  */
 const char *_get_content_type_from_uri(const char *uri);
 
+/**
+ * @brief Get the value of a URL query parameter.
+ *
+ * @param request HTTP request (may be NULL, e.g. when only sizing a response).
+ * @param key Query parameter name.
+ * @param value Buffer for the NUL-terminated value.
+ * @param value_size Size of the value buffer.
+ * @return true if the parameter is present and fits in the buffer.
+ */
+bool _get_query_param(httpd_req_t *request, const char *key, char *value, size_t value_size);
+
+/**
+ * @brief Get the URL-decoded value of a query parameter of any length.
+ *
+ * @param request HTTP request (may be NULL).
+ * @param key Query parameter name.
+ * @return Decoded value (release with free()), or NULL if the parameter is absent
+ *         or memory is short. "+" and %XX escapes are decoded.
+ */
+char *_get_query_param_dup(httpd_req_t *request, const char *key);
+
+/**
+ * @brief Get an unsigned decimal URL query parameter.
+ *
+ * @param request HTTP request (may be NULL).
+ * @param key Query parameter name.
+ * @param value Output value (left unchanged if the parameter is absent or invalid).
+ * @return true if the parameter is present and a valid 32-bit unsigned number.
+ */
+bool _get_query_uint(httpd_req_t *request, const char *key, uint32_t *value);
+
+/**
+ * @brief Get a duration URL query parameter in milliseconds.
+ *
+ * @param request HTTP request (may be NULL).
+ * @param key Query parameter name.
+ * @param value_ms Output duration (left unchanged if the parameter is absent or invalid).
+ * @return true if the parameter is present and a valid duration
+ *         (decimal number with optional unit "ms", "s" (default), "m" or "h").
+ */
+bool _get_query_duration_ms(httpd_req_t *request, const char *key, uint32_t *value_ms);
+
 /**
  * @brief Clean up multiple cJSON objects.
  *
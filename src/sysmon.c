@@ -27,12 +27,30 @@
 
 // Project-specific includes
 #include "sysmon.h"
+#include "sysmon_alert.h"
+#include "sysmon_history.h"
 #include "sysmon_http.h"
+#include "sysmon_index.h"
+#include "sysmon_isr.h"
+#include "sysmon_json.h"
+#include "sysmon_snapshot.h"
+#include "sysmon_profile.h"
+#include "sysmon_persist.h"
+#include "sysmon_push.h"
+#include "sysmon_export.h"
+#include "sysmon_heap.h"
+#include "sysmon_alloc.h"
+#include "sysmon_bench.h"
+#include "sysmon_burst.h"
+#include "sysmon_rollup.h"
 #include "sysmon_stack.h"
+#include "sysmon_task_stats.h"
+#include "sysmon_trace.h"
 #include "sysmon_utils.h"
 
 // ESP-IDF includes
 #include "esp_log.h"
+#include "esp_timer.h"
 #include "freertos/FreeRTOS.h"
 #include "freertos/task.h"
 #include "esp_heap_caps.h"
@@ -49,41 +67,124 @@ static const char *LOG_TAG = "sysmon";
 // Stores current task info, stats buffers, task handle, and ringbuffer pointers.
 SysMonState self = { 0 };
 
+// How long sysmon_deinit() waits for the sampler to finish its sample before warning
+#define SYSMON_MONITOR_STOP_TIMEOUT_MS 2000
+#define SYSMON_MONITOR_STOP_POLL_MS    10
+
+// Set by sysmon_deinit(); the sampler exits at the top of its loop, outside any snapshot write
+static volatile bool s_monitor_stop = false;
+
+/**
+ * @brief Grown task storage waiting to be handed off (sampler task only).
+ *
+ * Members:
+ * - tasks          : New task array (NULL if no growth is pending).
+ * - status         : New task status array.
+ * - entries        : New handle index entries (NULL if the index does not need to grow).
+ * - capacity       : Number of slots in tasks and status.
+ * - index_capacity : Number of entries in entries.
+ * - deferred       : The hand-off was refused at least once (logged once per growth).
+ */
+typedef struct
+{
+    TaskUsageSample *tasks;
+    TaskStatus_t *status;
+    sysmon_index_entry_t *entries;
+    int capacity;
+    uint32_t index_capacity;
+    bool deferred;
+} TaskGrowth;
+
+static TaskGrowth s_pending_growth = { 0 };
+
+// Stack registrations (see _stack_generation()) counted before the latest task scan, before the
+// previous one, and before the scan in progress (sampler task only)
+static uint32_t s_stack_generation_scan    = 0;
+static uint32_t s_stack_generation_prev    = 0;
+static uint32_t s_stack_generation_pending = 0;
+
+/**
+ * @brief Fixed-rate sampler schedule (sampler task only).
+ *
+ * Members:
+ * - interval_us : Sampling period in microseconds.
+ * - deadline_us : Scheduled start of the next sample (esp_timer time base).
+ */
+typedef struct
+{
+    int64_t interval_us;
+    int64_t deadline_us;
+} SamplerClock;
+
 // ============================================================================
 // Monitor Task Helper Functions
 // ============================================================================
 
+/**
+ * @brief Free the arrays of a task storage growth that was not handed off.
+ */
+static void _discard_pending_growth(void)
+{
+    free(s_pending_growth.tasks);
+    free(s_pending_growth.status);
+    free(s_pending_growth.entries);
+    memset(&s_pending_growth, 0, sizeof(s_pending_growth));
+}
+
+/**
+ * @brief Allocate the arrays of a task storage growth.
+ * 
+ * @param capacity Number of task slots to allocate.
+ * @return true on success, false on allocation failure (nothing is kept).
+ */
+static bool _alloc_pending_growth(int capacity)
+{
+    TaskGrowth *growth = &s_pending_growth;
+    growth->tasks    = (TaskUsageSample *)calloc(capacity, sizeof(TaskUsageSample));
+    growth->status   = (TaskStatus_t *)malloc(sizeof(TaskStatus_t) * capacity);
+    growth->capacity = capacity;
+    
+    // Grow the handle index alongside the slot array (slot numbers are preserved by the copy)
+    growth->index_capacity = _index_capacity_for((uint32_t)capacity);
+    bool index_ok = true;
+    if (_index_needs_grow(&self.task_index, (uint32_t)capacity))
+    {
+        growth->entries = (sysmon_index_entry_t *)calloc(growth->index_capacity, sizeof(sysmon_index_entry_t));
+        index_ok = (growth->entries != NULL);
+    }
+    
+    if (growth->tasks == NULL || growth->status == NULL || !index_ok)
+    {
+        _discard_pending_growth();
+        return false;
+    }
+    return true;
+}
+
 /**
  * @brief Ensure task storage capacity is sufficient for all active tasks.
  * 
  * Uses dynamic calculation based on actual task count with percentage-based growth buffer.
+ * The per-task history lives in the history arena, so growing only copies metadata
+ * and rebinds each slot to its (unmoved) history page. If an HTTP reader still pins
+ * the previously retired array, the grown task array is kept and its hand-off is
+ * retried on the next sample; the sampler-private status array grows at once, so the
+ * task scan fits and the sample goes on with the current task array.
  * 
- * @return true if capacity is adequate, false on allocation failure.
+ * @param actual_task_count Number of tasks the next sample must hold.
+ * @return true if the sample can run, false on allocation failure.
  */
-static bool _ensure_task_storage_capacity(void)
+static bool _ensure_task_storage_capacity(int actual_task_count)
 {
-    // If we have existing capacity, try to get actual task count
-    int actual_task_count = 0;
     bool buffer_was_full = false;
     if (self.task_capacity > 0 && self.task_status != NULL)
     {
-        uint32_t total_run_time = 0;
-        UBaseType_t num = uxTaskGetSystemState(self.task_status, self.task_capacity, &total_run_time);
-        actual_task_count = (int)num;
-        
-        // If we got fewer tasks than capacity, we have enough space
+        // Fewer tasks than capacity leaves room for a task created before the sample
         if (actual_task_count < self.task_capacity)
         {
             return true;
         }
-        
-        // If we got exactly capacity, buffer was full - might have more tasks
-        buffer_was_full = (actual_task_count == self.task_capacity);
-    }
-    else
-    {
-        // No existing buffer, use uxTaskGetNumberOfTasks() as initial estimate
-        actual_task_count = (int)uxTaskGetNumberOfTasks();
+        buffer_was_full = true;
     }
     
     // Calculate required capacity with dynamic growth buffer
@@ -108,44 +209,117 @@ static bool _ensure_task_storage_capacity(void)
         return true;
     }
     
-    TaskUsageSample *new_tasks = (TaskUsageSample *)calloc(required_capacity, sizeof(TaskUsageSample));
-    if (new_tasks == NULL)
+    if (!_history_reserve_slots(required_capacity))
     {
         return false;
     }
     
-    TaskStatus_t *new_status = (TaskStatus_t *)malloc(sizeof(TaskStatus_t) * required_capacity);
-    if (new_status == NULL)
+    // A growth still waiting for its hand-off is reused unless more tasks arrived since
+    TaskGrowth *growth = &s_pending_growth;
+    if (growth->tasks != NULL && growth->capacity < required_capacity)
+    {
+        _discard_pending_growth();
+    }
+    if (growth->tasks == NULL && !_alloc_pending_growth(required_capacity))
     {
-        free(new_tasks);
         return false;
     }
     
-    // Copy existing active tasks
+    // Copy existing active tasks (again on a retry, since the sampler kept writing the old array)
+    memset(growth->tasks, 0, sizeof(TaskUsageSample) * (size_t)growth->capacity);
     if (self.tasks != NULL)
     {
         for (int j = 0; j < self.task_capacity; j++)
         {
             if (self.tasks[j].is_active)
             {
-                new_tasks[j] = self.tasks[j];
+                growth->tasks[j] = self.tasks[j];
             }
         }
     }
+    for (int j = 0; j < growth->capacity; j++)
+    {
+        _history_bind_slot(&growth->tasks[j], j);
+    }
     
-    // Ownership hand-off
-    free(self.tasks);
-    free(self.task_status);
-    self.tasks         = new_tasks;
-    self.task_status   = new_status;
-    self.task_capacity = required_capacity;
+    // The status array is private to the sampler, so the scan can use the larger one at once
+    if (growth->status != NULL)
+    {
+        free(self.task_status);
+        self.task_status          = growth->status;
+        self.task_status_capacity = growth->capacity;
+        growth->status            = NULL;
+    }
+    
+    // Ownership hand-off (HTTP readers may still hold a view of the old array)
+    if (!_snapshot_replace_tasks(growth->tasks, growth->capacity))
+    {
+        // Keep sampling into the current array (tasks that do not fit wait for a free slot)
+        if (!growth->deferred)
+        {
+            ESP_LOGW(LOG_TAG, "Task storage growth deferred: previous array still in use by a reader");
+            growth->deferred = true;
+        }
+        return true;
+    }
+    if (growth->entries != NULL)
+    {
+        free(_index_rehash(&self.task_index, growth->entries, growth->index_capacity));
+    }
+    memset(growth, 0, sizeof(*growth));
     
     return true;
 }
 
+/**
+ * @brief Free the task arrays, the handle index and the history arena.
+ * 
+ * Only called while the sampler task is not running.
+ */
+static void _release_task_storage(void)
+{
+    _discard_pending_growth();
+    _snapshot_cleanup();
+    _history_cleanup();
+    free(self.task_status);
+    free(_index_release(&self.task_index));
+    self.task_status          = NULL;
+    self.task_status_capacity = 0;
+    s_stack_generation_scan    = 0;
+    s_stack_generation_prev    = 0;
+    s_stack_generation_pending = 0;
+    self.prev_total_run_time  = 0;
+}
+
+/**
+ * @brief Advance the total runtime counter and return its delta since the previous sample.
+ * 
+ * @param total_run_time Total runtime counter of this sample.
+ * @return Delta for total runtime, handling wrap-around.
+ */
+static uint32_t _advance_total_run_time(uint32_t total_run_time)
+{
+    uint32_t delta_total;
+    if (total_run_time >= self.prev_total_run_time)
+    {
+        delta_total = total_run_time - self.prev_total_run_time;
+    }
+    else
+    {
+        // Wrap-around case
+        delta_total = (UINT32_MAX - self.prev_total_run_time) + total_run_time + 1;
+    }
+    
+    self.prev_total_run_time = total_run_time;
+    return delta_total;
+}
+
 /**
  * @brief Sample current task states and calculate total runtime delta.
  * 
+ * This is a full sample: uxTaskGetSystemState() also scans every task's stack for its
+ * high-water mark, with the scheduler suspended.
+ * 
  * @param num_returned Output: number of tasks returned by uxTaskGetSystemState.
  * @param delta_total Output: calculated delta for total runtime.
  * @return true on success, false if sampling failed.
@@ -153,7 +327,10 @@ static bool _ensure_task_storage_capacity(void)
 static bool _sample_task_states(UBaseType_t *num_returned, uint32_t *delta_total)
 {
     uint32_t total_run_time = 0;
-    UBaseType_t num = uxTaskGetSystemState(self.task_status, self.task_capacity, &total_run_time);
+    // Read before the scan, so a task created or deleted during it forces another full sample
+    uint32_t generation = 0;
+    _trace_task_generation(&generation);
+    UBaseType_t num = uxTaskGetSystemState(self.task_status, self.task_status_capacity, &total_run_time);
     
     if (num == 0)
     {
@@ -161,56 +338,375 @@ static bool _sample_task_states(UBaseType_t *num_returned, uint32_t *delta_total
     }
     
     *num_returned = num;
+    *delta_total = _advance_total_run_time(total_run_time);
+    self.scanned_generation = generation;
     
-    // Calculate delta_total, handling wrap-around
-    if (total_run_time >= self.prev_total_run_time)
+    return true;
+}
+
+#if CONFIG_SYSMON_LIGHT_SAMPLING
+/**
+ * @brief Sample only the runtime counters of the tasks seen by the latest full sample.
+ * 
+ * Fills the task status array from the tracked entries, with fresh counters from
+ * ulTaskGetRunTimeCounter() and the stack high-water marks of the last full sample,
+ * so the rest of the sample runs unchanged. No stack is scanned; the scheduler is
+ * only suspended for the counter reads.
+ * 
+ * The kept handles are only valid while no task was created or deleted since the last
+ * full sample, which the task generation of the trace hooks tells. It is checked
+ * around each counter read (see _trace_task_run_time()), so a value possibly read
+ * from the freed TCB of a task deleted on the other core is never used; if it
+ * changed, the caller takes a full sample instead.
+ * 
+ * @param num_returned Output: number of task status entries filled.
+ * @param delta_total Output: calculated delta for total runtime.
+ * @return true on success, false if a full sample is needed.
+ */
+static bool _sample_task_runtimes(UBaseType_t *num_returned, uint32_t *delta_total)
+{
+    uint32_t generation = 0;
+    if (!_trace_task_generation(&generation) || generation != self.scanned_generation)
     {
-        *delta_total = total_run_time - self.prev_total_run_time;
+        return false;
     }
-    else
+    
+    UBaseType_t num = 0;
+    bool valid = true;
+    vTaskSuspendAll();
+    for (int j = 0; j < self.task_capacity; j++)
     {
-        // Wrap-around case
-        *delta_total = (UINT32_MAX - self.prev_total_run_time) + total_run_time + 1;
+        const TaskUsageSample *task = &self.tasks[j];
+        
+        // Only tasks present in the previous sample still have a valid handle
+        if (!task->is_active || task->handle == NULL || task->consecutive_zero_samples > 0)
+        {
+            continue;
+        }
+        
+        uint32_t run_time = 0;
+        if (!_trace_task_run_time(task->handle, generation, &run_time) || run_time < task->prev_run_time_ticks)
+        {
+            valid = false;
+            break;
+        }
+        
+        TaskStatus_t *status = &self.task_status[num++];
+        memset(status, 0, sizeof(*status));
+        status->xHandle              = task->handle;
+        status->pcTaskName           = task->task_name;
+        status->xTaskNumber          = task->task_id;
+        status->uxCurrentPriority    = task->current_priority;
+        status->uxBasePriority       = task->base_priority;
+        status->ulRunTimeCounter     = run_time;
+        status->usStackHighWaterMark = task->stack_high_water_mark;
     }
+    xTaskResumeAll();
     
-    self.prev_total_run_time = total_run_time;
+    if (!valid || num == 0)
+    {
+        return false;
+    }
+    
+    *num_returned = num;
+    *delta_total = _advance_total_run_time((uint32_t)portGET_RUN_TIME_COUNTER_VALUE());
     
     return true;
 }
+#endif
 
 /**
- * @brief Find or create task entry index for a given task name.
+ * @brief Decide whether this sample must scan task stacks (full sample).
  * 
- * @param task_name Task name to find.
+ * @return true for a full sample: always without CONFIG_SYSMON_LIGHT_SAMPLING, otherwise
+ *         every CONFIG_SYSMON_STACK_SCAN_INTERVAL samples (a created or deleted task also
+ *         forces one, see _sample_task_runtimes()).
+ */
+static bool _stack_scan_due(void)
+{
+#if CONFIG_SYSMON_LIGHT_SAMPLING
+    return self.stack_scan_age + 1U >= CONFIG_SYSMON_STACK_SCAN_INTERVAL;
+#else
+    return true;
+#endif
+}
+
+/**
+ * @brief Sum the counts of a ready-to-run latency histogram.
+ * 
+ * @param buckets Latency histogram.
+ * @return Number of latencies it holds (wraps).
+ */
+static uint32_t _ready_count(const uint32_t buckets[SYSMON_TRACE_LATENCY_BUCKETS])
+{
+    uint32_t count = 0U;
+    for (int i = 0; i < SYSMON_TRACE_LATENCY_BUCKETS; i++)
+    {
+        count += buckets[i];
+    }
+    return count;
+}
+
+/**
+ * @brief Start the scheduling deltas of a task entry from the trace hooks' current counters.
+ * 
+ * @param idx Task index (handle already bound).
+ */
+static void _reset_task_sched(int idx)
+{
+    TaskUsageSample *task = &self.tasks[idx];
+    task->sched_valid         = false;
+    task->prev_sched_switches = 0U;
+    task->prev_ready_total_us = 0U;
+    task->prev_ready_count    = 0U;
+
+    // The trace entry may predate this binding
+    sysmon_trace_sched_t sched;
+    if (_trace_read_sched(task->handle, &sched))
+    {
+        task->prev_sched_switches = sched.switches;
+        task->prev_ready_total_us = sched.ready_total_us;
+        task->prev_ready_count    = _ready_count(sched.ready_buckets);
+    }
+}
+
+/**
+ * @brief Bind a task handle to a task entry in the handle index.
+ * 
+ * @param idx Task index.
+ * @param task_status Task status from uxTaskGetSystemState.
+ */
+static void _bind_task_handle(int idx, const TaskStatus_t *task_status)
+{
+    self.tasks[idx].handle  = task_status->xHandle;
+    self.tasks[idx].task_id = task_status->xTaskNumber;
+    
+    // Per-core deltas count from here (the trace entry may predate this binding)
+    self.tasks[idx].core_trace_valid = false;
+    memset(self.tasks[idx].prev_core_run_time, 0, sizeof(self.tasks[idx].prev_core_run_time));
+    _trace_read_task(task_status->xHandle, self.tasks[idx].prev_core_run_time, &self.tasks[idx].migrations);
+    _reset_task_sched(idx);
+    self.tasks[idx].heap_valid = false;
+    sysmon_stack_get_size(task_status->xHandle, &self.tasks[idx].stack_size_bytes);
+    self.task_binds++;
+    if (!_index_insert(&self.task_index, task_status->xHandle, (uint32_t)idx))
+    {
+        ESP_LOGW(LOG_TAG, "Task index full, cannot index task '%s'", self.tasks[idx].task_name);
+    }
+}
+
+/**
+ * @brief Remove a task entry's handle from the handle index and drop its stack registration.
+ * 
+ * @param idx Task index.
+ */
+static void _unbind_task_handle(int idx)
+{
+    // The task behind the handle is gone; keep the registry from growing with task churn
+    _stack_forget(self.tasks[idx].handle, s_stack_generation_prev);
+    
+    uint32_t bound_idx = 0;
+    if (_index_find(&self.task_index, self.tasks[idx].handle, &bound_idx) && bound_idx == (uint32_t)idx)
+    {
+        _index_remove(&self.task_index, self.tasks[idx].handle);
+    }
+    self.tasks[idx].handle = NULL;
+}
+
+/**
+ * @brief Find or create task entry index for a sampled task.
+ * 
+ * Tasks are identified by handle through the hash index, so each lookup is O(1)
+ * and tasks sharing a name get separate entries. The name is only used as a
+ * fallback to re-attach a task that was deleted and re-created to its history.
+ * 
+ * @param task_status Task status from uxTaskGetSystemState.
  * @return Task index on success, -1 if no slot available.
  */
-static int _find_or_create_task_index(const char *task_name)
+static int _find_or_create_task_index(const TaskStatus_t *task_status)
 {
-    // Try to find existing task entry
-    for (int j = 0; j < self.task_capacity; j++)
+    // Fast path: known handle (xTaskNumber guards against a recycled TCB address)
+    uint32_t bound_idx = 0;
+    if (_index_find(&self.task_index, task_status->xHandle, &bound_idx))
     {
-        if (self.tasks[j].is_active && 
-            strncmp(self.tasks[j].task_name, task_name, sizeof(self.tasks[j].task_name)) == 0)
+        if (self.tasks[bound_idx].task_id == task_status->xTaskNumber)
         {
-            return j;
+            return (int)bound_idx;
         }
+        // Handle reused by a new task; let the old entry time out on its own
+        _unbind_task_handle((int)bound_idx);
     }
     
-    // Allocate slot for new task
+    // Slow path, only taken for tasks not seen before
+    const char *task_name = task_status->pcTaskName;
+    int free_slot = -1;
+    int next_ordinal = 0;
     for (int j = 0; j < self.task_capacity; j++)
     {
         if (!self.tasks[j].is_active)
         {
-            memset(&self.tasks[j], 0, sizeof(TaskUsageSample));
-            strncpy(self.tasks[j].task_name, task_name, sizeof(self.tasks[j].task_name) - 1);
-            self.tasks[j].is_active = true;
-            self.tasks[j].consecutive_zero_samples = 0;
-            ESP_LOGI(LOG_TAG, "Discovered new task: '%s'", task_name);
+            if (free_slot < 0)
+            {
+                free_slot = j;
+            }
+            continue;
+        }
+        if (strncmp(self.tasks[j].task_name, task_name, sizeof(self.tasks[j].task_name)) != 0)
+        {
+            continue;
+        }
+        
+        // Not seen in the previous sample: the old task was deleted, reuse its entry.
+        // Otherwise the entry belongs to a live task sharing this name.
+        if (self.tasks[j].consecutive_zero_samples > 0)
+        {
+            _unbind_task_handle(j);
+            _bind_task_handle(j, task_status);
+            self.tasks[j].prev_run_time_ticks = 0U;
+            ESP_LOGI(LOG_TAG, "Task re-created, resuming history: '%s'", task_name);
             return j;
         }
+        if (self.tasks[j].name_ordinal + 1 > next_ordinal)
+        {
+            next_ordinal = self.tasks[j].name_ordinal + 1;
+        }
+    }
+    
+    // Allocate slot for new task
+    if (free_slot < 0)
+    {
+        return -1;
+    }
+    memset(&self.tasks[free_slot], 0, sizeof(TaskUsageSample));
+    _history_bind_slot(&self.tasks[free_slot], free_slot);
+    _history_clear_slot(&self.tasks[free_slot]);
+    strncpy(self.tasks[free_slot].task_name, task_name, sizeof(self.tasks[free_slot].task_name) - 1);
+    self.tasks[free_slot].name_ordinal = (uint8_t)((next_ordinal > UINT8_MAX) ? UINT8_MAX : next_ordinal);
+    self.tasks[free_slot].is_active = true;
+    self.tasks[free_slot].consecutive_zero_samples = 0;
+    _bind_task_handle(free_slot, task_status);
+    ESP_LOGI(LOG_TAG, "Discovered new task: '%s'", task_name);
+    return free_slot;
+}
+
+/**
+ * @brief Update the per-core usage and migration count of a task from the trace hooks.
+ * 
+ * @param idx Task index.
+ * @param delta_total Total runtime delta for CPU calculation.
+ */
+static void _update_task_core_usage(int idx, uint32_t delta_total)
+{
+    TaskUsageSample *task = &self.tasks[idx];
+    uint32_t run_time[SYSMON_CORE_COUNT];
+    if (!_trace_read_task(task->handle, run_time, &task->migrations))
+    {
+        task->core_trace_valid = false;
+        return;
     }
     
-    return -1;
+    for (int core = 0; core < SYSMON_CORE_COUNT; core++)
+    {
+        // A counter below the previous one means the trace entry was recycled
+        uint32_t delta = (run_time[core] >= task->prev_core_run_time[core])
+                         ? (run_time[core] - task->prev_core_run_time[core]) : run_time[core];
+        task->prev_core_run_time[core] = run_time[core];
+        task->core_usage_percent[core] = (delta_total > 0) ? ((float)delta / (float)delta_total) * 100.0f : 0.0f;
+    }
+    task->core_trace_valid = true;
+}
+
+/**
+ * @brief Fold the trace hooks' scheduling counters of a task into its entry.
+ * 
+ * @param idx Task index.
+ */
+static void _update_task_sched(int idx)
+{
+    TaskUsageSample *task = &self.tasks[idx];
+    sysmon_trace_sched_t sched;
+    if (!_trace_read_sched(task->handle, &sched))
+    {
+        task->sched_valid = false;
+        return;
+    }
+    
+    // Counters below the previous ones mean the trace entry was recycled
+    uint32_t ready_count = _ready_count(sched.ready_buckets);
+    bool recycled = (sched.switches < task->prev_sched_switches) || (ready_count < task->prev_ready_count);
+    uint32_t switches    = recycled ? sched.switches : (sched.switches - task->prev_sched_switches);
+    uint32_t ready_delta = recycled ? ready_count : (ready_count - task->prev_ready_count);
+    uint32_t ready_sum   = recycled ? sched.ready_total_us : (sched.ready_total_us - task->prev_ready_total_us);
+    task->prev_sched_switches = sched.switches;
+    task->prev_ready_count    = ready_count;
+    task->prev_ready_total_us = sched.ready_total_us;
+    
+    task->sched_switches = switches;
+    task->ready_avg_us   = (ready_delta > 0U) ? (ready_sum / ready_delta) : 0U;
+    task->ready_max_us   = sched.ready_max_us;
+    if (sched.ready_max_us > task->ready_max_lifetime_us)
+    {
+        task->ready_max_lifetime_us = sched.ready_max_us;
+    }
+    memcpy(task->ready_hist, sched.ready_buckets, sizeof(task->ready_hist));
+    task->sched_valid = true;
+}
+
+/**
+ * @brief Update the per-core context switch counts of the latest sample interval.
+ * 
+ * @param timestamp_us Timestamp of the sample.
+ */
+static void _update_core_switches(int64_t timestamp_us)
+{
+    uint32_t switches[SYSMON_CORE_COUNT];
+    if (!_trace_read_core_switches(switches))
+    {
+        return;
+    }
+    
+    for (int core = 0; core < SYSMON_CORE_COUNT; core++)
+    {
+        self.core_switches[core] = switches[core] - self.prev_core_switches[core];
+        self.prev_core_switches[core] = switches[core];
+    }
+    self.sched_interval_us = (self.sched_prev_time_us > 0)
+                             ? (uint32_t)(timestamp_us - self.sched_prev_time_us) : 0U;
+    self.sched_prev_time_us = timestamp_us;
+}
+
+/**
+ * @brief Update the heap counters and live heap history of a task from the heap hooks.
+ * 
+ * @param idx Task index (write_index not yet advanced for this sample).
+ */
+static void _update_task_heap(int idx)
+{
+    TaskUsageSample *task = &self.tasks[idx];
+    sysmon_alloc_stats_t stats = { 0 };
+    bool valid = _alloc_read_task(task->handle, &stats);
+    
+    // Rates need two readings of the same entry; a count below the previous one means a recycled entry
+    if (valid && task->heap_valid && stats.alloc_count >= task->heap_alloc_count)
+    {
+        task->heap_sample_allocs      = stats.alloc_count - task->heap_alloc_count;
+        task->heap_sample_alloc_bytes = stats.alloc_bytes - task->heap_alloc_bytes;
+    }
+    else
+    {
+        task->heap_sample_allocs      = 0U;
+        task->heap_sample_alloc_bytes = 0U;
+    }
+    task->heap_valid       = valid;
+    task->heap_alloc_count = stats.alloc_count;
+    task->heap_alloc_bytes = stats.alloc_bytes;
+    task->heap_live_bytes  = stats.live_bytes;
+    task->heap_live_blocks = stats.live_blocks;
+    
+    if (task->heap_live_history != NULL)
+    {
+        task->heap_live_history[task->write_index] = stats.live_bytes;
+    }
 }
 
 /**
@@ -233,17 +729,18 @@ static void _update_task_history(int idx, const TaskStatus_t *task_status, uint3
     // Calculate CPU usage
     float usage = (delta_total > 0) ? ((float)delta_task / (float)delta_total) * 100.0f : 0.0f;
     self.tasks[idx].consecutive_zero_samples = 0;  // Task is present, reset counter
-    self.tasks[idx].usage_percent_history[self.tasks[idx].write_index] = usage;
+    self.tasks[idx].usage_percent_history[self.tasks[idx].write_index] = _history_encode_cpu(usage);
     
     // Calculate stack usage
     self.tasks[idx].stack_high_water_mark = task_status->usStackHighWaterMark;
     uint32_t stack_hwm_bytes = task_status->usStackHighWaterMark * sizeof(StackType_t);
     
-    // Lookup registered stack size
-    uint32_t stack_size_bytes = 0U;
-    sysmon_stack_get_size(task_status->xHandle, &stack_size_bytes);
-    
-    self.tasks[idx].stack_size_bytes = stack_size_bytes;
+    // Registered stack size, cached at binding and refreshed only after new registrations
+    if (s_stack_generation_scan != s_stack_generation_prev)
+    {
+        sysmon_stack_get_size(task_status->xHandle, &self.tasks[idx].stack_size_bytes);
+    }
+    uint32_t stack_size_bytes = self.tasks[idx].stack_size_bytes;
     
     uint32_t stack_used_bytes = 0U;
     float stack_usage_percent = 0.0f;
@@ -256,17 +753,24 @@ static void _update_task_history(int idx, const TaskStatus_t *task_status, uint3
         stack_usage_percent = ((float)stack_used_bytes / (float)stack_size_bytes) * 100.0f;
     }
     
-    // Store stack usage history
-    self.tasks[idx].stack_usage_bytes_history[self.tasks[idx].write_index] = stack_used_bytes;
-    self.tasks[idx].stack_usage_percent_history[self.tasks[idx].write_index] = stack_usage_percent;
+    // Store stack usage history (percentages are derived from the bytes on read)
+    self.tasks[idx].stack_usage_bytes_history[self.tasks[idx].write_index] = _history_encode_stack(stack_used_bytes);
+    _rollup_feed_task(self.tasks[idx].rollup, usage, stack_used_bytes);
+    _task_stats_feed(&self.tasks[idx].stats, usage, stack_hwm_bytes);
+    _update_task_heap(idx);
     
     // Update task metadata
-    self.tasks[idx].write_index = (self.tasks[idx].write_index + 1) % CONFIG_SYSMON_SAMPLE_COUNT;
+    self.tasks[idx].usage_percent = usage;
+    self.tasks[idx].stack_used_bytes = stack_used_bytes;
+    self.tasks[idx].stack_used_percent = stack_usage_percent;
+    self.tasks[idx].write_index = (self.tasks[idx].write_index + 1) % self.history_depth;
     self.tasks[idx].task_id = task_status->xTaskNumber;
     self.tasks[idx].current_priority = task_status->uxCurrentPriority;
     self.tasks[idx].base_priority = task_status->uxBasePriority;
     self.tasks[idx].total_run_time_ticks = task_status->ulRunTimeCounter;
     self.tasks[idx].core_id = xTaskGetCoreID(task_status->xHandle);
+    _update_task_core_usage(idx, delta_total);
+    _update_task_sched(idx);
 }
 
 /**
@@ -282,24 +786,47 @@ static void _process_deleted_tasks(const bool *tasks_seen)
         {
             self.tasks[j].consecutive_zero_samples++;
             
+            // Blocks the task left allocated now count as held by exited tasks
+            if (self.tasks[j].consecutive_zero_samples == 1 && self.tasks[j].handle != NULL)
+            {
+                _alloc_task_exited(self.tasks[j].handle);
+            }
+            
+            // Retried every sample: a registration since the previous scan keeps the entry once
+            _stack_forget(self.tasks[j].handle, s_stack_generation_prev);
+            
             // Record zero values
-            self.tasks[j].usage_percent_history[self.tasks[j].write_index] = 0.0f;
-            self.tasks[j].stack_usage_bytes_history[self.tasks[j].write_index] = 0U;
-            self.tasks[j].stack_usage_percent_history[self.tasks[j].write_index] = 0.0f;
-            self.tasks[j].write_index = (self.tasks[j].write_index + 1) % CONFIG_SYSMON_SAMPLE_COUNT;
+            self.tasks[j].usage_percent_history[self.tasks[j].write_index] = _history_encode_cpu(0.0f);
+            self.tasks[j].stack_usage_bytes_history[self.tasks[j].write_index] = _history_encode_stack(0U);
+            if (self.tasks[j].heap_live_history != NULL)
+            {
+                self.tasks[j].heap_live_history[self.tasks[j].write_index] = 0U;
+            }
+            _rollup_feed_task(self.tasks[j].rollup, 0.0f, 0U);
+            self.tasks[j].usage_percent = 0.0f;
+            self.tasks[j].stack_used_bytes = 0U;
+            self.tasks[j].stack_used_percent = 0.0f;
+            self.tasks[j].heap_valid = false;
+            self.tasks[j].heap_live_bytes = 0U;
+            self.tasks[j].heap_live_blocks = 0U;
+            self.tasks[j].heap_sample_allocs = 0U;
+            self.tasks[j].heap_sample_alloc_bytes = 0U;
+            memset(self.tasks[j].core_usage_percent, 0, sizeof(self.tasks[j].core_usage_percent));
+            self.tasks[j].write_index = (self.tasks[j].write_index + 1) % self.history_depth;
             
-            // Mark inactive after CONFIG_SYSMON_SAMPLE_COUNT consecutive zeros
-            if (self.tasks[j].consecutive_zero_samples >= CONFIG_SYSMON_SAMPLE_COUNT)
+            // Mark inactive after a full history of consecutive zeros
+            if (self.tasks[j].consecutive_zero_samples >= self.history_depth)
             {
+                _unbind_task_handle(j);
                 self.tasks[j].is_active = false;
                 self.tasks[j].consecutive_zero_samples = 0;
                 ESP_LOGI(LOG_TAG, "Task removed after %d consecutive zero samples: '%s'", 
-                         CONFIG_SYSMON_SAMPLE_COUNT, self.tasks[j].task_name);
+                         self.history_depth, self.tasks[j].task_name);
             }
             else if (self.tasks[j].consecutive_zero_samples % 10 == 0)
             {
                 ESP_LOGI(LOG_TAG, "Task not detected; logging zero for inactivity (sample %d of %d): '%s'", 
-                         self.tasks[j].consecutive_zero_samples, CONFIG_SYSMON_SAMPLE_COUNT, 
+                         self.tasks[j].consecutive_zero_samples, self.history_depth, 
                          self.tasks[j].task_name);
             }
         }
@@ -307,59 +834,124 @@ static void _process_deleted_tasks(const bool *tasks_seen)
 }
 
 /**
- * @brief Calculate per-core CPU usage from idle task deltas.
+ * @brief Look up the idle task of every core (idle tasks live as long as the scheduler).
+ */
+static void _init_idle_task_handles(void)
+{
+    for (int core = 0; core < SYSMON_CORE_COUNT; core++)
+    {
+        self.idle_task_handles[core] = xTaskGetIdleTaskHandleForCore(core);
+        self.prev_idle_ticks[core]   = 0U;
+    }
+}
+
+/**
+ * @brief Record the run time of a sampled task if it is the idle task of a core.
  * 
- * @param num_returned Number of tasks returned by uxTaskGetSystemState.
- * @param delta_total Total runtime delta.
- * @param core_usage_0 Output: CPU usage for core 0.
- * @param core_usage_1 Output: CPU usage for core 1.
- * @param overall_usage Output: Overall CPU usage.
+ * Called for every entry of the task status array in the main per-task pass,
+ * so per-core idle time needs no separate lookup loop.
+ * 
+ * @param task_status Task status from uxTaskGetSystemState.
+ * @param idle_ticks Idle task run time per core (updated for idle tasks).
  */
-static void _calculate_cpu_metrics(UBaseType_t num_returned, uint32_t delta_total,
-                                    float *core_usage_0, float *core_usage_1, float *overall_usage)
+static void _record_idle_ticks(const TaskStatus_t *task_status, uint32_t idle_ticks[SYSMON_CORE_COUNT])
 {
-    TaskHandle_t idle_handle_0 = xTaskGetIdleTaskHandleForCore(0);
-    TaskHandle_t idle_handle_1 = xTaskGetIdleTaskHandleForCore(1);
+    for (int core = 0; core < SYSMON_CORE_COUNT; core++)
+    {
+        if (task_status->xHandle == self.idle_task_handles[core])
+        {
+            idle_ticks[core] = task_status->ulRunTimeCounter;
+            return;
+        }
+    }
+}
+
+/**
+ * @brief Update every sampled task and process the tasks that were not sampled.
+ * 
+ * Opens the snapshot write (readers retry until _snapshot_write_end() publishes the
+ * sample); the same pass picks up each core's idle time.
+ * 
+ * @param num_returned Number of entries in self.task_status.
+ * @param delta_total Total runtime delta for CPU calculation.
+ * @param idle_ticks Output: idle task run time per core.
+ * @return true on success, false on allocation failure (the snapshot write is not opened).
+ */
+static bool _update_tasks(UBaseType_t num_returned, uint32_t delta_total, uint32_t idle_ticks[SYSMON_CORE_COUNT])
+{
+    // Track which tasks were seen
+    bool *tasks_seen = (bool *)calloc(self.task_capacity, sizeof(bool));
+    if (tasks_seen == NULL)
+    {
+        return false;
+    }
+    s_stack_generation_prev = s_stack_generation_scan;
+    s_stack_generation_scan = s_stack_generation_pending;
     
-    uint32_t idle_ticks_0 = 0;
-    uint32_t idle_ticks_1 = 0;
+    // 3. Update per-task histories
+    _snapshot_write_begin();
     for (UBaseType_t i = 0; i < num_returned; i++)
     {
         TaskStatus_t *t = &self.task_status[i];
-        if (t->xHandle == idle_handle_0)
+        _record_idle_ticks(t, idle_ticks);
+        if (t->pcTaskName == NULL)
         {
-            idle_ticks_0 = t->ulRunTimeCounter;
+            continue;
         }
-        else if (t->xHandle == idle_handle_1)
+        
+        int idx = _find_or_create_task_index(t);
+        if (idx == -1)
         {
-            idle_ticks_1 = t->ulRunTimeCounter;
+            // While a growth waits for its hand-off, the deferral was already logged
+            if (s_pending_growth.tasks == NULL)
+            {
+                ESP_LOGW(LOG_TAG, "Task capacity exceeded, cannot track task '%s' (capacity: %d, num_tasks: %d). Will retry next sample.", 
+                         t->pcTaskName, self.task_capacity, uxTaskGetNumberOfTasks());
+            }
+            continue;
         }
+        
+        _update_task_history(idx, t, delta_total);
+        tasks_seen[idx] = true;
     }
     
-    // Maintain state between iterations
-    static uint32_t prev_idle_ticks_0 = 0;
-    static uint32_t prev_idle_ticks_1 = 0;
-    uint32_t delta_idle_0 = (idle_ticks_0 >= prev_idle_ticks_0) ? (idle_ticks_0 - prev_idle_ticks_0) : 0;
-    uint32_t delta_idle_1 = (idle_ticks_1 >= prev_idle_ticks_1) ? (idle_ticks_1 - prev_idle_ticks_1) : 0;
-    prev_idle_ticks_0 = idle_ticks_0;
-    prev_idle_ticks_1 = idle_ticks_1;
-    
-    *core_usage_0 = 0.0f;
-    *core_usage_1 = 0.0f;
-    if (delta_total > 0U)
+    // 4. Process deleted tasks
+    _process_deleted_tasks(tasks_seen);
+    free(tasks_seen);
+    return true;
+}
+
+/**
+ * @brief Calculate per-core CPU usage from idle task deltas.
+ * 
+ * @param idle_ticks Idle task run time per core in this sample.
+ * @param delta_total Total runtime delta.
+ * @param core_usage Output: CPU usage per core.
+ * @param overall_usage Output: Overall CPU usage (average over all cores).
+ */
+static void _calculate_cpu_metrics(const uint32_t idle_ticks[SYSMON_CORE_COUNT], uint32_t delta_total,
+                                    float core_usage[SYSMON_CORE_COUNT], float *overall_usage)
+{
+    float usage_sum = 0.0f;
+    for (int core = 0; core < SYSMON_CORE_COUNT; core++)
     {
-        float idle_percent_0 = ((float)delta_idle_0 / (float)delta_total) * 100.0f;
-        float idle_percent_1 = ((float)delta_idle_1 / (float)delta_total) * 100.0f;
-        *core_usage_0 = 100.0f - idle_percent_0;
-        *core_usage_1 = 100.0f - idle_percent_1;
+        uint32_t prev_idle = self.prev_idle_ticks[core];
+        uint32_t delta_idle = (idle_ticks[core] >= prev_idle) ? (idle_ticks[core] - prev_idle) : 0;
+        self.prev_idle_ticks[core] = idle_ticks[core];
         
-        // Clamp to valid range
-        if (*core_usage_0 < 0.0f) { *core_usage_0 = 0.0f; }
-        if (*core_usage_0 > 100.0f) { *core_usage_0 = 100.0f; }
-        if (*core_usage_1 < 0.0f) { *core_usage_1 = 0.0f; }
-        if (*core_usage_1 > 100.0f) { *core_usage_1 = 100.0f; }
+        core_usage[core] = 0.0f;
+        if (delta_total > 0U)
+        {
+            float idle_percent = ((float)delta_idle / (float)delta_total) * 100.0f;
+            core_usage[core] = 100.0f - idle_percent;
+            
+            // Clamp to valid range
+            if (core_usage[core] < 0.0f) { core_usage[core] = 0.0f; }
+            if (core_usage[core] > 100.0f) { core_usage[core] = 100.0f; }
+        }
+        usage_sum += core_usage[core];
     }
-    *overall_usage = (*core_usage_0 + *core_usage_1) * 0.5f;
+    *overall_usage = usage_sum / (float)SYSMON_CORE_COUNT;
 }
 
 /**
@@ -399,8 +991,8 @@ static void _collect_memory_stats(uint32_t *dram_free, uint32_t *dram_min_free,
  * @brief Store sampled metrics in cyclic ringbuffer.
  * 
  * @param overall_usage Overall CPU usage.
- * @param core_usage_0 CPU usage for core 0.
- * @param core_usage_1 CPU usage for core 1.
+ * @param core_usage CPU usage per core.
+ * @param isr_usage Interrupt load per core (stored only with CONFIG_SYSMON_ISR_MONITOR).
  * @param dram_free DRAM free bytes.
  * @param dram_min_free DRAM minimum free bytes.
  * @param dram_largest DRAM largest free block.
@@ -409,41 +1001,185 @@ static void _collect_memory_stats(uint32_t *dram_free, uint32_t *dram_min_free,
  * @param psram_free PSRAM free bytes.
  * @param psram_total PSRAM total bytes.
  * @param psram_used_percent PSRAM used percentage.
+ * @param timestamp_us Sample start time (esp_timer_get_time()).
+ * @param jitter_us Sample start jitter (actual minus scheduled start).
  */
-static void _update_series_buffers(float overall_usage, float core_usage_0, float core_usage_1,
+static void _update_series_buffers(float overall_usage, const float core_usage[SYSMON_CORE_COUNT],
+                                   const float isr_usage[SYSMON_CORE_COUNT],
                                    uint32_t dram_free, uint32_t dram_min_free, uint32_t dram_largest,
                                    uint32_t dram_total, float dram_used_percent,
-                                   uint32_t psram_free, uint32_t psram_total, float psram_used_percent)
+                                   uint32_t psram_free, uint32_t psram_total, float psram_used_percent,
+                                   int64_t timestamp_us, int32_t jitter_us)
 {
     int write_index = self.series_write_index;
+    self.sample_time_us[write_index] = timestamp_us;
+    self.sample_jitter_us[write_index] = jitter_us;
     self.cpu_overall_percent[write_index] = overall_usage;
-    self.cpu_core_percent[0][write_index] = core_usage_0;
-    self.cpu_core_percent[1][write_index] = core_usage_1;
+    for (int core = 0; core < SYSMON_CORE_COUNT; core++)
+    {
+        self.cpu_core_percent[core][write_index] = core_usage[core];
+        if (self.isr_core_percent[core] != NULL)
+        {
+            self.isr_core_percent[core][write_index] = isr_usage[core];
+        }
+    }
     self.dram_free[write_index] = dram_free;
     self.dram_min_free[write_index] = dram_min_free;
     self.dram_largest_block[write_index] = dram_largest;
     self.dram_total[write_index] = dram_total;
     self.dram_used_percent[write_index] = dram_used_percent;
+    float dram_frag_percent = _heap_frag_percent(dram_free, dram_largest);
+    self.dram_frag_percent[write_index] = dram_frag_percent;
     self.psram_free[write_index] = psram_free;
     self.psram_total[write_index] = psram_total;
     self.psram_used_percent[write_index] = psram_used_percent;
-    self.series_write_index = (write_index + 1) % CONFIG_SYSMON_SAMPLE_COUNT;
+    self.series_write_index = (write_index + 1) % self.history_depth;
+
+    // Feed the downsampled tiers
+    float percent[SYSMON_ROLLUP_PERCENT_SERIES] =
+    {
+        [SYSMON_ROLLUP_CPU]            = overall_usage,
+        [SYSMON_ROLLUP_DRAM_USED_PCT]  = dram_used_percent,
+        [SYSMON_ROLLUP_PSRAM_USED_PCT] = psram_used_percent,
+        [SYSMON_ROLLUP_DRAM_FRAG_PCT]  = dram_frag_percent
+    };
+    for (int core = 0; core < SYSMON_CORE_COUNT; core++)
+    {
+        percent[SYSMON_ROLLUP_CORE0 + core] = core_usage[core];
+    }
+    const uint32_t bytes[SYSMON_ROLLUP_BYTES_SERIES] =
+    {
+        [SYSMON_ROLLUP_DRAM_FREE]     = dram_free,
+        [SYSMON_ROLLUP_DRAM_MIN_FREE] = dram_min_free,
+        [SYSMON_ROLLUP_DRAM_LARGEST]  = dram_largest,
+        [SYSMON_ROLLUP_PSRAM_FREE]    = psram_free
+    };
+    _rollup_feed_system(percent, bytes);
+}
+
+/**
+ * @brief Schedule the first sample on the configured phase.
+ *
+ * @param clock Sampler schedule to initialize.
+ *
+ * The first deadline is the next instant after now (in esp_timer time, i.e.
+ * since boot) with t % interval == CONFIG_SYSMON_CPU_SAMPLING_PHASE_MS.
+ */
+static void _sampler_clock_init(SamplerClock *clock)
+{
+    int64_t interval_us = (int64_t)CONFIG_SYSMON_CPU_SAMPLING_INTERVAL_MS * 1000;
+    int64_t phase_us    = ((int64_t)CONFIG_SYSMON_CPU_SAMPLING_PHASE_MS * 1000) % interval_us;
+    int64_t now_us      = esp_timer_get_time();
+
+    int64_t deadline_us = (now_us / interval_us) * interval_us + phase_us;
+    if (deadline_us <= now_us)
+    {
+        deadline_us += interval_us;
+    }
+
+    clock->interval_us = interval_us;
+    clock->deadline_us = deadline_us;
+}
+
+/**
+ * @brief Sleep until the next scheduled sample and advance the schedule by one period.
+ *
+ * @param clock Sampler schedule.
+ * @param timestamp_us Output: actual start time of this sample.
+ * @param jitter_us Output: actual minus scheduled start time.
+ * @param overruns Output: 1 if the deadline had already passed on entry, 0 otherwise.
+ * @param skipped Output: number of whole periods dropped to get back on schedule.
+ *
+ * Details:
+ *   - Deadlines are absolute, so the period does not stretch with sampling time.
+ *   - If the sampler is a full period or more behind, the missed slots are
+ *     dropped instead of sampled back-to-back; the phase is preserved.
+ *   - The sleep is rounded up to whole RTOS ticks; since the first tick comes
+ *     after a partial period, |jitter| is normally below one tick plus
+ *     scheduling latency, and it may be negative.
+ */
+static void _sampler_clock_wait(SamplerClock *clock, int64_t *timestamp_us, int32_t *jitter_us,
+                                uint32_t *overruns, uint32_t *skipped)
+{
+    const int64_t tick_us = 1000000LL / configTICK_RATE_HZ;
+    int64_t now_us = esp_timer_get_time();
+
+    *overruns = 0;
+    *skipped  = 0;
+    if (now_us > clock->deadline_us)
+    {
+        *overruns = 1;
+        int64_t behind_periods = (now_us - clock->deadline_us) / clock->interval_us;
+        clock->deadline_us += behind_periods * clock->interval_us;
+        *skipped = (uint32_t)behind_periods;
+    }
+    else
+    {
+        int64_t wait_ticks = (clock->deadline_us - now_us + tick_us - 1) / tick_us;
+        if (wait_ticks > 0)
+        {
+            // A notification (sysmon_deinit()) ends the wait early
+            ulTaskNotifyTake(pdTRUE, (TickType_t)wait_ticks);
+        }
+        now_us = esp_timer_get_time();
+    }
+
+    *timestamp_us = now_us;
+    *jitter_us    = (int32_t)(now_us - clock->deadline_us);
+    clock->deadline_us += clock->interval_us;
+}
+
+/**
+ * @brief Record the schedule statistics of the sample being written (inside the snapshot write).
+ *
+ * @param jitter_us Start jitter of this sample.
+ * @param overruns Late starts to add.
+ * @param skipped Dropped periods to add.
+ * @param stack_scan Whether this sample scanned task stacks (full sample).
+ */
+static void _update_schedule_stats(int32_t jitter_us, uint32_t overruns, uint32_t skipped, bool stack_scan)
+{
+    self.stack_scan_age = stack_scan ? 0U : (self.stack_scan_age + 1U);
+    int32_t magnitude = (jitter_us < 0) ? -jitter_us : jitter_us;
+    if (magnitude > self.sample_jitter_max_us)
+    {
+        self.sample_jitter_max_us = magnitude;
+    }
+    self.sample_overruns += overruns;
+    self.sample_skipped  += skipped;
 }
 
 /**
  * @brief FreeRTOS-RTOS task to sample per-task CPU usage and memory stats at fixed intervals.
  *
  * This function is executed as a pinned FreeRTOS task and performs the following loop:
+ *   0. Sleeps until the next slot of a fixed-rate schedule (interval and phase from Kconfig).
  *   1. Allocates and right-sizes memory to track all active tasks if the count grows.
  *   2. Samples all tasks' runtime counters and global total counters using uxTaskGetSystemState().
- *   3. Updates or creates per-task usage history entries, calculating deltas and utilization percent.
- *   4. Identifies idle tasks per core, computes per-core idle, and derives CPU workload metrics.
- *   5. Collects DRAM and PSRAM heap statistics for memory diagnostics.
- *   6. Records all observations into cyclic ringbuffers for overview and UI reporting.
- *   7. Sleeps for a configured interval before next sample.
- * Loop continues until task is deleted by external shutdown.
+ *      With CONFIG_SYSMON_LIGHT_SAMPLING, most samples only read the runtime counters of the
+ *      known tasks and reuse the last stack high-water marks (see _sample_task_runtimes()).
+ *   3-4. Updates or creates per-task usage history entries, calculating deltas and utilization
+ *      percent, and records zeros for tasks that were not seen.
+ *   5. Derives per-core CPU usage (SYSMON_CORE_COUNT cores) from the idle time collected in
+ *      steps 3-4, and the interrupt load per core (see sysmon_isr.h).
+ *   6. Collects DRAM and PSRAM heap statistics for memory diagnostics.
+ *   7. Records all observations into cyclic ringbuffers for overview and UI reporting,
+ *      and into the downsampled rollup tiers (see sysmon_rollup.h), and mirrors the
+ *      sample into the RTC memory ring that survives resets (see sysmon_persist.h).
+ *   8. Pushes the new sample to live WebSocket subscribers (see sysmon_push.h), wakes
+ *      the UDP exporter when a batch is complete (see sysmon_export.h) and checks the
+ *      burst capture thresholds (see sysmon_burst.h).
+ *   9. Every CONFIG_SYSMON_HEAP_CAPS_INTERVAL samples, scans per-capability heap statistics
+ *      (see sysmon_heap.h).
+ *  10. Evaluates the alert rules on the finished sample (see sysmon_alert.h).
+ * Loop continues until sysmon_deinit() asks it to stop.
  *
- * Thread-unsafe: This runs as a single RTOS sampler and should not be invoked directly.
+ * Each sample is stamped with esp_timer_get_time() at its start, together with its
+ * start jitter; late starts and dropped slots are counted (see _sampler_clock_wait()).
+ * Steps 1-10 are timed for self-profiling (see sysmon_profile.h).
+ *
+ * Single writer: Steps 3-7 are wrapped in _snapshot_write_begin()/_snapshot_write_end() so
+ * HTTP readers copying state concurrently always see one complete sample (see sysmon_snapshot.h).
  * Relies on external lifetime management through sysmon_init()/sysmon_deinit().
  *
  * @param param (unused)
@@ -454,24 +1190,57 @@ static void sysmon_monitor(void *param)
     ESP_LOGI(LOG_TAG, "task monitor started");
     
     static int log_counter = 0;
+
+    SamplerClock clock;
+    _sampler_clock_init(&clock);
+    _init_idle_task_handles();
+    uint32_t pending_overruns = 0;
+    uint32_t pending_skipped  = 0;
     
-    for (;;)
+    while (!s_monitor_stop)
     {
+        // 0. Wait for the next slot of the fixed-rate schedule
+        int64_t timestamp_us = 0;
+        int32_t jitter_us    = 0;
+        uint32_t overruns    = 0;
+        uint32_t skipped     = 0;
+        _sampler_clock_wait(&clock, &timestamp_us, &jitter_us, &overruns, &skipped);
+        if (s_monitor_stop)
+        {
+            break;
+        }
+        pending_overruns += overruns;
+        pending_skipped  += skipped;
+
         // 1. Ensure task storage capacity
-        if (!_ensure_task_storage_capacity())
+        sysmon_profile_mark_t sample_mark = { 0 };
+        sysmon_profile_mark_t step_mark   = { 0 };
+        _profile_begin(&sample_mark);
+        step_mark = sample_mark;
+        // The task count is a plain kernel variable read; uxTaskGetSystemState() would scan every stack
+        if (!_ensure_task_storage_capacity((int)uxTaskGetNumberOfTasks()))
         {
-            vTaskDelay(pdMS_TO_TICKS(CONFIG_SYSMON_CPU_SAMPLING_INTERVAL_MS));
             continue;
         }
+        _profile_end(SYSMON_PROFILE_CAPACITY, &step_mark);
         
-        // 2. Sample task states
+        // 2. Sample task states (a full sample scans every stack for its high-water mark)
         UBaseType_t num_returned = 0;
         uint32_t delta_total = 0;
-        if (!_sample_task_states(&num_returned, &delta_total))
+        s_stack_generation_pending = _stack_generation();
+        _profile_begin(&step_mark);
+        bool stack_scan = _stack_scan_due();
+#if CONFIG_SYSMON_LIGHT_SAMPLING
+        if (!stack_scan && !_sample_task_runtimes(&num_returned, &delta_total))
+        {
+            stack_scan = true;
+        }
+#endif
+        if (stack_scan && !_sample_task_states(&num_returned, &delta_total))
         {
-            vTaskDelay(pdMS_TO_TICKS(CONFIG_SYSMON_CPU_SAMPLING_INTERVAL_MS));
             continue;
         }
+        _profile_end(SYSMON_PROFILE_TASK_STATES, &step_mark);
         
         // Debug logging
         if (log_counter++ % 10 == 0)
@@ -479,65 +1248,184 @@ static void sysmon_monitor(void *param)
             ESP_LOGI(LOG_TAG, "Sampling %u tasks", num_returned);
         }
         
-        // Track which tasks were seen
-        bool *tasks_seen = (bool *)calloc(self.task_capacity, sizeof(bool));
-        if (tasks_seen == NULL)
+        // 3-4. Update per-task histories and process deleted tasks (opens the snapshot write)
+        uint32_t idle_ticks[SYSMON_CORE_COUNT] = { 0 };
+        _profile_begin(&step_mark);
+        if (!_update_tasks(num_returned, delta_total, idle_ticks))
         {
-            vTaskDelay(pdMS_TO_TICKS(CONFIG_SYSMON_CPU_SAMPLING_INTERVAL_MS));
             continue;
         }
+        _profile_end(SYSMON_PROFILE_TASK_UPDATE, &step_mark);
         
-        // 3. Update per-task histories
-        for (UBaseType_t i = 0; i < num_returned; i++)
-        {
-            TaskStatus_t *t = &self.task_status[i];
-            if (t->pcTaskName == NULL)
-            {
-                continue;
-            }
-            
-            int idx = _find_or_create_task_index(t->pcTaskName);
-            if (idx == -1)
-            {
-                ESP_LOGW(LOG_TAG, "Task capacity exceeded, cannot track task '%s' (capacity: %d, num_tasks: %d). Will retry next sample.", 
-                         t->pcTaskName, self.task_capacity, uxTaskGetNumberOfTasks());
-                continue;
-            }
-            
-            _update_task_history(idx, t, delta_total);
-            tasks_seen[idx] = true;
-        }
-        
-        // 4. Process deleted tasks
-        _process_deleted_tasks(tasks_seen);
-        free(tasks_seen);
-        
-        // 5. Calculate CPU metrics
-        float core_usage_0, core_usage_1, overall_usage;
-        _calculate_cpu_metrics(num_returned, delta_total, &core_usage_0, &core_usage_1, &overall_usage);
+        // 5. Calculate CPU metrics and the interrupt load
+        float core_usage[SYSMON_CORE_COUNT];
+        float overall_usage;
+        float isr_usage[SYSMON_CORE_COUNT];
+        _calculate_cpu_metrics(idle_ticks, delta_total, core_usage, &overall_usage);
+        _isr_sample(timestamp_us, isr_usage);
         
         // 6. Collect memory statistics
+        _profile_begin(&step_mark);
         uint32_t dram_free, dram_min_free, dram_largest, dram_total;
         float dram_used_percent;
         uint32_t psram_free, psram_total;
         float psram_used_percent;
         _collect_memory_stats(&dram_free, &dram_min_free, &dram_largest, &dram_total, &dram_used_percent,
                               &psram_free, &psram_total, &psram_used_percent);
+        _profile_end(SYSMON_PROFILE_MEMORY, &step_mark);
         
         // 7. Update series buffers
-        _update_series_buffers(overall_usage, core_usage_0, core_usage_1,
+        _profile_begin(&step_mark);
+        _update_series_buffers(overall_usage, core_usage, isr_usage,
                                dram_free, dram_min_free, dram_largest, dram_total, dram_used_percent,
-                               psram_free, psram_total, psram_used_percent);
+                               psram_free, psram_total, psram_used_percent,
+                               timestamp_us, jitter_us);
+        _update_schedule_stats(jitter_us, pending_overruns, pending_skipped, stack_scan);
+        _update_core_switches(timestamp_us);
+        pending_overruns = 0;
+        pending_skipped  = 0;
+        _rollup_end_sample();
+        _snapshot_write_end();
+        _persist_record(timestamp_us);
+        _profile_end(SYSMON_PROFILE_SERIES, &step_mark);
         
-        // 8. Delay before next sample
-        vTaskDelay(pdMS_TO_TICKS(CONFIG_SYSMON_CPU_SAMPLING_INTERVAL_MS));
+        // 8. Push the new sample to live subscribers (serialized once for all of them)
+        _profile_begin(&step_mark);
+        _push_publish();
+        _export_notify();
+        _burst_check(overall_usage, dram_free);
+        _profile_end(SYSMON_PROFILE_PUSH, &step_mark);
+
+        // 9. Every few samples, scan per-capability heap stats (walks the heaps with them locked)
+        _profile_begin(&step_mark);
+        if (_heap_caps_sample(_snapshot_read_sequence()))
+        {
+            _profile_end(SYSMON_PROFILE_HEAP_CAPS, &step_mark);
+        }
+
+        // 10. Evaluate the alert rules on the finished sample
+        _profile_begin(&step_mark);
+        _alert_evaluate(timestamp_us);
+        _profile_end(SYSMON_PROFILE_ALERTS, &step_mark);
+        _profile_end(SYSMON_PROFILE_SAMPLE, &sample_mark);
+    }
+
+    // Stopped between samples, so the last sample is published (sample_seq is even)
+    ESP_LOGI(LOG_TAG, "task monitor stopped");
+    self.monitor_task_handle = NULL;
+    vTaskDelete(NULL);
+}
+
+/**
+ * @brief Stop the sampler task between two samples.
+ *
+ * Deleting the task outright could catch it inside a snapshot write (leaving
+ * sample_seq odd, so every reader would wait forever), with the scheduler
+ * suspended, inside a heap walk or holding a pinned view. The task is asked to
+ * stop and woken instead, and this waits until it exits at the top of its loop,
+ * warning once if that takes longer than SYSMON_MONITOR_STOP_TIMEOUT_MS.
+ */
+static void _monitor_stop(void)
+{
+    TaskHandle_t task = self.monitor_task_handle;
+    if (task == NULL)
+    {
+        return;
+    }
+
+    s_monitor_stop = true;
+    xTaskNotifyGive(task);
+    for (int waited_ms = 0; self.monitor_task_handle != NULL; waited_ms += SYSMON_MONITOR_STOP_POLL_MS)
+    {
+        if (waited_ms == SYSMON_MONITOR_STOP_TIMEOUT_MS)
+        {
+            ESP_LOGW(LOG_TAG, "sysmon_monitor task did not stop in %d ms; still waiting", SYSMON_MONITOR_STOP_TIMEOUT_MS);
+        }
+        vTaskDelay(pdMS_TO_TICKS(SYSMON_MONITOR_STOP_POLL_MS));
+    }
+    s_monitor_stop = false;
+}
+
+#if CONFIG_SYSMON_BENCHMARK
+/**
+ * @brief Prepare the sampler state for a replay (see sysmon_bench.h).
+ *
+ * @return ESP_OK on success, ESP_ERR_INVALID_STATE while the sampler task runs,
+ *         error code of _history_init() otherwise.
+ */
+esp_err_t _sampler_replay_begin(void)
+{
+    if (self.monitor_task_handle != NULL)
+    {
+        return ESP_ERR_INVALID_STATE;
+    }
+    if (self.history_depth == 0)
+    {
+        const sysmon_config_t config = SYSMON_CONFIG_DEFAULT();
+        return _history_init((int)config.history_depth, config.history_in_psram);
+    }
+    return ESP_OK;
+}
+
+/**
+ * @brief Run steps 1 and 3-7 of a sample on recorded task states (see sysmon_bench.h).
+ *
+ * @param task_states Recorded task states, as returned by uxTaskGetSystemState().
+ * @param num_tasks Number of entries in task_states.
+ * @param total_run_time Total runtime counter of the sample.
+ * @return true if the sample was published, false on allocation failure.
+ */
+bool _sampler_replay_sample(const TaskStatus_t *task_states, UBaseType_t num_tasks, uint32_t total_run_time)
+{
+    if (!_ensure_task_storage_capacity((int)num_tasks) || (int)num_tasks > self.task_status_capacity)
+    {
+        return false;
+    }
+    s_stack_generation_pending = _stack_generation();
+    memcpy(self.task_status, task_states, sizeof(TaskStatus_t) * num_tasks);
+    uint32_t delta_total = _advance_total_run_time(total_run_time);
+    
+    uint32_t idle_ticks[SYSMON_CORE_COUNT] = { 0 };
+    if (!_update_tasks(num_tasks, delta_total, idle_ticks))
+    {
+        return false;
     }
+    
+    float core_usage[SYSMON_CORE_COUNT];
+    float overall_usage;
+    _calculate_cpu_metrics(idle_ticks, delta_total, core_usage, &overall_usage);
+    const float isr_usage[SYSMON_CORE_COUNT] = { 0 };
+    
+    uint32_t dram_free, dram_min_free, dram_largest, dram_total;
+    float dram_used_percent;
+    uint32_t psram_free, psram_total;
+    float psram_used_percent;
+    _collect_memory_stats(&dram_free, &dram_min_free, &dram_largest, &dram_total, &dram_used_percent,
+                          &psram_free, &psram_total, &psram_used_percent);
+    _update_series_buffers(overall_usage, core_usage, isr_usage,
+                           dram_free, dram_min_free, dram_largest, dram_total, dram_used_percent,
+                           psram_free, psram_total, psram_used_percent,
+                           esp_timer_get_time(), 0);
+    _rollup_end_sample();
+    _snapshot_write_end();
+    return true;
+}
+
+/**
+ * @brief Release everything a replay allocated (see sysmon_bench.h).
+ */
+void _sampler_replay_end(void)
+{
+    _release_task_storage();
+    memset(&self.rollup, 0, sizeof(self.rollup));
+    memset(self.prev_idle_ticks, 0, sizeof(self.prev_idle_ticks));
 }
+#endif
 
 /**
  * @brief Deinitialize all sysmon state and monitoring resources.
  *
- * Shuts down HTTP telemetry, stops the sampler task, and releases all
+ * Shuts down HTTP telemetry, stops the sampler and exporter tasks, and releases all
  * dynamically allocated memory. After calling, all state is reset and
  * sysmon monitoring is fully stopped.
  *
@@ -548,44 +1436,61 @@ static void sysmon_monitor(void *param)
  */
 void sysmon_deinit(void)
 {
+    // Stop the task monitor, if running (first, so it cannot push to a stopping server)
+    _monitor_stop();
+
+    _export_stop();
     sysmon_http_stop();
+    _burst_stop();
+    _hardware_cache_cleanup();
 
-    // Terminate task monitor, if running
-    if (self.monitor_task_handle != NULL)
-    {
-        vTaskDelete(self.monitor_task_handle);
-        self.monitor_task_handle = NULL;
-    }
     // Free task metric storage buffers
-    free(self.tasks);
-    self.tasks = NULL;
-    free(self.task_status);
-    self.task_status          = NULL;
-    self.task_capacity        = 0;
-    self.prev_total_run_time  = 0;
+    _release_task_storage();
     
     // Clean up stack records
     sysmon_stack_cleanup();
 }
 
 
+/**
+ * @brief Initialize task and system monitoring with the default configuration.
+ *
+ * @return ESP_OK on success, or ESP_FAIL/ESP_ERR_xx on failure.
+ */
+esp_err_t sysmon_init(void)
+{
+    return sysmon_init_with_config(NULL);
+}
+
 /**
  * @brief Initialize task and system monitoring, and start HTTP telemetry server.
  *
  * Allocates and starts the main sampler background task (pinned to core 0)
  * if not already active, and initializes HTTP telemetry endpoints.
  *
+ * @param config Configuration (NULL for SYSMON_CONFIG_DEFAULT()).
  * @return ESP_OK on success, or ESP_FAIL/ESP_ERR_xx on failure.
  * @note Call only once at system startup or when first enabling the UI/telemetry feature.
  *
  * Step-by-step operation:
  *  1. Verify WiFi connectivity (required for HTTP server).
- *  2. Start HTTP API handler for telemetry endpoints.
- *  3. If not already running, create task monitor (CPU+memory) pinned to core 0.
- *  4. Report initialization status via log and return result.
+ *  2. Allocate the history arena for the configured depth (kept if already allocated).
+ *  3. Recover the previous boot's samples from RTC memory if enabled (see sysmon_persist.h).
+ *  4. Cache static hardware info (chip, partitions, flash) for /hardware.
+ *  5. Start HTTP API handler for telemetry endpoints.
+ *  6. If not already running, create task monitor (CPU+memory) pinned to core 0.
+ *  7. Allocate the burst capture buffer if enabled (see sysmon_burst.h).
+ *  8. Start the UDP exporter if enabled (see sysmon_export.h).
+ *  9. Report initialization status via log and return result.
  */
-esp_err_t sysmon_init(void)
+esp_err_t sysmon_init_with_config(const sysmon_config_t *config)
 {
+    const sysmon_config_t default_config = SYSMON_CONFIG_DEFAULT();
+    if (config == NULL)
+    {
+        config = &default_config;
+    }
+
     // 1. Verify WiFi connectivity before starting HTTP server
     esp_err_t err = _check_wifi_connectivity();
     if (err != ESP_OK)
@@ -595,7 +1500,39 @@ esp_err_t sysmon_init(void)
         return err;
     }
 
-    // 2. Start HTTP endpoint
+    // 2. Allocate the history arena (the depth cannot change while the sampler runs)
+    if (self.history_depth == 0)
+    {
+        err = _history_init((int)config->history_depth, config->history_in_psram);
+        if (err != ESP_OK)
+        {
+            ESP_LOGE(LOG_TAG, "_history_init() failed: %s (0x%x). Cannot allocate history storage.", 
+                     esp_err_to_name(err), err);
+            return err;
+        }
+    }
+    else if (self.history_depth != (int)config->history_depth)
+    {
+        ESP_LOGW(LOG_TAG, "History depth stays at %d until sysmon_deinit()", self.history_depth);
+    }
+
+    // 3. Recover the previous boot's samples before the sampler overwrites them (non-fatal)
+    err = _persist_start();
+    if (err != ESP_OK)
+    {
+        ESP_LOGW(LOG_TAG, "_persist_start() failed: %s (0x%x). The previous boot's samples are lost.", 
+                 esp_err_to_name(err), err);
+    }
+
+    // 4. Cache hardware info (non-fatal: /hardware retries the build on the next request)
+    err = _hardware_cache_init();
+    if (err != ESP_OK)
+    {
+        ESP_LOGW(LOG_TAG, "_hardware_cache_init() failed: %s (0x%x). /hardware will retry on request.", 
+                 esp_err_to_name(err), err);
+    }
+
+    // 5. Start HTTP endpoint
     err = sysmon_http_start();
     if (err != ESP_OK)
     {
@@ -604,7 +1541,7 @@ esp_err_t sysmon_init(void)
         return err;
     }
 
-    // 3. Only start monitor if not running (singleton pattern)
+    // 6. Only start monitor if not running (singleton pattern)
     if (self.monitor_task_handle == NULL)
     {
         BaseType_t result = xTaskCreatePinnedToCore(
@@ -628,7 +1565,23 @@ esp_err_t sysmon_init(void)
 
     }
 
-    // 4. Successful startup log for diagnostics with actual IP and port
+    // 7. Allocate the burst capture buffer (non-fatal: only burst capture is lost)
+    err = _burst_start();
+    if (err != ESP_OK)
+    {
+        ESP_LOGW(LOG_TAG, "_burst_start() failed: %s (0x%x). Burst capture is unavailable.", 
+                 esp_err_to_name(err), err);
+    }
+
+    // 8. Start the UDP exporter (non-fatal: the HTTP endpoints work without it)
+    err = _export_start();
+    if (err != ESP_OK)
+    {
+        ESP_LOGW(LOG_TAG, "_export_start() failed: %s (0x%x). Samples are not exported over UDP.", 
+                 esp_err_to_name(err), err);
+    }
+
+    // 9. Successful startup log for diagnostics with actual IP and port
     char ip_buffer[16] = { 0 };
     esp_err_t ip_err = _get_wifi_ip_info(ip_buffer, sizeof(ip_buffer));
     if (ip_err == ESP_OK)
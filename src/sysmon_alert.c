@@ -0,0 +1,653 @@
+/**
+ * @file sysmon_alert.c
+ * @brief Threshold alert rules evaluated by the sampler.
+ *
+ * This file implements the rule table described in sysmon_alert.h. Rules are
+ * added and removed by application tasks and evaluated by the sampler task;
+ * the sampler copies each rule out of the table under a short spinlock,
+ * evaluates the copy without it and writes the copy back only if the rule
+ * was not removed meanwhile. Callbacks run after the lock is released.
+ */
+
+// Project-specific includes
+#include "sysmon_alert.h"
+#include "sysmon.h"
+#include "sysmon_json_stream.h"
+#include "sysmon_snapshot.h"
+#include "sysmon_utils.h"
+
+// ESP-IDF includes
+#include "esp_log.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+
+// System includes
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+
+#if CONFIG_SYSMON_ALERT_MAX_RULES > 0
+
+// Logger tag for this module
+static const char *LOG_TAG = "sysmon_alert";
+
+/**
+ * @brief Rule table entry.
+ *
+ * Members:
+ * - id           : Rule ID (0 for a free entry).
+ * - rule         : Rule as added (name and task point into this entry).
+ * - name         : Copy of the rule label.
+ * - task         : Copy of the task key.
+ * - callback     : Fire/clear callback (may be NULL).
+ * - arg          : Callback argument.
+ * - slot         : Task entry the task key resolved to (-1 if none).
+ * - task_id      : xTaskNumber of the task in slot.
+ * - binds        : SysMonState.task_binds when the task entries were last scanned.
+ * - scanned      : Whether the task entries were scanned since the rule was added.
+ * - value_valid  : Whether value holds a value of the latest sample.
+ * - value        : Metric value of the latest sample.
+ * - holding      : Whether the comparison held in the latest sample.
+ * - holding_since: Timestamp of the first sample of the current holding run.
+ * - held_ms      : How long the comparison has held, as of the latest sample.
+ * - active       : Whether the rule has fired and not cleared yet.
+ * - fire_count   : Number of fires since the rule was added.
+ */
+typedef struct
+{
+    int id;
+    sysmon_alert_rule_t rule;
+    char name[24];
+    char task[32];
+    sysmon_alert_callback_t callback;
+    void *arg;
+    int slot;
+    UBaseType_t task_id;
+    uint32_t binds;
+    bool scanned;
+    bool value_valid;
+    float value;
+    bool holding;
+    int64_t holding_since;
+    uint32_t held_ms;
+    bool active;
+    uint32_t fire_count;
+} AlertRule;
+
+static AlertRule s_rules[CONFIG_SYSMON_ALERT_MAX_RULES];
+static int s_next_rule_id = 1;
+static sysmon_alert_event_t s_events[CONFIG_SYSMON_ALERT_LOG_SIZE];
+static uint32_t s_event_total = 0;
+static portMUX_TYPE s_alert_lock = portMUX_INITIALIZER_UNLOCKED;
+#endif
+
+// ============================================================================
+// Internal Helper Functions
+// ============================================================================
+
+#if CONFIG_SYSMON_ALERT_MAX_RULES > 0
+
+/**
+ * @brief Whether a metric belongs to a task.
+ *
+ * @param metric Metric.
+ * @return true for the SYSMON_ALERT_TASK_* metrics.
+ */
+static bool _alert_is_task_metric(sysmon_alert_metric_t metric)
+{
+    return metric == SYSMON_ALERT_TASK_CPU || metric == SYSMON_ALERT_TASK_STACK_PERCENT ||
+           metric == SYSMON_ALERT_TASK_STACK_FREE || metric == SYSMON_ALERT_TASK_HEAP;
+}
+
+/**
+ * @brief JSON name of a metric.
+ *
+ * @param metric Metric.
+ * @return Name, as in /telemetry where the metric appears there.
+ */
+static const char *_alert_metric_name(sysmon_alert_metric_t metric)
+{
+    static const char *const names[SYSMON_ALERT_METRIC_COUNT] =
+    {
+        [SYSMON_ALERT_TASK_CPU]           = "taskCpu",
+        [SYSMON_ALERT_TASK_STACK_PERCENT] = "taskStackPct",
+        [SYSMON_ALERT_TASK_STACK_FREE]    = "taskStackFree",
+        [SYSMON_ALERT_TASK_HEAP]          = "taskHeap",
+        [SYSMON_ALERT_CPU]                = "cpu",
+        [SYSMON_ALERT_CORE_CPU]           = "coreCpu",
+        [SYSMON_ALERT_DRAM_FREE]          = "dramFree",
+        [SYSMON_ALERT_DRAM_MIN_FREE]      = "dramMinFree",
+        [SYSMON_ALERT_DRAM_LARGEST]       = "dramLargest",
+        [SYSMON_ALERT_DRAM_FRAG_PERCENT]  = "dramFragPct",
+        [SYSMON_ALERT_DRAM_USED_PERCENT]  = "dramUsedPct",
+        [SYSMON_ALERT_PSRAM_FREE]         = "psramFree"
+    };
+    return ((int)metric >= 0 && metric < SYSMON_ALERT_METRIC_COUNT) ? names[metric] : "unknown";
+}
+
+/**
+ * @brief Text of a comparison.
+ *
+ * @param op Comparison.
+ * @return ">", ">=", "<" or "<=".
+ */
+static const char *_alert_op_name(sysmon_alert_op_t op)
+{
+    switch (op)
+    {
+        case SYSMON_ALERT_GE: return ">=";
+        case SYSMON_ALERT_LT: return "<";
+        case SYSMON_ALERT_LE: return "<=";
+        default:              return ">";
+    }
+}
+
+/**
+ * @brief Resolve the task key of a rule to a task entry (sampler task only).
+ *
+ * The remembered entry is checked in O(1); the task entries are only scanned
+ * again after a task was discovered or re-created since the last scan.
+ *
+ * @param rule Rule (slot, task_id, binds and scanned are updated).
+ * @return Task index, or -1 if no live task has the key.
+ */
+static int _alert_find_task(AlertRule *rule)
+{
+    int slot = rule->slot;
+    if (slot >= 0 && slot < self.task_capacity && self.tasks[slot].is_active &&
+        self.tasks[slot].consecutive_zero_samples == 0 && self.tasks[slot].task_id == rule->task_id)
+    {
+        return slot;
+    }
+    if (rule->scanned && rule->binds == self.task_binds)
+    {
+        return -1;
+    }
+
+    rule->slot    = -1;
+    rule->scanned = true;
+    rule->binds   = self.task_binds;
+    char key[32];
+    for (int i = 0; i < self.task_capacity; i++)
+    {
+        const TaskUsageSample *task = &self.tasks[i];
+        if (!task->is_active || task->consecutive_zero_samples > 0)
+        {
+            continue;
+        }
+        if (strcmp(_get_task_display_key(task->task_name, task->name_ordinal, key, sizeof(key)), rule->task) == 0)
+        {
+            rule->slot    = i;
+            rule->task_id = task->task_id;
+            return i;
+        }
+    }
+    return -1;
+}
+
+/**
+ * @brief Read the metric of a rule from the latest sample (sampler task only).
+ *
+ * @param rule Rule.
+ * @param latest Series index of the latest sample.
+ * @param value Output: metric value.
+ * @return true if the metric has a value (task found, stack registered, ...).
+ */
+static bool _alert_read_value(AlertRule *rule, int latest, float *value)
+{
+    if (_alert_is_task_metric(rule->rule.metric))
+    {
+        int idx = _alert_find_task(rule);
+        if (idx < 0)
+        {
+            return false;
+        }
+        const TaskUsageSample *task = &self.tasks[idx];
+        switch (rule->rule.metric)
+        {
+            case SYSMON_ALERT_TASK_CPU:
+                *value = task->usage_percent;
+                return true;
+            case SYSMON_ALERT_TASK_STACK_PERCENT:
+                *value = task->stack_used_percent;
+                return task->stack_size_bytes > 0U;
+            case SYSMON_ALERT_TASK_STACK_FREE:
+                *value = (float)(task->stack_high_water_mark * sizeof(StackType_t));
+                return true;
+            default:
+                *value = (float)task->heap_live_bytes;
+                return task->heap_valid;
+        }
+    }
+
+    switch (rule->rule.metric)
+    {
+        case SYSMON_ALERT_CPU:
+            *value = self.cpu_overall_percent[latest];
+            return true;
+        case SYSMON_ALERT_CORE_CPU:
+            *value = self.cpu_core_percent[rule->rule.core][latest];
+            return true;
+        case SYSMON_ALERT_DRAM_FREE:
+            *value = (float)self.dram_free[latest];
+            return true;
+        case SYSMON_ALERT_DRAM_MIN_FREE:
+            *value = (float)self.dram_min_free[latest];
+            return true;
+        case SYSMON_ALERT_DRAM_LARGEST:
+            *value = (float)self.dram_largest_block[latest];
+            return true;
+        case SYSMON_ALERT_DRAM_FRAG_PERCENT:
+            *value = self.dram_frag_percent[latest];
+            return true;
+        case SYSMON_ALERT_DRAM_USED_PERCENT:
+            *value = self.dram_used_percent[latest];
+            return true;
+        default:
+            *value = (float)self.psram_free[latest];
+            return self.psram_seen;
+    }
+}
+
+/**
+ * @brief Compare a value with a rule's threshold.
+ *
+ * @param op Comparison.
+ * @param value Metric value.
+ * @param threshold Threshold.
+ * @return true if "value <op> threshold".
+ */
+static bool _alert_compare(sysmon_alert_op_t op, float value, float threshold)
+{
+    switch (op)
+    {
+        case SYSMON_ALERT_GE: return value >= threshold;
+        case SYSMON_ALERT_LT: return value < threshold;
+        case SYSMON_ALERT_LE: return value <= threshold;
+        default:              return value > threshold;
+    }
+}
+
+/**
+ * @brief Evaluate one rule on the latest sample (sampler task only).
+ *
+ * @param rule Copy of the rule (state is updated).
+ * @param latest Series index of the latest sample.
+ * @param timestamp_us Timestamp of the sample.
+ * @return true if the rule fired or cleared.
+ */
+static bool _alert_step(AlertRule *rule, int latest, int64_t timestamp_us)
+{
+    float value      = 0.0f;
+    rule->value_valid = _alert_read_value(rule, latest, &value);
+    rule->value       = rule->value_valid ? value : 0.0f;
+
+    bool holds = rule->value_valid && _alert_compare(rule->rule.op, value, rule->rule.threshold);
+    if (!holds)
+    {
+        rule->holding = false;
+        rule->held_ms = 0U;
+        if (rule->active)
+        {
+            rule->active = false;
+            return true;
+        }
+        return false;
+    }
+
+    if (!rule->holding)
+    {
+        rule->holding       = true;
+        rule->holding_since = timestamp_us;
+    }
+    int64_t held_us = timestamp_us - rule->holding_since;
+    rule->held_ms   = (uint32_t)(held_us / 1000);
+    if (!rule->active && held_us >= (int64_t)rule->rule.hold_ms * 1000)
+    {
+        rule->active = true;
+        rule->fire_count++;
+        return true;
+    }
+    return false;
+}
+
+/**
+ * @brief Log a fire or clear and append it to the event ring.
+ *
+ * @param rule Rule that fired or cleared (its active flag tells which).
+ * @param event Output: the event.
+ * @param timestamp_us Timestamp of the sample.
+ * @param seq Sequence number of the sample.
+ */
+static void _alert_record(const AlertRule *rule, sysmon_alert_event_t *event, int64_t timestamp_us, uint32_t seq)
+{
+    memset(event, 0, sizeof(*event));
+    event->rule_id      = rule->id;
+    event->fired        = rule->active;
+    event->value        = rule->value;
+    event->threshold    = rule->rule.threshold;
+    event->timestamp_us = timestamp_us;
+    event->seq          = seq;
+    strncpy(event->name, rule->name, sizeof(event->name) - 1);
+
+    portENTER_CRITICAL(&s_alert_lock);
+    s_events[s_event_total % CONFIG_SYSMON_ALERT_LOG_SIZE] = *event;
+    s_event_total++;
+    portEXIT_CRITICAL(&s_alert_lock);
+
+    if (event->fired)
+    {
+        ESP_LOGW(LOG_TAG, "Alert '%s' fired: %s%s%s %.2f %s %.2f for %lu ms", rule->name,
+                 _alert_metric_name(rule->rule.metric), _alert_is_task_metric(rule->rule.metric) ? " of " : "",
+                 _alert_is_task_metric(rule->rule.metric) ? rule->task : "", (double)rule->value,
+                 _alert_op_name(rule->rule.op), (double)rule->rule.threshold, (unsigned long)rule->held_ms);
+    }
+    else
+    {
+        ESP_LOGI(LOG_TAG, "Alert '%s' cleared (%s %s)", rule->name, _alert_metric_name(rule->rule.metric),
+                 rule->value_valid ? "back in range" : "unavailable");
+    }
+}
+
+/**
+ * @brief Write one rule as a JSON object.
+ *
+ * @param stream Chunked response writer.
+ * @param rule Copy of the rule.
+ */
+static void _alert_write_rule(json_stream_t *stream, const AlertRule *rule)
+{
+    json_stream_object_begin(stream);
+    json_stream_add_int(stream, "id", rule->id);
+    json_stream_add_string(stream, "name", rule->name);
+    json_stream_add_string(stream, "metric", _alert_metric_name(rule->rule.metric));
+    if (_alert_is_task_metric(rule->rule.metric))
+    {
+        json_stream_add_string(stream, "task", rule->task);
+    }
+    if (rule->rule.metric == SYSMON_ALERT_CORE_CPU)
+    {
+        json_stream_add_int(stream, "core", rule->rule.core);
+    }
+    json_stream_add_string(stream, "op", _alert_op_name(rule->rule.op));
+    json_stream_add_fixed(stream, "threshold", rule->rule.threshold, 2);
+    json_stream_add_uint(stream, "holdMs", rule->rule.hold_ms);
+    if (rule->value_valid)
+    {
+        json_stream_add_fixed(stream, "value", rule->value, 2);
+    }
+    else
+    {
+        json_stream_add_null(stream, "value");
+    }
+    json_stream_add_uint(stream, "heldMs", rule->held_ms);
+    json_stream_add_bool(stream, "active", rule->active);
+    json_stream_add_uint(stream, "fired", rule->fire_count);
+    json_stream_object_end(stream);
+}
+
+/**
+ * @brief Write one event as a JSON object.
+ *
+ * @param stream Chunked response writer.
+ * @param event Event.
+ */
+static void _alert_write_event(json_stream_t *stream, const sysmon_alert_event_t *event)
+{
+    json_stream_object_begin(stream);
+    json_stream_add_int(stream, "rule", event->rule_id);
+    json_stream_add_string(stream, "name", event->name);
+    json_stream_add_string(stream, "state", event->fired ? "fired" : "cleared");
+    json_stream_add_fixed(stream, "value", event->value, 2);
+    json_stream_add_fixed(stream, "threshold", event->threshold, 2);
+    json_stream_add_uint64(stream, "timeUs", (uint64_t)event->timestamp_us);
+    json_stream_add_uint(stream, "seq", event->seq);
+    json_stream_object_end(stream);
+}
+#endif
+
+// ============================================================================
+// Public API Functions
+// ============================================================================
+
+/**
+ * @brief Add an alert rule.
+ *
+ * @param rule Rule (copied).
+ * @param callback Called on every fire and clear (NULL for log and /alerts only).
+ * @param arg Argument for the callback.
+ * @param rule_id Output: rule ID for sysmon_alert_remove() (may be NULL).
+ * @return ESP_OK on success, ESP_ERR_INVALID_ARG for a bad rule, ESP_ERR_NO_MEM
+ *         if the rule table is full, ESP_ERR_NOT_SUPPORTED if alerts are disabled.
+ */
+esp_err_t sysmon_alert_add(const sysmon_alert_rule_t *rule, sysmon_alert_callback_t callback, void *arg,
+                           int *rule_id)
+{
+#if CONFIG_SYSMON_ALERT_MAX_RULES > 0
+    if (rule == NULL || (int)rule->metric < 0 || rule->metric >= SYSMON_ALERT_METRIC_COUNT ||
+        (int)rule->op < 0 || rule->op > SYSMON_ALERT_LE)
+    {
+        return ESP_ERR_INVALID_ARG;
+    }
+    if (_alert_is_task_metric(rule->metric) && (rule->task == NULL || rule->task[0] == '\0'))
+    {
+        ESP_LOGE(LOG_TAG, "Rule on %s needs a task key", _alert_metric_name(rule->metric));
+        return ESP_ERR_INVALID_ARG;
+    }
+    if (rule->metric == SYSMON_ALERT_CORE_CPU && (rule->core < 0 || rule->core >= SYSMON_CORE_COUNT))
+    {
+        ESP_LOGE(LOG_TAG, "Rule on %s: no core %d", _alert_metric_name(rule->metric), rule->core);
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    // Build the entry outside the lock; it becomes visible to the sampler with its ID
+    AlertRule entry;
+    memset(&entry, 0, sizeof(entry));
+    entry.rule     = *rule;
+    entry.callback = callback;
+    entry.arg      = arg;
+    entry.slot     = -1;
+    if (_alert_is_task_metric(rule->metric))
+    {
+        strncpy(entry.task, rule->task, sizeof(entry.task) - 1);
+    }
+
+    esp_err_t err = ESP_ERR_NO_MEM;
+    portENTER_CRITICAL(&s_alert_lock);
+    for (int i = 0; i < CONFIG_SYSMON_ALERT_MAX_RULES; i++)
+    {
+        if (s_rules[i].id == 0)
+        {
+            entry.id = s_next_rule_id++;
+            if (rule->name != NULL)
+            {
+                strncpy(entry.name, rule->name, sizeof(entry.name) - 1);
+            }
+            else
+            {
+                snprintf(entry.name, sizeof(entry.name), "rule%d", entry.id);
+            }
+            entry.rule.name = NULL;
+            entry.rule.task = NULL;
+            s_rules[i]      = entry;
+            err = ESP_OK;
+            break;
+        }
+    }
+    portEXIT_CRITICAL(&s_alert_lock);
+
+    if (err != ESP_OK)
+    {
+        ESP_LOGE(LOG_TAG, "Rule table full (%d rules)", CONFIG_SYSMON_ALERT_MAX_RULES);
+        return err;
+    }
+    if (rule_id != NULL)
+    {
+        *rule_id = entry.id;
+    }
+    ESP_LOGI(LOG_TAG, "Rule %d '%s': %s %s %.2f for %lu ms", entry.id, entry.name,
+             _alert_metric_name(rule->metric), _alert_op_name(rule->op), (double)rule->threshold,
+             (unsigned long)rule->hold_ms);
+    return ESP_OK;
+#else
+    (void)rule;
+    (void)callback;
+    (void)arg;
+    (void)rule_id;
+    return ESP_ERR_NOT_SUPPORTED;
+#endif
+}
+
+/**
+ * @brief Remove an alert rule.
+ *
+ * @param rule_id Rule ID from sysmon_alert_add().
+ * @return ESP_OK on success, ESP_ERR_NOT_FOUND for an unknown rule ID.
+ */
+esp_err_t sysmon_alert_remove(int rule_id)
+{
+#if CONFIG_SYSMON_ALERT_MAX_RULES > 0
+    esp_err_t err = ESP_ERR_NOT_FOUND;
+    if (rule_id <= 0)
+    {
+        return err;
+    }
+    portENTER_CRITICAL(&s_alert_lock);
+    for (int i = 0; i < CONFIG_SYSMON_ALERT_MAX_RULES; i++)
+    {
+        if (s_rules[i].id == rule_id)
+        {
+            s_rules[i].id = 0;
+            err = ESP_OK;
+            break;
+        }
+    }
+    portEXIT_CRITICAL(&s_alert_lock);
+    return err;
+#else
+    (void)rule_id;
+    return ESP_ERR_NOT_FOUND;
+#endif
+}
+
+/**
+ * @brief Evaluate every rule on the sample just published (sampler task only).
+ *
+ * @param timestamp_us Timestamp of the sample.
+ *
+ * Details:
+ *   - O(rules): each rule reads one value of the latest sample.
+ *   - A rule removed (or replaced) while it was evaluated is not written back
+ *     and its callback is not called.
+ */
+void _alert_evaluate(int64_t timestamp_us)
+{
+#if CONFIG_SYSMON_ALERT_MAX_RULES > 0
+    if (self.history_depth <= 0)
+    {
+        return;
+    }
+    int latest   = (self.series_write_index + self.history_depth - 1) % self.history_depth;
+    uint32_t seq = _snapshot_read_sequence();
+
+    for (int i = 0; i < CONFIG_SYSMON_ALERT_MAX_RULES; i++)
+    {
+        AlertRule rule;
+        portENTER_CRITICAL(&s_alert_lock);
+        rule = s_rules[i];
+        portEXIT_CRITICAL(&s_alert_lock);
+        if (rule.id == 0)
+        {
+            continue;
+        }
+
+        bool changed = _alert_step(&rule, latest, timestamp_us);
+
+        bool current = false;
+        portENTER_CRITICAL(&s_alert_lock);
+        if (s_rules[i].id == rule.id)
+        {
+            s_rules[i] = rule;
+            current    = true;
+        }
+        portEXIT_CRITICAL(&s_alert_lock);
+
+        if (current && changed)
+        {
+            sysmon_alert_event_t event;
+            _alert_record(&rule, &event, timestamp_us, seq);
+            if (rule.callback != NULL)
+            {
+                rule.callback(&event, rule.arg);
+            }
+        }
+    }
+#else
+    (void)timestamp_us;
+#endif
+}
+
+/**
+ * @brief Write the rules and the event ring (/alerts).
+ *
+ * @param stream Chunked response writer.
+ * @return ESP_OK on success, or the first error raised while streaming.
+ *
+ * Details:
+ *   - "rules" in table order; "value" is null if the metric had no value in
+ *     the latest sample (task not found, stack not registered, ...).
+ *   - "events" oldest first; "eventCount" counts every event since boot, so
+ *     eventCount minus the events listed were overwritten.
+ */
+esp_err_t _write_alerts_json(json_stream_t *stream)
+{
+    json_stream_object_begin(stream);
+    json_stream_add_bool(stream, "enabled", CONFIG_SYSMON_ALERT_MAX_RULES > 0);
+#if CONFIG_SYSMON_ALERT_MAX_RULES > 0
+    json_stream_add_uint(stream, "maxRules", CONFIG_SYSMON_ALERT_MAX_RULES);
+
+    json_stream_key(stream, "rules");
+    json_stream_array_begin(stream);
+    for (int i = 0; i < CONFIG_SYSMON_ALERT_MAX_RULES; i++)
+    {
+        AlertRule rule;
+        portENTER_CRITICAL(&s_alert_lock);
+        rule = s_rules[i];
+        portEXIT_CRITICAL(&s_alert_lock);
+        if (rule.id != 0)
+        {
+            _alert_write_rule(stream, &rule);
+        }
+    }
+    json_stream_array_end(stream);
+
+    portENTER_CRITICAL(&s_alert_lock);
+    uint32_t total = s_event_total;
+    portEXIT_CRITICAL(&s_alert_lock);
+    uint32_t first = (total > CONFIG_SYSMON_ALERT_LOG_SIZE) ? total - CONFIG_SYSMON_ALERT_LOG_SIZE : 0U;
+    json_stream_add_uint(stream, "eventCount", total);
+    json_stream_key(stream, "events");
+    json_stream_array_begin(stream);
+    for (uint32_t n = first; n < total; n++)
+    {
+        // Skip events overwritten while the response was being written
+        sysmon_alert_event_t event;
+        bool present = false;
+        portENTER_CRITICAL(&s_alert_lock);
+        if (s_event_total - n <= CONFIG_SYSMON_ALERT_LOG_SIZE)
+        {
+            event   = s_events[n % CONFIG_SYSMON_ALERT_LOG_SIZE];
+            present = true;
+        }
+        portEXIT_CRITICAL(&s_alert_lock);
+        if (present)
+        {
+            _alert_write_event(stream, &event);
+        }
+    }
+    json_stream_array_end(stream);
+#endif
+    json_stream_object_end(stream);
+    return stream->error;
+}
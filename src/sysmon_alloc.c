@@ -0,0 +1,364 @@
+/**
+ * @file sysmon_alloc.c
+ * @brief Per-task heap accounting from the heap allocation hooks.
+ *
+ * This file implements the task and block tables described in sysmon_alloc.h.
+ * The hook functions run inside every malloc() and free(), possibly with the
+ * flash cache disabled, so they live in IRAM, touch only the static tables
+ * and never block.
+ */
+
+// Project-specific includes
+#include "sysmon_alloc.h"
+#include "sysmon.h"
+
+// ESP-IDF includes
+#include "esp_attr.h"
+#include "esp_heap_caps.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+
+// System includes
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#if CONFIG_SYSMON_TASK_HEAP_ACCOUNTING
+
+// Task table size: twice the tracked task count keeps probe chains short
+#define ALLOC_TASK_TABLE_SIZE (2U * CONFIG_SYSMON_TASK_HEAP_MAX_TASKS)
+
+// Block table size and the number of entries probed from a block's home entry
+#define ALLOC_BLOCK_TABLE_SIZE ((uint32_t)CONFIG_SYSMON_TASK_HEAP_MAX_BLOCKS)
+#define ALLOC_BLOCK_PROBES     8U
+
+// Key markers besides real TCB and block addresses (both word aligned, never 1 to 3)
+#define ALLOC_KEY_FREED    ((void *)1)   // Released; probing continues past it
+#define ALLOC_KEY_CLAIMING ((void *)2)   // Being written by a hook
+#define ALLOC_KEY_EXITED   ((void *)3)   // Task deleted; kept until its blocks are freed
+
+/**
+ * @brief Heap counters of one task.
+ *
+ * Members:
+ * - tcb         : Key (TCB address), NULL if never used, or an ALLOC_KEY_* marker.
+ * - live_bytes  : Bytes allocated by the task and not yet freed.
+ * - live_blocks : Blocks allocated by the task and not yet freed.
+ * - alloc_count : Allocations made by the task (cumulative, wraps).
+ * - alloc_bytes : Bytes allocated by the task (cumulative, wraps).
+ */
+typedef struct
+{
+    void *tcb;
+    uint32_t live_bytes;
+    uint32_t live_blocks;
+    uint32_t alloc_count;
+    uint32_t alloc_bytes;
+} AllocTaskEntry;
+
+/**
+ * @brief Record of one live allocation.
+ *
+ * Members:
+ * - ptr   : Key (block address), NULL if never used, or an ALLOC_KEY_* marker.
+ * - size  : Requested size in bytes.
+ * - owner : Index of the allocating task's entry in s_tasks.
+ */
+typedef struct
+{
+    void *ptr;
+    uint32_t size;
+    uint16_t owner;
+} AllocBlockEntry;
+
+static AllocTaskEntry s_tasks[ALLOC_TASK_TABLE_SIZE];
+static AllocBlockEntry s_blocks[ALLOC_BLOCK_TABLE_SIZE];
+static uint32_t s_untracked_allocs = 0;
+
+// ============================================================================
+// Internal Helper Functions
+// ============================================================================
+
+/**
+ * @brief Hash an address to its home entry.
+ *
+ * @param key TCB or block address.
+ * @param size Table size.
+ * @return Home entry index.
+ */
+static inline IRAM_ATTR uint32_t _alloc_slot(const void *key, uint32_t size)
+{
+    // Same Fibonacci hash as sysmon_index.c
+    uint32_t h = (uint32_t)((uintptr_t)key >> 2);
+    h *= 2654435761U;
+    return (h ^ (h >> 16)) % size;
+}
+
+/**
+ * @brief Find the entry of a task, optionally claiming one for it.
+ *
+ * @param tcb TCB address.
+ * @param insert Claim a free entry if the task has none.
+ * @return Entry, or NULL if not found (or the table is full).
+ *
+ * Only the hooks of the task itself insert its key, so a key is never
+ * inserted twice; claims of different keys racing for the same entry are
+ * resolved by compare-and-swap. An exited task's entry is reused once its
+ * last block was freed.
+ */
+static IRAM_ATTR AllocTaskEntry *_alloc_task_entry(void *tcb, bool insert)
+{
+    uint32_t home = _alloc_slot(tcb, ALLOC_TASK_TABLE_SIZE);
+
+    for (;;)
+    {
+        AllocTaskEntry *candidate = NULL;
+        for (uint32_t i = 0; i < ALLOC_TASK_TABLE_SIZE; i++)
+        {
+            AllocTaskEntry *entry = &s_tasks[(home + i) % ALLOC_TASK_TABLE_SIZE];
+            void *key = __atomic_load_n(&entry->tcb, __ATOMIC_ACQUIRE);
+            if (key == tcb)
+            {
+                return entry;
+            }
+            if (candidate == NULL &&
+                (key == ALLOC_KEY_FREED ||
+                 (key == ALLOC_KEY_EXITED && __atomic_load_n(&entry->live_blocks, __ATOMIC_RELAXED) == 0U)))
+            {
+                candidate = entry;
+            }
+            if (key == NULL)
+            {
+                // End of the probe chain
+                if (candidate == NULL)
+                {
+                    candidate = entry;
+                }
+                break;
+            }
+        }
+
+        if (!insert || candidate == NULL)
+        {
+            return NULL;
+        }
+
+        void *expected = __atomic_load_n(&candidate->tcb, __ATOMIC_RELAXED);
+        if ((expected == NULL || expected == ALLOC_KEY_FREED || expected == ALLOC_KEY_EXITED) &&
+            __atomic_compare_exchange_n(&candidate->tcb, &expected, ALLOC_KEY_CLAIMING,
+                                        false, __ATOMIC_ACQUIRE, __ATOMIC_RELAXED))
+        {
+            // A stray free of an exited task's block may still land here; live counters restart at 0
+            __atomic_store_n(&candidate->live_bytes, 0U, __ATOMIC_RELAXED);
+            __atomic_store_n(&candidate->live_blocks, 0U, __ATOMIC_RELAXED);
+            candidate->alloc_count = 0U;
+            candidate->alloc_bytes = 0U;
+            __atomic_store_n(&candidate->tcb, tcb, __ATOMIC_RELEASE);
+            return candidate;
+        }
+        // Lost the entry to another claim; probe again
+    }
+}
+
+/**
+ * @brief Remove a block record and take its bytes off its owner.
+ *
+ * @param ptr Block address.
+ * @return true if the block was recorded.
+ */
+static IRAM_ATTR bool _alloc_block_remove(void *ptr)
+{
+    uint32_t home = _alloc_slot(ptr, ALLOC_BLOCK_TABLE_SIZE);
+    for (uint32_t i = 0; i < ALLOC_BLOCK_PROBES; i++)
+    {
+        AllocBlockEntry *block = &s_blocks[(home + i) % ALLOC_BLOCK_TABLE_SIZE];
+        void *expected = ptr;
+        if (__atomic_load_n(&block->ptr, __ATOMIC_ACQUIRE) == ptr &&
+            __atomic_compare_exchange_n(&block->ptr, &expected, ALLOC_KEY_CLAIMING,
+                                        false, __ATOMIC_ACQUIRE, __ATOMIC_RELAXED))
+        {
+            AllocTaskEntry *owner = &s_tasks[block->owner];
+            uint32_t size = block->size;
+            __atomic_store_n(&block->ptr, ALLOC_KEY_FREED, __ATOMIC_RELEASE);
+            __atomic_fetch_sub(&owner->live_bytes, size, __ATOMIC_RELAXED);
+            __atomic_fetch_sub(&owner->live_blocks, 1U, __ATOMIC_RELAXED);
+            return true;
+        }
+    }
+    return false;
+}
+
+/**
+ * @brief Record a block for its owner.
+ *
+ * @param ptr Block address.
+ * @param size Requested size in bytes.
+ * @param owner Owner entry index.
+ * @return true if the block was recorded, false if its probe window is full.
+ */
+static IRAM_ATTR bool _alloc_block_insert(void *ptr, uint32_t size, uint16_t owner)
+{
+    uint32_t home = _alloc_slot(ptr, ALLOC_BLOCK_TABLE_SIZE);
+    for (uint32_t i = 0; i < ALLOC_BLOCK_PROBES; i++)
+    {
+        AllocBlockEntry *block = &s_blocks[(home + i) % ALLOC_BLOCK_TABLE_SIZE];
+        void *expected = __atomic_load_n(&block->ptr, __ATOMIC_RELAXED);
+        if ((expected == NULL || expected == ALLOC_KEY_FREED) &&
+            __atomic_compare_exchange_n(&block->ptr, &expected, ALLOC_KEY_CLAIMING,
+                                        false, __ATOMIC_ACQUIRE, __ATOMIC_RELAXED))
+        {
+            block->size  = size;
+            block->owner = owner;
+            __atomic_store_n(&block->ptr, ptr, __ATOMIC_RELEASE);
+            return true;
+        }
+    }
+    return false;
+}
+
+// ============================================================================
+// Heap Hooks (malloc/free context)
+// ============================================================================
+
+/**
+ * @brief Heap hook: a block was allocated (called by heap_caps_malloc() and friends).
+ *
+ * @param ptr Allocated block.
+ * @param size Requested size in bytes.
+ * @param caps Capabilities requested (unused).
+ */
+void IRAM_ATTR esp_heap_trace_alloc_hook(void *ptr, size_t size, uint32_t caps)
+{
+    (void)caps;
+    if (ptr == NULL)
+    {
+        return;
+    }
+
+    // An in-place realloc() reports the same block again: replace its record
+    _alloc_block_remove(ptr);
+
+    void *tcb = xPortInIsrContext() ? NULL : (void *)xTaskGetCurrentTaskHandle();
+    AllocTaskEntry *entry = (tcb != NULL) ? _alloc_task_entry(tcb, true) : NULL;
+    if (entry == NULL)
+    {
+        __atomic_fetch_add(&s_untracked_allocs, 1U, __ATOMIC_RELAXED);
+        return;
+    }
+
+    // Only the task itself writes its cumulative counters
+    entry->alloc_count++;
+    entry->alloc_bytes += (uint32_t)size;
+
+    // Count the bytes before the record is visible, so a racing free never takes them below 0
+    __atomic_fetch_add(&entry->live_bytes, (uint32_t)size, __ATOMIC_RELAXED);
+    __atomic_fetch_add(&entry->live_blocks, 1U, __ATOMIC_RELAXED);
+    if (!_alloc_block_insert(ptr, (uint32_t)size, (uint16_t)(entry - s_tasks)))
+    {
+        __atomic_fetch_sub(&entry->live_bytes, (uint32_t)size, __ATOMIC_RELAXED);
+        __atomic_fetch_sub(&entry->live_blocks, 1U, __ATOMIC_RELAXED);
+        __atomic_fetch_add(&s_untracked_allocs, 1U, __ATOMIC_RELAXED);
+    }
+}
+
+/**
+ * @brief Heap hook: a block was freed (called by heap_caps_free()).
+ *
+ * @param ptr Freed block.
+ */
+void IRAM_ATTR esp_heap_trace_free_hook(void *ptr)
+{
+    if (ptr != NULL)
+    {
+        _alloc_block_remove(ptr);
+    }
+}
+
+#endif  // CONFIG_SYSMON_TASK_HEAP_ACCOUNTING
+
+// ============================================================================
+// Public API Functions
+// ============================================================================
+
+/**
+ * @brief Read the heap counters of a task (sampler task only).
+ *
+ * @param handle Task handle.
+ * @param out Output counters.
+ * @return true if the task has allocated since its entry was claimed, false if
+ *         it has not, the task table is full or accounting is disabled.
+ */
+bool _alloc_read_task(TaskHandle_t handle, sysmon_alloc_stats_t *out)
+{
+#if CONFIG_SYSMON_TASK_HEAP_ACCOUNTING
+    AllocTaskEntry *entry = _alloc_task_entry((void *)handle, false);
+    if (entry == NULL)
+    {
+        return false;
+    }
+    out->live_bytes  = __atomic_load_n(&entry->live_bytes, __ATOMIC_RELAXED);
+    out->live_blocks = __atomic_load_n(&entry->live_blocks, __ATOMIC_RELAXED);
+    out->alloc_count = __atomic_load_n(&entry->alloc_count, __ATOMIC_RELAXED);
+    out->alloc_bytes = __atomic_load_n(&entry->alloc_bytes, __ATOMIC_RELAXED);
+
+    // A stray free (see the limitations in sysmon_alloc.h) may take the counters below 0
+    if ((int32_t)out->live_bytes < 0 || (int32_t)out->live_blocks < 0)
+    {
+        out->live_bytes  = 0U;
+        out->live_blocks = 0U;
+    }
+    return true;
+#else
+    (void)handle;
+    (void)out;
+    return false;
+#endif
+}
+
+/**
+ * @brief Retire the entry of a deleted task (sampler task only).
+ *
+ * @param handle Handle of the deleted task.
+ */
+void _alloc_task_exited(TaskHandle_t handle)
+{
+#if CONFIG_SYSMON_TASK_HEAP_ACCOUNTING
+    AllocTaskEntry *entry = _alloc_task_entry((void *)handle, false);
+    if (entry != NULL)
+    {
+        void *expected = (void *)handle;
+        __atomic_compare_exchange_n(&entry->tcb, &expected, ALLOC_KEY_EXITED,
+                                    false, __ATOMIC_RELEASE, __ATOMIC_RELAXED);
+    }
+#else
+    (void)handle;
+#endif
+}
+
+/**
+ * @brief Read the totals outside of the live tasks.
+ *
+ * @param out Output totals (all zero if accounting is disabled).
+ */
+void _alloc_read_summary(sysmon_alloc_summary_t *out)
+{
+    out->exited_bytes     = 0U;
+    out->exited_blocks    = 0U;
+    out->untracked_allocs = 0U;
+#if CONFIG_SYSMON_TASK_HEAP_ACCOUNTING
+    for (uint32_t i = 0; i < ALLOC_TASK_TABLE_SIZE; i++)
+    {
+        if (__atomic_load_n(&s_tasks[i].tcb, __ATOMIC_ACQUIRE) == ALLOC_KEY_EXITED)
+        {
+            uint32_t bytes  = __atomic_load_n(&s_tasks[i].live_bytes, __ATOMIC_RELAXED);
+            uint32_t blocks = __atomic_load_n(&s_tasks[i].live_blocks, __ATOMIC_RELAXED);
+            if ((int32_t)bytes > 0 && (int32_t)blocks > 0)
+            {
+                out->exited_bytes  += bytes;
+                out->exited_blocks += blocks;
+            }
+        }
+    }
+    out->untracked_allocs = __atomic_load_n(&s_untracked_allocs, __ATOMIC_RELAXED);
+#endif
+}
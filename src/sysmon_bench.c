@@ -0,0 +1,455 @@
+/**
+ * @file sysmon_bench.c
+ * @brief On-target replay benchmark of the sampler and serialization hot paths.
+ *
+ * This file implements the sweep described in sysmon_bench.h. The synthetic
+ * snapshot is generated once per point and advanced in place between samples;
+ * the writers run into a json_stream_t without a request, which counts the
+ * flushed bytes and sends nothing.
+ */
+
+// Project-specific includes
+#include "sysmon_bench.h"
+#include "sysmon.h"
+#include "sysmon_alloc.h"
+#include "sysmon_history_bin.h"
+#include "sysmon_json.h"
+#include "sysmon_json_stream.h"
+#include "sysmon_metrics.h"
+
+// ESP-IDF includes
+#include "esp_heap_caps.h"
+#include "esp_idf_version.h"
+#include "esp_log.h"
+#include "esp_timer.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+
+// System includes
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+static const char *LOG_TAG = "sysmon_bench";
+
+static const char *const s_writer_names[SYSMON_BENCH_WRITER_COUNT] =
+{
+    [SYSMON_BENCH_TASKS]       = "/tasks",
+    [SYSMON_BENCH_HISTORY]     = "/history",
+    [SYSMON_BENCH_HISTORY_BIN] = "/history.bin",
+    [SYSMON_BENCH_TELEMETRY]   = "/telemetry",
+    [SYSMON_BENCH_METRICS]     = "/metrics",
+    [SYSMON_BENCH_HEAP]        = "/heap",
+};
+
+#if CONFIG_SYSMON_BENCHMARK
+
+// Writer runs averaged per point
+#define BENCH_BUILD_RUNS 4
+
+// One task is deleted and re-created every this many samples
+#define BENCH_CHURN_PERIOD 8
+
+// heap_caps_monitor_local_minimum_free_size_start() appeared in ESP-IDF 5.1
+#if ESP_IDF_VERSION >= ESP_IDF_VERSION_VAL(5, 1, 0)
+#define BENCH_HAS_LOCAL_MINIMUM 1
+#else
+#define BENCH_HAS_LOCAL_MINIMUM 0
+#endif
+
+// Heap the replay draws from (the history arena may live in PSRAM)
+#define BENCH_HEAP_CAPS MALLOC_CAP_8BIT
+
+typedef esp_err_t (*bench_writer_fn_t)(json_stream_t *stream);
+
+static const bench_writer_fn_t s_writers[SYSMON_BENCH_WRITER_COUNT] =
+{
+    [SYSMON_BENCH_TASKS]       = _write_tasks_json,
+    [SYSMON_BENCH_HISTORY]     = _write_history_json,
+    [SYSMON_BENCH_HISTORY_BIN] = _write_history_bin,
+    [SYSMON_BENCH_TELEMETRY]   = _write_telemetry_json,
+    [SYSMON_BENCH_METRICS]     = _write_metrics_text,
+    [SYSMON_BENCH_HEAP]        = _write_heap_json,
+};
+
+static const uint16_t s_sweep[] = { 10, 32, 64, 128, 256 };
+
+/**
+ * @brief Recorded snapshot of one sweep point.
+ *
+ * Members:
+ * - tcbs        : Zeroed TCBs the synthetic handles point at (never scheduled).
+ * - states      : Task states of the next sample.
+ * - names       : Task name storage.
+ * - task_count  : Number of synthetic tasks.
+ * - run_time    : Total runtime counter of the next sample.
+ * - next_number : Next free task number (re-created tasks get a new one).
+ * - rng         : Pseudo-random state for run time and stack figures.
+ * - min_free    : Lowest free heap seen between steps (without a local minimum monitor).
+ */
+typedef struct
+{
+    StaticTask_t *tcbs;
+    TaskStatus_t *states;
+    char (*names)[configMAX_TASK_NAME_LEN];
+    uint16_t task_count;
+    uint32_t run_time;
+    UBaseType_t next_number;
+    uint32_t rng;
+    size_t min_free;
+} BenchReplay;
+
+// ============================================================================
+// Internal Helper Functions
+// ============================================================================
+
+/**
+ * @brief Next pseudo-random value (xorshift32).
+ *
+ * @param replay Replay state.
+ * @return Pseudo-random value.
+ */
+static uint32_t _bench_random(BenchReplay *replay)
+{
+    uint32_t x = replay->rng;
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+    replay->rng = x;
+    return x;
+}
+
+/**
+ * @brief Record the free heap for the peak estimate (without a local minimum monitor).
+ *
+ * @param replay Replay state.
+ */
+static void _bench_track_heap(BenchReplay *replay)
+{
+#if !BENCH_HAS_LOCAL_MINIMUM
+    size_t free_bytes = heap_caps_get_free_size(BENCH_HEAP_CAPS);
+    if (free_bytes < replay->min_free)
+    {
+        replay->min_free = free_bytes;
+    }
+#else
+    (void)replay;
+#endif
+}
+
+/**
+ * @brief Allocate the synthetic snapshot of a sweep point.
+ *
+ * @param replay Replay state to fill.
+ * @param task_count Number of synthetic tasks.
+ * @return true on success, false on allocation failure.
+ */
+static bool _bench_replay_init(BenchReplay *replay, uint16_t task_count)
+{
+    memset(replay, 0, sizeof(*replay));
+    replay->tcbs   = (StaticTask_t *)calloc(task_count, sizeof(StaticTask_t));
+    replay->states = (TaskStatus_t *)calloc(task_count, sizeof(TaskStatus_t));
+    replay->names  = calloc(task_count, sizeof(*replay->names));
+    if (replay->tcbs == NULL || replay->states == NULL || replay->names == NULL)
+    {
+        free(replay->tcbs);
+        free(replay->states);
+        free(replay->names);
+        return false;
+    }
+
+    replay->task_count = task_count;
+    replay->rng        = 0x9E3779B9U ^ task_count;
+    for (uint16_t i = 0; i < task_count; i++)
+    {
+        TaskStatus_t *state = &replay->states[i];
+        snprintf(replay->names[i], sizeof(replay->names[i]), "bench%03u", (unsigned)i);
+        state->xHandle              = (TaskHandle_t)&replay->tcbs[i];
+        state->pcTaskName           = replay->names[i];
+        state->xTaskNumber          = ++replay->next_number;
+        state->eCurrentState        = eBlocked;
+        state->uxBasePriority       = 1U + (i % 20U);
+        state->uxCurrentPriority    = state->uxBasePriority;
+        state->usStackHighWaterMark = (configSTACK_DEPTH_TYPE)(256U + (_bench_random(replay) % 1024U));
+    }
+    return true;
+}
+
+/**
+ * @brief Free the synthetic snapshot of a sweep point.
+ *
+ * @param replay Replay state.
+ */
+static void _bench_replay_free(BenchReplay *replay)
+{
+    free(replay->tcbs);
+    free(replay->states);
+    free(replay->names);
+    memset(replay, 0, sizeof(*replay));
+}
+
+/**
+ * @brief Advance the snapshot to a new sample.
+ *
+ * Every task runs for a pseudo-random share of the sample and its stack
+ * high-water mark drifts. Every BENCH_CHURN_PERIOD samples one task is left
+ * out (deleted) and comes back under a new task number in the next sample.
+ *
+ * @param replay Replay state.
+ * @param sample Sample number (0-based).
+ * @param num_tasks Output: number of states to replay.
+ * @return Task states of the sample (the churned task is moved to the end).
+ */
+static const TaskStatus_t *_bench_replay_step(BenchReplay *replay, uint32_t sample, UBaseType_t *num_tasks)
+{
+    uint32_t sample_ticks = 0U;
+    for (uint16_t i = 0; i < replay->task_count; i++)
+    {
+        TaskStatus_t *state = &replay->states[i];
+        uint32_t ticks = _bench_random(replay) % 2000U;
+        state->ulRunTimeCounter += ticks;
+        sample_ticks += ticks;
+        if ((_bench_random(replay) & 7U) == 0U && state->usStackHighWaterMark > 64U)
+        {
+            state->usStackHighWaterMark--;
+        }
+    }
+    replay->run_time += sample_ticks + 1000U;
+
+    *num_tasks = replay->task_count;
+    if (replay->task_count > 1U && sample > 0U && (sample % BENCH_CHURN_PERIOD) == 0U)
+    {
+        // Swap the churned task to the end and leave it out of this sample
+        uint16_t churned = (uint16_t)((sample / BENCH_CHURN_PERIOD) % replay->task_count);
+        uint16_t last    = (uint16_t)(replay->task_count - 1U);
+        TaskStatus_t swap        = replay->states[churned];
+        replay->states[churned]  = replay->states[last];
+        replay->states[last]     = swap;
+        replay->states[last].xTaskNumber      = ++replay->next_number;
+        replay->states[last].ulRunTimeCounter = 0U;
+        *num_tasks = last;
+    }
+    return replay->states;
+}
+
+/**
+ * @brief Heap counters of the calling task, if the heap hooks record them.
+ *
+ * @param out Output counters (zero if not recorded).
+ * @return true if the counters are measured.
+ */
+static bool _bench_read_allocs(sysmon_alloc_stats_t *out)
+{
+    memset(out, 0, sizeof(*out));
+#if CONFIG_SYSMON_TASK_HEAP_ACCOUNTING
+    // No entry yet means no allocation recorded so far
+    _alloc_read_task(xTaskGetCurrentTaskHandle(), out);
+    return true;
+#else
+    return false;
+#endif
+}
+
+/**
+ * @brief Run every writer on the replayed state.
+ *
+ * @param replay Replay state (heap tracking).
+ * @param builds Output: cost per writer.
+ */
+static void _bench_run_writers(BenchReplay *replay, sysmon_bench_build_t builds[SYSMON_BENCH_WRITER_COUNT])
+{
+    for (int writer = 0; writer < SYSMON_BENCH_WRITER_COUNT; writer++)
+    {
+        sysmon_bench_build_t *build = &builds[writer];
+        int64_t total_us = 0;
+        build->error = ESP_OK;
+        for (int run = 0; run < BENCH_BUILD_RUNS; run++)
+        {
+            // Same per-request chunk buffer as the HTTP handlers
+            char *chunk_buffer = malloc(CONFIG_SYSMON_HTTP_CHUNK_SIZE);
+            if (chunk_buffer == NULL)
+            {
+                build->error = ESP_ERR_NO_MEM;
+                break;
+            }
+
+            json_stream_t stream;
+            json_stream_init(&stream, NULL, chunk_buffer, CONFIG_SYSMON_HTTP_CHUNK_SIZE);
+            int64_t start_us = esp_timer_get_time();
+            esp_err_t err = s_writers[writer](&stream);
+            if (err == ESP_OK)
+            {
+                err = json_stream_finish(&stream);
+            }
+            total_us += esp_timer_get_time() - start_us;
+            _bench_track_heap(replay);
+            free(chunk_buffer);
+
+            build->bytes = (uint32_t)stream.bytes_sent;
+            build->error = err;
+        }
+        build->build_ns = (uint32_t)((total_us * 1000) / BENCH_BUILD_RUNS);
+    }
+}
+
+#endif  // CONFIG_SYSMON_BENCHMARK
+
+// ============================================================================
+// Public API Functions
+// ============================================================================
+
+/**
+ * @brief Replay one sweep point.
+ *
+ * @param task_count Synthetic tasks (1 .. SYSMON_MAX_TRACKED_TASKS).
+ * @param samples Samples to replay (0 for twice the history depth).
+ * @param out Output result.
+ * @return ESP_OK on success, ESP_ERR_INVALID_ARG for a bad task count,
+ *         ESP_ERR_INVALID_STATE while the sampler runs, ESP_ERR_NO_MEM on
+ *         allocation failure, ESP_ERR_NOT_SUPPORTED without CONFIG_SYSMON_BENCHMARK.
+ */
+esp_err_t sysmon_bench_run_point(uint16_t task_count, uint32_t samples, sysmon_bench_result_t *out)
+{
+#if CONFIG_SYSMON_BENCHMARK
+    if (out == NULL || task_count == 0U || task_count > SYSMON_MAX_TRACKED_TASKS)
+    {
+        return ESP_ERR_INVALID_ARG;
+    }
+    memset(out, 0, sizeof(*out));
+
+    BenchReplay replay;
+    if (!_bench_replay_init(&replay, task_count))
+    {
+        return ESP_ERR_NO_MEM;
+    }
+
+    // Discovering hundreds of tasks would otherwise log a line each
+    esp_log_level_t sysmon_level = esp_log_level_get("sysmon");
+    esp_log_level_set("sysmon", ESP_LOG_WARN);
+
+    size_t baseline_free = heap_caps_get_free_size(BENCH_HEAP_CAPS);
+    replay.min_free = baseline_free;
+#if BENCH_HAS_LOCAL_MINIMUM
+    heap_caps_monitor_local_minimum_free_size_start();
+#endif
+
+    esp_err_t err = _sampler_replay_begin();
+    if (err == ESP_OK)
+    {
+        if (samples == 0U)
+        {
+            samples = 2U * (uint32_t)self.history_depth;
+        }
+
+        sysmon_alloc_stats_t allocs_before;
+        sysmon_alloc_stats_t allocs_after;
+        out->allocs_valid = _bench_read_allocs(&allocs_before);
+
+        int64_t total_us = 0;
+        int64_t max_us   = 0;
+        for (uint32_t sample = 0; sample < samples && err == ESP_OK; sample++)
+        {
+            UBaseType_t num_tasks = 0;
+            const TaskStatus_t *states = _bench_replay_step(&replay, sample, &num_tasks);
+
+            int64_t start_us = esp_timer_get_time();
+            if (!_sampler_replay_sample(states, num_tasks, replay.run_time))
+            {
+                err = ESP_ERR_NO_MEM;
+            }
+            int64_t elapsed_us = esp_timer_get_time() - start_us;
+            total_us += elapsed_us;
+            max_us    = (elapsed_us > max_us) ? elapsed_us : max_us;
+            _bench_track_heap(&replay);
+        }
+
+        _bench_read_allocs(&allocs_after);
+        out->task_count     = task_count;
+        out->samples        = samples;
+        out->sample_ns      = (uint32_t)((total_us * 1000) / samples);
+        out->sample_max_ns  = (uint32_t)(max_us * 1000);
+        out->alloc_count    = allocs_after.alloc_count - allocs_before.alloc_count;
+        out->alloc_bytes    = allocs_after.alloc_bytes - allocs_before.alloc_bytes;
+        size_t replay_free  = heap_caps_get_free_size(BENCH_HEAP_CAPS);
+        out->retained_bytes = (baseline_free > replay_free) ? (uint32_t)(baseline_free - replay_free) : 0U;
+
+        if (err == ESP_OK)
+        {
+            _bench_run_writers(&replay, out->builds);
+        }
+        _sampler_replay_end();
+    }
+
+#if BENCH_HAS_LOCAL_MINIMUM
+    replay.min_free = heap_caps_get_minimum_free_size(BENCH_HEAP_CAPS);
+    heap_caps_monitor_local_minimum_free_size_stop();
+#endif
+    out->peak_bytes = (baseline_free > replay.min_free) ? (uint32_t)(baseline_free - replay.min_free) : 0U;
+
+    esp_log_level_set("sysmon", sysmon_level);
+    _bench_replay_free(&replay);
+    return err;
+#else
+    (void)task_count;
+    (void)samples;
+    (void)out;
+    return ESP_ERR_NOT_SUPPORTED;
+#endif
+}
+
+/**
+ * @brief Replay the default sweep (10, 32, 64, 128 and 256 tasks) and log a report.
+ *
+ * @return ESP_OK if every point ran, error code of the first failing point otherwise.
+ */
+esp_err_t sysmon_bench_run(void)
+{
+#if CONFIG_SYSMON_BENCHMARK
+    sysmon_bench_result_t result;
+    for (size_t point = 0; point < sizeof(s_sweep) / sizeof(s_sweep[0]); point++)
+    {
+        esp_err_t err = sysmon_bench_run_point(s_sweep[point], 0U, &result);
+        if (err != ESP_OK)
+        {
+            ESP_LOGE(LOG_TAG, "%u tasks: replay failed: %s (0x%x)",
+                     (unsigned)s_sweep[point], esp_err_to_name(err), err);
+            return err;
+        }
+
+        ESP_LOGI(LOG_TAG, "%3u tasks, %u samples: %u ns/sample (max %u), retained %u B, peak %u B",
+                 (unsigned)result.task_count, (unsigned)result.samples, (unsigned)result.sample_ns,
+                 (unsigned)result.sample_max_ns, (unsigned)result.retained_bytes, (unsigned)result.peak_bytes);
+        if (result.allocs_valid)
+        {
+            ESP_LOGI(LOG_TAG, "    %u allocs/sample, %u B/sample",
+                     (unsigned)(result.alloc_count / result.samples), (unsigned)(result.alloc_bytes / result.samples));
+        }
+        for (int writer = 0; writer < SYSMON_BENCH_WRITER_COUNT; writer++)
+        {
+            const sysmon_bench_build_t *build = &result.builds[writer];
+            ESP_LOGI(LOG_TAG, "    %-13s %8u ns %7u B%s", s_writer_names[writer], (unsigned)build->build_ns,
+                     (unsigned)build->bytes, (build->error == ESP_OK) ? "" : " (failed)");
+        }
+    }
+    return ESP_OK;
+#else
+    return ESP_ERR_NOT_SUPPORTED;
+#endif
+}
+
+/**
+ * @brief Endpoint of a writer, for reports.
+ *
+ * @param writer Writer.
+ * @return URI ("/tasks", "/history", ...).
+ */
+const char *sysmon_bench_writer_name(sysmon_bench_writer_t writer)
+{
+    if ((unsigned)writer >= SYSMON_BENCH_WRITER_COUNT)
+    {
+        return "unknown";
+    }
+    return s_writer_names[writer];
+}
@@ -0,0 +1,819 @@
+/**
+ * @file sysmon_burst.c
+ * @brief High-rate burst capture of run time counters, on demand or on a threshold.
+ *
+ * This file implements the capture described in sysmon_burst.h. The capture
+ * buffer is one preallocated block of uint32_t columns; the esp_timer tick is
+ * its only writer and publishes each sample by advancing the sample count
+ * with release ordering, so /burst.bin can stream a capture that is still
+ * running. Starting a capture and pinning it for a download are serialized
+ * by a short spinlock.
+ */
+
+// Project-specific includes
+#include "sysmon_burst.h"
+#include "sysmon.h"
+#include "sysmon_history_bin.h"
+#include "sysmon_json_stream.h"
+#include "sysmon_snapshot.h"
+#include "sysmon_trace.h"
+#include "sysmon_utils.h"
+
+// ESP-IDF includes
+#include "esp_heap_caps.h"
+#include "esp_http_server.h"
+#include "esp_log.h"
+#include "esp_timer.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+
+// System includes
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#if CONFIG_SYSMON_BURST_CAPTURE
+
+// Logger tag for this module
+static const char *LOG_TAG = "sysmon_burst";
+
+#define SYSMON_BURST_URI "/burst"
+
+// Columns per sample: time, total run time, idle per core, free heap, then the tasks
+#define BURST_SYSTEM_COLUMNS (3 + SYSMON_CORE_COUNT)
+#define BURST_COLUMNS        (BURST_SYSTEM_COLUMNS + CONFIG_SYSMON_BURST_MAX_TASKS)
+
+// Spare task status entries for tasks created between counting and scanning at trigger time
+#define BURST_STATUS_SLACK 4
+
+/**
+ * @brief Capture state.
+ */
+typedef enum
+{
+    BURST_IDLE = 0,     ///< No capture yet
+    BURST_ARMING,       ///< Capture being set up by _burst_trigger()
+    BURST_RUNNING,      ///< Timer running
+    BURST_DONE          ///< Capture complete, kept until the next one
+} BurstState;
+
+/**
+ * @brief Task tracked by a capture.
+ *
+ * Members:
+ * - handle        : Task handle (from the task scan at trigger time).
+ * - prev_run_time : Run time counter at the previous tick.
+ * - key           : Task key, as used by the JSON endpoints.
+ */
+typedef struct
+{
+    TaskHandle_t handle;
+    uint32_t prev_run_time;
+    char key[32];
+} BurstTask;
+
+/**
+ * @brief Burst capture module state.
+ *
+ * Members:
+ * - block        : Column storage (BURST_COLUMNS columns of CONFIG_SYSMON_BURST_SAMPLES).
+ * - time_us      : End of each slice, from start_us.
+ * - total        : Total run time of each slice.
+ * - idle         : Idle run time of each slice, per core.
+ * - dram_free    : Free internal heap at each tick.
+ * - task_run     : Run time of each slice, per tracked task.
+ * - tasks        : Tracked tasks.
+ * - task_count   : Number of tracked tasks.
+ * - idle_handles : Idle task of each core.
+ * - prev_total   : Total run time counter at the previous tick.
+ * - prev_idle    : Idle run time counters at the previous tick.
+ * - generation   : Task generation (see _trace_task_generation()) read before the task scan at the start.
+ * - timer        : Periodic capture timer.
+ * - start_us     : esp_timer_get_time() when the capture started.
+ * - sequence     : Latest sampler sample when the capture started.
+ * - trigger      : What started the capture.
+ * - triggers     : Number of captures started since boot.
+ * - count        : Samples recorded (written by the tick with release ordering).
+ * - task_samples : Samples with task columns (stops growing if the task set changed).
+ * - state        : Capture state (under s_burst_lock).
+ * - readers      : Downloads in progress (under s_burst_lock).
+ * - ticking      : A tick is recording a sample (under s_burst_lock).
+ * - stopping     : _burst_stop() is waiting for the timer; ticks return at once (under s_burst_lock).
+ * - cpu_armed    : CPU threshold may trigger (sampler task only).
+ * - dram_armed   : Free heap threshold may trigger (sampler task only).
+ */
+typedef struct
+{
+    uint32_t *block;
+    uint32_t *time_us;
+    uint32_t *total;
+    uint32_t *idle[SYSMON_CORE_COUNT];
+    uint32_t *dram_free;
+    uint32_t *task_run[CONFIG_SYSMON_BURST_MAX_TASKS];
+    BurstTask tasks[CONFIG_SYSMON_BURST_MAX_TASKS];
+    int task_count;
+    TaskHandle_t idle_handles[SYSMON_CORE_COUNT];
+    uint32_t prev_total;
+    uint32_t prev_idle[SYSMON_CORE_COUNT];
+    uint32_t generation;
+    esp_timer_handle_t timer;
+    int64_t start_us;
+    uint32_t sequence;
+    sysmon_burst_trigger_t trigger;
+    uint32_t triggers;
+    uint32_t count;
+    uint32_t task_samples;
+    BurstState state;
+    int readers;
+    bool ticking;
+    bool stopping;
+    bool cpu_armed;
+    bool dram_armed;
+} BurstCapture;
+
+static BurstCapture s_burst;
+static portMUX_TYPE s_burst_lock = portMUX_INITIALIZER_UNLOCKED;
+#endif
+
+// ============================================================================
+// Internal Helper Functions
+// ============================================================================
+
+#if CONFIG_SYSMON_BURST_CAPTURE
+/**
+ * @brief JSON name of a trigger.
+ *
+ * @param trigger Trigger.
+ * @return "http", "cpu" or "dramFree".
+ */
+static const char *_burst_trigger_name(sysmon_burst_trigger_t trigger)
+{
+    switch (trigger)
+    {
+        case SYSMON_BURST_TRIGGER_CPU:       return "cpu";
+        case SYSMON_BURST_TRIGGER_DRAM_FREE: return "dramFree";
+        default:                             return "http";
+    }
+}
+
+/**
+ * @brief Record one burst sample (from _burst_tick()).
+ *
+ * Every counter is read into locals first. A task created or deleted during the
+ * reads (the task generation changed) may have had its freed TCB read on the
+ * other core, so the tick is dropped and the next one records sample i instead.
+ */
+static void _burst_record(void)
+{
+    uint32_t i = s_burst.count;
+    if (i >= CONFIG_SYSMON_BURST_SAMPLES)
+    {
+        return;
+    }
+
+    uint32_t tick_generation = 0U;
+    bool tracing = _trace_task_generation(&tick_generation);
+
+    uint32_t total = (uint32_t)portGET_RUN_TIME_COUNTER_VALUE();
+    uint32_t idle[SYSMON_CORE_COUNT];
+    for (int core = 0; core < SYSMON_CORE_COUNT; core++)
+    {
+        idle[core] = ulTaskGetRunTimeCounter(s_burst.idle_handles[core]);
+    }
+
+    // The tracked handles are only valid while the generation still matches the one of the
+    // scan at trigger time; once it changed, the task columns stop at the previous sample
+    uint32_t run_time[CONFIG_SYSMON_BURST_MAX_TASKS];
+    bool tasks_valid = (s_burst.task_samples == i);
+    if (tasks_valid)
+    {
+        vTaskSuspendAll();
+        for (int t = 0; t < s_burst.task_count && tasks_valid; t++)
+        {
+            tasks_valid = _trace_task_run_time(s_burst.tasks[t].handle, s_burst.generation, &run_time[t]);
+        }
+        xTaskResumeAll();
+    }
+
+    uint32_t generation = 0U;
+    if (tracing && _trace_task_generation(&generation) && generation != tick_generation)
+    {
+        return;
+    }
+
+    s_burst.time_us[i]  = (uint32_t)(esp_timer_get_time() - s_burst.start_us);
+    s_burst.total[i]    = total - s_burst.prev_total;
+    s_burst.prev_total  = total;
+    for (int core = 0; core < SYSMON_CORE_COUNT; core++)
+    {
+        s_burst.idle[core][i]   = idle[core] - s_burst.prev_idle[core];
+        s_burst.prev_idle[core] = idle[core];
+    }
+    s_burst.dram_free[i] = (uint32_t)heap_caps_get_free_size(MALLOC_CAP_INTERNAL);
+    if (tasks_valid)
+    {
+        for (int t = 0; t < s_burst.task_count; t++)
+        {
+            BurstTask *task = &s_burst.tasks[t];
+            s_burst.task_run[t][i] = run_time[t] - task->prev_run_time;
+            task->prev_run_time    = run_time[t];
+        }
+        __atomic_store_n(&s_burst.task_samples, i + 1U, __ATOMIC_RELEASE);
+    }
+    __atomic_store_n(&s_burst.count, i + 1U, __ATOMIC_RELEASE);
+
+    if (i + 1U >= CONFIG_SYSMON_BURST_SAMPLES)
+    {
+        esp_timer_stop(s_burst.timer);
+        portENTER_CRITICAL(&s_burst_lock);
+        s_burst.state = BURST_DONE;
+        portEXIT_CRITICAL(&s_burst_lock);
+    }
+}
+
+/**
+ * @brief Record one burst sample (esp_timer task).
+ *
+ * @param arg (unused)
+ */
+static void _burst_tick(void *arg)
+{
+    (void)arg;
+    // esp_timer_stop() does not wait for a running callback, so _burst_stop() waits on ticking
+    portENTER_CRITICAL(&s_burst_lock);
+    bool stopping = s_burst.stopping;
+    s_burst.ticking = !stopping;
+    portEXIT_CRITICAL(&s_burst_lock);
+    if (stopping)
+    {
+        return;
+    }
+    _burst_record();
+    portENTER_CRITICAL(&s_burst_lock);
+    s_burst.ticking = false;
+    portEXIT_CRITICAL(&s_burst_lock);
+}
+
+/**
+ * @brief Check whether a handle is the idle task of a core.
+ *
+ * @param handle Task handle.
+ * @return true for an idle task.
+ */
+static bool _burst_is_idle_task(TaskHandle_t handle)
+{
+    for (int core = 0; core < SYSMON_CORE_COUNT; core++)
+    {
+        if (handle == s_burst.idle_handles[core])
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
+/**
+ * @brief Find a task of the latest sample in a fresh task scan.
+ *
+ * Only compares handles and names, so a handle of a task deleted since the
+ * sample is never dereferenced; a reused TCB is told apart by its name.
+ *
+ * @param status Task scan (from uxTaskGetSystemState()).
+ * @param num Number of entries in the scan.
+ * @param task Task of the latest sample.
+ * @return Matching scan entry, NULL if the task is gone.
+ */
+static const TaskStatus_t *_burst_find_task(const TaskStatus_t *status, UBaseType_t num,
+                                            const TaskUsageSample *task)
+{
+    for (UBaseType_t s = 0; s < num; s++)
+    {
+        if (status[s].xHandle == task->handle &&
+            strncmp(status[s].pcTaskName, task->task_name, sizeof(task->task_name)) == 0)
+        {
+            return &status[s];
+        }
+    }
+    return NULL;
+}
+
+/**
+ * @brief Pick the busiest tasks of the latest sample that still exist (idle tasks excluded).
+ *
+ * Reads the task metadata through a snapshot view, so it is safe from any task.
+ * The handles of the latest sample may be a whole interval old, so only tasks
+ * found in a fresh task scan are tracked, with their run time counters from
+ * that scan.
+ *
+ * @param status Task scan taken for this capture (from uxTaskGetSystemState()).
+ * @param num Number of entries in the scan.
+ */
+static void _burst_select_tasks(const TaskStatus_t *status, UBaseType_t num)
+{
+    float usage[CONFIG_SYSMON_BURST_MAX_TASKS];
+    TaskUsageSample copy;
+    memset(&copy, 0, sizeof(copy));
+    s_burst.task_count = 0;
+
+    sysmon_view_t view;
+    _snapshot_acquire_view(&view);
+    for (int i = 0; i < view.task_capacity; i++)
+    {
+        if (!_snapshot_read_task(&view, i, &copy, NULL) || copy.consecutive_zero_samples > 0 ||
+            copy.handle == NULL || _burst_is_idle_task(copy.handle))
+        {
+            continue;
+        }
+        const TaskStatus_t *current = _burst_find_task(status, num, &copy);
+        if (current == NULL)
+        {
+            continue;
+        }
+
+        // Fill the table, then replace the least busy task with a busier one
+        int slot = s_burst.task_count;
+        if (slot == CONFIG_SYSMON_BURST_MAX_TASKS)
+        {
+            slot = 0;
+            for (int t = 1; t < CONFIG_SYSMON_BURST_MAX_TASKS; t++)
+            {
+                if (usage[t] < usage[slot])
+                {
+                    slot = t;
+                }
+            }
+            if (copy.usage_percent <= usage[slot])
+            {
+                continue;
+            }
+        }
+        else
+        {
+            s_burst.task_count++;
+        }
+
+        BurstTask *task = &s_burst.tasks[slot];
+        char key_buffer[sizeof(task->key)];
+        const char *key = _get_task_display_key(copy.task_name, copy.name_ordinal, key_buffer, sizeof(key_buffer));
+        task->handle        = copy.handle;
+        task->prev_run_time = current->ulRunTimeCounter;
+        strncpy(task->key, key, sizeof(task->key) - 1);
+        task->key[sizeof(task->key) - 1] = '\0';
+        usage[slot] = copy.usage_percent;
+    }
+    _snapshot_release_view(&view);
+}
+
+/**
+ * @brief Pin the latest capture for a download.
+ *
+ * @return true if a capture exists (release with _burst_release()).
+ */
+static bool _burst_acquire(void)
+{
+    bool pinned = false;
+    portENTER_CRITICAL(&s_burst_lock);
+    if (s_burst.block != NULL && (s_burst.state == BURST_RUNNING || s_burst.state == BURST_DONE))
+    {
+        s_burst.readers++;
+        pinned = true;
+    }
+    portEXIT_CRITICAL(&s_burst_lock);
+    return pinned;
+}
+
+/**
+ * @brief Release a capture pinned by _burst_acquire().
+ */
+static void _burst_release(void)
+{
+    portENTER_CRITICAL(&s_burst_lock);
+    s_burst.readers--;
+    portEXIT_CRITICAL(&s_burst_lock);
+}
+
+/**
+ * @brief Handler for POST /burst: start a capture.
+ *
+ * @param request HTTP request.
+ * @return ESP_OK once the response is sent, error code otherwise.
+ */
+static esp_err_t _burst_handle_post(httpd_req_t *request)
+{
+    esp_err_t err = _burst_trigger(SYSMON_BURST_TRIGGER_HTTP);
+    httpd_resp_set_hdr(request, "Access-Control-Allow-Origin", "*");
+    if (err == ESP_ERR_INVALID_STATE)
+    {
+        httpd_resp_set_status(request, "409 Conflict");
+        httpd_resp_set_type(request, "application/json");
+        return httpd_resp_sendstr(request, "{\"error\":\"capture running or being downloaded\"}");
+    }
+    if (err != ESP_OK)
+    {
+        return httpd_resp_send_500(request);
+    }
+
+    char body[96];
+    snprintf(body, sizeof(body), "{\"state\":\"running\",\"intervalMs\":%d,\"capacity\":%d}",
+             CONFIG_SYSMON_BURST_INTERVAL_MS, CONFIG_SYSMON_BURST_SAMPLES);
+    httpd_resp_set_status(request, "202 Accepted");
+    httpd_resp_set_type(request, "application/json");
+    return httpd_resp_sendstr(request, body);
+}
+#endif  // CONFIG_SYSMON_BURST_CAPTURE
+
+// ============================================================================
+// Public API Functions
+// ============================================================================
+
+/**
+ * @brief Allocate the capture buffer and create the capture timer.
+ *
+ * @return ESP_OK on success (or if burst capture is disabled or already set up), error code otherwise.
+ */
+esp_err_t _burst_start(void)
+{
+#if CONFIG_SYSMON_BURST_CAPTURE
+    if (s_burst.block != NULL)
+    {
+        return ESP_OK;
+    }
+
+    size_t size = sizeof(uint32_t) * BURST_COLUMNS * CONFIG_SYSMON_BURST_SAMPLES;
+#if CONFIG_SYSMON_HISTORY_IN_PSRAM
+    uint32_t *block = (uint32_t *)heap_caps_malloc_prefer(size, 2, MALLOC_CAP_SPIRAM | MALLOC_CAP_8BIT,
+                                                          MALLOC_CAP_8BIT);
+#else
+    uint32_t *block = (uint32_t *)heap_caps_malloc(size, MALLOC_CAP_8BIT);
+#endif
+    if (block == NULL)
+    {
+        ESP_LOGE(LOG_TAG, "Failed to allocate %u byte capture buffer", (unsigned)size);
+        return ESP_ERR_NO_MEM;
+    }
+
+    const esp_timer_create_args_t timer_args =
+    {
+        .callback        = _burst_tick,
+        .arg             = NULL,
+        .dispatch_method = ESP_TIMER_TASK,
+        .name            = "sysmon_burst"
+    };
+    esp_err_t err = esp_timer_create(&timer_args, &s_burst.timer);
+    if (err != ESP_OK)
+    {
+        heap_caps_free(block);
+        return err;
+    }
+
+    uint32_t *column = block;
+    s_burst.time_us = column;
+    column += CONFIG_SYSMON_BURST_SAMPLES;
+    s_burst.total = column;
+    column += CONFIG_SYSMON_BURST_SAMPLES;
+    for (int core = 0; core < SYSMON_CORE_COUNT; core++)
+    {
+        s_burst.idle[core] = column;
+        column += CONFIG_SYSMON_BURST_SAMPLES;
+        s_burst.idle_handles[core] = xTaskGetIdleTaskHandleForCore(core);
+    }
+    s_burst.dram_free = column;
+    column += CONFIG_SYSMON_BURST_SAMPLES;
+    for (int t = 0; t < CONFIG_SYSMON_BURST_MAX_TASKS; t++)
+    {
+        s_burst.task_run[t] = column;
+        column += CONFIG_SYSMON_BURST_SAMPLES;
+    }
+
+    s_burst.cpu_armed  = true;
+    s_burst.dram_armed = true;
+    portENTER_CRITICAL(&s_burst_lock);
+    s_burst.block = block;
+    s_burst.state = BURST_IDLE;
+    portEXIT_CRITICAL(&s_burst_lock);
+
+    ESP_LOGI(LOG_TAG, "Burst capture ready: %d samples every %d ms, %u bytes",
+             CONFIG_SYSMON_BURST_SAMPLES, CONFIG_SYSMON_BURST_INTERVAL_MS, (unsigned)size);
+    return ESP_OK;
+#else
+    return ESP_OK;
+#endif
+}
+
+/**
+ * @brief Stop a running capture and free the capture buffer.
+ *
+ * Waits for a tick already in progress to return before the buffer is freed.
+ * Call after the HTTP server is stopped.
+ */
+void _burst_stop(void)
+{
+#if CONFIG_SYSMON_BURST_CAPTURE
+    if (s_burst.timer != NULL)
+    {
+        portENTER_CRITICAL(&s_burst_lock);
+        s_burst.stopping = true;
+        portEXIT_CRITICAL(&s_burst_lock);
+        esp_timer_stop(s_burst.timer);
+        
+        // A tick already running keeps writing into the block until it returns
+        for (;;)
+        {
+            portENTER_CRITICAL(&s_burst_lock);
+            bool ticking = s_burst.ticking;
+            portEXIT_CRITICAL(&s_burst_lock);
+            if (!ticking)
+            {
+                break;
+            }
+            vTaskDelay(1);
+        }
+        esp_timer_delete(s_burst.timer);
+        s_burst.timer = NULL;
+    }
+
+    portENTER_CRITICAL(&s_burst_lock);
+    uint32_t *block = s_burst.block;
+    s_burst.block    = NULL;
+    s_burst.state    = BURST_IDLE;
+    s_burst.stopping = false;
+    portEXIT_CRITICAL(&s_burst_lock);
+    heap_caps_free(block);
+#endif
+}
+
+/**
+ * @brief Start a capture.
+ *
+ * @param trigger What started it.
+ * @return ESP_OK if the capture started, ESP_ERR_INVALID_STATE while a capture
+ *         runs or is downloaded, ESP_ERR_NOT_SUPPORTED if burst capture is disabled.
+ */
+esp_err_t _burst_trigger(sysmon_burst_trigger_t trigger)
+{
+#if CONFIG_SYSMON_BURST_CAPTURE
+    portENTER_CRITICAL(&s_burst_lock);
+    bool busy = (s_burst.block == NULL) || s_burst.state == BURST_ARMING ||
+                s_burst.state == BURST_RUNNING || s_burst.readers > 0;
+    if (!busy)
+    {
+        s_burst.state = BURST_ARMING;
+    }
+    portEXIT_CRITICAL(&s_burst_lock);
+    if (busy)
+    {
+        return ESP_ERR_INVALID_STATE;
+    }
+
+    // Only this caller touches the capture until the timer starts. The task columns need
+    // the task generation to validate their handles, so without trace hooks there are none.
+    s_burst.task_count = 0;
+    if (_trace_task_generation(&s_burst.generation))
+    {
+        UBaseType_t capacity = uxTaskGetNumberOfTasks() + BURST_STATUS_SLACK;
+        TaskStatus_t *status = (TaskStatus_t *)malloc(sizeof(TaskStatus_t) * capacity);
+        if (status != NULL)
+        {
+            UBaseType_t num = uxTaskGetSystemState(status, capacity, NULL);
+            _burst_select_tasks(status, num);
+            free(status);
+        }
+        else
+        {
+            ESP_LOGW(LOG_TAG, "No memory for the task scan, capturing system columns only");
+        }
+    }
+    for (int core = 0; core < SYSMON_CORE_COUNT; core++)
+    {
+        s_burst.prev_idle[core] = ulTaskGetRunTimeCounter(s_burst.idle_handles[core]);
+    }
+    s_burst.prev_total = (uint32_t)portGET_RUN_TIME_COUNTER_VALUE();
+    s_burst.trigger    = trigger;
+    s_burst.sequence   = _snapshot_read_sequence();
+    s_burst.triggers++;
+    __atomic_store_n(&s_burst.count, 0U, __ATOMIC_RELEASE);
+    __atomic_store_n(&s_burst.task_samples, 0U, __ATOMIC_RELEASE);
+    s_burst.start_us = esp_timer_get_time();
+
+    esp_err_t err = esp_timer_start_periodic(s_burst.timer, (uint64_t)CONFIG_SYSMON_BURST_INTERVAL_MS * 1000U);
+    portENTER_CRITICAL(&s_burst_lock);
+    s_burst.state = (err == ESP_OK) ? BURST_RUNNING : BURST_IDLE;
+    portEXIT_CRITICAL(&s_burst_lock);
+
+    if (err != ESP_OK)
+    {
+        ESP_LOGE(LOG_TAG, "esp_timer_start_periodic() failed: %s (0x%x)", esp_err_to_name(err), err);
+        return err;
+    }
+    ESP_LOGI(LOG_TAG, "Burst capture started (%s): %d samples every %d ms, %d tasks",
+             _burst_trigger_name(trigger), CONFIG_SYSMON_BURST_SAMPLES, CONFIG_SYSMON_BURST_INTERVAL_MS,
+             s_burst.task_count);
+    return ESP_OK;
+#else
+    (void)trigger;
+    return ESP_ERR_NOT_SUPPORTED;
+#endif
+}
+
+/**
+ * @brief Start a capture if a threshold was crossed (sampler task only).
+ *
+ * @param overall_usage Overall CPU usage of the sample just published.
+ * @param dram_free Free internal heap of the sample just published.
+ */
+void _burst_check(float overall_usage, uint32_t dram_free)
+{
+#if CONFIG_SYSMON_BURST_CAPTURE
+    // A trigger that finds a capture running stays armed and retries on the next sample
+#if CONFIG_SYSMON_BURST_CPU_THRESHOLD > 0
+    if (overall_usage >= (float)CONFIG_SYSMON_BURST_CPU_THRESHOLD)
+    {
+        if (s_burst.cpu_armed && _burst_trigger(SYSMON_BURST_TRIGGER_CPU) == ESP_OK)
+        {
+            s_burst.cpu_armed = false;
+        }
+    }
+    else
+    {
+        s_burst.cpu_armed = true;
+    }
+#endif
+#if CONFIG_SYSMON_BURST_DRAM_FREE_THRESHOLD > 0
+    if (dram_free <= (uint32_t)CONFIG_SYSMON_BURST_DRAM_FREE_THRESHOLD)
+    {
+        if (s_burst.dram_armed && _burst_trigger(SYSMON_BURST_TRIGGER_DRAM_FREE) == ESP_OK)
+        {
+            s_burst.dram_armed = false;
+        }
+    }
+    else
+    {
+        s_burst.dram_armed = true;
+    }
+#endif
+#endif
+    (void)overall_usage;
+    (void)dram_free;
+}
+
+/**
+ * @brief Register the POST /burst handler.
+ *
+ * @param server Running HTTP server.
+ * @return ESP_OK on success (or if burst capture is disabled), error code otherwise.
+ */
+esp_err_t _burst_register(httpd_handle_t server)
+{
+#if CONFIG_SYSMON_BURST_CAPTURE
+    httpd_uri_t uri_config =
+    {
+        .uri      = SYSMON_BURST_URI,
+        .method   = HTTP_POST,
+        .handler  = _burst_handle_post,
+        .user_ctx = NULL
+    };
+
+    esp_err_t err = httpd_register_uri_handler(server, &uri_config);
+    if (err != ESP_OK)
+    {
+        ESP_LOGE(LOG_TAG, "Failed to register POST %s handler: %s", SYSMON_BURST_URI, esp_err_to_name(err));
+    }
+    return err;
+#else
+    (void)server;
+    return ESP_OK;
+#endif
+}
+
+/**
+ * @brief Number of URI handlers _burst_register() adds (for httpd_config_t.max_uri_handlers).
+ *
+ * @return 1 with burst capture, 0 otherwise.
+ */
+size_t _burst_handler_count(void)
+{
+#if CONFIG_SYSMON_BURST_CAPTURE
+    return 1;
+#else
+    return 0;
+#endif
+}
+
+/**
+ * @brief Write the capture state (/burst).
+ *
+ * @param stream Chunked response writer.
+ * @return ESP_OK on success, or the first error raised while streaming.
+ *
+ * Details:
+ *   - "state" is "idle" before the first capture, then "running" or "done".
+ *   - Thresholds of 0 are disabled.
+ *   - "samples" and "taskSamples" grow while the capture runs.
+ */
+esp_err_t _write_burst_json(json_stream_t *stream)
+{
+    json_stream_object_begin(stream);
+    json_stream_add_bool(stream, "enabled", CONFIG_SYSMON_BURST_CAPTURE);
+#if CONFIG_SYSMON_BURST_CAPTURE
+    json_stream_add_uint(stream, "intervalMs", CONFIG_SYSMON_BURST_INTERVAL_MS);
+    json_stream_add_uint(stream, "capacity", CONFIG_SYSMON_BURST_SAMPLES);
+    json_stream_add_uint(stream, "maxTasks", CONFIG_SYSMON_BURST_MAX_TASKS);
+    json_stream_add_uint(stream, "cpuThreshold", CONFIG_SYSMON_BURST_CPU_THRESHOLD);
+    json_stream_add_uint(stream, "dramFreeThreshold", CONFIG_SYSMON_BURST_DRAM_FREE_THRESHOLD);
+
+    bool pinned = _burst_acquire();
+    portENTER_CRITICAL(&s_burst_lock);
+    BurstState state  = s_burst.state;
+    uint32_t triggers = s_burst.triggers;
+    portEXIT_CRITICAL(&s_burst_lock);
+    json_stream_add_string(stream, "state", (state == BURST_RUNNING || state == BURST_ARMING) ? "running"
+                                            : (state == BURST_DONE) ? "done" : "idle");
+    json_stream_add_uint(stream, "triggers", triggers);
+
+    if (pinned)
+    {
+        uint32_t count        = __atomic_load_n(&s_burst.count, __ATOMIC_ACQUIRE);
+        uint32_t task_samples = __atomic_load_n(&s_burst.task_samples, __ATOMIC_ACQUIRE);
+        json_stream_add_string(stream, "trigger", _burst_trigger_name(s_burst.trigger));
+        json_stream_add_uint64(stream, "startUs", (uint64_t)s_burst.start_us);
+        json_stream_add_uint(stream, "seq", s_burst.sequence);
+        json_stream_add_uint(stream, "samples", count);
+        json_stream_add_uint(stream, "taskSamples", (task_samples < count) ? task_samples : count);
+        json_stream_key(stream, "tasks");
+        json_stream_array_begin(stream);
+        for (int t = 0; t < s_burst.task_count; t++)
+        {
+            json_stream_string(stream, s_burst.tasks[t].key);
+        }
+        json_stream_array_end(stream);
+        _burst_release();
+    }
+#endif
+    json_stream_object_end(stream);
+    return stream->error;
+}
+
+/**
+ * @brief Write the samples of the latest capture (/burst.bin).
+ *
+ * @param stream Chunked response writer (headers already set by the caller).
+ * @return ESP_OK on success, or the first error raised while streaming.
+ *
+ * Details:
+ *   - Without a capture, only the header (0 samples) and the end marker are written.
+ *   - A running capture is written up to its latest sample.
+ */
+esp_err_t _write_burst_bin(json_stream_t *stream)
+{
+    static const char magic[4] = { 'S', 'M', 'B', 'C' };
+    const uint8_t version = SYSMON_BURST_VERSION;
+    json_stream_raw(stream, magic, sizeof(magic));
+    json_stream_raw(stream, (const char *)&version, 1);
+
+#if CONFIG_SYSMON_BURST_CAPTURE
+    if (_burst_acquire())
+    {
+        uint32_t count        = __atomic_load_n(&s_burst.count, __ATOMIC_ACQUIRE);
+        uint32_t task_samples = __atomic_load_n(&s_burst.task_samples, __ATOMIC_ACQUIRE);
+        const uint8_t trigger = (uint8_t)s_burst.trigger;
+        task_samples = (task_samples < count) ? task_samples : count;
+
+        _history_bin_put_varint(stream, count);
+        _history_bin_put_varint(stream, (uint64_t)CONFIG_SYSMON_BURST_INTERVAL_MS * 1000U);
+        json_stream_raw(stream, (const char *)&trigger, 1);
+        _history_bin_put_varint(stream, (uint64_t)s_burst.start_us);
+        _history_bin_put_varint(stream, s_burst.sequence);
+
+        _history_bin_put_uint_array(stream, "burst/timeUs", s_burst.time_us, count);
+        _history_bin_put_uint_array(stream, "burst/total", s_burst.total, count);
+        for (int core = 0; core < SYSMON_CORE_COUNT; core++)
+        {
+            char name[16];
+            snprintf(name, sizeof(name), "burst/idle%d", core);
+            _history_bin_put_uint_array(stream, name, s_burst.idle[core], count);
+        }
+        _history_bin_put_uint_array(stream, "burst/dramFree", s_burst.dram_free, count);
+        for (int t = 0; t < s_burst.task_count && stream->error == ESP_OK; t++)
+        {
+            char name[48];
+            snprintf(name, sizeof(name), "task/%s/runTime", s_burst.tasks[t].key);
+            _history_bin_put_uint_array(stream, name, s_burst.task_run[t], task_samples);
+        }
+        _history_bin_put_varint(stream, 0);
+        _burst_release();
+        return stream->error;
+    }
+#endif
+
+    // No capture: empty header and the end marker
+    const uint8_t trigger = SYSMON_BURST_TRIGGER_HTTP;
+    _history_bin_put_varint(stream, 0);
+    _history_bin_put_varint(stream, (uint64_t)CONFIG_SYSMON_BURST_INTERVAL_MS * 1000U);
+    json_stream_raw(stream, (const char *)&trigger, 1);
+    _history_bin_put_varint(stream, 0);
+    _history_bin_put_varint(stream, 0);
+    _history_bin_put_varint(stream, 0);
+    return stream->error;
+}
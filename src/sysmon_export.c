@@ -0,0 +1,467 @@
+/**
+ * @file sysmon_export.c
+ * @brief Batched UDP export of recent samples to a fleet collector.
+ *
+ * This file implements the exporter described in sysmon_export.h. The
+ * exporter task sleeps on a task notification from the sampler, copies the
+ * samples of each complete batch from the series rings and per-task columns
+ * (like /history?since=), encodes them into its preallocated datagram buffer
+ * and sends the buffer with one sendto().
+ */
+
+// Project-specific includes
+#include "sysmon_export.h"
+#include "sysmon_history.h"
+#include "sysmon_history_bin.h"
+#include "sysmon_json_stream.h"
+#include "sysmon_snapshot.h"
+#include "sysmon_stack.h"
+#include "sysmon_utils.h"
+#include "sysmon.h"
+
+// ESP-IDF includes
+#include "esp_log.h"
+#include "esp_mac.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "lwip/sockets.h"
+
+// System includes
+#include <errno.h>
+#include <inttypes.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#if CONFIG_SYSMON_UDP_EXPORT
+
+// Logger tag for this module
+static const char *LOG_TAG = "sysmon_export";
+
+// Exporter task parameters (below the sampler, which must never wait for it)
+#define EXPORT_TASK_STACK_SIZE 4096
+#define EXPORT_TASK_PRIORITY   3
+
+// Room kept free for the end marker and the omitted task count (two varints)
+#define EXPORT_TRAILER_BYTES 6U
+
+// How long _export_stop() waits for the task to finish its datagram before warning
+#define EXPORT_STOP_TIMEOUT_MS 1000
+#define EXPORT_STOP_POLL_MS    10
+
+// Log one send failure out of this many
+#define EXPORT_FAILURE_LOG_EVERY 100U
+
+static TaskHandle_t volatile s_task = NULL;
+static volatile bool s_stop         = false;
+
+// Owned by the exporter task while it runs
+static int s_socket                  = -1;
+static struct sockaddr_in s_collector;
+static char *s_datagram              = NULL;
+static uint32_t *s_ring_copy         = NULL;
+static TaskUsageSample *s_task_copy  = NULL;
+static uint8_t s_mac[6]              = { 0 };
+static uint32_t s_batch              = 0;
+static uint32_t s_sent_seq           = 0;
+static uint32_t s_send_failures      = 0;
+
+// ============================================================================
+// Internal Helper Functions
+// ============================================================================
+
+/**
+ * @brief Ring index of the first sample of a batch.
+ *
+ * @param write_index Ring write index of the copy.
+ * @param newest Sequence number of the newest sample in the copy.
+ * @param first_seq Sequence number of the first sample of the batch.
+ * @param count Number of samples in the batch.
+ * @return Ring index, or -1 if the batch is not (or no longer) fully in the ring.
+ */
+static int _export_first_index(int write_index, uint32_t newest, uint32_t first_seq, uint32_t count)
+{
+    uint32_t age = newest - first_seq;
+    if (age >= (uint32_t)self.history_depth || age + 1U < count)
+    {
+        return -1;
+    }
+    return (write_index - 1 - (int)age + 2 * self.history_depth) % self.history_depth;
+}
+
+/**
+ * @brief Copy a float ring and write the batch as a column (skipped if it left the ring).
+ *
+ * @param stream Datagram writer.
+ * @param name Column name.
+ * @param ring Ring buffer of self.
+ * @param first_seq Sequence number of the first sample.
+ * @param count Number of samples.
+ */
+static void _export_float_ring(json_stream_t *stream, const char *name, const float *ring,
+                               uint32_t first_seq, uint32_t count)
+{
+    int write_index = 0;
+    uint32_t newest = 0;
+    _snapshot_read_ring(ring, sizeof(float), s_ring_copy, &write_index, &newest);
+    int first = _export_first_index(write_index, newest, first_seq, count);
+    if (first >= 0)
+    {
+        _history_bin_put_float_column(stream, name, (const float *)s_ring_copy, first, count, 1);
+    }
+}
+
+/**
+ * @brief Copy a uint32_t ring and write the batch as a column (skipped if it left the ring).
+ *
+ * @param stream Datagram writer.
+ * @param name Column name.
+ * @param ring Ring buffer of self.
+ * @param first_seq Sequence number of the first sample.
+ * @param count Number of samples.
+ */
+static void _export_uint_ring(json_stream_t *stream, const char *name, const uint32_t *ring,
+                              uint32_t first_seq, uint32_t count)
+{
+    int write_index = 0;
+    uint32_t newest = 0;
+    _snapshot_read_ring(ring, sizeof(uint32_t), s_ring_copy, &write_index, &newest);
+    int first = _export_first_index(write_index, newest, first_seq, count);
+    if (first >= 0)
+    {
+        _history_bin_put_uint_column(stream, name, s_ring_copy, first, count);
+    }
+}
+
+/**
+ * @brief Write the per-task columns that fit into the datagram.
+ *
+ * @param stream Datagram writer.
+ * @param first_seq Sequence number of the first sample.
+ * @param count Number of samples.
+ * @return Number of tasks left out because their columns did not fit.
+ */
+static uint32_t _export_write_tasks(json_stream_t *stream, uint32_t first_seq, uint32_t count)
+{
+    uint32_t omitted = 0U;
+    sysmon_view_t view;
+    _snapshot_acquire_view(&view);
+    for (int i = 0; i < view.task_capacity; i++)
+    {
+        uint32_t newest = 0;
+        if (!_snapshot_read_task(&view, i, s_task_copy, &newest))
+        {
+            continue;
+        }
+        int first = _export_first_index(s_task_copy->write_index, newest, first_seq, count);
+        if (first < 0)
+        {
+            continue;
+        }
+
+        char key_buffer[32];
+        char name[48];
+        const char *key = _get_task_display_key(s_task_copy->task_name, s_task_copy->name_ordinal,
+                                                key_buffer, sizeof(key_buffer));
+        size_t task_start = stream->length;
+
+        snprintf(name, sizeof(name), "task/%s/cpu", key);
+        _history_decode_cpu_column(s_task_copy->usage_percent_history, (float *)s_ring_copy, view.depth);
+        _history_bin_put_float_column(stream, name, (const float *)s_ring_copy, first, count, 1);
+
+        // Stack history only for registered tasks, as in /history
+        if (s_task_copy->stack_size_bytes > 0U)
+        {
+            snprintf(name, sizeof(name), "task/%s/stack", key);
+            _history_decode_stack_column(s_task_copy->stack_usage_bytes_history, s_ring_copy, view.depth);
+            _history_bin_put_uint_column(stream, name, s_ring_copy, first, count);
+        }
+
+        if (stream->error == ESP_ERR_NO_MEM)
+        {
+            // Leave the whole task out; a smaller one may still fit
+            json_stream_rewind(stream, task_start);
+            omitted++;
+        }
+    }
+    _snapshot_release_view(&view);
+    return omitted;
+}
+
+/**
+ * @brief Encode one batch into the datagram buffer.
+ *
+ * @param stream Datagram writer (capacity excludes EXPORT_TRAILER_BYTES).
+ * @param first_seq Sequence number of the first sample.
+ * @param count Number of samples.
+ * @return ESP_OK on success, ESP_ERR_NOT_FOUND if the batch left the ring,
+ *         ESP_ERR_NO_MEM if the system-wide columns do not fit.
+ */
+static esp_err_t _export_encode(json_stream_t *stream, uint32_t first_seq, uint32_t count)
+{
+    int write_index = 0;
+    uint32_t newest = 0;
+
+    // Timestamp of the first sample (the ring copy buffer holds 64-bit elements)
+    int64_t *time_copy = (int64_t *)(void *)s_ring_copy;
+    _snapshot_read_ring(self.sample_time_us, sizeof(int64_t), time_copy, &write_index, &newest);
+    int first = _export_first_index(write_index, newest, first_seq, count);
+    if (first < 0)
+    {
+        return ESP_ERR_NOT_FOUND;
+    }
+
+    // Header
+    static const char magic[4] = { 'S', 'M', 'U', 'D' };
+    const uint8_t version = SYSMON_EXPORT_VERSION;
+    json_stream_raw(stream, magic, sizeof(magic));
+    json_stream_raw(stream, (const char *)&version, 1);
+    json_stream_raw(stream, (const char *)s_mac, sizeof(s_mac));
+    _history_bin_put_varint(stream, first_seq);
+    _history_bin_put_varint(stream, count);
+    _history_bin_put_varint(stream, CONFIG_SYSMON_CPU_SAMPLING_INTERVAL_MS);
+    _history_bin_put_varint(stream, (uint64_t)time_copy[first]);
+
+    // System-wide columns
+    int32_t *int_copy = (int32_t *)s_ring_copy;
+    _snapshot_read_ring(self.sample_jitter_us, sizeof(int32_t), int_copy, &write_index, &newest);
+    first = _export_first_index(write_index, newest, first_seq, count);
+    if (first >= 0)
+    {
+        _history_bin_put_int_column(stream, "sys/jitterUs", int_copy, first, count);
+    }
+    _export_float_ring(stream, "sys/cpu", self.cpu_overall_percent, first_seq, count);
+    for (int core = 0; core < SYSMON_CORE_COUNT; core++)
+    {
+        char name[16];
+        snprintf(name, sizeof(name), "sys/core%d", core);
+        _export_float_ring(stream, name, self.cpu_core_percent[core], first_seq, count);
+    }
+    _export_uint_ring(stream, "sys/dramFree", self.dram_free, first_seq, count);
+    _export_uint_ring(stream, "sys/dramMinFree", self.dram_min_free, first_seq, count);
+    _export_uint_ring(stream, "sys/dramLargest", self.dram_largest_block, first_seq, count);
+    _export_uint_ring(stream, "sys/psramFree", self.psram_free, first_seq, count);
+    if (stream->error != ESP_OK)
+    {
+        return stream->error;
+    }
+
+    uint32_t omitted = _export_write_tasks(stream, first_seq, count);
+
+    // Trailer, into the room kept free for it
+    stream->capacity += EXPORT_TRAILER_BYTES;
+    _history_bin_put_varint(stream, 0);
+    _history_bin_put_varint(stream, omitted);
+    return stream->error;
+}
+
+/**
+ * @brief Encode and send one batch.
+ *
+ * @param first_seq Sequence number of the first sample.
+ * @param count Number of samples.
+ */
+static void _export_send_batch(uint32_t first_seq, uint32_t count)
+{
+    json_stream_t stream;
+    json_stream_init_memory(&stream, s_datagram, CONFIG_SYSMON_UDP_EXPORT_MAX_BYTES - EXPORT_TRAILER_BYTES);
+    esp_err_t err = _export_encode(&stream, first_seq, count);
+    if (err != ESP_OK)
+    {
+        ESP_LOGW(LOG_TAG, "Batch of samples %" PRIu32 "..%" PRIu32 " not exported: %s (0x%x)",
+                 first_seq, first_seq + count - 1U, esp_err_to_name(err), err);
+        return;
+    }
+
+    int sent = sendto(s_socket, s_datagram, stream.length, 0,
+                      (const struct sockaddr *)&s_collector, sizeof(s_collector));
+    if (sent < 0)
+    {
+        if (s_send_failures % EXPORT_FAILURE_LOG_EVERY == 0U)
+        {
+            ESP_LOGW(LOG_TAG, "sendto() failed: errno %d (%" PRIu32 " failures so far)", errno, s_send_failures + 1U);
+        }
+        s_send_failures++;
+    }
+}
+
+/**
+ * @brief Exporter task: send every complete batch when the sampler signals one.
+ *
+ * @param param (unused)
+ */
+static void _export_task(void *param)
+{
+    (void)param;
+
+    while (!s_stop)
+    {
+        ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+        if (s_stop)
+        {
+            break;
+        }
+
+        uint32_t until = _snapshot_read_sequence();
+        if (until < s_sent_seq)
+        {
+            s_sent_seq = until;
+        }
+        if (until - s_sent_seq > (uint32_t)self.history_depth)
+        {
+            ESP_LOGW(LOG_TAG, "Exporter fell behind: samples %" PRIu32 "..%" PRIu32 " lost",
+                     s_sent_seq + 1U, until - (uint32_t)self.history_depth);
+            s_sent_seq = until - (uint32_t)self.history_depth;
+        }
+
+        while (until - s_sent_seq >= s_batch && !s_stop)
+        {
+            _export_send_batch(s_sent_seq + 1U, s_batch);
+            s_sent_seq += s_batch;
+        }
+    }
+
+    s_task = NULL;
+    vTaskDelete(NULL);
+}
+
+/**
+ * @brief Release the exporter's buffers and socket.
+ */
+static void _export_release(void)
+{
+    if (s_socket >= 0)
+    {
+        close(s_socket);
+        s_socket = -1;
+    }
+    free(s_datagram);
+    free(s_ring_copy);
+    free(s_task_copy);
+    s_datagram  = NULL;
+    s_ring_copy = NULL;
+    s_task_copy = NULL;
+}
+
+#endif  // CONFIG_SYSMON_UDP_EXPORT
+
+// ============================================================================
+// Public API Functions
+// ============================================================================
+
+/**
+ * @brief Start the exporter task (after the history arena is allocated).
+ *
+ * @return ESP_OK on success (or if the exporter is disabled or already running), error code otherwise.
+ */
+esp_err_t _export_start(void)
+{
+#if CONFIG_SYSMON_UDP_EXPORT
+    if (s_task != NULL)
+    {
+        return ESP_OK;
+    }
+
+    memset(&s_collector, 0, sizeof(s_collector));
+    s_collector.sin_family = AF_INET;
+    s_collector.sin_port   = htons(CONFIG_SYSMON_UDP_EXPORT_PORT);
+    if (inet_pton(AF_INET, CONFIG_SYSMON_UDP_EXPORT_HOST, &s_collector.sin_addr) != 1)
+    {
+        ESP_LOGE(LOG_TAG, "Invalid collector address \"%s\" (IPv4 address expected)", CONFIG_SYSMON_UDP_EXPORT_HOST);
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    // A batch must still be in the rings when the exporter reads it
+    s_batch = CONFIG_SYSMON_UDP_EXPORT_BATCH;
+    if (s_batch > (uint32_t)self.history_depth)
+    {
+        ESP_LOGW(LOG_TAG, "Export batch limited to the history depth (%d samples)", self.history_depth);
+        s_batch = (uint32_t)self.history_depth;
+    }
+
+    // All buffers up front; the ring copy is sized for the widest ring (64-bit timestamps)
+    s_datagram  = malloc(CONFIG_SYSMON_UDP_EXPORT_MAX_BYTES);
+    s_ring_copy = malloc(sizeof(int64_t) * (size_t)self.history_depth);
+    s_task_copy = _snapshot_alloc_task(SNAPSHOT_COPY_HISTORY);
+    if (s_datagram == NULL || s_ring_copy == NULL || s_task_copy == NULL)
+    {
+        ESP_LOGE(LOG_TAG, "Failed to allocate export buffers");
+        _export_release();
+        return ESP_ERR_NO_MEM;
+    }
+
+    s_socket = socket(AF_INET, SOCK_DGRAM, IPPROTO_IP);
+    if (s_socket < 0)
+    {
+        ESP_LOGE(LOG_TAG, "Failed to create UDP socket: errno %d", errno);
+        _export_release();
+        return ESP_FAIL;
+    }
+
+    esp_read_mac(s_mac, ESP_MAC_WIFI_STA);
+    s_sent_seq      = _snapshot_read_sequence();
+    s_send_failures = 0U;
+    s_stop          = false;
+
+    TaskHandle_t handle = NULL;
+    if (xTaskCreate(_export_task, "sysmon_export", EXPORT_TASK_STACK_SIZE, NULL,
+                    EXPORT_TASK_PRIORITY, &handle) != pdPASS)
+    {
+        ESP_LOGE(LOG_TAG, "Failed to create sysmon_export task");
+        _export_release();
+        return ESP_ERR_NO_MEM;
+    }
+    s_task = handle;
+    sysmon_stack_register(handle, EXPORT_TASK_STACK_SIZE);
+
+    ESP_LOGI(LOG_TAG, "Exporting batches of %" PRIu32 " samples to %s:%d",
+             s_batch, CONFIG_SYSMON_UDP_EXPORT_HOST, CONFIG_SYSMON_UDP_EXPORT_PORT);
+    return ESP_OK;
+#else
+    return ESP_OK;
+#endif
+}
+
+/**
+ * @brief Wake the exporter when a batch is complete (sampler task only).
+ */
+void _export_notify(void)
+{
+#if CONFIG_SYSMON_UDP_EXPORT
+    TaskHandle_t task = s_task;
+    if (task != NULL && _snapshot_read_sequence() % s_batch == 0U)
+    {
+        xTaskNotifyGive(task);
+    }
+#endif
+}
+
+/**
+ * @brief Stop the exporter task and release its buffers and socket (after the sampler stopped).
+ */
+void _export_stop(void)
+{
+#if CONFIG_SYSMON_UDP_EXPORT
+    TaskHandle_t task = s_task;
+    if (task == NULL)
+    {
+        return;
+    }
+
+    // Let the task finish its datagram and exit on its own: it holds a snapshot view while
+    // encoding, which deleting it would leave pinned along with the retired task array
+    s_stop = true;
+    xTaskNotifyGive(task);
+    for (int waited_ms = 0; s_task != NULL; waited_ms += EXPORT_STOP_POLL_MS)
+    {
+        if (waited_ms == EXPORT_STOP_TIMEOUT_MS)
+        {
+            ESP_LOGW(LOG_TAG, "sysmon_export task did not stop in %d ms; still waiting", EXPORT_STOP_TIMEOUT_MS);
+        }
+        vTaskDelay(pdMS_TO_TICKS(EXPORT_STOP_POLL_MS));
+    }
+    _export_release();
+#endif
+}
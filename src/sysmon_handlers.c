@@ -9,26 +9,56 @@
 // Project-specific includes
 #include "sysmon_config.h"
 #include "sysmon_json.h"
+#include "sysmon_json_stream.h"
+#include "sysmon_profile.h"
 #include "sysmon_utils.h"
 #include "sysmon.h"
 
 // ESP-IDF includes
 #include "esp_log.h"
 #include "esp_http_server.h"
-#include "cJSON.h"
 
 // System includes
+#include <stdbool.h>
 #include <stdlib.h>
 #include <string.h>
 
 // Logger tag for this module
 static const char *LOG_TAG = "sysmon_handlers";
 
+// Longest Accept-Encoding / If-None-Match value inspected by the static file handler
+#define STATIC_HEADER_VALUE_MAX 128
+
+/**
+ * @brief Copy a request header value.
+ *
+ * @param request HTTP request object.
+ * @param name Header name.
+ * @param value Buffer for the NUL-terminated value.
+ * @param value_size Size of the value buffer.
+ * @return true if the header is present and fits in the buffer.
+ */
+static bool _get_request_header(httpd_req_t *request, const char *name, char *value, size_t value_size)
+{
+    size_t len = httpd_req_get_hdr_value_len(request, name);
+    if (len == 0 || len >= value_size)
+    {
+        return false;
+    }
+    return httpd_req_get_hdr_value_str(request, name, value, value_size) == ESP_OK;
+}
+
 /**
  * @brief Handler function for static files (internal use only).
  *
  * @param request HTTP request object.
  * @return ESP_OK on success, error code otherwise.
+ *
+ * Details:
+ *   - Serves the build-time gzip variant when the client accepts gzip and it is smaller.
+ *   - Sends a strong ETag per representation with "Cache-Control: no-cache", so a
+ *     reload costs one 304 per file instead of a full transfer.
+ *   - Answers 304 Not Modified when If-None-Match carries the current ETag.
  */
 esp_err_t http_handle_static_file(httpd_req_t *request)
 {
@@ -57,6 +87,14 @@ esp_err_t http_handle_static_file(httpd_req_t *request)
         return httpd_resp_send_500(request);
     }
 
+    // Pick the representation: gzip if the client accepts it and it actually saves bytes
+    char header_value[STATIC_HEADER_VALUE_MAX];
+    size_t gzip_len = (config->gzip_start != NULL) ? (size_t)(config->gzip_end - config->gzip_start) : 0;
+    bool use_gzip = gzip_len > 0 && gzip_len < len &&
+                    _get_request_header(request, "Accept-Encoding", header_value, sizeof(header_value)) &&
+                    strstr(header_value, "gzip") != NULL;
+    const char *etag = use_gzip ? config->etag_gzip : config->etag;
+
     const char *content_type = _get_content_type_from_uri(config->uri);
     httpd_resp_set_type(request, content_type);
     
@@ -64,60 +102,127 @@ esp_err_t http_handle_static_file(httpd_req_t *request)
     httpd_resp_set_hdr(request, "Access-Control-Allow-Origin", "*");
     httpd_resp_set_hdr(request, "Access-Control-Allow-Methods", "GET, OPTIONS");
     httpd_resp_set_hdr(request, "Access-Control-Allow-Headers", "Content-Type");
-    
+
+    // Caching headers (7 headers in total, within the default max_resp_headers of 8)
+    httpd_resp_set_hdr(request, "ETag", etag);
+    httpd_resp_set_hdr(request, "Cache-Control", "no-cache");
+    httpd_resp_set_hdr(request, "Vary", "Accept-Encoding");
+
+    // If-None-Match uses weak comparison, so a W/ prefix or a list of tags still matches
+    if (_get_request_header(request, "If-None-Match", header_value, sizeof(header_value)) &&
+        (strstr(header_value, etag) != NULL || strcmp(header_value, "*") == 0))
+    {
+        httpd_resp_set_status(request, "304 Not Modified");
+        return httpd_resp_send(request, NULL, 0);
+    }
+
+    if (use_gzip)
+    {
+        httpd_resp_set_hdr(request, "Content-Encoding", "gzip");
+        return httpd_resp_send(request, (const char *)config->gzip_start, (ssize_t)gzip_len);
+    }
     return httpd_resp_send(request, (const char *)start, (ssize_t)len);
 }
 
 /**
- * @brief Handler function for JSON endpoints (internal use only).
+ * @brief Stream a JSON (or binary) endpoint response in CONFIG_SYSMON_HTTP_CHUNK_SIZE chunks.
  *
  * @param request HTTP request object.
- * @return ESP_OK on success, HTTP 500 on JSON build failure.
+ * @param config Endpoint configuration with a write_json writer.
+ * @param send_us Output: time spent sending chunks (for self-profiling).
+ * @return ESP_OK on success, error code otherwise.
+ *
+ * Details:
+ *   - Only the chunk buffer is allocated, regardless of response size.
+ *   - Once the first chunk is sent the status line is committed, so later
+ *     failures can only be logged. The response is then left unterminated and
+ *     the error returned, so httpd closes the socket and the client sees a
+ *     truncated body rather than a complete one.
  */
-esp_err_t http_handle_json_endpoint(httpd_req_t *request)
+static esp_err_t _http_stream_json_endpoint(httpd_req_t *request, const json_handler_config_t *config,
+                                            int64_t *send_us)
 {
-    // Get config from user_ctx
-    const json_handler_config_t *config = (const json_handler_config_t *)request->user_ctx;
-    if (config == NULL || config->create_json == NULL)
-    {
-        ESP_LOGE(LOG_TAG, "JSON handler config is NULL");
-        return httpd_resp_send_500(request);
-    }
-
-    cJSON *json_root = config->create_json();
-    if (json_root == NULL)
+    char *chunk_buffer = malloc(CONFIG_SYSMON_HTTP_CHUNK_SIZE);
+    if (chunk_buffer == NULL)
     {
-        ESP_LOGE(LOG_TAG, "Failed to create JSON for %s", config->uri);
+        ESP_LOGE(LOG_TAG, "Failed to allocate %d byte chunk buffer for %s",
+                 CONFIG_SYSMON_HTTP_CHUNK_SIZE, config->uri);
         return httpd_resp_send_500(request);
     }
 
-    // Serialize JSON to string
-    char *json_string = cJSON_Print(json_root);
-    if (json_string == NULL)
-    {
-        ESP_LOGE(LOG_TAG, "Failed to serialize JSON for %s", config->uri);
-        JSON_CLEANUP(json_root);
-        return httpd_resp_send_500(request);
-    }
+    httpd_resp_set_type(request, (config->content_type != NULL) ? config->content_type
+                                                                : "application/json; charset=utf-8");
 
-    // Send JSON response
-    httpd_resp_set_type(request, "application/json; charset=utf-8");
-    
     // Add CORS headers to allow cross-origin requests from other machines
     httpd_resp_set_hdr(request, "Access-Control-Allow-Origin", "*");
     httpd_resp_set_hdr(request, "Access-Control-Allow-Methods", "GET, OPTIONS");
     httpd_resp_set_hdr(request, "Access-Control-Allow-Headers", "Content-Type");
-    
-    esp_err_t result = httpd_resp_send(request, json_string, HTTPD_RESP_USE_STRLEN);
+
+    json_stream_t stream;
+    esp_err_t result = json_stream_init(&stream, request, chunk_buffer, CONFIG_SYSMON_HTTP_CHUNK_SIZE);
+    stream.slice_us = (int64_t)CONFIG_SYSMON_HTTP_BUILD_SLICE_MS * 1000;
+    if (result == ESP_OK)
+    {
+        result = config->write_json(&stream);
+        if (result == ESP_ERR_INVALID_ARG && stream.bytes_sent == 0)
+        {
+            // Writers report unsupported query parameters before writing anything
+            *send_us = stream.send_us;
+            free(chunk_buffer);
+            return httpd_resp_send_err(request, HTTPD_400_BAD_REQUEST, "Invalid query parameter");
+        }
+        if (result != ESP_OK && stream.bytes_sent == 0)
+        {
+            // Nothing sent yet, so a proper error status can still be returned
+            ESP_LOGE(LOG_TAG, "Failed to write JSON for %s: %s (0x%x)",
+                     config->uri, esp_err_to_name(result), result);
+            *send_us = stream.send_us;
+            free(chunk_buffer);
+            return httpd_resp_send_500(request);
+        }
+        if (result != ESP_OK && stream.error == ESP_OK)
+        {
+            // Keep json_stream_finish() from terminating a failed response
+            stream.error = result;
+        }
+        result = json_stream_finish(&stream);
+        *send_us = stream.send_us;
+    }
+
     if (result != ESP_OK)
     {
-        ESP_LOGE(LOG_TAG, "httpd_resp_send() failed for %s: %s (0x%x)", 
+        ESP_LOGE(LOG_TAG, "Streaming JSON failed for %s: %s (0x%x)",
                  config->uri, esp_err_to_name(result), result);
     }
 
-    // Cleanup
-    free(json_string);
-    cJSON_Delete(json_root);
+    free(chunk_buffer);
+    return result;
+}
+
+/**
+ * @brief Handler function for JSON endpoints (internal use only).
+ *
+ * @param request HTTP request object.
+ * @return ESP_OK on success, HTTP 500 on JSON build failure.
+ *
+ * Each response is recorded for self-profiling as the endpoint's build and
+ * send phases (see sysmon_profile.h).
+ */
+esp_err_t http_handle_json_endpoint(httpd_req_t *request)
+{
+    // Get config from user_ctx
+    const json_handler_config_t *config = (const json_handler_config_t *)request->user_ctx;
+    if (config == NULL || config->write_json == NULL)
+    {
+        ESP_LOGE(LOG_TAG, "JSON handler config is NULL");
+        return httpd_resp_send_500(request);
+    }
+
+    sysmon_profile_mark_t mark;
+    _profile_begin(&mark);
+    int64_t send_us = 0;
+    esp_err_t result = _http_stream_json_endpoint(request, config, &send_us);
+    _profile_end_response(config->profile, &mark, send_us);
     return result;
 }
 
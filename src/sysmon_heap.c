@@ -0,0 +1,224 @@
+/**
+ * @file sysmon_heap.c
+ * @brief Per-capability heap statistics and free block size histograms.
+ *
+ * This file implements the rate-limited heap scan described in sysmon_heap.h.
+ * The sampler fills a scratch report while walking the heaps and then copies
+ * it into the published report under a short spinlock, so readers never wait
+ * for a heap walk.
+ */
+
+// Project-specific includes
+#include "sysmon_heap.h"
+#include "sysmon.h"
+
+// ESP-IDF includes
+#include "esp_heap_caps.h"
+#include "esp_idf_version.h"
+#include "esp_timer.h"
+#include "freertos/FreeRTOS.h"
+
+// System includes
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+
+// heap_caps_walk() appeared in ESP-IDF 5.3
+#if ESP_IDF_VERSION >= ESP_IDF_VERSION_VAL(5, 3, 0)
+#define HEAP_HAS_WALK 1
+#else
+#define HEAP_HAS_WALK 0
+#endif
+
+/**
+ * @brief Capability of a report entry.
+ */
+typedef struct
+{
+    uint32_t caps;
+    const char *name;
+} HeapCapsInfo;
+
+static const HeapCapsInfo s_caps_info[SYSMON_HEAP_CAPS_COUNT] =
+{
+    [SYSMON_HEAP_CAPS_INTERNAL] = { MALLOC_CAP_INTERNAL, "internal" },
+    [SYSMON_HEAP_CAPS_DMA]      = { MALLOC_CAP_DMA, "dma" },
+    [SYSMON_HEAP_CAPS_SPIRAM]   = { MALLOC_CAP_SPIRAM, "spiram" },
+    [SYSMON_HEAP_CAPS_32BIT]    = { MALLOC_CAP_32BIT, "32bit" },
+    [SYSMON_HEAP_CAPS_EXEC]     = { MALLOC_CAP_EXEC, "exec" },
+};
+
+#if CONFIG_SYSMON_HEAP_CAPS_INTERVAL > 0
+static sysmon_heap_report_t s_scratch;    // Sampler task only
+static sysmon_heap_report_t s_report;     // Published copy, under s_heap_lock
+static portMUX_TYPE s_heap_lock = portMUX_INITIALIZER_UNLOCKED;
+#endif
+
+// ============================================================================
+// Internal Helper Functions
+// ============================================================================
+
+#if CONFIG_SYSMON_HEAP_CAPS_INTERVAL > 0
+/**
+ * @brief Histogram bucket of a free block size.
+ *
+ * @param size Block size in bytes.
+ * @return Bucket index (see SYSMON_HEAP_HISTOGRAM_BUCKETS).
+ */
+static int _heap_bucket(size_t size)
+{
+    if (size < 32U)
+    {
+        return 0;
+    }
+    int bucket = (31 - __builtin_clz((uint32_t)size)) - 4;
+    return (bucket < SYSMON_HEAP_HISTOGRAM_BUCKETS) ? bucket : (SYSMON_HEAP_HISTOGRAM_BUCKETS - 1);
+}
+
+#if HEAP_HAS_WALK
+/**
+ * @brief heap_caps_walk() callback: count a free block (runs with the heap locked).
+ *
+ * @param heap_info Heap being walked (unused).
+ * @param block_info Current block.
+ * @param user_data Histogram to update.
+ * @return true to continue the walk.
+ */
+static bool _heap_walk_block(walker_heap_into_t heap_info, walker_block_info_t block_info, void *user_data)
+{
+    (void)heap_info;
+    if (!block_info.used)
+    {
+        uint32_t *histogram = (uint32_t *)user_data;
+        histogram[_heap_bucket(block_info.size)]++;
+    }
+    return true;
+}
+#endif
+
+/**
+ * @brief Fill the statistics of one capability.
+ *
+ * @param caps Capability bits (MALLOC_CAP_*).
+ * @param out Output statistics.
+ */
+static void _heap_scan_caps(uint32_t caps, sysmon_heap_caps_stats_t *out)
+{
+    multi_heap_info_t info;
+    heap_caps_get_info(&info, caps);
+
+    out->total_bytes      = (uint32_t)heap_caps_get_total_size(caps);
+    out->free_bytes       = (uint32_t)info.total_free_bytes;
+    out->largest_free     = (uint32_t)info.largest_free_block;
+    out->minimum_free     = (uint32_t)info.minimum_free_bytes;
+    out->allocated_blocks = (uint32_t)info.allocated_blocks;
+    out->free_blocks      = (uint32_t)info.free_blocks;
+    out->frag_percent     = _heap_frag_percent(out->free_bytes, out->largest_free);
+
+    memset(out->free_histogram, 0, sizeof(out->free_histogram));
+#if HEAP_HAS_WALK
+    if (out->total_bytes > 0U)
+    {
+        heap_caps_walk(caps, _heap_walk_block, out->free_histogram);
+    }
+#endif
+}
+#endif  // CONFIG_SYSMON_HEAP_CAPS_INTERVAL > 0
+
+// ============================================================================
+// Public API Functions
+// ============================================================================
+
+/**
+ * @brief Fragmentation index of a heap.
+ *
+ * @param free_bytes Free bytes.
+ * @param largest_free Largest free block.
+ * @return 100 * (1 - largest_free / free_bytes), or 0 without free memory.
+ */
+float _heap_frag_percent(uint32_t free_bytes, uint32_t largest_free)
+{
+    if (free_bytes == 0U || largest_free >= free_bytes)
+    {
+        return 0.0f;
+    }
+    return (1.0f - (float)largest_free / (float)free_bytes) * 100.0f;
+}
+
+/**
+ * @brief Scan the per-capability statistics if a scan is due (sampler task only).
+ *
+ * @param sequence Sequence number of the sample just published.
+ * @return true if a scan was done.
+ */
+bool _heap_caps_sample(uint32_t sequence)
+{
+#if CONFIG_SYSMON_HEAP_CAPS_INTERVAL > 0
+    if (sequence % CONFIG_SYSMON_HEAP_CAPS_INTERVAL != 1U % CONFIG_SYSMON_HEAP_CAPS_INTERVAL)
+    {
+        return false;
+    }
+
+    int64_t start_us = esp_timer_get_time();
+    for (int caps = 0; caps < SYSMON_HEAP_CAPS_COUNT; caps++)
+    {
+        _heap_scan_caps(s_caps_info[caps].caps, &s_scratch.caps[caps]);
+    }
+    s_scratch.sequence      = sequence;
+    s_scratch.scan_us       = (uint32_t)(esp_timer_get_time() - start_us);
+    s_scratch.has_histogram = HEAP_HAS_WALK;
+
+    portENTER_CRITICAL(&s_heap_lock);
+    s_report = s_scratch;
+    portEXIT_CRITICAL(&s_heap_lock);
+    return true;
+#else
+    (void)sequence;
+    return false;
+#endif
+}
+
+/**
+ * @brief Copy the latest per-capability scan.
+ *
+ * @param out Output report.
+ * @return true if a scan is available, false if disabled or not yet scanned.
+ */
+bool _heap_caps_read(sysmon_heap_report_t *out)
+{
+#if CONFIG_SYSMON_HEAP_CAPS_INTERVAL > 0
+    portENTER_CRITICAL(&s_heap_lock);
+    *out = s_report;
+    portEXIT_CRITICAL(&s_heap_lock);
+    return out->sequence != 0U;
+#else
+    (void)out;
+    return false;
+#endif
+}
+
+/**
+ * @brief JSON name of a capability.
+ *
+ * @param caps Capability.
+ * @return Name ("internal", "dma", "spiram", "32bit", "exec").
+ */
+const char *_heap_caps_name(sysmon_heap_caps_t caps)
+{
+    if ((unsigned)caps >= SYSMON_HEAP_CAPS_COUNT)
+    {
+        return "unknown";
+    }
+    return s_caps_info[caps].name;
+}
+
+/**
+ * @brief Lower bound of a histogram bucket.
+ *
+ * @param bucket Bucket index.
+ * @return Smallest block size counted in the bucket (bytes).
+ */
+uint32_t _heap_histogram_lower_bytes(int bucket)
+{
+    return (bucket <= 0) ? 0U : (1U << (bucket + 4));
+}
@@ -0,0 +1,391 @@
+/**
+ * @file sysmon_history.c
+ * @brief Column-wise history arena for the per-sample rings.
+ *
+ * This file implements the history arena described in sysmon_history.h:
+ * the system-wide column block and the pages backing the task slots.
+ */
+
+// Project-specific includes
+#include "sysmon_history.h"
+#include "sysmon.h"
+
+// ESP-IDF includes
+#include "esp_heap_caps.h"
+#include "esp_log.h"
+
+// System includes
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+// Logger tag for this module
+static const char *LOG_TAG = "sysmon_history";
+
+/**
+ * @brief One page of task history: rollup tiers and sample columns of SYSMON_HISTORY_PAGE_SLOTS slots.
+ *
+ * The columns follow the header: CPU samples, then stack samples, then (with
+ * CONFIG_SYSMON_TASK_HEAP_ACCOUNTING) live heap bytes, each
+ * SYSMON_HISTORY_PAGE_SLOTS * depth elements, slot-major. All column sizes
+ * are multiples of 4 bytes, so every column stays aligned.
+ */
+typedef struct
+{
+    TaskRollup rollup[SYSMON_HISTORY_PAGE_SLOTS];
+    uint8_t columns[];
+} HistoryPage;
+
+// Size of one live heap sample (no column without heap accounting)
+#define HISTORY_HEAP_SAMPLE_SIZE (CONFIG_SYSMON_TASK_HEAP_ACCOUNTING ? sizeof(uint32_t) : 0U)
+
+// Arena state (sampler task only, except during init/cleanup)
+static HistoryPage *s_pages[SYSMON_HISTORY_MAX_PAGES];
+static int s_page_count          = 0;
+static void *s_system_block      = NULL;
+static bool s_prefer_psram       = false;
+static size_t s_internal_bytes   = 0;
+static size_t s_psram_bytes      = 0;
+
+// ============================================================================
+// Internal Helper Functions
+// ============================================================================
+
+/**
+ * @brief Allocate zeroed arena memory, from PSRAM if preferred and available.
+ *
+ * @param size Number of bytes.
+ * @return Allocated memory, or NULL on failure.
+ */
+static void *_arena_calloc(size_t size)
+{
+    if (s_prefer_psram)
+    {
+        void *memory = heap_caps_calloc(1, size, MALLOC_CAP_SPIRAM | MALLOC_CAP_8BIT);
+        if (memory != NULL)
+        {
+            s_psram_bytes += size;
+            return memory;
+        }
+    }
+
+    void *memory = heap_caps_calloc(1, size, MALLOC_CAP_INTERNAL | MALLOC_CAP_8BIT);
+    if (memory != NULL)
+    {
+        s_internal_bytes += size;
+    }
+    return memory;
+}
+
+/**
+ * @brief Size of one history page for the current depth.
+ *
+ * @return Page size in bytes.
+ */
+static size_t _page_size(void)
+{
+    size_t elements = SYSMON_HISTORY_PAGE_SLOTS * (size_t)self.history_depth;
+    return sizeof(HistoryPage) + elements * (sizeof(sysmon_cpu_sample_t) + sizeof(sysmon_stack_sample_t) +
+                                             HISTORY_HEAP_SAMPLE_SIZE);
+}
+
+// ============================================================================
+// Public API Functions
+// ============================================================================
+
+/**
+ * @brief Allocate the system-wide history columns and set the history depth.
+ *
+ * @param depth Samples per series.
+ * @param prefer_psram Place the arena in PSRAM when available.
+ * @return ESP_OK on success, ESP_ERR_INVALID_ARG for an unsupported depth,
+ *         ESP_ERR_NO_MEM on allocation failure.
+ */
+esp_err_t _history_init(int depth, bool prefer_psram)
+{
+    if (depth < SYSMON_HISTORY_MIN_DEPTH || depth > SYSMON_HISTORY_MAX_DEPTH)
+    {
+        ESP_LOGE(LOG_TAG, "History depth %d out of range (%d-%d)", depth,
+                 SYSMON_HISTORY_MIN_DEPTH, SYSMON_HISTORY_MAX_DEPTH);
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    s_prefer_psram = prefer_psram && heap_caps_get_total_size(MALLOC_CAP_SPIRAM) > 0U;
+
+    // 64-bit timestamps first keep every column naturally aligned
+    size_t n = (size_t)depth;
+    size_t isr_columns = CONFIG_SYSMON_ISR_MONITOR ? SYSMON_CORE_COUNT : 0U;
+    size_t size = n * (sizeof(int64_t) + sizeof(int32_t) + (4U + SYSMON_CORE_COUNT + isr_columns) * sizeof(float) +
+                       6U * sizeof(uint32_t));
+    uint8_t *block = (uint8_t *)_arena_calloc(size);
+    if (block == NULL)
+    {
+        ESP_LOGE(LOG_TAG, "Failed to allocate %u byte history block", (unsigned)size);
+        return ESP_ERR_NO_MEM;
+    }
+
+    self.sample_time_us      = (int64_t *)(void *)block;
+    block += n * sizeof(int64_t);
+    self.sample_jitter_us    = (int32_t *)(void *)block;
+    block += n * sizeof(int32_t);
+    self.cpu_overall_percent = (float *)(void *)block;
+    block += n * sizeof(float);
+    for (int core = 0; core < SYSMON_CORE_COUNT; core++)
+    {
+        self.cpu_core_percent[core] = (float *)(void *)block;
+        block += n * sizeof(float);
+    }
+#if CONFIG_SYSMON_ISR_MONITOR
+    for (int core = 0; core < SYSMON_CORE_COUNT; core++)
+    {
+        self.isr_core_percent[core] = (float *)(void *)block;
+        block += n * sizeof(float);
+    }
+#endif
+    self.dram_used_percent   = (float *)(void *)block;
+    block += n * sizeof(float);
+    self.dram_frag_percent   = (float *)(void *)block;
+    block += n * sizeof(float);
+    self.psram_used_percent  = (float *)(void *)block;
+    block += n * sizeof(float);
+    self.dram_free           = (uint32_t *)(void *)block;
+    block += n * sizeof(uint32_t);
+    self.dram_min_free       = (uint32_t *)(void *)block;
+    block += n * sizeof(uint32_t);
+    self.dram_largest_block  = (uint32_t *)(void *)block;
+    block += n * sizeof(uint32_t);
+    self.dram_total          = (uint32_t *)(void *)block;
+    block += n * sizeof(uint32_t);
+    self.psram_free          = (uint32_t *)(void *)block;
+    block += n * sizeof(uint32_t);
+    self.psram_total         = (uint32_t *)(void *)block;
+
+    s_system_block = self.sample_time_us;
+    self.history_depth      = depth;
+    self.series_write_index = 0;
+
+    ESP_LOGI(LOG_TAG, "History depth %d samples, stored in %s", depth,
+             (s_psram_bytes > 0U) ? "PSRAM" : "internal RAM");
+    return ESP_OK;
+}
+
+/**
+ * @brief Free all history pages and the system-wide columns (called during sysmon_deinit).
+ */
+void _history_cleanup(void)
+{
+    for (int i = 0; i < s_page_count; i++)
+    {
+        heap_caps_free(s_pages[i]);
+        s_pages[i] = NULL;
+    }
+    s_page_count = 0;
+
+    heap_caps_free(s_system_block);
+    s_system_block           = NULL;
+    self.sample_time_us      = NULL;
+    self.sample_jitter_us    = NULL;
+    self.cpu_overall_percent = NULL;
+    for (int core = 0; core < SYSMON_CORE_COUNT; core++)
+    {
+        self.cpu_core_percent[core] = NULL;
+        self.isr_core_percent[core] = NULL;
+    }
+    self.dram_used_percent   = NULL;
+    self.dram_frag_percent   = NULL;
+    self.psram_used_percent  = NULL;
+    self.dram_free           = NULL;
+    self.dram_min_free       = NULL;
+    self.dram_largest_block  = NULL;
+    self.dram_total          = NULL;
+    self.psram_free          = NULL;
+    self.psram_total         = NULL;
+    self.history_depth       = 0;
+    s_internal_bytes         = 0;
+    s_psram_bytes            = 0;
+}
+
+/**
+ * @brief Make sure task slots [0, capacity) are backed by history pages (sampler task only).
+ *
+ * @param capacity Number of task slots needed.
+ * @return true on success, false on allocation failure (existing pages are kept).
+ */
+bool _history_reserve_slots(int capacity)
+{
+    int pages_needed = (capacity + SYSMON_HISTORY_PAGE_SLOTS - 1) / SYSMON_HISTORY_PAGE_SLOTS;
+    if (pages_needed > SYSMON_HISTORY_MAX_PAGES)
+    {
+        return false;
+    }
+
+    while (s_page_count < pages_needed)
+    {
+        HistoryPage *page = (HistoryPage *)_arena_calloc(_page_size());
+        if (page == NULL)
+        {
+            ESP_LOGW(LOG_TAG, "Failed to allocate history page for %d more task slots", SYSMON_HISTORY_PAGE_SLOTS);
+            return false;
+        }
+        s_pages[s_page_count++] = page;
+    }
+    return true;
+}
+
+/**
+ * @brief Point a task entry's history columns and rollup at the storage of a slot.
+ *
+ * @param task Task entry (in the array that will hold it at index slot).
+ * @param slot Slot index (must be reserved).
+ */
+void _history_bind_slot(TaskUsageSample *task, int slot)
+{
+    HistoryPage *page  = s_pages[slot / SYSMON_HISTORY_PAGE_SLOTS];
+    int in_page        = slot % SYSMON_HISTORY_PAGE_SLOTS;
+    size_t elements    = SYSMON_HISTORY_PAGE_SLOTS * (size_t)self.history_depth;
+    size_t slot_offset = (size_t)in_page * (size_t)self.history_depth;
+
+    sysmon_cpu_sample_t *cpu_column     = (sysmon_cpu_sample_t *)(void *)page->columns;
+    sysmon_stack_sample_t *stack_column = (sysmon_stack_sample_t *)(void *)(page->columns + elements * sizeof(sysmon_cpu_sample_t));
+
+    task->usage_percent_history     = cpu_column + slot_offset;
+    task->stack_usage_bytes_history = stack_column + slot_offset;
+    task->heap_live_history         = NULL;
+    task->rollup                    = &page->rollup[in_page];
+#if CONFIG_SYSMON_TASK_HEAP_ACCOUNTING
+    uint32_t *heap_column = (uint32_t *)(void *)(page->columns + elements * (sizeof(sysmon_cpu_sample_t) +
+                                                                             sizeof(sysmon_stack_sample_t)));
+    task->heap_live_history = heap_column + slot_offset;
+#endif
+}
+
+/**
+ * @brief Zero a task entry's history columns and rollup tiers (sampler task only).
+ *
+ * @param task Bound task entry.
+ */
+void _history_clear_slot(TaskUsageSample *task)
+{
+    memset(task->usage_percent_history, 0, (size_t)self.history_depth * sizeof(sysmon_cpu_sample_t));
+    memset(task->stack_usage_bytes_history, 0, (size_t)self.history_depth * sizeof(sysmon_stack_sample_t));
+    if (task->heap_live_history != NULL)
+    {
+        memset(task->heap_live_history, 0, (size_t)self.history_depth * sizeof(uint32_t));
+    }
+    memset(task->rollup, 0, sizeof(TaskRollup));
+}
+
+/**
+ * @brief Get the history storage allocated so far, by memory type.
+ *
+ * @param internal_bytes Output: bytes in internal RAM (may be NULL).
+ * @param psram_bytes Output: bytes in PSRAM (may be NULL).
+ */
+void _history_memory_usage(size_t *internal_bytes, size_t *psram_bytes)
+{
+    if (internal_bytes != NULL)
+    {
+        *internal_bytes = s_internal_bytes;
+    }
+    if (psram_bytes != NULL)
+    {
+        *psram_bytes = s_psram_bytes;
+    }
+}
+
+/**
+ * @brief Encode a CPU usage percentage as a history sample.
+ *
+ * @param percent CPU usage in percent.
+ * @return Sample (hundredths of a percent, saturating, in compact mode).
+ */
+sysmon_cpu_sample_t _history_encode_cpu(float percent)
+{
+#if CONFIG_SYSMON_COMPACT_HISTORY
+    if (!(percent > 0.0f))
+    {
+        return 0U;
+    }
+    float scaled = percent * 100.0f + 0.5f;
+    return (scaled >= (float)UINT16_MAX) ? UINT16_MAX : (uint16_t)scaled;
+#else
+    return percent;
+#endif
+}
+
+/**
+ * @brief Decode a CPU history sample.
+ *
+ * @param sample Sample from a usage_percent_history column.
+ * @return CPU usage in percent.
+ */
+float _history_decode_cpu(sysmon_cpu_sample_t sample)
+{
+#if CONFIG_SYSMON_COMPACT_HISTORY
+    return (float)sample * 0.01f;
+#else
+    return sample;
+#endif
+}
+
+/**
+ * @brief Encode a stack usage in bytes as a history sample.
+ *
+ * @param bytes Stack usage in bytes.
+ * @return Sample (SYSMON_COMPACT_STACK_UNIT units rounded up, saturating, in compact mode).
+ */
+sysmon_stack_sample_t _history_encode_stack(uint32_t bytes)
+{
+#if CONFIG_SYSMON_COMPACT_HISTORY
+    uint32_t units = (bytes / SYSMON_COMPACT_STACK_UNIT) + ((bytes % SYSMON_COMPACT_STACK_UNIT) != 0U ? 1U : 0U);
+    return (units > UINT16_MAX) ? UINT16_MAX : (uint16_t)units;
+#else
+    return bytes;
+#endif
+}
+
+/**
+ * @brief Decode a stack history sample.
+ *
+ * @param sample Sample from a stack_usage_bytes_history column.
+ * @return Stack usage in bytes.
+ */
+uint32_t _history_decode_stack(sysmon_stack_sample_t sample)
+{
+#if CONFIG_SYSMON_COMPACT_HISTORY
+    return (uint32_t)sample * SYSMON_COMPACT_STACK_UNIT;
+#else
+    return sample;
+#endif
+}
+
+/**
+ * @brief Decode a whole CPU history column.
+ *
+ * @param column Column of count samples.
+ * @param out Output percentages (count elements).
+ * @param count Number of samples.
+ */
+void _history_decode_cpu_column(const sysmon_cpu_sample_t *column, float *out, int count)
+{
+    for (int i = 0; i < count; i++)
+    {
+        out[i] = _history_decode_cpu(column[i]);
+    }
+}
+
+/**
+ * @brief Decode a whole stack history column.
+ *
+ * @param column Column of count samples.
+ * @param out Output byte counts (count elements).
+ * @param count Number of samples.
+ */
+void _history_decode_stack_column(const sysmon_stack_sample_t *column, uint32_t *out, int count)
+{
+    for (int i = 0; i < count; i++)
+    {
+        out[i] = _history_decode_stack(column[i]);
+    }
+}
@@ -0,0 +1,378 @@
+/**
+ * @file sysmon_history_bin.c
+ * @brief Compact binary encoding of the sample history (/history.bin).
+ *
+ * This file implements the columnar, delta/varint encoded history endpoint
+ * described in sysmon_history_bin.h. Bytes go out through the same chunked
+ * writer as the JSON endpoints, so peak memory is the chunk buffer, the
+ * system-wide columns (copied together so they hold the same samples) and one
+ * task slot.
+ */
+
+// Project-specific includes
+#include "sysmon_history.h"
+#include "sysmon_history_bin.h"
+#include "sysmon_json_stream.h"
+#include "sysmon_snapshot.h"
+#include "sysmon_utils.h"
+#include "sysmon.h"
+
+// ESP-IDF includes
+#include "esp_heap_caps.h"
+
+// System includes
+#include <math.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+// Maximum encoded size of a 64-bit varint
+#define VARINT_MAX_BYTES 10
+
+// Powers of ten for the supported column precisions
+static const float DECIMAL_SCALE[] = { 1.0f, 10.0f, 100.0f };
+
+// ============================================================================
+// Column Encoders (shared with the UDP exporter)
+// ============================================================================
+
+/**
+ * @brief Write an unsigned LEB128 varint.
+ *
+ * @param stream Chunked response writer.
+ * @param value Value to encode.
+ */
+void _history_bin_put_varint(json_stream_t *stream, uint64_t value)
+{
+    char bytes[VARINT_MAX_BYTES];
+    size_t len = 0;
+    do
+    {
+        uint8_t byte = (uint8_t)(value & 0x7FU);
+        value >>= 7;
+        bytes[len++] = (char)(value != 0U ? (byte | 0x80U) : byte);
+    } while (value != 0U);
+    json_stream_raw(stream, bytes, len);
+}
+
+/**
+ * @brief Write a signed value as a zigzag varint.
+ *
+ * @param stream Chunked response writer.
+ * @param value Value to encode.
+ */
+static void _put_zigzag(json_stream_t *stream, int64_t value)
+{
+    _history_bin_put_varint(stream, ((uint64_t)value << 1) ^ (uint64_t)(value >> 63));
+}
+
+/**
+ * @brief Write a column header.
+ *
+ * @param stream Chunked response writer.
+ * @param name Column name.
+ * @param decimals Fixed-point decimals of the samples.
+ * @param count Number of samples that follow.
+ */
+static void _put_column_header(json_stream_t *stream, const char *name, uint8_t decimals, uint32_t count)
+{
+    size_t name_len = strlen(name);
+    _history_bin_put_varint(stream, name_len);
+    json_stream_raw(stream, name, name_len);
+    json_stream_raw(stream, (const char *)&decimals, 1);
+    _history_bin_put_varint(stream, count);
+}
+
+/**
+ * @brief Write samples of a float ring buffer as a fixed-point delta column, oldest sample first.
+ *
+ * @param stream Chunked response writer.
+ * @param name Column name.
+ * @param ring Ring buffer (self.history_depth elements).
+ * @param first Index of the first (oldest) sample to write.
+ * @param count Number of samples to write (at most self.history_depth).
+ * @param decimals Fixed-point decimals (0-2).
+ */
+void _history_bin_put_float_column(json_stream_t *stream, const char *name, const float *ring,
+                                   int first, uint32_t count, uint8_t decimals)
+{
+    float scale = DECIMAL_SCALE[decimals];
+    int64_t previous = 0;
+
+    _put_column_header(stream, name, decimals, count);
+    for (uint32_t i = 0; i < count; i++)
+    {
+        float value = ring[(first + (int)i) % self.history_depth];
+        int64_t quantized = isfinite(value) ? (int64_t)lroundf(value * scale) : 0;
+        _put_zigzag(stream, quantized - previous);
+        previous = quantized;
+    }
+}
+
+/**
+ * @brief Write samples of a uint32_t ring buffer as an integer delta column, oldest sample first.
+ *
+ * @param stream Chunked response writer.
+ * @param name Column name.
+ * @param ring Ring buffer (self.history_depth elements).
+ * @param first Index of the first (oldest) sample to write.
+ * @param count Number of samples to write (at most self.history_depth).
+ */
+void _history_bin_put_uint_column(json_stream_t *stream, const char *name, const uint32_t *ring,
+                                  int first, uint32_t count)
+{
+    int64_t previous = 0;
+
+    _put_column_header(stream, name, 0, count);
+    for (uint32_t i = 0; i < count; i++)
+    {
+        int64_t value = (int64_t)ring[(first + (int)i) % self.history_depth];
+        _put_zigzag(stream, value - previous);
+        previous = value;
+    }
+}
+
+/**
+ * @brief Write samples of an int32_t ring buffer as an integer delta column, oldest sample first.
+ *
+ * @param stream Chunked response writer.
+ * @param name Column name.
+ * @param ring Ring buffer (self.history_depth elements).
+ * @param first Index of the first (oldest) sample to write.
+ * @param count Number of samples to write (at most self.history_depth).
+ */
+void _history_bin_put_int_column(json_stream_t *stream, const char *name, const int32_t *ring,
+                                 int first, uint32_t count)
+{
+    int64_t previous = 0;
+
+    _put_column_header(stream, name, 0, count);
+    for (uint32_t i = 0; i < count; i++)
+    {
+        int64_t value = (int64_t)ring[(first + (int)i) % self.history_depth];
+        _put_zigzag(stream, value - previous);
+        previous = value;
+    }
+}
+
+/**
+ * @brief Write a plain uint32_t array as an integer delta column.
+ *
+ * @param stream Chunked response writer.
+ * @param name Column name.
+ * @param values Samples, oldest first.
+ * @param count Number of samples to write.
+ */
+void _history_bin_put_uint_array(json_stream_t *stream, const char *name, const uint32_t *values, uint32_t count)
+{
+    int64_t previous = 0;
+
+    _put_column_header(stream, name, 0, count);
+    for (uint32_t i = 0; i < count; i++)
+    {
+        int64_t value = (int64_t)values[i];
+        _put_zigzag(stream, value - previous);
+        previous = value;
+    }
+}
+
+// ============================================================================
+// /history.bin
+// ============================================================================
+
+/**
+ * @brief System-wide series written by /history.bin, in column order.
+ *
+ * Members:
+ * - name     : Column name.
+ * - is_float : true for a float ring (1 decimal), false for a uint32_t ring.
+ */
+typedef struct
+{
+    const char *name;
+    bool is_float;
+} HistoryBinSeries;
+
+// Core columns follow sys/cpu; the table holds the rest
+#define SYSTEM_COLUMN_COUNT (8 + SYSMON_CORE_COUNT)
+
+static const HistoryBinSeries SYSTEM_SERIES[] =
+{
+    { "sys/dramFree",     false },
+    { "sys/dramMinFree",  false },
+    { "sys/dramLargest",  false },
+    { "sys/dramUsedPct",  true },
+    { "sys/dramFragPct",  true },
+    { "sys/psramFree",    false },
+    { "sys/psramUsedPct", true }
+};
+
+/**
+ * @brief Copy the newest samples of every system-wide series in one snapshot read.
+ *
+ * @param count Number of samples per series.
+ * @param sequence Output: sequence number of the newest sample copied.
+ * @return Columns in SYSTEM_COLUMN_COUNT order (release with heap_caps_free()), NULL on allocation failure.
+ */
+static uint32_t *_copy_system_columns(int count, uint32_t *sequence)
+{
+    const void *rings[SYSTEM_COLUMN_COUNT];
+    int r = 0;
+    rings[r++] = self.cpu_overall_percent;
+    for (int core = 0; core < SYSMON_CORE_COUNT; core++)
+    {
+        rings[r++] = self.cpu_core_percent[core];
+    }
+    rings[r++] = self.dram_free;
+    rings[r++] = self.dram_min_free;
+    rings[r++] = self.dram_largest_block;
+    rings[r++] = self.dram_used_percent;
+    rings[r++] = self.dram_frag_percent;
+    rings[r++] = self.psram_free;
+    rings[r++] = self.psram_used_percent;
+
+    // Floats and uint32_t alike: one 4-byte element per sample
+    size_t size = sizeof(uint32_t) * SYSTEM_COLUMN_COUNT * (size_t)((count > 0) ? count : 1);
+#if CONFIG_SYSMON_HISTORY_IN_PSRAM
+    uint32_t *columns = (uint32_t *)heap_caps_malloc_prefer(size, 2, MALLOC_CAP_SPIRAM | MALLOC_CAP_8BIT,
+                                                            MALLOC_CAP_8BIT);
+#else
+    uint32_t *columns = (uint32_t *)heap_caps_malloc(size, MALLOC_CAP_8BIT);
+#endif
+    if (columns != NULL)
+    {
+        _snapshot_read_rings(rings, SYSTEM_COLUMN_COUNT, sizeof(uint32_t), count, columns, sequence);
+    }
+    return columns;
+}
+
+/**
+ * @brief Write all system-wide series columns from their copies.
+ *
+ * @param stream Chunked response writer.
+ * @param columns Copies from _copy_system_columns().
+ * @param count Number of samples per column.
+ */
+static void _write_system_columns(json_stream_t *stream, const uint32_t *columns, uint32_t count)
+{
+    const uint32_t *column = columns;
+    _history_bin_put_float_column(stream, "sys/cpu", (const float *)column, 0, count, 1);
+    column += count;
+
+    for (int core = 0; core < SYSMON_CORE_COUNT; core++, column += count)
+    {
+        char name[16];
+        snprintf(name, sizeof(name), "sys/core%d", core);
+        _history_bin_put_float_column(stream, name, (const float *)column, 0, count, 1);
+    }
+
+    for (size_t i = 0; i < sizeof(SYSTEM_SERIES) / sizeof(SYSTEM_SERIES[0]); i++, column += count)
+    {
+        if (SYSTEM_SERIES[i].is_float)
+        {
+            _history_bin_put_float_column(stream, SYSTEM_SERIES[i].name, (const float *)column, 0, count, 1);
+        }
+        else
+        {
+            _history_bin_put_uint_column(stream, SYSTEM_SERIES[i].name, column, 0, count);
+        }
+    }
+}
+
+/**
+ * @brief Write the binary history for all system-wide series and monitored tasks.
+ *
+ * @param stream Chunked response writer (headers already set by the caller).
+ * @return ESP_OK on success, or the first error raised while streaming.
+ *
+ * Details:
+ *   - The header carries the sequence number of the newest sample and the number of
+ *     samples held (fewer than the history depth until the rings have filled).
+ *   - System-wide columns come first, all copied in one snapshot read, so they hold the
+ *     same samples. Then "cpu" and (for registered tasks) "stack" per task.
+ *   - Each task slot is copied as of one published sample, like /history, and its columns
+ *     end at the header's sample too. If the sampler overwrote the oldest samples before
+ *     the slot was copied, its columns are shorter.
+ *   - CPU and percentage columns use 1 decimal, byte counts are exact.
+ */
+esp_err_t _write_history_bin(json_stream_t *stream)
+{
+    uint32_t published = _snapshot_read_sequence();
+    uint32_t count = (published < (uint32_t)self.history_depth) ? published : (uint32_t)self.history_depth;
+
+    uint32_t *ring_copy   = (uint32_t *)malloc(sizeof(uint32_t) * (size_t)self.history_depth);
+    TaskUsageSample *task = _snapshot_alloc_task(SNAPSHOT_COPY_HISTORY);
+    uint32_t sequence     = 0;
+    uint32_t *columns     = (ring_copy != NULL && task != NULL) ? _copy_system_columns((int)count, &sequence) : NULL;
+    if (columns == NULL)
+    {
+        free(ring_copy);
+        free(task);
+        return ESP_ERR_NO_MEM;
+    }
+
+    // Header
+    static const char magic[4] = { 'S', 'M', 'H', 'B' };
+    const uint8_t version = SYSMON_HISTORY_BIN_VERSION;
+    json_stream_raw(stream, magic, sizeof(magic));
+    json_stream_raw(stream, (const char *)&version, 1);
+    _history_bin_put_varint(stream, sequence);
+    _history_bin_put_varint(stream, count);
+    _history_bin_put_varint(stream, CONFIG_SYSMON_CPU_SAMPLING_INTERVAL_MS);
+
+    _write_system_columns(stream, columns, count);
+    heap_caps_free(columns);
+
+    // Per-task columns, samples sequence - count + 1 .. sequence
+    sysmon_view_t view;
+    _snapshot_acquire_view(&view);
+    for (int i = 0; i < view.task_capacity && stream->error == ESP_OK; i++)
+    {
+        uint32_t newest = 0;
+        if (!_snapshot_read_task(&view, i, task, &newest))
+        {
+            continue;
+        }
+
+        // The copy may be newer than the system columns: skip its samples after sequence
+        // and drop those before the column start it no longer holds
+        uint32_t newer = newest - sequence;
+        uint32_t held  = (newer < (uint32_t)view.depth) ? (uint32_t)view.depth - newer : 0U;
+        uint32_t task_count = (count < held) ? count : held;
+        int first = (task->write_index - (int)newer - (int)task_count + 2 * view.depth) % view.depth;
+
+        char key_buffer[32];
+        char name[48];
+        const char *key = _get_task_display_key(task->task_name, task->name_ordinal,
+                                                key_buffer, sizeof(key_buffer));
+
+        snprintf(name, sizeof(name), "task/%s/cpu", key);
+        _history_decode_cpu_column(task->usage_percent_history, (float *)ring_copy, view.depth);
+        _history_bin_put_float_column(stream, name, (const float *)ring_copy, first, task_count, 1);
+
+        // Stack history only for registered tasks, as in /history
+        if (task->stack_size_bytes > 0U)
+        {
+            snprintf(name, sizeof(name), "task/%s/stack", key);
+            _history_decode_stack_column(task->stack_usage_bytes_history, ring_copy, view.depth);
+            _history_bin_put_uint_column(stream, name, ring_copy, first, task_count);
+        }
+
+        // Live heap history only with per-task heap accounting
+        if (task->heap_live_history != NULL)
+        {
+            snprintf(name, sizeof(name), "task/%s/heap", key);
+            _history_bin_put_uint_column(stream, name, task->heap_live_history, first, task_count);
+        }
+    }
+    _snapshot_release_view(&view);
+
+    // End marker
+    _history_bin_put_varint(stream, 0);
+
+    free(ring_copy);
+    free(task);
+    return stream->error;
+}
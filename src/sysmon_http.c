@@ -20,14 +20,24 @@
  *
  * Usage:
  *   - Call sysmon_http_start() to activate endpoints; sysmon_http_stop() to disable.
- *   - Endpoints: '/', '/tasks', '/history', '/telemetry', '/hardware'
+ *   - Endpoints: '/', '/tasks', '/history', '/history.bin', '/telemetry', '/bundle', '/hardware',
+ *     '/burst' and '/burst.bin' (see sysmon_burst.h), '/alerts' (see sysmon_alert.h) and the
+ *     '/telemetry/ws' WebSocket
+ *     (see sysmon_push.h)
  *  */
 
 // Project-specific includes
 #include "sysmon_http.h"
 #include "sysmon.h"
+#include "sysmon_alert.h"
+#include "sysmon_burst.h"
 #include "sysmon_config.h"
 #include "sysmon_json.h"
+#include "sysmon_history_bin.h"
+#include "sysmon_isr.h"
+#include "sysmon_metrics.h"
+#include "sysmon_push.h"
+#include "sysmon_www_etags.h"
 
 // ESP-IDF includes
 #include "esp_log.h"
@@ -47,24 +57,26 @@ extern esp_err_t http_handle_json_endpoint(httpd_req_t *request);
 static const static_file_config_t static_file_configs[] =
 {
     STATIC_FILE_ENTRY("/", index_html),
-    STATIC_FILE_ENTRY("/css/sysmon-theme-color-vars.css", sysmon_theme_color_vars_css),
-    STATIC_FILE_ENTRY("/css/sysmon-theme-utility-classes.css", sysmon_theme_utility_classes_css),
-    STATIC_FILE_ENTRY("/css/sysmon-theme.css", sysmon_theme_css),
-    STATIC_FILE_ENTRY("/js/theme.js", theme_js),
-    STATIC_FILE_ENTRY("/js/config.js", config_js),
-    STATIC_FILE_ENTRY("/js/utils.js", utils_js),
-    STATIC_FILE_ENTRY("/js/charts.js", charts_js),
-    STATIC_FILE_ENTRY("/js/table.js", table_js),
-    STATIC_FILE_ENTRY("/js/app.js", app_js)
+    STATIC_FILE_ENTRY("/css/sysmon.css", sysmon_css),
+    STATIC_FILE_ENTRY("/js/sysmon.js", sysmon_js)
 };
 
 // JSON endpoint handler configurations
 static const json_handler_config_t json_handler_configs[] =
 {
-    JSON_ENDPOINT_ENTRY("/tasks", _create_tasks_json),
-    JSON_ENDPOINT_ENTRY("/history", _create_history_json),
-    JSON_ENDPOINT_ENTRY("/telemetry", _create_telemetry_json),
-    JSON_ENDPOINT_ENTRY("/hardware", _create_hardware_json)
+    JSON_STREAM_ENTRY("/tasks", _write_tasks_json, SYSMON_PROFILE_TASKS_BUILD),
+    JSON_STREAM_ENTRY("/history", _write_history_json, SYSMON_PROFILE_HISTORY_BUILD),
+    BINARY_STREAM_ENTRY("/history.bin", _write_history_bin, SYSMON_PROFILE_HISTORY_BIN_BUILD),
+    JSON_STREAM_ENTRY("/telemetry", _write_telemetry_json, SYSMON_PROFILE_TELEMETRY_BUILD),
+    JSON_STREAM_ENTRY("/bundle", _write_bundle_json, SYSMON_PROFILE_BUNDLE_BUILD),
+    JSON_STREAM_ENTRY("/hardware", _write_hardware_json, SYSMON_PROFILE_HARDWARE_BUILD),
+    JSON_STREAM_ENTRY("/heap", _write_heap_json, SYSMON_PROFILE_HEAP_BUILD),
+    JSON_STREAM_ENTRY("/burst", _write_burst_json, SYSMON_PROFILE_BURST_BUILD),
+    BINARY_STREAM_ENTRY("/burst.bin", _write_burst_bin, SYSMON_PROFILE_BURST_BIN_BUILD),
+    JSON_STREAM_ENTRY("/alerts", _write_alerts_json, SYSMON_PROFILE_ALERTS_BUILD),
+    JSON_STREAM_ENTRY("/interrupts", _write_interrupts_json, SYSMON_PROFILE_INTERRUPTS_BUILD),
+    TEXT_STREAM_ENTRY("/metrics", _write_metrics_text, SYSMON_METRICS_CONTENT_TYPE, SYSMON_PROFILE_METRICS_BUILD),
+    JSON_STREAM_ENTRY("/sysmon/self", _write_self_json, SYSMON_PROFILE_SELF_BUILD)
 };
 
 /**
@@ -114,7 +126,7 @@ static esp_err_t _register_handler(httpd_handle_t server, const char *uri, httpd
  *   4. On error, leaves self.httpd = NULL and propagates error upwards.
  *
  * @note The HTTP API uses port/task settings defined by CONFIG_SYSMON_HTTPD_SERVER_PORT/etc.
- * @note All handlers are GET (read-only, telemetry export).
+ * @note All handlers are GET (read-only, telemetry export), except POST /burst.
  * @note The sysmon_http module must be initialized before use.
  */
 esp_err_t sysmon_http_start(void)
@@ -128,19 +140,31 @@ esp_err_t sysmon_http_start(void)
     config.server_port      = CONFIG_SYSMON_HTTPD_SERVER_PORT;
     config.ctrl_port        = CONFIG_SYSMON_HTTPD_CTRL_PORT; // necessary if you want to create multiple HTTPD servers
 
-    // Allow more simultaneous connections for multiple browser asset/API requests
-    // Served files: 1 HTML + 3 CSS + 6 JS = 10 static files, plus 4 JSON API endpoints
-    // Browsers load these concurrently, so default max_open_sockets=7 is insufficient
-    config.max_open_sockets = 12;
+    // Keep the server task away from real-time work (see Kconfig)
+    config.task_priority    = CONFIG_SYSMON_HTTPD_TASK_PRIORITY;
+    config.stack_size       = CONFIG_SYSMON_HTTPD_STACK_SIZE;
+    config.core_id          = tskNO_AFFINITY;
+    if (CONFIG_SYSMON_HTTPD_TASK_CORE >= 0 && CONFIG_SYSMON_HTTPD_TASK_CORE < SYSMON_CORE_COUNT)
+    {
+        config.core_id = CONFIG_SYSMON_HTTPD_TASK_CORE;
+    }
+    else if (CONFIG_SYSMON_HTTPD_TASK_CORE >= SYSMON_CORE_COUNT)
+    {
+        ESP_LOGW(LOG_TAG, "HTTP server core %d does not exist, running unpinned", CONFIG_SYSMON_HTTPD_TASK_CORE);
+    }
+
+    // The dashboard loads the page plus one script and one style bundle, then polls /bundle
+    config.max_open_sockets = CONFIG_SYSMON_HTTPD_MAX_SOCKETS;
 
     // Set max URI handlers based on how many static files & APIs we'll serve
     size_t static_file_count  = sizeof(static_file_configs) / sizeof(static_file_configs[0]);
     size_t json_handler_count = sizeof(json_handler_configs) / sizeof(json_handler_configs[0]);
-    config.max_uri_handlers   = static_file_count + json_handler_count;
+    config.max_uri_handlers   = static_file_count + json_handler_count + _push_handler_count() +
+                                _burst_handler_count();
 
     // Warn if LWIP socket pool is too small for this server config
-#if CONFIG_LWIP_MAX_SOCKETS < 15
-    #warning "CONFIG_LWIP_MAX_SOCKETS may be too low (need at least 15 for max_open_sockets=12)."
+#if CONFIG_LWIP_MAX_SOCKETS < CONFIG_SYSMON_HTTPD_MAX_SOCKETS + 3
+    #warning "CONFIG_LWIP_MAX_SOCKETS may be too low (need CONFIG_SYSMON_HTTPD_MAX_SOCKETS + 3)."
 #endif
 
 
@@ -176,6 +200,24 @@ esp_err_t sysmon_http_start(void)
         }
     }
 
+    // Register the live telemetry WebSocket (no-op without CONFIG_HTTPD_WS_SUPPORT)
+    err = _push_register(self.httpd);
+    if (err != ESP_OK)
+    {
+        httpd_stop(self.httpd);
+        self.httpd = NULL;
+        return err;
+    }
+
+    // Register POST /burst (no-op without CONFIG_SYSMON_BURST_CAPTURE)
+    err = _burst_register(self.httpd);
+    if (err != ESP_OK)
+    {
+        httpd_stop(self.httpd);
+        self.httpd = NULL;
+        return err;
+    }
+
     return ESP_OK;
 }
 
@@ -193,4 +235,5 @@ void sysmon_http_stop(void)
         httpd_stop(self.httpd);
         self.httpd = NULL;
     }
+    _push_cleanup();
 }
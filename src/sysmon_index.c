@@ -0,0 +1,218 @@
+/**
+ * @file sysmon_index.c
+ * @brief Open-addressing hash index keyed by task handle.
+ *
+ * Linear probing with backward-shift deletion, so no tombstones accumulate
+ * as tasks come and go.
+ */
+
+// Project-specific includes
+#include "sysmon_index.h"
+
+// System includes
+#include <stdint.h>
+#include <string.h>
+
+// Smallest slot table ever allocated
+#define INDEX_MIN_CAPACITY 16U
+
+/**
+ * @brief Hash a pointer key to a home slot.
+ *
+ * @param key Key to hash.
+ * @param mask Table capacity minus one.
+ * @return Home slot index.
+ */
+static uint32_t _index_slot(const void *key, uint32_t mask)
+{
+    // TCBs are word aligned; drop the zero bits, then Fibonacci-hash the rest
+    uint32_t h = (uint32_t)((uintptr_t)key >> 2);
+    h *= 2654435761U;
+    return (h ^ (h >> 16)) & mask;
+}
+
+/**
+ * @brief Get the slot table size needed to hold a number of keys at <= 50% load.
+ *
+ * @param items Number of keys the index must hold.
+ * @return Power-of-two slot count.
+ */
+uint32_t _index_capacity_for(uint32_t items)
+{
+    uint32_t capacity = INDEX_MIN_CAPACITY;
+    while (capacity < items * 2U)
+    {
+        capacity <<= 1;
+    }
+    return capacity;
+}
+
+/**
+ * @brief Check whether the index must grow before holding a number of keys.
+ *
+ * @param index Index to check.
+ * @param items Number of keys the index must hold.
+ * @return true if a larger table is required.
+ */
+bool _index_needs_grow(const sysmon_index_t *index, uint32_t items)
+{
+    return index->entries == NULL || items * 2U > index->capacity;
+}
+
+/**
+ * @brief Move all keys into a new slot table.
+ *
+ * @param index Index to rehash.
+ * @param entries Zeroed slot table (ownership is transferred to the index).
+ * @param capacity Number of slots in entries (power of two, larger than index->count).
+ * @return Previous slot table, to be freed by the caller (may be NULL).
+ */
+sysmon_index_entry_t *_index_rehash(sysmon_index_t *index, sysmon_index_entry_t *entries, uint32_t capacity)
+{
+    sysmon_index_entry_t *old_entries = index->entries;
+    uint32_t old_capacity = index->capacity;
+
+    index->entries  = entries;
+    index->capacity = capacity;
+    index->count    = 0;
+
+    for (uint32_t i = 0; i < old_capacity; i++)
+    {
+        if (old_entries[i].key != NULL)
+        {
+            _index_insert(index, old_entries[i].key, old_entries[i].value);
+        }
+    }
+
+    return old_entries;
+}
+
+/**
+ * @brief Look up a key.
+ *
+ * @param index Index to search.
+ * @param key Key to find (non-NULL).
+ * @param value Output: stored value (may be NULL).
+ * @return true if the key is present.
+ */
+bool _index_find(const sysmon_index_t *index, const void *key, uint32_t *value)
+{
+    if (index->entries == NULL || key == NULL)
+    {
+        return false;
+    }
+
+    uint32_t mask = index->capacity - 1U;
+    for (uint32_t slot = _index_slot(key, mask);; slot = (slot + 1U) & mask)
+    {
+        const sysmon_index_entry_t *entry = &index->entries[slot];
+        if (entry->key == NULL)
+        {
+            return false;
+        }
+        if (entry->key == key)
+        {
+            if (value != NULL)
+            {
+                *value = entry->value;
+            }
+            return true;
+        }
+    }
+}
+
+/**
+ * @brief Insert a key or update its value.
+ *
+ * @param index Index to update.
+ * @param key Key to insert (non-NULL).
+ * @param value Value to store.
+ * @return true on success, false if the table is full.
+ */
+bool _index_insert(sysmon_index_t *index, const void *key, uint32_t value)
+{
+    if (index->entries == NULL || key == NULL)
+    {
+        return false;
+    }
+
+    uint32_t mask = index->capacity - 1U;
+    for (uint32_t slot = _index_slot(key, mask);; slot = (slot + 1U) & mask)
+    {
+        sysmon_index_entry_t *entry = &index->entries[slot];
+        if (entry->key == key)
+        {
+            entry->value = value;
+            return true;
+        }
+        if (entry->key == NULL)
+        {
+            // Keep at least one empty slot so probes always terminate
+            if (index->count + 1U >= index->capacity)
+            {
+                return false;
+            }
+            entry->key   = key;
+            entry->value = value;
+            index->count++;
+            return true;
+        }
+    }
+}
+
+/**
+ * @brief Remove a key (no-op if absent).
+ *
+ * @param index Index to update.
+ * @param key Key to remove.
+ */
+void _index_remove(sysmon_index_t *index, const void *key)
+{
+    if (index->entries == NULL || key == NULL)
+    {
+        return;
+    }
+
+    uint32_t mask = index->capacity - 1U;
+    uint32_t slot = _index_slot(key, mask);
+    while (index->entries[slot].key != key)
+    {
+        if (index->entries[slot].key == NULL)
+        {
+            return;
+        }
+        slot = (slot + 1U) & mask;
+    }
+
+    // Backward-shift deletion: pull later members of the probe run into the hole
+    uint32_t hole = slot;
+    for (uint32_t next = (hole + 1U) & mask; index->entries[next].key != NULL; next = (next + 1U) & mask)
+    {
+        uint32_t home = _index_slot(index->entries[next].key, mask);
+        // Move the entry unless its home lies cyclically in (hole, next]
+        bool home_after_hole = (next > hole) ? (home > hole && home <= next)
+                                             : (home > hole || home <= next);
+        if (!home_after_hole)
+        {
+            index->entries[hole] = index->entries[next];
+            hole = next;
+        }
+    }
+
+    index->entries[hole].key   = NULL;
+    index->entries[hole].value = 0U;
+    index->count--;
+}
+
+/**
+ * @brief Detach and return the slot table, leaving an empty index.
+ *
+ * @param index Index to reset.
+ * @return Slot table to be freed by the caller (may be NULL).
+ */
+sysmon_index_entry_t *_index_release(sysmon_index_t *index)
+{
+    sysmon_index_entry_t *entries = index->entries;
+    memset(index, 0, sizeof(*index));
+    return entries;
+}
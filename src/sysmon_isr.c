@@ -0,0 +1,369 @@
+/**
+ * @file sysmon_isr.c
+ * @brief Interrupt load per core from wrapped interrupt handlers.
+ *
+ * This file implements the handler shim and the linker wrappers described in
+ * sysmon_isr.h. The shim runs in interrupt context on every interrupt, so it
+ * lives in IRAM, touches only the static tables and never locks; allocation,
+ * release and the sampler's per-interval figures are serialized by a spinlock.
+ */
+
+// Project-specific includes
+#include "sysmon_isr.h"
+#include "sysmon.h"
+#include "sysmon_json_stream.h"
+
+// ESP-IDF includes
+#include "esp_attr.h"
+#include "esp_clk_tree.h"
+#include "esp_cpu.h"
+#include "esp_intr_alloc.h"
+#include "esp_log.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+
+// System includes
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+
+#if CONFIG_SYSMON_ISR_MONITOR
+
+// Logger tag for this module
+static const char *LOG_TAG = "sysmon_isr";
+
+/**
+ * @brief Wrapped handler.
+ *
+ * Members:
+ * - used         : Whether the entry holds an allocated handler.
+ * - handler      : Real handler.
+ * - arg          : Argument of the real handler.
+ * - handle       : Interrupt handle returned by the allocation (key for esp_intr_free()).
+ * - source       : Interrupt source (ETS_*_INTR_SOURCE, negative for internal interrupts).
+ * - flags        : Allocation flags (ESP_INTR_FLAG_*).
+ * - core         : Core the handler was allocated on.
+ * - calls        : Calls, cumulative (written by the shim, wraps).
+ * - cycles       : CPU cycles spent in the handler, cumulative (written by the shim, wraps).
+ * - max_cycles   : Longest call since the sampler's previous read (reset by the sampler).
+ * - prev_calls   : calls at the previous sample.
+ * - prev_cycles  : cycles at the previous sample.
+ * - load_percent : Share of its core's time spent in the handler during the latest interval.
+ * - calls_per_sec: Call rate during the latest interval.
+ * - max_us       : Longest call during the latest interval (microseconds).
+ */
+typedef struct
+{
+    bool used;
+    intr_handler_t handler;
+    void *arg;
+    intr_handle_t handle;
+    int source;
+    int flags;
+    int core;
+    uint32_t calls;
+    uint32_t cycles;
+    uint32_t max_cycles;
+    uint32_t prev_calls;
+    uint32_t prev_cycles;
+    float load_percent;
+    uint32_t calls_per_sec;
+    uint32_t max_us;
+} IsrEntry;
+
+static IsrEntry s_entries[CONFIG_SYSMON_ISR_MAX_HANDLERS];
+static portMUX_TYPE s_isr_lock = portMUX_INITIALIZER_UNLOCKED;
+static uint32_t s_untracked = 0;
+
+// Per-core state, written by the core's own interrupts only
+static uint32_t s_core_cycles[SYSMON_CORE_COUNT];
+static uint32_t s_core_depth[SYSMON_CORE_COUNT];
+
+// Sampler state
+static uint32_t s_prev_core_cycles[SYSMON_CORE_COUNT];
+static int64_t s_prev_time_us = 0;
+
+// Real allocator functions (resolved by the linker's --wrap)
+esp_err_t __real_esp_intr_alloc_intrstatus(int source, int flags, uint32_t intrstatusreg, uint32_t intrstatusmask,
+                                           intr_handler_t handler, void *arg, intr_handle_t *ret_handle);
+esp_err_t __real_esp_intr_free(intr_handle_t handle);
+
+// ============================================================================
+// Internal Helper Functions
+// ============================================================================
+
+/**
+ * @brief Handler shim: time the real handler with the cycle counter (interrupt context).
+ *
+ * @param arg Entry of the wrapped handler.
+ */
+static void IRAM_ATTR _isr_shim(void *arg)
+{
+    IsrEntry *entry = (IsrEntry *)arg;
+    int core = (int)xPortGetCoreID();
+
+    s_core_depth[core]++;
+    uint32_t start = (uint32_t)esp_cpu_get_cycle_count();
+    entry->handler(entry->arg);
+    uint32_t cycles = (uint32_t)esp_cpu_get_cycle_count() - start;
+    s_core_depth[core]--;
+
+    __atomic_store_n(&entry->calls, entry->calls + 1U, __ATOMIC_RELAXED);
+    __atomic_store_n(&entry->cycles, entry->cycles + cycles, __ATOMIC_RELAXED);
+    if (cycles > __atomic_load_n(&entry->max_cycles, __ATOMIC_RELAXED))
+    {
+        __atomic_store_n(&entry->max_cycles, cycles, __ATOMIC_RELAXED);
+    }
+
+    // Nested interrupts are already part of the outermost one's cycles
+    if (s_core_depth[core] == 0U)
+    {
+        __atomic_store_n(&s_core_cycles[core], s_core_cycles[core] + cycles, __ATOMIC_RELAXED);
+    }
+}
+
+/**
+ * @brief Claim a table entry for a handler.
+ *
+ * @param source Interrupt source.
+ * @param flags Allocation flags.
+ * @param handler Real handler.
+ * @param arg Argument of the real handler.
+ * @return Entry, or NULL if the table is full.
+ */
+static IsrEntry *_isr_claim(int source, int flags, intr_handler_t handler, void *arg)
+{
+    IsrEntry *entry = NULL;
+    portENTER_CRITICAL(&s_isr_lock);
+    for (int i = 0; i < CONFIG_SYSMON_ISR_MAX_HANDLERS; i++)
+    {
+        if (!s_entries[i].used)
+        {
+            entry = &s_entries[i];
+            memset(entry, 0, sizeof(*entry));
+            entry->used    = true;
+            entry->handler = handler;
+            entry->arg     = arg;
+            entry->source  = source;
+            entry->flags   = flags;
+            entry->core    = -1;
+            break;
+        }
+    }
+    portEXIT_CRITICAL(&s_isr_lock);
+    return entry;
+}
+
+// ============================================================================
+// Linker Wrappers (-Wl,--wrap)
+// ============================================================================
+
+/**
+ * @brief Allocate an interrupt with a status register check, timing its handler.
+ *
+ * Same contract as esp_intr_alloc_intrstatus(); C handlers of low and medium level
+ * interrupts are registered through the shim.
+ */
+esp_err_t __wrap_esp_intr_alloc_intrstatus(int source, int flags, uint32_t intrstatusreg, uint32_t intrstatusmask,
+                                           intr_handler_t handler, void *arg, intr_handle_t *ret_handle)
+{
+    if (handler == NULL || (flags & ESP_INTR_FLAG_HIGH) != 0)
+    {
+        return __real_esp_intr_alloc_intrstatus(source, flags, intrstatusreg, intrstatusmask,
+                                                handler, arg, ret_handle);
+    }
+
+    IsrEntry *entry = _isr_claim(source, flags, handler, arg);
+    if (entry == NULL)
+    {
+        __atomic_fetch_add(&s_untracked, 1U, __ATOMIC_RELAXED);
+        return __real_esp_intr_alloc_intrstatus(source, flags, intrstatusreg, intrstatusmask,
+                                                handler, arg, ret_handle);
+    }
+
+    intr_handle_t handle = NULL;
+    esp_err_t err = __real_esp_intr_alloc_intrstatus(source, flags, intrstatusreg, intrstatusmask,
+                                                     _isr_shim, entry, &handle);
+    portENTER_CRITICAL(&s_isr_lock);
+    if (err == ESP_OK)
+    {
+        entry->handle = handle;
+        entry->core   = esp_intr_get_cpu(handle);
+    }
+    else
+    {
+        entry->used = false;
+    }
+    portEXIT_CRITICAL(&s_isr_lock);
+
+    if (err == ESP_OK && ret_handle != NULL)
+    {
+        *ret_handle = handle;
+    }
+    return err;
+}
+
+/**
+ * @brief Allocate an interrupt, timing its handler.
+ *
+ * Same contract as esp_intr_alloc().
+ */
+esp_err_t __wrap_esp_intr_alloc(int source, int flags, intr_handler_t handler, void *arg, intr_handle_t *ret_handle)
+{
+    // The real esp_intr_alloc() calls esp_intr_alloc_intrstatus() within its own file, past the wrapper
+    return __wrap_esp_intr_alloc_intrstatus(source, flags, 0, 0, handler, arg, ret_handle);
+}
+
+/**
+ * @brief Free an interrupt and release its table entry.
+ *
+ * Same contract as esp_intr_free().
+ */
+esp_err_t __wrap_esp_intr_free(intr_handle_t handle)
+{
+    esp_err_t err = __real_esp_intr_free(handle);
+    if (err != ESP_OK)
+    {
+        return err;
+    }
+
+    // The handler no longer runs once esp_intr_free() returned
+    portENTER_CRITICAL(&s_isr_lock);
+    for (int i = 0; i < CONFIG_SYSMON_ISR_MAX_HANDLERS; i++)
+    {
+        if (s_entries[i].used && s_entries[i].handle == handle)
+        {
+            s_entries[i].used = false;
+            break;
+        }
+    }
+    portEXIT_CRITICAL(&s_isr_lock);
+    return ESP_OK;
+}
+
+#endif  // CONFIG_SYSMON_ISR_MONITOR
+
+// ============================================================================
+// Public API Functions
+// ============================================================================
+
+/**
+ * @brief Turn the interrupt counters into the interrupt load of the latest interval (sampler task only).
+ *
+ * @param timestamp_us Timestamp of the sample.
+ * @param isr_percent Output: interrupt load per core (0 for the first sample).
+ * @return true on success, false if interrupt monitoring is disabled (isr_percent is zeroed).
+ */
+bool _isr_sample(int64_t timestamp_us, float isr_percent[SYSMON_CORE_COUNT])
+{
+    memset(isr_percent, 0, SYSMON_CORE_COUNT * sizeof(float));
+#if CONFIG_SYSMON_ISR_MONITOR
+    uint32_t cpu_freq_hz = 0U;
+    if (esp_clk_tree_src_get_freq_hz(SOC_MOD_CLK_CPU, ESP_CLK_TREE_SRC_FREQ_PRECISION_CACHED, &cpu_freq_hz) != ESP_OK)
+    {
+        cpu_freq_hz = 0U;
+    }
+    int64_t interval_us = (s_prev_time_us > 0) ? (timestamp_us - s_prev_time_us) : 0;
+    s_prev_time_us = timestamp_us;
+
+    // Cycles the interval held on one core
+    double interval_cycles = (double)interval_us * (double)cpu_freq_hz / 1000000.0;
+
+    for (int core = 0; core < SYSMON_CORE_COUNT; core++)
+    {
+        uint32_t cycles = __atomic_load_n(&s_core_cycles[core], __ATOMIC_RELAXED);
+        uint32_t delta  = cycles - s_prev_core_cycles[core];
+        s_prev_core_cycles[core] = cycles;
+        if (interval_cycles > 0.0)
+        {
+            float load = (float)((double)delta / interval_cycles * 100.0);
+            isr_percent[core] = (load < 100.0f) ? load : 100.0f;
+        }
+    }
+
+    for (int i = 0; i < CONFIG_SYSMON_ISR_MAX_HANDLERS; i++)
+    {
+        IsrEntry *entry = &s_entries[i];
+        portENTER_CRITICAL(&s_isr_lock);
+        if (entry->used)
+        {
+            uint32_t calls      = __atomic_load_n(&entry->calls, __ATOMIC_RELAXED);
+            uint32_t cycles     = __atomic_load_n(&entry->cycles, __ATOMIC_RELAXED);
+            uint32_t max_cycles = __atomic_exchange_n(&entry->max_cycles, 0U, __ATOMIC_RELAXED);
+            uint32_t delta_calls  = calls - entry->prev_calls;
+            uint32_t delta_cycles = cycles - entry->prev_cycles;
+            entry->prev_calls  = calls;
+            entry->prev_cycles = cycles;
+            entry->load_percent  = (interval_cycles > 0.0)
+                                   ? (float)((double)delta_cycles / interval_cycles * 100.0) : 0.0f;
+            entry->calls_per_sec = (interval_us > 0)
+                                   ? (uint32_t)(((uint64_t)delta_calls * 1000000U) / (uint64_t)interval_us) : 0U;
+            entry->max_us        = (cpu_freq_hz > 0U)
+                                   ? (uint32_t)(((uint64_t)max_cycles * 1000000U) / cpu_freq_hz) : 0U;
+        }
+        portEXIT_CRITICAL(&s_isr_lock);
+    }
+
+    static bool s_logged = false;
+    if (!s_logged)
+    {
+        s_logged = true;
+        ESP_LOGI(LOG_TAG, "Timing interrupt handlers (%u untracked)", (unsigned)s_untracked);
+    }
+    return true;
+#else
+    (void)timestamp_us;
+    return false;
+#endif
+}
+
+/**
+ * @brief Write the per-handler interrupt statistics (/interrupts).
+ *
+ * @param stream Chunked response writer.
+ * @return ESP_OK on success, or the first error raised while streaming.
+ *
+ * Details:
+ *   - "handlers" lists the wrapped handlers with their "source", "core", interrupt
+ *     "level" flags, "iram" (ESP_INTR_FLAG_IRAM), "shared", cumulative "calls" and,
+ *     for the latest sample interval, "loadPct", "callsPerSec" and "maxUs".
+ *   - "untracked" counts handlers allocated while the table was full.
+ */
+esp_err_t _write_interrupts_json(json_stream_t *stream)
+{
+    json_stream_object_begin(stream);
+    json_stream_add_bool(stream, "enabled", CONFIG_SYSMON_ISR_MONITOR);
+#if CONFIG_SYSMON_ISR_MONITOR
+    json_stream_add_uint(stream, "maxHandlers", CONFIG_SYSMON_ISR_MAX_HANDLERS);
+    json_stream_add_uint(stream, "untracked", __atomic_load_n(&s_untracked, __ATOMIC_RELAXED));
+
+    json_stream_key(stream, "handlers");
+    json_stream_array_begin(stream);
+    for (int i = 0; i < CONFIG_SYSMON_ISR_MAX_HANDLERS; i++)
+    {
+        IsrEntry entry;
+        portENTER_CRITICAL(&s_isr_lock);
+        entry = s_entries[i];
+        portEXIT_CRITICAL(&s_isr_lock);
+        if (!entry.used)
+        {
+            continue;
+        }
+
+        json_stream_object_begin(stream);
+        json_stream_add_int(stream, "source", entry.source);
+        json_stream_add_int(stream, "core", entry.core);
+        json_stream_add_uint(stream, "levelFlags", (uint32_t)(entry.flags & ESP_INTR_FLAG_LEVELMASK));
+        json_stream_add_bool(stream, "iram", (entry.flags & ESP_INTR_FLAG_IRAM) != 0);
+        json_stream_add_bool(stream, "shared", (entry.flags & ESP_INTR_FLAG_SHARED) != 0);
+        json_stream_add_uint(stream, "calls", entry.calls);
+        json_stream_add_fixed(stream, "loadPct", entry.load_percent, 2);
+        json_stream_add_uint(stream, "callsPerSec", entry.calls_per_sec);
+        json_stream_add_uint(stream, "maxUs", entry.max_us);
+        json_stream_object_end(stream);
+    }
+    json_stream_array_end(stream);
+#endif
+    json_stream_object_end(stream);
+    return stream->error;
+}
@@ -8,6 +8,16 @@
 
 // Project-specific includes
 #include "sysmon_json.h"
+#include "sysmon_json_stream.h"
+#include "sysmon_alloc.h"
+#include "sysmon_heap.h"
+#include "sysmon_history.h"
+#include "sysmon_persist.h"
+#include "sysmon_profile.h"
+#include "sysmon_rollup.h"
+#include "sysmon_snapshot.h"
+#include "sysmon_task_stats.h"
+#include "sysmon_trace.h"
 #include "sysmon.h"
 #include "sysmon_utils.h"
 
@@ -16,6 +26,7 @@
 #include "esp_log.h"
 #include "esp_system.h"
 #include "esp_heap_caps.h"
+#include "esp_timer.h"
 #include "esp_clk_tree.h"
 #include "soc/clk_tree_defs.h"
 #include "esp_partition.h"
@@ -32,11 +43,122 @@
 #include <stdlib.h>
 #include <string.h>
 #include <stddef.h>
+#include <stdio.h>
 #include <time.h>
 
 // Logger tag for this module
 static const char *LOG_TAG = "sysmon_json";
 
+/**
+ * @brief One partition table entry with its usage, as cached for /hardware.
+ */
+typedef struct
+{
+    const esp_partition_t *part;
+    uint32_t used_bytes;
+    uint32_t free_bytes;
+    bool usage_available;
+} HardwarePartition;
+
+/**
+ * @brief Cached /hardware data.
+ *
+ * Members:
+ * - chip_json        : Serialized "chip" object (never changes at runtime).
+ * - memory_json      : Serialized "memory" object (heap totals).
+ * - partitions       : Partition table entries with their usage.
+ * - partition_count  : Number of entries in partitions.
+ * - total_flash_size : Flash chip size in bytes (0 if unknown).
+ * - nvs_refreshed_at : Tick count of the last NVS usage refresh.
+ * - invalidated      : Set by sysmon_refresh_hardware_info(); the next request rebuilds the cache.
+ * - ready            : True once the cache has been built.
+ */
+typedef struct
+{
+    char *chip_json;
+    char *memory_json;
+    HardwarePartition *partitions;
+    size_t partition_count;
+    uint32_t total_flash_size;
+    TickType_t nvs_refreshed_at;
+    bool invalidated;
+    bool ready;
+} HardwareCache;
+
+static HardwareCache s_hardware = { 0 };
+
+/**
+ * @brief Fields selected by ?fields= (JSON_FIELD_* flags).
+ */
+#define JSON_FIELD_CPU    (1U << 0)  ///< Task CPU usage ("cpu")
+#define JSON_FIELD_STACK  (1U << 1)  ///< Task stack usage ("stack", "stackPct", "stackRemaining", "stackMax")
+#define JSON_FIELD_HEAP   (1U << 2)  ///< Task heap accounting ("heap", "heapBlocks", "allocs", "allocBytes")
+#define JSON_FIELD_CORE   (1U << 3)  ///< Task per-core split ("coreCpu", "migrations")
+#define JSON_FIELD_SCHED  (1U << 4)  ///< Task scheduling ("switchesPerSec", "readyAvgUs", "readyMaxUs")
+#define JSON_FIELD_SYSTEM (1U << 5)  ///< System-wide series, summary and sampling information
+#define JSON_FIELD_TASKS  (JSON_FIELD_CPU | JSON_FIELD_STACK | JSON_FIELD_HEAP | JSON_FIELD_CORE | JSON_FIELD_SCHED)
+#define JSON_FIELD_ALL    (JSON_FIELD_TASKS | JSON_FIELD_SYSTEM)
+
+/**
+ * @brief Parts of a /bundle response selected by ?parts= (JSON_BUNDLE_* flags).
+ */
+#define JSON_BUNDLE_TELEMETRY (1U << 0)  ///< "telemetry", as /telemetry
+#define JSON_BUNDLE_TASKS     (1U << 1)  ///< "tasks", as /tasks
+#define JSON_BUNDLE_HISTORY   (1U << 2)  ///< "history", as /history?since=<seq>
+#define JSON_BUNDLE_ALL       (JSON_BUNDLE_TELEMETRY | JSON_BUNDLE_TASKS | JSON_BUNDLE_HISTORY)
+
+// Samples per snapshot read when /history?since= walks a ring (see _write_series_since())
+#define HISTORY_SINCE_WINDOW 32
+
+/**
+ * @brief Element type of a history ring, as written by _write_series_since().
+ */
+typedef enum
+{
+    HISTORY_VALUE_FLOAT = 0,    ///< float, 1 decimal place
+    HISTORY_VALUE_UINT,         ///< uint32_t
+    HISTORY_VALUE_INT,          ///< int32_t
+    HISTORY_VALUE_TIME,         ///< int64_t timestamp
+    HISTORY_VALUE_CPU,          ///< sysmon_cpu_sample_t (task CPU column)
+    HISTORY_VALUE_STACK         ///< sysmon_stack_sample_t (task stack column)
+} HistoryValueType;
+
+/**
+ * @brief History ring read by _write_series_since(): a system-wide ring or a task column.
+ *
+ * Members:
+ * - ring       : System-wide ring of self (view == NULL).
+ * - view       : Pinned view for a task column, NULL for a system-wide ring.
+ * - task_index : Slot index of the task.
+ * - task_id    : Task the slot must still hold.
+ * - column     : Task column.
+ * - type       : Element type.
+ */
+typedef struct
+{
+    const void *ring;
+    const sysmon_view_t *view;
+    int task_index;
+    UBaseType_t task_id;
+    sysmon_snapshot_column_t column;
+    HistoryValueType type;
+} HistorySource;
+
+/**
+ * @brief Projection of a /history or /telemetry request (?tasks=, ?fields=, ?last=).
+ *
+ * Members:
+ * - tasks  : Comma-separated task keys or names to write (decoded, owned), NULL for all tasks.
+ * - fields : JSON_FIELD_* flags to write (JSON_FIELD_ALL without ?fields=).
+ * - last   : Newest samples (rollup: buckets) to write per series, 0 for all.
+ */
+typedef struct
+{
+    char *tasks;
+    uint32_t fields;
+    uint32_t last;
+} JsonQuery;
+
 // ============================================================================
 // Internal Helper Functions (Build Sub-components)
 // ============================================================================
@@ -118,84 +240,279 @@ static const char *_determine_chip_variant(const esp_chip_info_t *chip_info, uin
     return variant_str;
 }
 
+#if CONFIG_SYSMON_TRACE_SCHED_STATS
 /**
- * @brief Build CPU summary JSON object.
+ * @brief Convert a count over a sample interval into a rate.
  *
- * @param read_index Index into series arrays for latest sample.
- * @return CPU summary JSON object, or NULL on allocation failure.
+ * @param count Events during the interval.
+ * @param interval_us Interval length (microseconds).
+ * @return Events per second, rounded (0 for an empty interval).
  */
-static cJSON *_build_cpu_summary(int read_index)
+static uint32_t _per_second(uint32_t count, uint32_t interval_us)
 {
-    cJSON *cpu = cJSON_CreateObject();
-    if (cpu == NULL)
+    if (interval_us == 0U)
     {
-        return NULL;
+        return 0U;
     }
+    return (uint32_t)(((uint64_t)count * 1000000U + interval_us / 2U) / interval_us);
+}
+#endif
 
-    // Round CPU overall to 2 decimal places (XX.XX%)
-    float overall_raw = self.cpu_overall_percent[read_index];
-    double overall_rounded = round(overall_raw * 100.0) / 100.0;
-    cJSON_AddNumberToObject(cpu, "overall", overall_rounded);
+/**
+ * @brief Parse the projection parameters of a request.
+ *
+ * @param request HTTP request (NULL for the default projection, e.g. live push frames).
+ * @param query Output projection; release with _json_query_release(), also on failure.
+ * @return ESP_OK on success, ESP_ERR_INVALID_ARG for an unknown field or an invalid ?last=.
+ */
+static esp_err_t _json_query_parse(httpd_req_t *request, JsonQuery *query)
+{
+    static const struct
+    {
+        const char *name;
+        uint32_t flag;
+    } field_names[] =
+    {
+        { "cpu",    JSON_FIELD_CPU },
+        { "stack",  JSON_FIELD_STACK },
+        { "heap",   JSON_FIELD_HEAP },
+        { "core",   JSON_FIELD_CORE },
+        { "sched",  JSON_FIELD_SCHED },
+        { "system", JSON_FIELD_SYSTEM }
+    };
+
+    query->tasks  = _get_query_param_dup(request, "tasks");
+    query->fields = JSON_FIELD_ALL;
+    query->last   = 0;
+
+    char *fields = _get_query_param_dup(request, "fields");
+    if (fields != NULL)
+    {
+        query->fields = 0;
+        char *save = NULL;
+        for (char *name = strtok_r(fields, ",", &save); name != NULL; name = strtok_r(NULL, ",", &save))
+        {
+            size_t i = 0;
+            while (i < sizeof(field_names) / sizeof(field_names[0]) && strcmp(name, field_names[i].name) != 0)
+            {
+                i++;
+            }
+            if (i == sizeof(field_names) / sizeof(field_names[0]))
+            {
+                free(fields);
+                return ESP_ERR_INVALID_ARG;
+            }
+            query->fields |= field_names[i].flag;
+        }
+        free(fields);
+    }
 
-    cJSON *cores_array = cJSON_CreateArray();
-    if (cores_array == NULL)
+    char last[12];
+    if (_get_query_param(request, "last", last, sizeof(last)) &&
+        (!_get_query_uint(request, "last", &query->last) || query->last == 0U))
     {
-        JSON_CLEANUP(cpu);
-        return NULL;
+        return ESP_ERR_INVALID_ARG;
     }
-    // Round CPU core percentages to 2 decimal places (XX.XX%)
-    float core0_raw = self.cpu_core_percent[0][read_index];
-    float core1_raw = self.cpu_core_percent[1][read_index];
-    double core0_rounded = round(core0_raw * 100.0) / 100.0;
-    double core1_rounded = round(core1_raw * 100.0) / 100.0;
-    cJSON_AddItemToArray(cores_array, cJSON_CreateNumber(core0_rounded));
-    cJSON_AddItemToArray(cores_array, cJSON_CreateNumber(core1_rounded));
-    cJSON_AddItemToObject(cpu, "cores", cores_array);
-
-    return cpu;
+    return ESP_OK;
+}
+
+/**
+ * @brief Release a projection parsed by _json_query_parse().
+ *
+ * @param query Projection.
+ */
+static void _json_query_release(JsonQuery *query)
+{
+    free(query->tasks);
+    query->tasks = NULL;
 }
 
 /**
- * @brief Build memory summary JSON object.
+ * @brief Check a task against the ?tasks= list.
  *
- * @param read_index Index into series arrays for latest sample.
- * @return Memory summary JSON object, or NULL on allocation failure.
+ * @param query Projection.
+ * @param task_name Task name.
+ * @param name_ordinal Duplicate ordinal of the name.
+ * @return true if the list names the task's display key (e.g. "app_main", "worker#2")
+ *         or its plain name (all duplicates), or if there is no list.
  */
-static cJSON *_build_memory_summary(int read_index)
+static bool _json_query_wants_task(const JsonQuery *query, const char *task_name, uint8_t name_ordinal)
 {
-    cJSON *mem = cJSON_CreateObject();
-    if (mem == NULL)
+    if (query->tasks == NULL)
     {
-        return NULL;
+        return true;
     }
 
-    // DRAM stats
-    cJSON *dram = cJSON_CreateObject();
-    if (dram == NULL)
+    char key_buffer[32];
+    const char *key = _get_task_display_key(task_name, name_ordinal, key_buffer, sizeof(key_buffer));
+    size_t key_len  = strlen(key);
+    size_t name_len = strlen(task_name);
+    const char *item = query->tasks;
+    for (;;)
     {
-        JSON_CLEANUP(mem);
-        return NULL;
+        const char *end = strchr(item, ',');
+        size_t len = (end != NULL) ? (size_t)(end - item) : strlen(item);
+        if ((len == key_len && strncmp(item, key, len) == 0) ||
+            (len == name_len && strncmp(item, task_name, len) == 0))
+        {
+            return true;
+        }
+        if (end == NULL)
+        {
+            return false;
+        }
+        item = end + 1;
     }
-    cJSON_AddNumberToObject(dram, "free", (double)self.dram_free[read_index]);
-    cJSON_AddNumberToObject(dram, "largest", (double)self.dram_largest_block[read_index]);
-    cJSON_AddNumberToObject(dram, "total", (double)self.dram_total[read_index]);
-    cJSON_AddNumberToObject(dram, "usedPct", (double)self.dram_used_percent[read_index]);
-    cJSON_AddItemToObject(mem, "dram", dram);
+}
 
-    // PSRAM stats
-    cJSON *psram = cJSON_CreateObject();
-    if (psram == NULL)
+/**
+ * @brief Copy a task slot if the projection selects it.
+ *
+ * Only the name is copied to decide, so unselected tasks cost no copy of their histories.
+ *
+ * @param query Projection.
+ * @param view Pinned view.
+ * @param index Slot index.
+ * @param task Output copy (from _snapshot_alloc_task()).
+ * @param sequence Output: sequence number of the newest sample in the copy (may be NULL).
+ * @return true if the slot holds an active, selected task.
+ */
+static bool _json_query_read_task(const JsonQuery *query, const sysmon_view_t *view, int index,
+                                  TaskUsageSample *task, uint32_t *sequence)
+{
+    if (query->tasks != NULL)
     {
-        JSON_CLEANUP(mem);
-        return NULL;
+        char name[sizeof(task->task_name)];
+        uint8_t name_ordinal = 0;
+        if (!_snapshot_read_task_name(view, index, name, &name_ordinal) ||
+            !_json_query_wants_task(query, name, name_ordinal))
+        {
+            return false;
+        }
+    }
+
+    // The slot may have been re-bound since its name was read
+    return _snapshot_read_task(view, index, task, sequence) &&
+           _json_query_wants_task(query, task->task_name, task->name_ordinal);
+}
+
+/**
+ * @brief Write CPU summary JSON object.
+ *
+ * @param stream Streaming JSON writer.
+ * @param sample Copy of the latest published system-wide sample.
+ */
+static void _write_cpu_summary(json_stream_t *stream, const SysMonSeriesSample *sample)
+{
+    json_stream_object_begin(stream);
+
+    // Round CPU overall to 2 decimal places (XX.XX%)
+    json_stream_add_fixed(stream, "overall", sample->cpu_overall_percent, 2);
+
+    // Round CPU core percentages to 2 decimal places (XX.XX%)
+    json_stream_key(stream, "cores");
+    json_stream_array_begin(stream);
+    for (int core = 0; core < SYSMON_CORE_COUNT; core++)
+    {
+        json_stream_fixed(stream, sample->cpu_core_percent[core], 2);
+    }
+    json_stream_array_end(stream);
+
+#if CONFIG_SYSMON_ISR_MONITOR
+    // Share of each core spent in interrupt handlers (part of "cores", see sysmon_isr.h)
+    json_stream_key(stream, "isr");
+    json_stream_array_begin(stream);
+    for (int core = 0; core < SYSMON_CORE_COUNT; core++)
+    {
+        json_stream_fixed(stream, sample->isr_core_percent[core], 2);
+    }
+    json_stream_array_end(stream);
+#endif
+
+#if CONFIG_SYSMON_TRACE_SCHED_STATS
+    // Context switches per core, from the trace hooks (none before the second sample)
+    if (sample->sched_interval_us > 0U)
+    {
+        json_stream_key(stream, "switchesPerSec");
+        json_stream_array_begin(stream);
+        for (int core = 0; core < SYSMON_CORE_COUNT; core++)
+        {
+            json_stream_uint(stream, _per_second(sample->core_switches[core], sample->sched_interval_us));
+        }
+        json_stream_array_end(stream);
     }
-    cJSON_AddNumberToObject(psram, "free", (double)self.psram_free[read_index]);
-    cJSON_AddNumberToObject(psram, "total", (double)self.psram_total[read_index]);
-    cJSON_AddNumberToObject(psram, "usedPct", (double)self.psram_used_percent[read_index]);
-    cJSON_AddBoolToObject(psram, "present", self.psram_seen);
-    cJSON_AddItemToObject(mem, "psram", psram);
+#endif
+
+    json_stream_object_end(stream);
+}
+
+/**
+ * @brief Write memory summary JSON object.
+ *
+ * @param stream Streaming JSON writer.
+ * @param sample Copy of the latest published system-wide sample.
+ */
+static void _write_memory_summary(json_stream_t *stream, const SysMonSeriesSample *sample)
+{
+    json_stream_object_begin(stream);
+
+    // DRAM stats
+    json_stream_key(stream, "dram");
+    json_stream_object_begin(stream);
+    json_stream_add_uint(stream, "free", sample->dram_free);
+    json_stream_add_uint(stream, "largest", sample->dram_largest_block);
+    json_stream_add_uint(stream, "total", sample->dram_total);
+    json_stream_add_fixed(stream, "usedPct", sample->dram_used_percent, 2);
+    json_stream_add_fixed(stream, "fragPct", sample->dram_frag_percent, 2);
+    json_stream_object_end(stream);
+
+    // PSRAM stats
+    json_stream_key(stream, "psram");
+    json_stream_object_begin(stream);
+    json_stream_add_uint(stream, "free", sample->psram_free);
+    json_stream_add_uint(stream, "total", sample->psram_total);
+    json_stream_add_fixed(stream, "usedPct", sample->psram_used_percent, 2);
+    json_stream_add_bool(stream, "present", sample->psram_seen);
+    json_stream_object_end(stream);
+
+#if CONFIG_SYSMON_TASK_HEAP_ACCOUNTING
+    // Heap accounting outside of the live tasks (see sysmon_alloc.h)
+    sysmon_alloc_summary_t summary;
+    _alloc_read_summary(&summary);
+    json_stream_key(stream, "taskHeap");
+    json_stream_object_begin(stream);
+    json_stream_add_uint(stream, "exitedBytes", summary.exited_bytes);
+    json_stream_add_uint(stream, "exitedBlocks", summary.exited_blocks);
+    json_stream_add_uint(stream, "untrackedAllocs", summary.untracked_allocs);
+    json_stream_object_end(stream);
+#endif
+
+    json_stream_object_end(stream);
+}
 
-    return mem;
+/**
+ * @brief Write sampler schedule JSON object (timestamp, jitter and overrun counters).
+ *
+ * @param stream Streaming JSON writer.
+ * @param sample Copy of the latest published system-wide sample.
+ */
+static void _write_sampling_info(json_stream_t *stream, const SysMonSeriesSample *sample)
+{
+    json_stream_object_begin(stream);
+    json_stream_add_uint(stream, "intervalMs", CONFIG_SYSMON_CPU_SAMPLING_INTERVAL_MS);
+    json_stream_add_uint(stream, "phaseMs", CONFIG_SYSMON_CPU_SAMPLING_PHASE_MS % CONFIG_SYSMON_CPU_SAMPLING_INTERVAL_MS);
+    json_stream_add_uint64(stream, "timestampUs", (uint64_t)sample->timestamp_us);
+    json_stream_add_int(stream, "jitterUs", sample->jitter_us);
+    json_stream_add_int(stream, "maxJitterUs", sample->jitter_max_us);
+    json_stream_add_uint(stream, "overruns", sample->overruns);
+    json_stream_add_uint(stream, "skipped", sample->skipped);
+#if CONFIG_SYSMON_LIGHT_SAMPLING
+    json_stream_add_uint(stream, "stackScanAge", sample->stack_scan_age);
+#endif
+#if CONFIG_SYSMON_TRACE_HOOKS
+    json_stream_add_uint(stream, "traceUntrackedSwitches", _trace_untracked_switches());
+#endif
+    json_stream_object_end(stream);
 }
 
 /**
@@ -326,409 +643,1474 @@ static bool _get_partition_usage(const esp_partition_t *part,
 }
 
 /**
- * @brief Build partitions JSON array.
+ * @brief Check whether a partition is an NVS data partition.
+ *
+ * @param part Partition to check.
+ * @return true for NVS partitions (whose usage changes at runtime).
+ */
+static bool _is_nvs_partition(const esp_partition_t *part)
+{
+    return part->type == ESP_PARTITION_TYPE_DATA && part->subtype == ESP_PARTITION_SUBTYPE_DATA_NVS;
+}
+
+/**
+ * @brief Collect the partition table and per-partition usage into the hardware cache.
  *
- * @return Partitions JSON array, or NULL on allocation failure.
+ * @return ESP_OK on success, ESP_ERR_NO_MEM on allocation failure.
  *
  * Details:
- *   - Enumerates all partitions in the partition table.
- *   - Includes label, type, subtype, address, and size for each partition.
- *   - Includes usage statistics (used, free, usedPct) when available.
- *   - All allocations checked for robustness.
+ *   - Enumerates all partitions in the partition table (phy_init is skipped).
+ *   - App image sizes are read from flash here, once, not on every request.
+ *   - Partition pointers stay valid for the lifetime of the application.
  */
-static cJSON *_build_partitions_json(void)
+static esp_err_t _collect_partitions(void)
 {
-    cJSON *partitions = cJSON_CreateArray();
-    if (partitions == NULL)
-    {
-        return NULL;
-    }
+    size_t count = 0;
+    size_t capacity = 0;
+    HardwarePartition *records = NULL;
 
     esp_partition_iterator_t it = esp_partition_find(ESP_PARTITION_TYPE_ANY, 
                                                      ESP_PARTITION_SUBTYPE_ANY, 
                                                      NULL);
-    if (it == NULL)
-    {
-        // No partitions found, return empty array
-        return partitions;
-    }
-
     while (it != NULL)
     {
         const esp_partition_t *part = esp_partition_get(it);
-        if (part == NULL)
-        {
-            it = esp_partition_next(it);
-            continue;
-        }
 
         // Skip system partitions that don't need to be displayed
         // phy_init is a system partition for PHY initialization data
         // Note: part->label is a char array, not a pointer, so we can compare directly
-        if (strcmp(part->label, "phy_init") == 0)
+        if (part == NULL || strcmp(part->label, "phy_init") == 0)
         {
             it = esp_partition_next(it);
             continue;
         }
 
-        cJSON *part_obj = cJSON_CreateObject();
-        if (part_obj == NULL)
-        {
-            esp_partition_iterator_release(it);
-            JSON_CLEANUP(partitions);
-            return NULL;
-        }
-
-        cJSON_AddStringToObject(part_obj, "label", part->label);
-        cJSON_AddNumberToObject(part_obj, "type", (double)part->type);
-        cJSON_AddNumberToObject(part_obj, "address", (double)part->address);
-        cJSON_AddNumberToObject(part_obj, "size", (double)part->size);
-
-        // Get usage statistics if available
-        uint32_t used_bytes = 0;
-        uint32_t free_bytes = 0;
-        bool usage_available = _get_partition_usage(part, &used_bytes, &free_bytes);
-        
-        cJSON_AddBoolToObject(part_obj, "usageAvailable", usage_available);
-        if (usage_available)
+        if (count == capacity)
         {
-            cJSON_AddNumberToObject(part_obj, "used", (double)used_bytes);
-            cJSON_AddNumberToObject(part_obj, "free", (double)free_bytes);
-            if (part->size > 0)
+            size_t new_capacity = (capacity == 0) ? 8 : capacity * 2;
+            HardwarePartition *grown = (HardwarePartition *)realloc(records, new_capacity * sizeof(HardwarePartition));
+            if (grown == NULL)
             {
-                double used_pct = ((double)used_bytes / (double)part->size) * 100.0;
-                cJSON_AddNumberToObject(part_obj, "usedPct", used_pct);
-            }
-            else
-            {
-                cJSON_AddNumberToObject(part_obj, "usedPct", 0.0);
+                esp_partition_iterator_release(it);
+                free(records);
+                return ESP_ERR_NO_MEM;
             }
+            records  = grown;
+            capacity = new_capacity;
         }
 
-        cJSON_AddItemToArray(partitions, part_obj);
+        HardwarePartition *record = &records[count++];
+        record->part            = part;
+        record->usage_available = _get_partition_usage(part, &record->used_bytes, &record->free_bytes);
+
         it = esp_partition_next(it);
     }
     esp_partition_iterator_release(it);
 
-    return partitions;
+    s_hardware.partitions      = records;
+    s_hardware.partition_count = count;
+    return ESP_OK;
 }
 
 /**
- * @brief Build current task usage JSON object.
- *
- * @return Current task usage JSON object, or NULL on allocation failure.
+ * @brief Re-read the usage of NVS partitions (the only partition usage that changes at runtime).
  */
-static cJSON *_build_current_task_usage(void)
+static void _refresh_nvs_usage(void)
 {
-    cJSON *current = cJSON_CreateObject();
-    if (current == NULL)
-    {
-        return NULL;
-    }
-
-    for (int i = 0; i < self.task_capacity; i++)
+    for (size_t i = 0; i < s_hardware.partition_count; i++)
     {
-        if (!self.tasks || !self.tasks[i].is_active)
-        {
-            continue;
-        }
-
-        int read_index = (self.tasks[i].write_index - 1 + CONFIG_SYSMON_SAMPLE_COUNT) % CONFIG_SYSMON_SAMPLE_COUNT;
-        cJSON *task_obj = cJSON_CreateObject();
-        if (task_obj == NULL)
-        {
-            JSON_CLEANUP(current);
-            return NULL;
-        }
-        // Round CPU usage to 2 decimal places (XX.XX%)
-        float cpu_raw = self.tasks[i].usage_percent_history[read_index];
-        double cpu_rounded = round(cpu_raw * 100.0) / 100.0;
-        cJSON_AddNumberToObject(task_obj, "cpu", cpu_rounded);
-
-        double stack_bytes = (double)self.tasks[i].stack_usage_bytes_history[read_index];
-        double stack_pct   = (double)self.tasks[i].stack_usage_percent_history[read_index];
-        cJSON_AddNumberToObject(task_obj, "stack", stack_bytes);
-        cJSON_AddNumberToObject(task_obj, "stackPct", stack_pct);
-
-        // Only include stackRemaining if stack & stackPct are nonzero
-        if (stack_bytes > 0.0 && stack_pct > 0.0)
+        HardwarePartition *record = &s_hardware.partitions[i];
+        if (_is_nvs_partition(record->part))
         {
-            uint32_t stack_remaining_bytes = self.tasks[i].stack_high_water_mark * sizeof(StackType_t);
-            cJSON_AddNumberToObject(task_obj, "stackRemaining", (double)stack_remaining_bytes);
+            record->usage_available = _get_partition_usage(record->part, &record->used_bytes, &record->free_bytes);
         }
-
-        // Use display name for JSON key (renames "main" to "app_main")
-        const char *display_name = _get_task_display_name(self.tasks[i].task_name);
-        cJSON_AddItemToObject(current, display_name, task_obj);
     }
-
-    return current;
+    s_hardware.nvs_refreshed_at = xTaskGetTickCount();
 }
 
-// ============================================================================
-// Public API Functions (Endpoint Handlers)
-// ============================================================================
-
 /**
- * @brief Build task metadata JSON object for all monitored tasks.
+ * @brief Write the partitions JSON array from the hardware cache.
  *
- * @return Pointer to root cJSON object (must be freed by caller), or NULL on oom.
+ * @param stream Streaming JSON writer.
  *
  * Details:
- *   - Iterates over all known tasks, skipping inactive or missing entries.
- *   - For each active task, emits static task metadata: core, priority, stack sizes.
- *   - Top-level dictionary keys are task names, values are per-task metadata objects.
- *   - Fails safely on allocation errors—frees all partial data.
+ *   - Includes label, type, address, and size for each partition.
+ *   - Includes usage statistics (used, free, usedPct) when available.
  */
-cJSON *_create_tasks_json(void)
+static void _write_partitions(json_stream_t *stream)
 {
-    cJSON *root = cJSON_CreateObject();
-    if (root == NULL)
-    {
-        return NULL;
-    }
-
-    for (int i = 0; i < self.task_capacity; i++)
+    json_stream_array_begin(stream);
+    for (size_t i = 0; i < s_hardware.partition_count; i++)
     {
-        // Defensive skip for inactive or missing tasks.
-        if (!self.tasks || !self.tasks[i].is_active)
-        {
-            continue;
-        }
+        const HardwarePartition *record = &s_hardware.partitions[i];
+        const esp_partition_t *part = record->part;
 
-        cJSON *task_obj = cJSON_CreateObject();
-        if (task_obj == NULL)
-        {
-            JSON_CLEANUP(root);
-            return NULL;
-        }
-
-        int read_index = (self.tasks[i].write_index - 1 + CONFIG_SYSMON_SAMPLE_COUNT) % CONFIG_SYSMON_SAMPLE_COUNT;
-
-        cJSON_AddNumberToObject(task_obj, "core", self.tasks[i].core_id);
-        cJSON_AddNumberToObject(task_obj, "prio", (double)self.tasks[i].current_priority);
-        cJSON_AddNumberToObject(task_obj, "stackSize", (double)self.tasks[i].stack_size_bytes);
+        json_stream_object_begin(stream);
+        json_stream_add_string(stream, "label", part->label);
+        json_stream_add_int(stream, "type", (int32_t)part->type);
+        json_stream_add_uint(stream, "address", part->address);
+        json_stream_add_uint(stream, "size", part->size);
 
-        double stack_bytes = (double)self.tasks[i].stack_usage_bytes_history[read_index];
-        double stack_pct   = (double)self.tasks[i].stack_usage_percent_history[read_index];
-
-        cJSON_AddNumberToObject(task_obj, "stackUsed", stack_bytes);
-        cJSON_AddNumberToObject(task_obj, "stackUsedPct", stack_pct);
-
-        // Only include stackRemaining if stack & stackPct are nonzero
-        if (stack_bytes > 0.0 && stack_pct > 0.0)
+        json_stream_add_bool(stream, "usageAvailable", record->usage_available);
+        if (record->usage_available)
         {
-            uint32_t stack_remaining_bytes = self.tasks[i].stack_high_water_mark * sizeof(StackType_t);
-            cJSON_AddNumberToObject(task_obj, "stackRemaining", (double)stack_remaining_bytes);
+            json_stream_add_uint(stream, "used", record->used_bytes);
+            json_stream_add_uint(stream, "free", record->free_bytes);
+            double used_pct = (part->size > 0) ? ((double)record->used_bytes / (double)part->size) * 100.0 : 0.0;
+            json_stream_add_fixed(stream, "usedPct", used_pct, 2);
         }
-
-        // Use display name for JSON key (renames "main" to "app_main")
-        const char *display_name = _get_task_display_name(self.tasks[i].task_name);
-        cJSON_AddItemToObject(root, display_name, task_obj);
+        json_stream_object_end(stream);
     }
-
-    return root;
+    json_stream_array_end(stream);
 }
 
 /**
- * @brief Build JSON object tracing task usage history for all monitored tasks.
+ * @brief Write the flash summary JSON object (total flash size and unused space).
  *
- * @return Root cJSON object, or NULL on allocation failure.
+ * @param stream Streaming JSON writer.
  *
- * Details:
- *   - Each key (task name) maps to an object with "cpu" and "stack" arrays.
- *   - "cpu" array contains CPU usage percent samples over time (rounded to 1 decimal place).
- *   - "stack" array contains stack usage in bytes samples over time (only for registered tasks).
- *   - Only active, known tasks included.
- *   - Array order is oldest-to-newest based on cyclic buffer logic.
- *   - All allocations checked for robustness/low-memory resilience.
+ * "unused" is 0 when the partitions reach past the reported flash size.
  */
-cJSON *_create_history_json(void)
+static void _write_flash_summary(json_stream_t *stream)
 {
-    cJSON *root = cJSON_CreateObject();
-    if (root == NULL)
+    uint32_t total_flash_size = s_hardware.total_flash_size;
+
+    // Calculate total partition size
+    uint32_t total_partition_size = 0;
+    for (size_t i = 0; i < s_hardware.partition_count; i++)
     {
-        return NULL;
+        total_partition_size += s_hardware.partitions[i].part->size;
     }
+    // Partitions can add up to more than the reported size (unknown or misdetected flash chip)
+    uint32_t unused_flash = (total_partition_size < total_flash_size) ? total_flash_size - total_partition_size : 0U;
+    double flash_size = (total_flash_size > 0U) ? (double)total_flash_size : 1.0;
+
+    json_stream_object_begin(stream);
+    json_stream_add_uint(stream, "totalFlash", total_flash_size);
+    json_stream_add_uint(stream, "totalPartitions", total_partition_size);
+    json_stream_add_uint(stream, "unused", unused_flash);
+    json_stream_add_fixed(stream, "unusedPct", ((double)unused_flash / flash_size) * 100.0, 2);
+    json_stream_add_fixed(stream, "partitionsPct", ((double)total_partition_size / flash_size) * 100.0, 2);
+    json_stream_object_end(stream);
+}
+
+/**
+ * @brief Write current task usage JSON object.
+ *
+ * @param stream Streaming JSON writer.
+ * @param view Pinned task array view.
+ * @param task Scratch slot receiving a coherent copy of each task.
+ * @param interval_us Length of the sample interval the scheduling counters cover (0 if unknown).
+ * @param query Tasks and fields to write.
+ */
+static void _write_current_task_usage(json_stream_t *stream, const sysmon_view_t *view, TaskUsageSample *task,
+                                      uint32_t interval_us, const JsonQuery *query)
+{
+    json_stream_object_begin(stream);
 
-    for (int i = 0; i < self.task_capacity; i++)
+    for (int i = 0; i < view->task_capacity && (query->fields & JSON_FIELD_TASKS) != 0U; i++)
     {
-        if (!self.tasks || !self.tasks[i].is_active)
+        if (!_json_query_read_task(query, view, i, task, NULL))
         {
             continue;
         }
 
-        cJSON *task_obj = cJSON_CreateObject();
-        if (task_obj == NULL)
-        {
-            JSON_CLEANUP(root);
-            return NULL;
-        }
+        // Use display name for JSON key (renames "main" to "app_main", suffixes duplicates)
+        char key_buffer[32];
+        json_stream_key(stream, _get_task_display_key(task->task_name, task->name_ordinal,
+                                                      key_buffer, sizeof(key_buffer)));
+        json_stream_object_begin(stream);
 
-        // CPU history array
-        cJSON *cpu_array = cJSON_CreateArray();
-        if (cpu_array == NULL)
+        // Round CPU usage to 2 decimal places (XX.XX%)
+        if (query->fields & JSON_FIELD_CPU)
         {
-            JSON_CLEANUP(task_obj, root);
-            return NULL;
+            json_stream_add_fixed(stream, "cpu", task->usage_percent, 2);
         }
 
-        // Stack history array (only for registered tasks)
-        cJSON *stack_array = NULL;
-        bool is_registered = (self.tasks[i].stack_size_bytes > 0U);
-        if (is_registered)
+        uint32_t stack_bytes = task->stack_used_bytes;
+        float stack_pct      = task->stack_used_percent;
+        if (query->fields & JSON_FIELD_STACK)
         {
-            stack_array = cJSON_CreateArray();
-            if (stack_array == NULL)
+            json_stream_add_uint(stream, "stack", stack_bytes);
+            json_stream_add_fixed(stream, "stackPct", stack_pct, 2);
+
+            // Only include stackRemaining if stack & stackPct are nonzero
+            if (stack_bytes > 0U && stack_pct > 0.0f)
             {
-                JSON_CLEANUP(cpu_array, task_obj, root);
-                return NULL;
+                uint32_t stack_remaining_bytes = task->stack_high_water_mark * sizeof(StackType_t);
+                json_stream_add_uint(stream, "stackRemaining", stack_remaining_bytes);
             }
         }
 
-        // Start from current write index (oldest sample).
-        int read_index = self.tasks[i].write_index;
-        for (int j = 0; j < CONFIG_SYSMON_SAMPLE_COUNT; j++)
+#if CONFIG_SYSMON_TRACE_HOOKS
+        // Per-core split of the CPU usage above, from the trace hooks
+        if (task->core_trace_valid && (query->fields & JSON_FIELD_CORE))
         {
-            // Round CPU usage to 1 decimal place to reduce JSON size
-            float cpu_raw = self.tasks[i].usage_percent_history[read_index];
-            double cpu_rounded = round(cpu_raw * 10.0) / 10.0;
-            cJSON *cpu_value = cJSON_CreateNumber(cpu_rounded);
-            if (cpu_value == NULL)
+            json_stream_key(stream, "coreCpu");
+            json_stream_array_begin(stream);
+            for (int core = 0; core < SYSMON_CORE_COUNT; core++)
             {
-                JSON_CLEANUP(cpu_array, stack_array, task_obj, root);
-                return NULL;
-            }
-            cJSON_AddItemToArray(cpu_array, cpu_value);
-
-            // Only generate stack history for registered tasks
-            if (is_registered)
-            {
-                uint32_t stack_value_bytes = self.tasks[i].stack_usage_bytes_history[read_index];
-                cJSON *stack_value = cJSON_CreateNumber((double)stack_value_bytes);
-                if (stack_value == NULL)
-                {
-                    JSON_CLEANUP(cpu_array, stack_array, task_obj, root);
-                    return NULL;
-                }
-                cJSON_AddItemToArray(stack_array, stack_value);
+                json_stream_fixed(stream, task->core_usage_percent[core], 2);
             }
+            json_stream_array_end(stream);
+            json_stream_add_uint(stream, "migrations", task->migrations);
+        }
+#endif
 
-            read_index = (read_index + 1) % CONFIG_SYSMON_SAMPLE_COUNT;
+#if CONFIG_SYSMON_TRACE_SCHED_STATS
+        // Switch-in rate and ready-to-run latency during the latest sample interval, from the trace hooks
+        if (task->sched_valid && interval_us > 0U && (query->fields & JSON_FIELD_SCHED))
+        {
+            json_stream_add_uint(stream, "switchesPerSec", _per_second(task->sched_switches, interval_us));
+            json_stream_add_uint(stream, "readyAvgUs", task->ready_avg_us);
+            json_stream_add_uint(stream, "readyMaxUs", task->ready_max_us);
         }
+#else
+        (void)interval_us;
+#endif
 
-        cJSON_AddItemToObject(task_obj, "cpu", cpu_array);
-        if (is_registered && stack_array != NULL)
+#if CONFIG_SYSMON_TASK_HEAP_ACCOUNTING
+        // Live heap and allocations during the latest sample interval, from the heap hooks
+        if (task->heap_valid && (query->fields & JSON_FIELD_HEAP))
         {
-            cJSON_AddItemToObject(task_obj, "stack", stack_array);
+            json_stream_add_uint(stream, "heap", task->heap_live_bytes);
+            json_stream_add_uint(stream, "heapBlocks", task->heap_live_blocks);
+            json_stream_add_uint(stream, "allocs", task->heap_sample_allocs);
+            json_stream_add_uint(stream, "allocBytes", task->heap_sample_alloc_bytes);
         }
-        // Use display name for JSON key (renames "main" to "app_main")
-        const char *display_name = _get_task_display_name(self.tasks[i].task_name);
-        cJSON_AddItemToObject(root, display_name, task_obj);
+#endif
+
+        json_stream_object_end(stream);
     }
 
-    return root;
+    json_stream_object_end(stream);
 }
 
 /**
- * @brief Build a complete telemetry JSON object summarizing CPU/memory and current registered task usage.
- *
- * @return Root cJSON object, or NULL on allocation failure.
+ * @brief Size of one element of a history ring.
  *
- * Details:
- *   - Produces a two-level structure:
- *       root->summary: {cpu, mem}, root->current: {task current usages}
- *   - 'cpu' includes overall percent + per-core array.
- *   - 'mem' summary embeds DRAM and (if present) PSRAM details.
- *   - Defensive allocation checks propagate errors cleanly upward.
+ * @param type Element type.
+ * @return Size in bytes.
  */
-cJSON *_create_telemetry_json(void)
+static size_t _history_source_element_size(HistoryValueType type)
 {
-    cJSON *root = cJSON_CreateObject();
-    if (root == NULL)
-    {
-        return NULL;
-    }
-
-    int read_index = (self.series_write_index - 1 + CONFIG_SYSMON_SAMPLE_COUNT) % CONFIG_SYSMON_SAMPLE_COUNT;
-
-    // Summary object
-    cJSON *summary = cJSON_CreateObject();
-    if (summary == NULL)
-    {
-        JSON_CLEANUP(root);
-        return NULL;
-    }
-
-    cJSON *cpu = _build_cpu_summary(read_index);
-    if (cpu == NULL)
-    {
-        JSON_CLEANUP(summary, root);
-        return NULL;
-    }
-    cJSON_AddItemToObject(summary, "cpu", cpu);
-
-    cJSON *mem = _build_memory_summary(read_index);
-    if (mem == NULL)
-    {
-        JSON_CLEANUP(summary, root);
-        return NULL;
-    }
-    cJSON_AddItemToObject(summary, "mem", mem);
-
-    // WiFi RSSI (signal strength)
-    int8_t rssi = 0;
-    esp_err_t rssi_err = _get_wifi_rssi(&rssi);
-    if (rssi_err == ESP_OK)
+    switch (type)
     {
-        cJSON_AddNumberToObject(summary, "wifiRssi", (double)rssi);
+        case HISTORY_VALUE_TIME:  return sizeof(int64_t);
+        case HISTORY_VALUE_CPU:   return sizeof(sysmon_cpu_sample_t);
+        case HISTORY_VALUE_STACK: return sizeof(sysmon_stack_sample_t);
+        default:                  return sizeof(uint32_t);
     }
-    else
-    {
-        cJSON_AddNullToObject(summary, "wifiRssi");
-    }
-
-    cJSON_AddItemToObject(root, "summary", summary);
-
-    // Current task usage
-    cJSON *current = _build_current_task_usage();
-    if (current == NULL)
-    {
-        JSON_CLEANUP(root);
-        return NULL;
-    }
-    cJSON_AddItemToObject(root, "current", current);
-
-    return root;
 }
 
 /**
- * @brief Create hardware information JSON object with static chip and system info.
+ * @brief Write the samples (since, until] of one history ring as a JSON array, a window at a time.
  *
- * @return Hardware info JSON object, or NULL on allocation failure.
+ * @param stream Streaming JSON writer.
+ * @param key Object key of the array.
+ * @param source Ring to read.
+ * @param since Last sequence number the client already has.
+ * @param until Sequence number of the last sample to write (at most the latest published one).
  *
- * Details:
- *   - Retrieves static hardware information that doesn't change during execution.
- *   - Includes chip model, revision, cores, features.
- *   - Includes ESP-IDF version, build info, memory totals.
- *   - All allocations checked for robustness.
+ * Copies HISTORY_SINCE_WINDOW samples per snapshot read into a stack buffer, so
+ * the memory needed does not depend on the history depth. Samples overwritten
+ * before their window was copied are written as null.
  */
-cJSON *_create_hardware_json(void)
+static void _write_series_since(json_stream_t *stream, const char *key, const HistorySource *source,
+                                uint32_t since, uint32_t until)
 {
-    cJSON *root = cJSON_CreateObject();
-    if (root == NULL)
+    // Widest element: 64-bit timestamps
+    int64_t window[HISTORY_SINCE_WINDOW];
+
+    json_stream_key(stream, key);
+    json_stream_array_begin(stream);
+    uint32_t first = since + 1U;
+    uint32_t remaining = until - since;
+    while (remaining > 0U && stream->error == ESP_OK)
     {
-        return NULL;
-    }
-
-    // Chip information
-    esp_chip_info_t chip_info;
-    esp_chip_info(&chip_info);
+        int count = (remaining < HISTORY_SINCE_WINDOW) ? (int)remaining : HISTORY_SINCE_WINDOW;
+        int missing = (source->view != NULL)
+                      ? _snapshot_read_task_window(source->view, source->task_index, source->task_id,
+                                                   source->column, first, count, window)
+                      : _snapshot_read_ring_window(source->ring, _history_source_element_size(source->type),
+                                                   first, count, window);
+        for (int k = 0; k < count; k++)
+        {
+            if (k < missing)
+            {
+                json_stream_null(stream);
+                continue;
+            }
+            switch (source->type)
+            {
+                case HISTORY_VALUE_FLOAT:
+                    json_stream_fixed(stream, ((const float *)(const void *)window)[k], 1);
+                    break;
+                case HISTORY_VALUE_UINT:
+                    json_stream_uint(stream, ((const uint32_t *)(const void *)window)[k]);
+                    break;
+                case HISTORY_VALUE_INT:
+                    json_stream_int(stream, ((const int32_t *)(const void *)window)[k]);
+                    break;
+                case HISTORY_VALUE_TIME:
+                    json_stream_uint64(stream, (uint64_t)window[k]);
+                    break;
+                case HISTORY_VALUE_CPU:
+                    json_stream_fixed(stream, _history_decode_cpu(((const sysmon_cpu_sample_t *)(const void *)window)[k]), 1);
+                    break;
+                default:
+                    json_stream_uint(stream, _history_decode_stack(((const sysmon_stack_sample_t *)(const void *)window)[k]));
+                    break;
+            }
+        }
+        first += (uint32_t)count;
+        remaining -= (uint32_t)count;
+    }
+    json_stream_array_end(stream);
+}
+
+/**
+ * @brief Write the samples (since, until] of a system-wide ring of self as a JSON array.
+ *
+ * @param stream Streaming JSON writer.
+ * @param key Object key of the array.
+ * @param ring Ring buffer of self (may be NULL: every sample is written as null).
+ * @param type Element type of the ring.
+ * @param since Last sequence number the client already has.
+ * @param until Sequence number of the last sample to write.
+ */
+static void _write_ring_since(json_stream_t *stream, const char *key, const void *ring, HistoryValueType type,
+                              uint32_t since, uint32_t until)
+{
+    HistorySource source = { .ring = ring, .type = type };
+    _write_series_since(stream, key, &source, since, until);
+}
+
+/**
+ * @brief Write the samples (since, until] of a task's history column as a JSON array.
+ *
+ * @param stream Streaming JSON writer.
+ * @param key Object key of the array.
+ * @param view Pinned view.
+ * @param index Slot index of the task.
+ * @param task Metadata copy of the slot (identifies the task).
+ * @param column Column to write.
+ * @param since Last sequence number the client already has.
+ * @param until Sequence number of the last sample to write.
+ */
+static void _write_task_column_since(json_stream_t *stream, const char *key, const sysmon_view_t *view, int index,
+                                     const TaskUsageSample *task, sysmon_snapshot_column_t column,
+                                     uint32_t since, uint32_t until)
+{
+    static const HistoryValueType column_types[] =
+    {
+        [SNAPSHOT_COLUMN_CPU]   = HISTORY_VALUE_CPU,
+        [SNAPSHOT_COLUMN_STACK] = HISTORY_VALUE_STACK,
+        [SNAPSHOT_COLUMN_HEAP]  = HISTORY_VALUE_UINT
+    };
+    HistorySource source =
+    {
+        .view       = view,
+        .task_index = index,
+        .task_id    = task->task_id,
+        .column     = column,
+        .type       = column_types[column]
+    };
+    _write_series_since(stream, key, &source, since, until);
+}
+
+/**
+ * @brief Write the system-wide series samples (since, until] as a JSON object.
+ *
+ * @param stream Streaming JSON writer.
+ * @param since Last sequence number the client already has.
+ * @param until Sequence number of the newest sample to write.
+ */
+static void _write_system_series_since(json_stream_t *stream, uint32_t since, uint32_t until)
+{
+    json_stream_object_begin(stream);
+
+    _write_ring_since(stream, "timeUs", self.sample_time_us, HISTORY_VALUE_TIME, since, until);
+    _write_ring_since(stream, "jitterUs", self.sample_jitter_us, HISTORY_VALUE_INT, since, until);
+    _write_ring_since(stream, "cpu", self.cpu_overall_percent, HISTORY_VALUE_FLOAT, since, until);
+
+    for (int core = 0; core < SYSMON_CORE_COUNT; core++)
+    {
+        char key[12];
+        snprintf(key, sizeof(key), "core%d", core);
+        _write_ring_since(stream, key, self.cpu_core_percent[core], HISTORY_VALUE_FLOAT, since, until);
+    }
+
+#if CONFIG_SYSMON_ISR_MONITOR
+    for (int core = 0; core < SYSMON_CORE_COUNT; core++)
+    {
+        char key[12];
+        snprintf(key, sizeof(key), "isr%d", core);
+        _write_ring_since(stream, key, self.isr_core_percent[core], HISTORY_VALUE_FLOAT, since, until);
+    }
+#endif
+
+    _write_ring_since(stream, "dramFree", self.dram_free, HISTORY_VALUE_UINT, since, until);
+    _write_ring_since(stream, "dramMinFree", self.dram_min_free, HISTORY_VALUE_UINT, since, until);
+    _write_ring_since(stream, "dramLargest", self.dram_largest_block, HISTORY_VALUE_UINT, since, until);
+    _write_ring_since(stream, "dramUsedPct", self.dram_used_percent, HISTORY_VALUE_FLOAT, since, until);
+    _write_ring_since(stream, "dramFragPct", self.dram_frag_percent, HISTORY_VALUE_FLOAT, since, until);
+    _write_ring_since(stream, "psramFree", self.psram_free, HISTORY_VALUE_UINT, since, until);
+    _write_ring_since(stream, "psramUsedPct", self.psram_used_percent, HISTORY_VALUE_FLOAT, since, until);
+
+    json_stream_object_end(stream);
+}
+
+/**
+ * @brief Write the history samples published after a given sequence number.
+ *
+ * @param stream Streaming JSON writer (headers already set by the caller).
+ * @param since Last sequence number the client already has.
+ * @param query Tasks, fields and number of samples to write.
+ * @return ESP_OK on success, or the first error raised while streaming.
+ *
+ * Details:
+ *   - Output: {"seq":S,"since":N,"tasks":{key:{"cpu":[..],"stack":[..],"heap":[..]}},"system":{series:[..]}},
+ *     each array holding samples N+1..S, oldest first.
+ *   - S is read once up front; every ring is then read in windows of HISTORY_SINCE_WINDOW
+ *     samples addressed by sequence number, so all arrays cover the same samples even if the
+ *     sampler runs meanwhile, and the memory needed is independent of the history depth.
+ *     A sample overwritten before its window was read is null, and so are the remaining
+ *     samples of a task deleted while its arrays are written.
+ *   - since is clamped so at most self.history_depth samples (query->last, if set) are
+ *     sent; a since newer than S (device restarted) is treated as 0. Clients should use
+ *     the returned "since".
+ *   - A task that appeared after sample N reports zeros for the samples before it existed.
+ */
+static esp_err_t _write_history_since_json(json_stream_t *stream, uint32_t since, const JsonQuery *query)
+{
+    uint32_t until = _snapshot_read_sequence();
+    if (since > until)
+    {
+        since = 0;
+    }
+    uint32_t max_samples = (uint32_t)self.history_depth;
+    if (query->last > 0U && query->last < max_samples)
+    {
+        max_samples = query->last;
+    }
+    if (until - since > max_samples)
+    {
+        since = until - max_samples;
+    }
+
+    // Metadata only: the history columns are read in windows
+    TaskUsageSample *task = _snapshot_alloc_task(0U);
+    if (task == NULL)
+    {
+        return ESP_ERR_NO_MEM;
+    }
+
+    json_stream_object_begin(stream);
+    json_stream_add_uint(stream, "seq", until);
+    json_stream_add_uint(stream, "since", since);
+
+    // Per-task series
+    json_stream_key(stream, "tasks");
+    json_stream_object_begin(stream);
+    sysmon_view_t view;
+    _snapshot_acquire_view(&view);
+    for (int i = 0; i < view.task_capacity && stream->error == ESP_OK && (query->fields & JSON_FIELD_TASKS); i++)
+    {
+        if (!_json_query_read_task(query, &view, i, task, NULL))
+        {
+            continue;
+        }
+
+        char key_buffer[32];
+        json_stream_key(stream, _get_task_display_key(task->task_name, task->name_ordinal,
+                                                      key_buffer, sizeof(key_buffer)));
+        json_stream_object_begin(stream);
+        if (query->fields & JSON_FIELD_CPU)
+        {
+            _write_task_column_since(stream, "cpu", &view, i, task, SNAPSHOT_COLUMN_CPU, since, until);
+        }
+        if (task->stack_size_bytes > 0U && (query->fields & JSON_FIELD_STACK))
+        {
+            _write_task_column_since(stream, "stack", &view, i, task, SNAPSHOT_COLUMN_STACK, since, until);
+        }
+        if (CONFIG_SYSMON_TASK_HEAP_ACCOUNTING && (query->fields & JSON_FIELD_HEAP))
+        {
+            _write_task_column_since(stream, "heap", &view, i, task, SNAPSHOT_COLUMN_HEAP, since, until);
+        }
+        json_stream_object_end(stream);
+    }
+    _snapshot_release_view(&view);
+    json_stream_object_end(stream);
+
+    // System-wide series
+    if (query->fields & JSON_FIELD_SYSTEM)
+    {
+        json_stream_key(stream, "system");
+        _write_system_series_since(stream, since, until);
+    }
+    json_stream_object_end(stream);
+
+    free(task);
+    return stream->error;
+}
+
+/**
+ * @brief Ring index of a rollup bucket in a copy, if the copy still holds it.
+ *
+ * @param closed Number of buckets closed when the copy was taken.
+ * @param number Bucket number (1-based).
+ * @return Ring index, or -1 if the bucket is not in the copy.
+ */
+static int _rollup_index_for_bucket(uint32_t closed, uint32_t number)
+{
+    if (number == 0U || number > closed || closed - number >= (uint32_t)CONFIG_SYSMON_ROLLUP_DEPTH)
+    {
+        return -1;
+    }
+    return (int)((number - 1U) % CONFIG_SYSMON_ROLLUP_DEPTH);
+}
+
+/**
+ * @brief Write {"min":[..],"avg":[..],"max":[..]} for buckets first..last of a percentage ring copy.
+ *
+ * @param stream Streaming JSON writer.
+ * @param key Object key.
+ * @param ring Ring copy (CONFIG_SYSMON_ROLLUP_DEPTH buckets).
+ * @param closed Number of buckets closed when the copy was taken.
+ * @param first First bucket number to write.
+ * @param last Last bucket number to write.
+ */
+static void _write_percent_buckets(json_stream_t *stream, const char *key, const RollupPercentBucket *ring,
+                                   uint32_t closed, uint32_t first, uint32_t last)
+{
+    static const char *const fields[] = { "min", "avg", "max" };
+
+    json_stream_key(stream, key);
+    json_stream_object_begin(stream);
+    for (int f = 0; f < 3; f++)
+    {
+        json_stream_key(stream, fields[f]);
+        json_stream_array_begin(stream);
+        for (uint32_t n = first; n <= last; n++)
+        {
+            int index = _rollup_index_for_bucket(closed, n);
+            if (index < 0)
+            {
+                json_stream_null(stream);
+                continue;
+            }
+            const RollupPercentBucket *bucket = &ring[index];
+            uint16_t value = (f == 0) ? bucket->min : ((f == 1) ? bucket->avg : bucket->max);
+            json_stream_fixed(stream, value / 100.0, 2);
+        }
+        json_stream_array_end(stream);
+    }
+    json_stream_object_end(stream);
+}
+
+/**
+ * @brief Write {"min":[..],"avg":[..],"max":[..]} for buckets first..last of a byte count ring copy.
+ *
+ * @param stream Streaming JSON writer.
+ * @param key Object key.
+ * @param ring Ring copy (CONFIG_SYSMON_ROLLUP_DEPTH buckets).
+ * @param closed Number of buckets closed when the copy was taken.
+ * @param first First bucket number to write.
+ * @param last Last bucket number to write.
+ */
+static void _write_bytes_buckets(json_stream_t *stream, const char *key, const RollupBytesBucket *ring,
+                                 uint32_t closed, uint32_t first, uint32_t last)
+{
+    static const char *const fields[] = { "min", "avg", "max" };
+
+    json_stream_key(stream, key);
+    json_stream_object_begin(stream);
+    for (int f = 0; f < 3; f++)
+    {
+        json_stream_key(stream, fields[f]);
+        json_stream_array_begin(stream);
+        for (uint32_t n = first; n <= last; n++)
+        {
+            int index = _rollup_index_for_bucket(closed, n);
+            if (index < 0)
+            {
+                json_stream_null(stream);
+                continue;
+            }
+            const RollupBytesBucket *bucket = &ring[index];
+            json_stream_uint(stream, (f == 0) ? bucket->min : ((f == 1) ? bucket->avg : bucket->max));
+        }
+        json_stream_array_end(stream);
+    }
+    json_stream_object_end(stream);
+}
+
+/**
+ * @brief Format a bucket duration as the shortest "<n>ms", "<n>s" or "<n>m" label.
+ *
+ * @param duration_ms Duration in milliseconds.
+ * @param buffer Output buffer.
+ * @param buffer_size Size of the buffer.
+ */
+static void _format_duration(uint32_t duration_ms, char *buffer, size_t buffer_size)
+{
+    if (duration_ms % 60000U == 0U)
+    {
+        snprintf(buffer, buffer_size, "%" PRIu32 "m", duration_ms / 60000U);
+    }
+    else if (duration_ms % 1000U == 0U)
+    {
+        snprintf(buffer, buffer_size, "%" PRIu32 "s", duration_ms / 1000U);
+    }
+    else
+    {
+        snprintf(buffer, buffer_size, "%" PRIu32 "ms", duration_ms);
+    }
+}
+
+/**
+ * @brief Write the downsampled history of one rollup tier.
+ *
+ * @param stream Streaming JSON writer (headers already set by the caller).
+ * @param tier Rollup tier (see sysmon_rollup.h).
+ * @param query Tasks, fields and number of buckets to write.
+ * @return ESP_OK on success, or the first error raised while streaming.
+ *
+ * Details:
+ *   - Output: {"res":"10s","bucketMs":B,"bucketSamples":N,"seq":S,"lastBucketSeq":E,
+ *     "tasks":{key:{"cpu":{min,avg,max},"stackMax":[..]}},"system":{series:{min,avg,max}}},
+ *     each array holding the closed buckets, oldest first; the newest ends at sample E.
+ *   - The bucket range is fixed from S up front; every ring is copied afterwards and
+ *     indexed by bucket number, so all arrays cover the same buckets.
+ *   - Percentages have 2 decimals, byte counts are exact.
+ */
+static esp_err_t _write_history_rollup_json(json_stream_t *stream, int tier, const JsonQuery *query)
+{
+    uint32_t bucket_samples = _rollup_samples_per_bucket(tier);
+    uint32_t until          = _snapshot_read_sequence();
+    uint32_t last           = until / bucket_samples;
+    uint32_t count          = (last < (uint32_t)CONFIG_SYSMON_ROLLUP_DEPTH) ? last : CONFIG_SYSMON_ROLLUP_DEPTH;
+    if (query->last > 0U && query->last < count)
+    {
+        count = query->last;
+    }
+    uint32_t first          = last - count + 1U;
+
+    // Scratch ring copy, sized for the widest bucket type
+    RollupBytesBucket *ring_copy = (RollupBytesBucket *)malloc(sizeof(RollupBytesBucket) * CONFIG_SYSMON_ROLLUP_DEPTH);
+    TaskUsageSample *task        = _snapshot_alloc_task(SNAPSHOT_COPY_ROLLUP);
+    if (ring_copy == NULL || task == NULL)
+    {
+        free(ring_copy);
+        free(task);
+        return ESP_ERR_NO_MEM;
+    }
+    RollupPercentBucket *percent_copy = (RollupPercentBucket *)(void *)ring_copy;
+    uint32_t newest = 0;
+
+    char res[12];
+    _format_duration(bucket_samples * CONFIG_SYSMON_CPU_SAMPLING_INTERVAL_MS, res, sizeof(res));
+
+    json_stream_object_begin(stream);
+    json_stream_add_string(stream, "res", res);
+    json_stream_add_uint(stream, "bucketMs", bucket_samples * CONFIG_SYSMON_CPU_SAMPLING_INTERVAL_MS);
+    json_stream_add_uint(stream, "bucketSamples", bucket_samples);
+    json_stream_add_uint(stream, "seq", until);
+    json_stream_add_uint(stream, "lastBucketSeq", last * bucket_samples);
+
+    // Per-task buckets
+    json_stream_key(stream, "tasks");
+    json_stream_object_begin(stream);
+    sysmon_view_t view;
+    _snapshot_acquire_view(&view);
+    for (int i = 0; i < view.task_capacity && stream->error == ESP_OK && (query->fields & JSON_FIELD_TASKS); i++)
+    {
+        if (!_json_query_read_task(query, &view, i, task, &newest))
+        {
+            continue;
+        }
+        uint32_t closed = newest / bucket_samples;
+
+        char key_buffer[32];
+        json_stream_key(stream, _get_task_display_key(task->task_name, task->name_ordinal,
+                                                      key_buffer, sizeof(key_buffer)));
+        json_stream_object_begin(stream);
+        if (query->fields & JSON_FIELD_CPU)
+        {
+            _write_percent_buckets(stream, "cpu", task->rollup->cpu[tier], closed, first, last);
+        }
+        if (task->stack_size_bytes > 0U && (query->fields & JSON_FIELD_STACK))
+        {
+            json_stream_key(stream, "stackMax");
+            json_stream_array_begin(stream);
+            for (uint32_t n = first; n <= last; n++)
+            {
+                int index = _rollup_index_for_bucket(closed, n);
+                if (index < 0)
+                {
+                    json_stream_null(stream);
+                }
+                else
+                {
+                    json_stream_uint(stream, task->rollup->stack_max[tier][index]);
+                }
+            }
+            json_stream_array_end(stream);
+        }
+        json_stream_object_end(stream);
+    }
+    _snapshot_release_view(&view);
+    json_stream_object_end(stream);
+
+    // System-wide buckets
+    // Core series (SYSMON_ROLLUP_CORE0 + n) are named "core<n>"
+    static const char *const percent_keys[SYSMON_ROLLUP_PERCENT_SERIES] =
+    {
+        [SYSMON_ROLLUP_CPU]            = "cpu",
+        [SYSMON_ROLLUP_DRAM_USED_PCT]  = "dramUsedPct",
+        [SYSMON_ROLLUP_PSRAM_USED_PCT] = "psramUsedPct",
+        [SYSMON_ROLLUP_DRAM_FRAG_PCT]  = "dramFragPct"
+    };
+    static const char *const bytes_keys[SYSMON_ROLLUP_BYTES_SERIES] =
+    {
+        [SYSMON_ROLLUP_DRAM_FREE]     = "dramFree",
+        [SYSMON_ROLLUP_DRAM_MIN_FREE] = "dramMinFree",
+        [SYSMON_ROLLUP_DRAM_LARGEST]  = "dramLargest",
+        [SYSMON_ROLLUP_PSRAM_FREE]    = "psramFree"
+    };
+
+    if (query->fields & JSON_FIELD_SYSTEM)
+    {
+        json_stream_key(stream, "system");
+        json_stream_object_begin(stream);
+        for (int s = 0; s < SYSMON_ROLLUP_PERCENT_SERIES; s++)
+        {
+            char core_key[12];
+            const char *key = percent_keys[s];
+            if (s >= SYSMON_ROLLUP_CORE0 && s < SYSMON_ROLLUP_CORE0 + SYSMON_CORE_COUNT)
+            {
+                snprintf(core_key, sizeof(core_key), "core%d", s - SYSMON_ROLLUP_CORE0);
+                key = core_key;
+            }
+            _snapshot_read_block(self.rollup.percent[tier][s], sizeof(self.rollup.percent[tier][s]), percent_copy, &newest);
+            _write_percent_buckets(stream, key, percent_copy, newest / bucket_samples, first, last);
+        }
+        for (int s = 0; s < SYSMON_ROLLUP_BYTES_SERIES; s++)
+        {
+            _snapshot_read_block(self.rollup.bytes[tier][s], sizeof(self.rollup.bytes[tier][s]), ring_copy, &newest);
+            _write_bytes_buckets(stream, bytes_keys[s], ring_copy, newest / bucket_samples, first, last);
+        }
+        json_stream_object_end(stream);
+    }
+
+    json_stream_object_end(stream);
+
+    free(ring_copy);
+    free(task);
+    return stream->error;
+}
+
+/**
+ * @brief Write the full per-sample history of every selected task.
+ *
+ * @param stream Streaming JSON writer (headers already set by the caller).
+ * @param query Tasks, fields and number of samples to write.
+ * @return ESP_OK on success, or the first error raised while streaming.
+ */
+static esp_err_t _write_history_samples_json(json_stream_t *stream, const JsonQuery *query)
+{
+    TaskUsageSample *task = _snapshot_alloc_task(SNAPSHOT_COPY_HISTORY);
+    if (task == NULL)
+    {
+        return ESP_ERR_NO_MEM;
+    }
+
+    sysmon_view_t view;
+    _snapshot_acquire_view(&view);
+
+    json_stream_object_begin(stream);
+
+    // Newest samples to write, oldest first
+    int count = view.depth;
+    if (query->last > 0U && query->last < (uint32_t)count)
+    {
+        count = (int)query->last;
+    }
+
+    for (int i = 0; i < view.task_capacity && stream->error == ESP_OK && (query->fields & JSON_FIELD_TASKS); i++)
+    {
+        // Copy the whole ring first so a row never mixes two samples
+        if (!_json_query_read_task(query, &view, i, task, NULL))
+        {
+            continue;
+        }
+        int first_index = (task->write_index + view.depth - count) % view.depth;
+
+        // Use display name for JSON key (renames "main" to "app_main", suffixes duplicates)
+        char key_buffer[32];
+        json_stream_key(stream, _get_task_display_key(task->task_name, task->name_ordinal,
+                                                      key_buffer, sizeof(key_buffer)));
+        json_stream_object_begin(stream);
+
+        // CPU history array, starting from the oldest sample written.
+        // Rounded to 1 decimal place to reduce JSON size.
+        int read_index = first_index;
+        if (query->fields & JSON_FIELD_CPU)
+        {
+            json_stream_key(stream, "cpu");
+            json_stream_array_begin(stream);
+            for (int j = 0; j < count; j++)
+            {
+                json_stream_fixed(stream, _history_decode_cpu(task->usage_percent_history[read_index]), 1);
+                read_index = (read_index + 1) % view.depth;
+            }
+            json_stream_array_end(stream);
+        }
+
+        // Stack history array (only for registered tasks)
+        if (task->stack_size_bytes > 0U && (query->fields & JSON_FIELD_STACK))
+        {
+            json_stream_key(stream, "stack");
+            json_stream_array_begin(stream);
+            read_index = first_index;
+            for (int j = 0; j < count; j++)
+            {
+                json_stream_uint(stream, _history_decode_stack(task->stack_usage_bytes_history[read_index]));
+                read_index = (read_index + 1) % view.depth;
+            }
+            json_stream_array_end(stream);
+        }
+
+        // Live heap history array (only with per-task heap accounting)
+        if (task->heap_live_history != NULL && (query->fields & JSON_FIELD_HEAP))
+        {
+            json_stream_key(stream, "heap");
+            json_stream_array_begin(stream);
+            read_index = first_index;
+            for (int j = 0; j < count; j++)
+            {
+                json_stream_uint(stream, task->heap_live_history[read_index]);
+                read_index = (read_index + 1) % view.depth;
+            }
+            json_stream_array_end(stream);
+        }
+
+        json_stream_object_end(stream);
+    }
+
+    json_stream_object_end(stream);
+
+    _snapshot_release_view(&view);
+    free(task);
+    return stream->error;
+}
+
+// ============================================================================
+// Public API Functions (Endpoint Handlers)
+// ============================================================================
+
+/**
+ * @brief Write task metadata JSON object for all monitored tasks.
+ *
+ * @param stream Streaming JSON writer (headers already set by the caller).
+ * @return ESP_OK on success, or the first error raised while streaming.
+ *
+ * Details:
+ *   - Iterates over all known tasks, skipping inactive or missing entries.
+ *   - For each active task, emits static task metadata: core, priority, stack sizes.
+ *   - Lifetime statistics of the task entry (see sysmon_task_stats.h): CPU usage percentiles
+ *     (cpuP50, cpuP95, cpuP99), cpuMax, stackMinFree (lowest stack never used, bytes) and
+ *     statSamples (samples they cover).
+ *   - With CONFIG_SYSMON_TRACE_SCHED_STATS, the ready-to-run latency distribution of the task
+ *     (readyP50Us, readyP99Us, readyMaxUs and the readyHist bucket counts, see sysmon_trace.h).
+ *   - Top-level dictionary keys are task names, values are per-task metadata objects.
+ *   - Each task is copied as of one published sample, so a row is never torn.
+ */
+esp_err_t _write_tasks_json(json_stream_t *stream)
+{
+    TaskUsageSample *task = _snapshot_alloc_task(0U);
+    if (task == NULL)
+    {
+        return ESP_ERR_NO_MEM;
+    }
+
+    sysmon_view_t view;
+    _snapshot_acquire_view(&view);
+
+    json_stream_object_begin(stream);
+
+    for (int i = 0; i < view.task_capacity; i++)
+    {
+        // Skip inactive slots; each active slot is copied as of one published sample.
+        if (!_snapshot_read_task(&view, i, task, NULL))
+        {
+            continue;
+        }
+
+        // Use display name for JSON key (renames "main" to "app_main", suffixes duplicates)
+        char key_buffer[32];
+        json_stream_key(stream, _get_task_display_key(task->task_name, task->name_ordinal,
+                                                      key_buffer, sizeof(key_buffer)));
+        json_stream_object_begin(stream);
+
+        json_stream_add_int(stream, "core", task->core_id);
+        json_stream_add_uint(stream, "prio", (uint32_t)task->current_priority);
+        json_stream_add_uint(stream, "stackSize", task->stack_size_bytes);
+
+        uint32_t stack_bytes = task->stack_used_bytes;
+        float stack_pct      = task->stack_used_percent;
+
+        json_stream_add_uint(stream, "stackUsed", stack_bytes);
+        json_stream_add_fixed(stream, "stackUsedPct", stack_pct, 2);
+
+        // Only include stackRemaining if stack & stackPct are nonzero
+        if (stack_bytes > 0U && stack_pct > 0.0f)
+        {
+            uint32_t stack_remaining_bytes = task->stack_high_water_mark * sizeof(StackType_t);
+            json_stream_add_uint(stream, "stackRemaining", stack_remaining_bytes);
+        }
+
+        if (task->stats.samples > 0U)
+        {
+            json_stream_add_fixed(stream, "cpuP50", _task_stats_cpu_percentile(&task->stats, 500U), 1);
+            json_stream_add_fixed(stream, "cpuP95", _task_stats_cpu_percentile(&task->stats, 950U), 1);
+            json_stream_add_fixed(stream, "cpuP99", _task_stats_cpu_percentile(&task->stats, 990U), 1);
+            json_stream_add_fixed(stream, "cpuMax", task->stats.cpu_max, 1);
+            json_stream_add_uint(stream, "stackMinFree", task->stats.stack_min_free);
+            json_stream_add_uint(stream, "statSamples", task->stats.samples);
+        }
+
+#if CONFIG_SYSMON_TRACE_SCHED_STATS
+        // Ready-to-run latency distribution, from the trace hooks
+        if (task->sched_valid)
+        {
+            json_stream_add_uint(stream, "readyP50Us",
+                                 _trace_latency_percentile_us(task->ready_hist, task->ready_max_lifetime_us, 500U));
+            json_stream_add_uint(stream, "readyP99Us",
+                                 _trace_latency_percentile_us(task->ready_hist, task->ready_max_lifetime_us, 990U));
+            json_stream_add_uint(stream, "readyMaxUs", task->ready_max_lifetime_us);
+            json_stream_key(stream, "readyHist");
+            json_stream_array_begin(stream);
+            for (int b = 0; b < SYSMON_TRACE_LATENCY_BUCKETS; b++)
+            {
+                json_stream_uint(stream, task->ready_hist[b]);
+            }
+            json_stream_array_end(stream);
+        }
+#endif
+
+        json_stream_object_end(stream);
+    }
+
+    json_stream_object_end(stream);
+
+    _snapshot_release_view(&view);
+    free(task);
+    return stream->error;
+}
+
+/**
+ * @brief Write JSON object tracing task usage history for all monitored tasks.
+ *
+ * @param stream Streaming JSON writer (headers already set by the caller).
+ * @return ESP_OK on success, or the first error raised while streaming.
+ *
+ * Details:
+ *   - Each key (task name) maps to an object with "cpu" and "stack" arrays.
+ *   - "cpu" array contains CPU usage percent samples over time (rounded to 1 decimal place).
+ *   - "stack" array contains stack usage in bytes samples over time (only for registered tasks).
+ *   - "heap" array contains live heap bytes samples over time (only with CONFIG_SYSMON_TASK_HEAP_ACCOUNTING).
+ *   - Only active, known tasks included.
+ *   - Array order is oldest-to-newest based on cyclic buffer logic.
+ *   - Each task is copied as of one published sample (see sysmon_snapshot.h) and
+ *     formatted from that copy, so memory use is one task history regardless of task count.
+ *   - With ?since=<seq>, only samples published after <seq> are written, for every
+ *     task and system-wide series (see _write_history_since_json()).
+ *   - With ?boot=previous, the samples of the previous boot recovered from RTC memory
+ *     are written instead (see sysmon_persist.h); ?boot=current is the default.
+ *   - With ?res=<duration> matching a rollup tier (e.g. 10s, 1m), min/avg/max buckets
+ *     are written instead (see _write_history_rollup_json()); a duration equal to the
+ *     sampling interval selects the normal history, others fail with ESP_ERR_INVALID_ARG.
+ *   - Every form but ?boot=previous honors the projection parameters: ?tasks=a,b writes only
+ *     the named tasks (display keys such as "app_main" or "worker#2", or plain names for all
+ *     duplicates), ?fields=cpu,stack,heap,system only those series ("system" selects the
+ *     system-wide series of ?since= and ?res=) and ?last=N only the newest N samples
+ *     (buckets with ?res=). Unselected tasks and series are never copied or formatted;
+ *     an unknown field or an invalid N fails with ESP_ERR_INVALID_ARG.
+ */
+esp_err_t _write_history_json(json_stream_t *stream)
+{
+    char boot[12];
+    if (_get_query_param(stream->request, "boot", boot, sizeof(boot)))
+    {
+        if (strcmp(boot, "previous") == 0)
+        {
+            return _write_persist_json(stream);
+        }
+        if (strcmp(boot, "current") != 0)
+        {
+            return ESP_ERR_INVALID_ARG;
+        }
+    }
+
+    JsonQuery query;
+    esp_err_t err = _json_query_parse(stream->request, &query);
+    if (err == ESP_OK)
+    {
+        uint32_t since = 0;
+        uint32_t bucket_ms = 0;
+        char res[16];
+        if (_get_query_uint(stream->request, "since", &since))
+        {
+            err = _write_history_since_json(stream, since, &query);
+        }
+        else if (!_get_query_param(stream->request, "res", res, sizeof(res)))
+        {
+            err = _write_history_samples_json(stream, &query);
+        }
+        else if (!_get_query_duration_ms(stream->request, "res", &bucket_ms))
+        {
+            err = ESP_ERR_INVALID_ARG;
+        }
+        else if (bucket_ms == CONFIG_SYSMON_CPU_SAMPLING_INTERVAL_MS)
+        {
+            err = _write_history_samples_json(stream, &query);
+        }
+        else
+        {
+            int tier = _rollup_tier_for_bucket_ms(bucket_ms);
+            err = (tier < 0) ? ESP_ERR_INVALID_ARG : _write_history_rollup_json(stream, tier, &query);
+        }
+    }
+    _json_query_release(&query);
+    return err;
+}
+
+/**
+ * @brief Write a complete telemetry JSON object summarizing CPU/memory and current registered task usage.
+ *
+ * @param stream Streaming JSON writer (headers already set by the caller).
+ * @return ESP_OK on success, or the first error raised while streaming.
+ *
+ * Details:
+ *   - Produces a two-level structure:
+ *       root->seq, root->sampling: {timestampUs, jitterUs, ...}, root->summary: {cpu, mem},
+ *       root->current: {task current usages}
+ *   - 'cpu' includes overall percent + per-core array.
+ *   - 'mem' summary embeds DRAM and (if present) PSRAM details.
+ *   - ?tasks=a,b limits "current" to the named tasks (display keys such as "app_main" or
+ *     "worker#2", or plain names for all duplicates); ?fields=cpu,stack,heap,core,sched,system
+ *     limits the fields written ("system" selects "sampling" and "summary"). Unselected tasks
+ *     and fields are never copied or formatted.
+ */
+esp_err_t _write_telemetry_json(json_stream_t *stream)
+{
+    JsonQuery query;
+    esp_err_t err = _json_query_parse(stream->request, &query);
+    if (err != ESP_OK)
+    {
+        _json_query_release(&query);
+        return err;
+    }
+
+    TaskUsageSample *task = _snapshot_alloc_task(0U);
+    if (task == NULL)
+    {
+        _json_query_release(&query);
+        return ESP_ERR_NO_MEM;
+    }
+
+    SysMonSeriesSample sample;
+    _snapshot_read_series(&sample);
+
+    json_stream_object_begin(stream);
+
+    // Sequence number of this sample, for /history?since=
+    json_stream_add_uint(stream, "seq", sample.sequence);
+
+    if (query.fields & JSON_FIELD_SYSTEM)
+    {
+        // Sample timestamp and schedule statistics
+        json_stream_key(stream, "sampling");
+        _write_sampling_info(stream, &sample);
+
+        // Summary object
+        json_stream_key(stream, "summary");
+        json_stream_object_begin(stream);
+
+        json_stream_key(stream, "cpu");
+        _write_cpu_summary(stream, &sample);
+
+        json_stream_key(stream, "mem");
+        _write_memory_summary(stream, &sample);
+
+        // WiFi RSSI (signal strength)
+        int8_t rssi = 0;
+        esp_err_t rssi_err = _get_wifi_rssi(&rssi);
+        if (rssi_err == ESP_OK)
+        {
+            json_stream_add_int(stream, "wifiRssi", rssi);
+        }
+        else
+        {
+            json_stream_add_null(stream, "wifiRssi");
+        }
+
+        json_stream_object_end(stream);
+    }
+
+    // Current task usage
+    sysmon_view_t view;
+    _snapshot_acquire_view(&view);
+    json_stream_key(stream, "current");
+    _write_current_task_usage(stream, &view, task, sample.sched_interval_us, &query);
+    _snapshot_release_view(&view);
+
+    json_stream_object_end(stream);
+
+    free(task);
+    _json_query_release(&query);
+    return stream->error;
+}
+
+/**
+ * @brief Settle one /bundle member after its writer returned.
+ *
+ * @param stream Streaming JSON writer, right after the member's writer.
+ * @param key Member name (for the log).
+ * @param err Result of the member's writer.
+ * @return ESP_OK to go on with the next member, otherwise the error that aborts the document.
+ *
+ * A writer that failed before writing anything (e.g. out of memory) left its key
+ * without a value; that member is written as null, so the document stays valid.
+ * A writer that failed partway leaves no way to close the document, so the error
+ * is returned and the response is left unterminated (see json_stream_finish()).
+ */
+static esp_err_t _bundle_part_end(json_stream_t *stream, const char *key, esp_err_t err)
+{
+    if (stream->error != ESP_OK)
+    {
+        return stream->error;
+    }
+    if (err == ESP_OK)
+    {
+        return ESP_OK;
+    }
+    if (stream->after_key && stream->depth == 1)
+    {
+        ESP_LOGW(LOG_TAG, "Bundle member \"%s\" failed: %s (0x%x), written as null", key, esp_err_to_name(err), err);
+        json_stream_null(stream);
+        return ESP_OK;
+    }
+    return err;
+}
+
+/**
+ * @brief Write the telemetry, task metadata and history delta in one response (/bundle).
+ *
+ * @param stream Streaming JSON writer (headers already set by the caller).
+ * @return ESP_OK on success, ESP_ERR_INVALID_ARG for an unknown part or projection
+ *         parameter, or the first error raised while streaming.
+ *
+ * Details:
+ *   - Output: {"telemetry":{..},"tasks":{..},"history":{..}}, each part exactly as
+ *     /telemetry, /tasks and /history?since=<seq> write it.
+ *   - ?parts=telemetry,tasks,history selects the parts (all by default); "history" is
+ *     only written with ?since=<seq>. The projection parameters (?tasks=, ?fields=,
+ *     ?last=) apply to "telemetry" and "history".
+ *   - Each part reads the latest sample on its own, so "history.seq" may be one ahead
+ *     of "telemetry.seq" if the sampler published in between.
+ *   - One request replaces the dashboard's separate telemetry, task table and backfill
+ *     requests, so polling needs a single connection.
+ *   - A part whose writer fails before writing anything is null; one that fails
+ *     partway aborts the response (see _bundle_part_end()).
+ */
+esp_err_t _write_bundle_json(json_stream_t *stream)
+{
+    static const struct
+    {
+        const char *name;
+        uint32_t flag;
+    } part_names[] =
+    {
+        { "telemetry", JSON_BUNDLE_TELEMETRY },
+        { "tasks",     JSON_BUNDLE_TASKS },
+        { "history",   JSON_BUNDLE_HISTORY }
+    };
+
+    uint32_t parts = JSON_BUNDLE_ALL;
+    char *list = _get_query_param_dup(stream->request, "parts");
+    if (list != NULL)
+    {
+        parts = 0;
+        char *save = NULL;
+        for (char *name = strtok_r(list, ",", &save); name != NULL; name = strtok_r(NULL, ",", &save))
+        {
+            size_t i = 0;
+            while (i < sizeof(part_names) / sizeof(part_names[0]) && strcmp(name, part_names[i].name) != 0)
+            {
+                i++;
+            }
+            if (i == sizeof(part_names) / sizeof(part_names[0]))
+            {
+                free(list);
+                return ESP_ERR_INVALID_ARG;
+            }
+            parts |= part_names[i].flag;
+        }
+        free(list);
+    }
+
+    // Validate the projection before anything is written, so a bad request still gets a 400
+    JsonQuery query;
+    esp_err_t err = _json_query_parse(stream->request, &query);
+    if (err != ESP_OK)
+    {
+        _json_query_release(&query);
+        return err;
+    }
+    uint32_t since = 0;
+    bool has_since = _get_query_uint(stream->request, "since", &since);
+
+    json_stream_object_begin(stream);
+    if (parts & JSON_BUNDLE_TELEMETRY)
+    {
+        json_stream_key(stream, "telemetry");
+        err = _bundle_part_end(stream, "telemetry", _write_telemetry_json(stream));
+    }
+    if (err == ESP_OK && (parts & JSON_BUNDLE_TASKS))
+    {
+        json_stream_key(stream, "tasks");
+        err = _bundle_part_end(stream, "tasks", _write_tasks_json(stream));
+    }
+    if (err == ESP_OK && (parts & JSON_BUNDLE_HISTORY) && has_since)
+    {
+        json_stream_key(stream, "history");
+        err = _bundle_part_end(stream, "history", _write_history_since_json(stream, since, &query));
+    }
+    if (err == ESP_OK)
+    {
+        json_stream_object_end(stream);
+    }
+
+    _json_query_release(&query);
+    return (err != ESP_OK) ? err : stream->error;
+}
+
+/**
+ * @brief Write the statistics of one profiled phase as a JSON object.
+ *
+ * @param stream Streaming JSON writer.
+ * @param stats Phase statistics.
+ */
+static void _write_profile_stats(json_stream_t *stream, const sysmon_profile_stats_t *stats)
+{
+    json_stream_object_begin(stream);
+    json_stream_add_uint(stream, "count", stats->count);
+    if (stats->count > 0U)
+    {
+        json_stream_add_uint(stream, "minUs", stats->min_us);
+        json_stream_add_fixed(stream, "avgUs", (double)stats->total_us / (double)stats->count, 1);
+        json_stream_add_uint(stream, "maxUs", stats->max_us);
+        json_stream_add_uint(stream, "p99Us", _profile_percentile_us(stats, 990U));
+        json_stream_add_fixed(stream, "heapDeltaAvg", (double)stats->heap_delta_total / (double)stats->count, 1);
+        json_stream_add_int(stream, "heapDeltaMax", stats->heap_delta_max);
+    }
+    json_stream_object_end(stream);
+}
+
+/**
+ * @brief Write the sysmon self-profiling JSON object (/sysmon/self).
+ *
+ * @param stream Streaming JSON writer (headers already set by the caller).
+ * @return ESP_OK on success, or the first error raised while streaming.
+ *
+ * Details:
+ *   - "sampler" holds one object per sampler step plus the whole sample ("total").
+ *   - "http" holds one object per endpoint URI, with "build" and "send" phases.
+ *   - "busyPct" is time spent per category since the first profiled phase, in
+ *     percent of one core ("httpSend" is mostly waiting for the network).
+ */
+esp_err_t _write_self_json(json_stream_t *stream)
+{
+    json_stream_object_begin(stream);
+
+    sysmon_profile_stats_t stats;
+    bool enabled = _profile_read(SYSMON_PROFILE_SAMPLE, &stats);
+    json_stream_add_bool(stream, "enabled", enabled);
+    if (!enabled)
+    {
+        json_stream_object_end(stream);
+        return stream->error;
+    }
+
+    int64_t started_us = _profile_started_us();
+    int64_t elapsed_us = (started_us > 0) ? (esp_timer_get_time() - started_us) : 0;
+    json_stream_add_uint64(stream, "elapsedUs", (uint64_t)elapsed_us);
+
+    // Sampler phases
+    uint64_t sampler_us = 0U;
+    uint64_t build_us   = 0U;
+    uint64_t send_us    = 0U;
+    json_stream_key(stream, "sampler");
+    json_stream_object_begin(stream);
+    for (int phase = 0; phase < SYSMON_PROFILE_PHASE_COUNT; phase++)
+    {
+        const char *group = NULL;
+        const char *name  = _profile_phase_name((sysmon_profile_phase_t)phase, &group);
+        if (group != NULL || !_profile_read((sysmon_profile_phase_t)phase, &stats))
+        {
+            continue;
+        }
+        if (phase == SYSMON_PROFILE_SAMPLE)
+        {
+            sampler_us = stats.total_us;
+        }
+        json_stream_key(stream, name);
+        _write_profile_stats(stream, &stats);
+    }
+    json_stream_object_end(stream);
+
+    // HTTP phases, grouped by endpoint (phases of one endpoint are consecutive)
+    json_stream_key(stream, "http");
+    json_stream_object_begin(stream);
+    const char *open_group = NULL;
+    for (int phase = 0; phase < SYSMON_PROFILE_PHASE_COUNT; phase++)
+    {
+        const char *group = NULL;
+        const char *name  = _profile_phase_name((sysmon_profile_phase_t)phase, &group);
+        if (group == NULL || !_profile_read((sysmon_profile_phase_t)phase, &stats))
+        {
+            continue;
+        }
+        if (open_group == NULL || strcmp(open_group, group) != 0)
+        {
+            if (open_group != NULL)
+            {
+                json_stream_object_end(stream);
+            }
+            json_stream_key(stream, group);
+            json_stream_object_begin(stream);
+            open_group = group;
+        }
+        if (strcmp(name, "send") == 0)
+        {
+            send_us += stats.total_us;
+        }
+        else
+        {
+            build_us += stats.total_us;
+        }
+        json_stream_key(stream, name);
+        _write_profile_stats(stream, &stats);
+    }
+    if (open_group != NULL)
+    {
+        json_stream_object_end(stream);
+    }
+    json_stream_object_end(stream);
+
+    // Share of one core's time
+    double elapsed = (elapsed_us > 0) ? (double)elapsed_us : 1.0;
+    json_stream_key(stream, "busyPct");
+    json_stream_object_begin(stream);
+    json_stream_add_fixed(stream, "sampler", (double)sampler_us * 100.0 / elapsed, 3);
+    json_stream_add_fixed(stream, "httpBuild", (double)build_us * 100.0 / elapsed, 3);
+    json_stream_add_fixed(stream, "httpSend", (double)send_us * 100.0 / elapsed, 3);
+    json_stream_object_end(stream);
+
+    json_stream_object_end(stream);
+    return stream->error;
+}
+
+/**
+ * @brief Write the per-capability heap statistics JSON object (/heap).
+ *
+ * @param stream Streaming JSON writer (headers already set by the caller).
+ * @return ESP_OK on success, or the first error raised while streaming.
+ *
+ * Details:
+ *   - Output: {"enabled", "seq", "scanUs", "intervalSamples", "caps": {name: {...}}}.
+ *   - "seq" is the sample the scan followed; the scan repeats every
+ *     "intervalSamples" samples. Without a scan yet, only "enabled" is written.
+ *   - "freeHistogram" has one {"minBytes", "count"} entry per non-empty size
+ *     bucket and is left out on ESP-IDF versions without heap_caps_walk().
+ */
+esp_err_t _write_heap_json(json_stream_t *stream)
+{
+    sysmon_heap_report_t *report = (sysmon_heap_report_t *)malloc(sizeof(sysmon_heap_report_t));
+    if (report == NULL)
+    {
+        return ESP_ERR_NO_MEM;
+    }
+
+    json_stream_object_begin(stream);
+    bool scanned = _heap_caps_read(report);
+    json_stream_add_bool(stream, "enabled", CONFIG_SYSMON_HEAP_CAPS_INTERVAL > 0);
+    if (scanned)
+    {
+        json_stream_add_uint(stream, "seq", report->sequence);
+        json_stream_add_uint(stream, "scanUs", report->scan_us);
+        json_stream_add_uint(stream, "intervalSamples", CONFIG_SYSMON_HEAP_CAPS_INTERVAL);
+
+        json_stream_key(stream, "caps");
+        json_stream_object_begin(stream);
+        for (int caps = 0; caps < SYSMON_HEAP_CAPS_COUNT; caps++)
+        {
+            const sysmon_heap_caps_stats_t *stats = &report->caps[caps];
+            json_stream_key(stream, _heap_caps_name((sysmon_heap_caps_t)caps));
+            json_stream_object_begin(stream);
+            json_stream_add_uint(stream, "total", stats->total_bytes);
+            json_stream_add_uint(stream, "free", stats->free_bytes);
+            json_stream_add_uint(stream, "largest", stats->largest_free);
+            json_stream_add_uint(stream, "minFree", stats->minimum_free);
+            json_stream_add_uint(stream, "allocatedBlocks", stats->allocated_blocks);
+            json_stream_add_uint(stream, "freeBlocks", stats->free_blocks);
+            json_stream_add_fixed(stream, "fragPct", stats->frag_percent, 2);
+            if (report->has_histogram)
+            {
+                json_stream_key(stream, "freeHistogram");
+                json_stream_array_begin(stream);
+                for (int bucket = 0; bucket < SYSMON_HEAP_HISTOGRAM_BUCKETS; bucket++)
+                {
+                    if (stats->free_histogram[bucket] == 0U)
+                    {
+                        continue;
+                    }
+                    json_stream_object_begin(stream);
+                    json_stream_add_uint(stream, "minBytes", _heap_histogram_lower_bytes(bucket));
+                    json_stream_add_uint(stream, "count", stats->free_histogram[bucket]);
+                    json_stream_object_end(stream);
+                }
+                json_stream_array_end(stream);
+            }
+            json_stream_object_end(stream);
+        }
+        json_stream_object_end(stream);
+    }
+    json_stream_object_end(stream);
+
+    free(report);
+    return stream->error;
+}
+
+/**
+ * @brief Build the static "chip" JSON object.
+ *
+ * @return Chip info JSON object, or NULL on allocation failure.
+ *
+ * Details:
+ *   - Includes chip model, revision, cores, variant, CPU frequency, features.
+ */
+static cJSON *_build_chip_json(void)
+{
+    esp_chip_info_t chip_info;
+    esp_chip_info(&chip_info);
 
     cJSON *chip = cJSON_CreateObject();
     if (chip == NULL)
     {
-        JSON_CLEANUP(root);
         return NULL;
     }
 
@@ -803,7 +2185,7 @@ cJSON *_create_hardware_json(void)
     cJSON *features = cJSON_CreateArray();
     if (features == NULL)
     {
-        JSON_CLEANUP(chip, root);
+        JSON_CLEANUP(chip);
         return NULL;
     }
 
@@ -833,20 +2215,27 @@ cJSON *_create_hardware_json(void)
     }
 
     cJSON_AddItemToObject(chip, "features", features);
-    cJSON_AddItemToObject(root, "chip", chip);
 
-    // Memory information (totals are static)
+    return chip;
+}
+
+/**
+ * @brief Build the static "memory" JSON object (heap totals).
+ *
+ * @return Memory info JSON object, or NULL on allocation failure.
+ */
+static cJSON *_build_memory_json(void)
+{
     cJSON *memory = cJSON_CreateObject();
     if (memory == NULL)
     {
-        JSON_CLEANUP(root);
         return NULL;
     }
 
     uint32_t dram_total = heap_caps_get_total_size(MALLOC_CAP_INTERNAL);
     cJSON_AddNumberToObject(memory, "dramTotal", (double)dram_total);
 
-    // PSRAM size already retrieved earlier for variant determination, reuse it
+    uint32_t psram_total = heap_caps_get_total_size(MALLOC_CAP_SPIRAM);
     if (psram_total > 0U)
     {
         cJSON_AddNumberToObject(memory, "psramTotal", (double)psram_total);
@@ -863,23 +2252,75 @@ cJSON *_create_hardware_json(void)
         cJSON_AddNumberToObject(memory, "psramTotal", 0);
     }
 
-    cJSON_AddItemToObject(root, "memory", memory);
+    return memory;
+}
 
-    // System information
-    cJSON *system = cJSON_CreateObject();
-    if (system == NULL)
+/**
+ * @brief Serialize a cJSON tree to a compact string and delete the tree.
+ *
+ * @param json Tree to serialize (may be NULL; always deleted).
+ * @return Heap-allocated JSON text, or NULL on failure.
+ */
+static char *_serialize_and_delete(cJSON *json)
+{
+    if (json == NULL)
     {
-        JSON_CLEANUP(root);
         return NULL;
     }
+    char *text = cJSON_PrintUnformatted(json);
+    cJSON_Delete(json);
+    return text;
+}
+
+/**
+ * @brief Build (or rebuild) the cached static parts of the /hardware response.
+ *
+ * @return ESP_OK on success, ESP_ERR_NO_MEM on allocation failure.
+ *
+ * Details:
+ *   - Serializes "chip" and "memory" once into ready-to-send JSON text.
+ *   - Reads the partition table, app image sizes and flash size once (the
+ *     flash reads that would otherwise stall the caches on every request).
+ */
+static esp_err_t _build_hardware_cache(void)
+{
+    _hardware_cache_cleanup();
+
+    s_hardware.chip_json   = _serialize_and_delete(_build_chip_json());
+    s_hardware.memory_json = _serialize_and_delete(_build_memory_json());
+    if (s_hardware.chip_json == NULL || s_hardware.memory_json == NULL || _collect_partitions() != ESP_OK)
+    {
+        ESP_LOGE(LOG_TAG, "Failed to build hardware info cache");
+        _hardware_cache_cleanup();
+        return ESP_ERR_NO_MEM;
+    }
+
+    esp_err_t flash_ret = esp_flash_get_size(NULL, &s_hardware.total_flash_size);
+    if (flash_ret != ESP_OK)
+    {
+        ESP_LOGW(LOG_TAG, "esp_flash_get_size() failed: %s (0x%x). Flash summary unavailable.", 
+                 esp_err_to_name(flash_ret), flash_ret);
+        s_hardware.total_flash_size = 0;
+    }
 
-    const char *idf_version = esp_get_idf_version();
-    cJSON_AddStringToObject(system, "idfVersion", idf_version);
+    s_hardware.nvs_refreshed_at = xTaskGetTickCount();
+    s_hardware.ready = true;
+    return ESP_OK;
+}
+
+/**
+ * @brief Write the "system" JSON object (build info and current time).
+ *
+ * @param stream Streaming JSON writer.
+ */
+static void _write_system_info(json_stream_t *stream)
+{
+    json_stream_object_begin(stream);
+
+    json_stream_add_string(stream, "idfVersion", esp_get_idf_version());
 
     // Compile time
-    char compile_time[64];
-    snprintf(compile_time, sizeof(compile_time), "%s %s", __DATE__, __TIME__);
-    cJSON_AddStringToObject(system, "compileTime", compile_time);
+    json_stream_add_string(stream, "compileTime", __DATE__ " " __TIME__);
 
     // Boot time - show current date/time as ESP32 sees it
     // Format matches compile time: "MMM DD YYYY HH:MM:SS" (e.g., "Nov 11 2025 02:17:56")
@@ -901,129 +2342,147 @@ cJSON *_create_hardware_json(void)
     {
         snprintf(boot_time_str, sizeof(boot_time_str), "Time not set");
     }
-    cJSON_AddStringToObject(system, "bootTime", boot_time_str);
+    json_stream_add_string(stream, "bootTime", boot_time_str);
+
+    json_stream_object_end(stream);
+}
 
-    cJSON_AddItemToObject(root, "system", system);
+/**
+ * @brief Write the "wifi" JSON object (connection state, queried on every request).
+ *
+ * @param stream Streaming JSON writer.
+ */
+static void _write_wifi_info(json_stream_t *stream)
+{
+    json_stream_object_begin(stream);
 
-    // Partition information
-    cJSON *partitions = _build_partitions_json();
-    if (partitions == NULL)
-    {
-        JSON_CLEANUP(root);
-        return NULL;
-    }
-    cJSON_AddItemToObject(root, "partitions", partitions);
+    // Get WiFi SSID
+    char ssid_buffer[33] = { 0 };
+    esp_err_t ssid_err = _get_wifi_ssid(ssid_buffer, sizeof(ssid_buffer));
+    json_stream_add_string(stream, "ssid", (ssid_err == ESP_OK) ? ssid_buffer : "Not Connected");
 
-    // Calculate flash summary (total flash size and unused space)
-    uint32_t total_flash_size = 0;
-    esp_err_t flash_ret = esp_flash_get_size(NULL, &total_flash_size);
-    if (flash_ret != ESP_OK)
+    // Get WiFi RSSI
+    int8_t rssi = 0;
+    esp_err_t rssi_err = _get_wifi_rssi(&rssi);
+    if (rssi_err == ESP_OK)
     {
-        ESP_LOGW(LOG_TAG, "esp_flash_get_size() failed: %s (0x%x). Flash summary unavailable.", 
-                 esp_err_to_name(flash_ret), flash_ret);
-        total_flash_size = 0;
+        json_stream_add_int(stream, "rssi", rssi);
     }
-    if (total_flash_size > 0)
+    else
     {
-        // Calculate total partition size
-        uint32_t total_partition_size = 0;
-        size_t partition_count = cJSON_GetArraySize(partitions);
-        for (size_t i = 0; i < partition_count; i++)
-        {
-            cJSON *part_obj = cJSON_GetArrayItem(partitions, i);
-            if (part_obj != NULL)
-            {
-                cJSON *size_obj = cJSON_GetObjectItem(part_obj, "size");
-                if (size_obj != NULL && cJSON_IsNumber(size_obj))
-                {
-                    total_partition_size += (uint32_t)cJSON_GetNumberValue(size_obj);
-                }
-            }
-        }
+        json_stream_add_null(stream, "rssi");
+    }
 
-        uint32_t unused_flash = total_flash_size - total_partition_size;
-        
-        cJSON *flash_summary = cJSON_CreateObject();
-        if (flash_summary != NULL)
+    // Get WiFi IP address
+    char ip_buffer[16] = { 0 };
+    esp_err_t ip_err = _get_wifi_ip_info(ip_buffer, sizeof(ip_buffer));
+    json_stream_add_string(stream, "ip", (ip_err == ESP_OK) ? ip_buffer : "N/A");
+
+    // HTTP server port
+    json_stream_add_uint(stream, "port", CONFIG_SYSMON_HTTPD_SERVER_PORT);
+
+    json_stream_object_end(stream);
+}
+
+/**
+ * @brief Build the /hardware cache (called from sysmon_init before the HTTP server starts).
+ *
+ * @return ESP_OK on success, ESP_ERR_NO_MEM on allocation failure.
+ */
+esp_err_t _hardware_cache_init(void)
+{
+    __atomic_store_n(&s_hardware.invalidated, false, __ATOMIC_RELAXED);
+    return _build_hardware_cache();
+}
+
+/**
+ * @brief Free the /hardware cache (called from sysmon_deinit after the HTTP server stops).
+ */
+void _hardware_cache_cleanup(void)
+{
+    free(s_hardware.chip_json);
+    free(s_hardware.memory_json);
+    free(s_hardware.partitions);
+    s_hardware.chip_json        = NULL;
+    s_hardware.memory_json      = NULL;
+    s_hardware.partitions       = NULL;
+    s_hardware.partition_count  = 0;
+    s_hardware.total_flash_size = 0;
+    s_hardware.ready            = false;
+}
+
+/**
+ * @brief Discard the cached /hardware data so the next request rebuilds it.
+ */
+void sysmon_refresh_hardware_info(void)
+{
+    __atomic_store_n(&s_hardware.invalidated, true, __ATOMIC_RELEASE);
+}
+
+/**
+ * @brief Write hardware information JSON object with chip, memory, partition and system info.
+ *
+ * @param stream Streaming JSON writer (headers already set by the caller).
+ * @return ESP_OK on success, or the first error raised while streaming.
+ *
+ * Details:
+ *   - chip, memory, the partition table, app image sizes and flash size come from
+ *     the cache built at sysmon_init, so a request does no flash reads.
+ *   - NVS partition usage is refreshed lazily, at most every CONFIG_SYSMON_HARDWARE_REFRESH_S.
+ *   - Wi-Fi state and the current time are read on every request (no flash access).
+ *   - sysmon_refresh_hardware_info() forces a full rebuild on the next request.
+ *   - The cache is only modified here and during init/deinit, i.e. from the HTTP server task.
+ */
+esp_err_t _write_hardware_json(json_stream_t *stream)
+{
+    if (!s_hardware.ready || __atomic_exchange_n(&s_hardware.invalidated, false, __ATOMIC_ACQUIRE))
+    {
+        esp_err_t err = _build_hardware_cache();
+        if (err != ESP_OK)
         {
-            cJSON_AddNumberToObject(flash_summary, "totalFlash", (double)total_flash_size);
-            cJSON_AddNumberToObject(flash_summary, "totalPartitions", (double)total_partition_size);
-            cJSON_AddNumberToObject(flash_summary, "unused", (double)unused_flash);
-            if (total_flash_size > 0)
-            {
-                double unused_pct = ((double)unused_flash / (double)total_flash_size) * 100.0;
-                double partitions_pct = ((double)total_partition_size / (double)total_flash_size) * 100.0;
-                cJSON_AddNumberToObject(flash_summary, "unusedPct", unused_pct);
-                cJSON_AddNumberToObject(flash_summary, "partitionsPct", partitions_pct);
-            }
-            else
-            {
-                cJSON_AddNumberToObject(flash_summary, "unusedPct", 0.0);
-                cJSON_AddNumberToObject(flash_summary, "partitionsPct", 0.0);
-            }
-            cJSON_AddItemToObject(root, "flashSummary", flash_summary);
+            return err;
         }
     }
-
-    // WiFi information
-    cJSON *wifi = cJSON_CreateObject();
-    if (wifi == NULL)
+    else if ((TickType_t)(xTaskGetTickCount() - s_hardware.nvs_refreshed_at) >=
+             pdMS_TO_TICKS(CONFIG_SYSMON_HARDWARE_REFRESH_S * 1000U))
     {
-        // If WiFi object creation fails, continue without it
-        // Don't fail the entire hardware JSON response
+        _refresh_nvs_usage();
     }
-    else
-    {
-        // Get WiFi SSID
-        char ssid_buffer[33] = { 0 };
-        esp_err_t ssid_err = _get_wifi_ssid(ssid_buffer, sizeof(ssid_buffer));
-        if (ssid_err == ESP_OK)
-        {
-            cJSON_AddStringToObject(wifi, "ssid", ssid_buffer);
-        }
-        else
-        {
-            cJSON_AddStringToObject(wifi, "ssid", "Not Connected");
-        }
 
-        // Get WiFi RSSI
-        int8_t rssi = 0;
-        esp_err_t rssi_err = _get_wifi_rssi(&rssi);
-        if (rssi_err == ESP_OK)
-        {
-            cJSON_AddNumberToObject(wifi, "rssi", (double)rssi);
-        }
-        else
-        {
-            cJSON_AddNullToObject(wifi, "rssi");
-        }
+    json_stream_object_begin(stream);
 
-        // Get WiFi IP address
-        char ip_buffer[16] = { 0 };
-        esp_err_t ip_err = _get_wifi_ip_info(ip_buffer, sizeof(ip_buffer));
-        if (ip_err == ESP_OK)
-        {
-            cJSON_AddStringToObject(wifi, "ip", ip_buffer);
-        }
-        else
-        {
-            cJSON_AddStringToObject(wifi, "ip", "N/A");
-        }
+    // Static sections, pre-serialized
+    json_stream_add_value_raw(stream, "chip", s_hardware.chip_json);
+    json_stream_add_value_raw(stream, "memory", s_hardware.memory_json);
 
-        // HTTP server port
-        cJSON_AddNumberToObject(wifi, "port", (double)CONFIG_SYSMON_HTTPD_SERVER_PORT);
+    json_stream_key(stream, "system");
+    _write_system_info(stream);
 
-        cJSON_AddItemToObject(root, "wifi", wifi);
-    }
+    json_stream_key(stream, "partitions");
+    _write_partitions(stream);
 
-    // Configuration section for frontend
-    cJSON *config = cJSON_CreateObject();
-    if (config != NULL)
+    if (s_hardware.total_flash_size > 0)
     {
-        cJSON_AddNumberToObject(config, "cpuSamplingIntervalMs", (double)CONFIG_SYSMON_CPU_SAMPLING_INTERVAL_MS);
-        cJSON_AddNumberToObject(config, "sampleCount", (double)CONFIG_SYSMON_SAMPLE_COUNT);
-        cJSON_AddItemToObject(root, "config", config);
+        json_stream_key(stream, "flashSummary");
+        _write_flash_summary(stream);
     }
 
-    return root;
+    json_stream_key(stream, "wifi");
+    _write_wifi_info(stream);
+
+    // Configuration section for frontend
+    json_stream_key(stream, "config");
+    json_stream_object_begin(stream);
+    json_stream_add_uint(stream, "cpuSamplingIntervalMs", CONFIG_SYSMON_CPU_SAMPLING_INTERVAL_MS);
+    json_stream_add_uint(stream, "sampleCount", (uint32_t)self.history_depth);
+    size_t history_internal = 0;
+    size_t history_psram    = 0;
+    _history_memory_usage(&history_internal, &history_psram);
+    json_stream_add_uint(stream, "historyInternalBytes", (uint32_t)history_internal);
+    json_stream_add_uint(stream, "historyPsramBytes", (uint32_t)history_psram);
+    json_stream_add_bool(stream, "compactHistory", CONFIG_SYSMON_COMPACT_HISTORY != 0);
+    json_stream_object_end(stream);
+
+    json_stream_object_end(stream);
+    return stream->error;
 }
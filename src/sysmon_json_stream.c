@@ -0,0 +1,594 @@
+/**
+ * @file sysmon_json_stream.c
+ * @brief Streaming JSON writer for sysmon HTTP endpoints.
+ *
+ * This file implements a minimal JSON writer that appends directly into a
+ * caller-provided chunk buffer and hands full chunks to httpd_resp_send_chunk().
+ * Separators (commas) are tracked with one bit per nesting level, so builders
+ * only describe structure and never allocate.
+ */
+
+// Project-specific includes
+#include "sysmon_json_stream.h"
+
+// ESP-IDF includes
+#include "esp_log.h"
+#include "esp_http_server.h"
+#include "esp_timer.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+
+// System includes
+#include <math.h>
+#include <string.h>
+
+// Logger tag for this module
+static const char *LOG_TAG = "sysmon_json_stream";
+
+// Powers of ten for fixed-point formatting (index = decimals)
+static const uint32_t s_pow10[] = { 1U, 10U, 100U, 1000U, 10000U, 100000U, 1000000U };
+
+// Largest scaled magnitude json_stream_fixed() rounds with llround() (just below 2^63)
+#define JSON_FIXED_MAX_SCALED 9.2e18
+
+// ============================================================================
+// Internal Helper Functions
+// ============================================================================
+
+/**
+ * @brief Append bytes to the chunk buffer, flushing whenever it fills up.
+ *
+ * @param stream Writer state.
+ * @param data Bytes to append.
+ * @param len Number of bytes.
+ */
+static void _append(json_stream_t *stream, const char *data, size_t len)
+{
+    while (len > 0 && stream->error == ESP_OK)
+    {
+        size_t room = stream->capacity - stream->length;
+        if (room == 0)
+        {
+            json_stream_flush(stream);
+            continue;
+        }
+        size_t copy = (len < room) ? len : room;
+        memcpy(stream->buffer + stream->length, data, copy);
+        stream->length += copy;
+        data += copy;
+        len -= copy;
+    }
+}
+
+/**
+ * @brief Append a single character.
+ *
+ * @param stream Writer state.
+ * @param c Character to append.
+ */
+static void _append_char(json_stream_t *stream, char c)
+{
+    if (stream->error != ESP_OK)
+    {
+        return;
+    }
+    if (stream->length == stream->capacity)
+    {
+        json_stream_flush(stream);
+        if (stream->error != ESP_OK)
+        {
+            return;
+        }
+    }
+    stream->buffer[stream->length++] = c;
+}
+
+/**
+ * @brief Emit a comma if the value is not the first element at the current level.
+ *
+ * @param stream Writer state.
+ */
+static void _separator(json_stream_t *stream)
+{
+    if (stream->after_key)
+    {
+        stream->after_key = false;
+        return;
+    }
+    uint32_t bit = 1U << stream->depth;
+    if (stream->first_mask & bit)
+    {
+        stream->first_mask &= ~bit;
+    }
+    else
+    {
+        _append_char(stream, ',');
+    }
+}
+
+/**
+ * @brief Append an unsigned decimal integer.
+ *
+ * @param stream Writer state.
+ * @param value Value to append.
+ * @param min_digits Minimum number of digits (zero padded).
+ */
+static void _append_uint(json_stream_t *stream, uint64_t value, int min_digits)
+{
+    char digits[24];
+    int pos = sizeof(digits);
+    do
+    {
+        digits[--pos] = (char)('0' + (value % 10U));
+        value /= 10U;
+        min_digits--;
+    } while ((value != 0U || min_digits > 0) && pos > 0);
+    _append(stream, &digits[pos], sizeof(digits) - pos);
+}
+
+/**
+ * @brief Append a quoted, escaped JSON string.
+ *
+ * @param stream Writer state.
+ * @param value NUL-terminated string.
+ */
+static void _append_quoted(json_stream_t *stream, const char *value)
+{
+    static const char hex[] = "0123456789abcdef";
+
+    _append_char(stream, '"');
+    const char *run = value;
+    for (const char *p = value; *p != '\0'; p++)
+    {
+        unsigned char c = (unsigned char)*p;
+        if (c >= 0x20 && c != '"' && c != '\\')
+        {
+            continue;
+        }
+
+        // Flush the unescaped run before the special character
+        _append(stream, run, (size_t)(p - run));
+        run = p + 1;
+
+        char escaped[6] = { '\\', 0 };
+        size_t escaped_len = 2;
+        switch (c)
+        {
+            case '"':  escaped[1] = '"';  break;
+            case '\\': escaped[1] = '\\'; break;
+            case '\n': escaped[1] = 'n';  break;
+            case '\r': escaped[1] = 'r';  break;
+            case '\t': escaped[1] = 't';  break;
+            default:
+                escaped[1] = 'u';
+                escaped[2] = '0';
+                escaped[3] = '0';
+                escaped[4] = hex[c >> 4];
+                escaped[5] = hex[c & 0x0F];
+                escaped_len = 6;
+                break;
+        }
+        _append(stream, escaped, escaped_len);
+    }
+    _append(stream, run, strlen(run));
+    _append_char(stream, '"');
+}
+
+// ============================================================================
+// Public API Functions
+// ============================================================================
+
+/**
+ * @brief Initialize a streaming JSON writer.
+ *
+ * @param stream Writer state to initialize.
+ * @param request HTTP request that receives the chunks.
+ * @param buffer Chunk buffer (owned by caller, must outlive the writer).
+ * @param capacity Size of the chunk buffer in bytes (at least 64).
+ * @return ESP_OK on success, ESP_ERR_INVALID_ARG on bad parameters.
+ */
+esp_err_t json_stream_init(json_stream_t *stream, httpd_req_t *request, char *buffer, size_t capacity)
+{
+    if (stream == NULL || buffer == NULL || capacity < 64)
+    {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    memset(stream, 0, sizeof(*stream));
+    stream->request    = request;
+    stream->buffer     = buffer;
+    stream->capacity   = capacity;
+    stream->first_mask = 1U;  // Top level starts with its first (and only) value
+    stream->slice_start_us = esp_timer_get_time();
+    stream->error      = ESP_OK;
+    return ESP_OK;
+}
+
+/**
+ * @brief Initialize a writer that formats a whole document into memory.
+ *
+ * @param stream Writer state to initialize.
+ * @param buffer Document buffer (owned by caller, must outlive the writer).
+ * @param capacity Size of the buffer in bytes (at least 64).
+ * @return ESP_OK on success, ESP_ERR_INVALID_ARG on bad parameters.
+ */
+esp_err_t json_stream_init_memory(json_stream_t *stream, char *buffer, size_t capacity)
+{
+    esp_err_t err = json_stream_init(stream, NULL, buffer, capacity);
+    if (err == ESP_OK)
+    {
+        stream->in_memory = true;
+    }
+    return err;
+}
+
+/**
+ * @brief Send any buffered bytes as a chunk without terminating the response.
+ *
+ * @param stream Writer state.
+ */
+void json_stream_flush(json_stream_t *stream)
+{
+    if (stream->error != ESP_OK || stream->length == 0)
+    {
+        return;
+    }
+
+    if (stream->in_memory)
+    {
+        // Nothing is sent; a flush of a full buffer means the document does not fit
+        if (stream->length == stream->capacity)
+        {
+            stream->error = ESP_ERR_NO_MEM;
+        }
+        return;
+    }
+
+    if (stream->request != NULL)
+    {
+        // Let lower-priority tasks run once building has held the core for a whole slice
+        int64_t send_start_us = esp_timer_get_time();
+        if (stream->slice_us > 0 &&
+            send_start_us - stream->slice_start_us - (stream->send_us - stream->slice_send_us) >= stream->slice_us)
+        {
+            vTaskDelay(1);
+            stream->slice_start_us = esp_timer_get_time();
+            stream->slice_send_us  = stream->send_us;
+            send_start_us          = stream->slice_start_us;
+        }
+
+        esp_err_t err = httpd_resp_send_chunk(stream->request, stream->buffer, (ssize_t)stream->length);
+        stream->send_us += esp_timer_get_time() - send_start_us;
+        if (err != ESP_OK)
+        {
+            ESP_LOGW(LOG_TAG, "httpd_resp_send_chunk() failed after %u bytes: %s (0x%x)",
+                     (unsigned)stream->bytes_sent, esp_err_to_name(err), err);
+            stream->error = err;
+            return;
+        }
+    }
+    stream->bytes_sent += stream->length;
+    stream->length = 0;
+}
+
+/**
+ * @brief Flush pending bytes and terminate the chunked response.
+ *
+ * @param stream Writer state.
+ * @return ESP_OK if the whole response was sent, otherwise the first error encountered.
+ *
+ * The terminating chunk is only sent if no error occurred, so a failed response
+ * never reaches the client as complete.
+ */
+esp_err_t json_stream_finish(json_stream_t *stream)
+{
+    if (stream->depth != 0 && stream->error == ESP_OK)
+    {
+        ESP_LOGE(LOG_TAG, "Unbalanced JSON document (depth %u)", (unsigned)stream->depth);
+        stream->error = ESP_ERR_INVALID_STATE;
+    }
+
+    json_stream_flush(stream);
+
+    // A zero-length chunk terminates the chunked response. After an error it is
+    // not sent: the handler returns the error, httpd closes the socket and the
+    // client sees a truncated chunked body instead of a complete 200 response.
+    if (stream->request != NULL && stream->error == ESP_OK)
+    {
+        int64_t send_start_us = esp_timer_get_time();
+        esp_err_t err = httpd_resp_send_chunk(stream->request, NULL, 0);
+        stream->send_us += esp_timer_get_time() - send_start_us;
+        stream->error = err;
+    }
+    return stream->error;
+}
+
+/**
+ * @brief Append raw, already-formatted JSON text (no separator handling).
+ */
+void json_stream_raw(json_stream_t *stream, const char *data, size_t len)
+{
+    _append(stream, data, len);
+}
+
+/**
+ * @brief Drop everything an in-memory writer appended after an earlier length.
+ */
+void json_stream_rewind(json_stream_t *stream, size_t length)
+{
+    if (!stream->in_memory || length > stream->length)
+    {
+        return;
+    }
+    stream->length = length;
+    if (stream->error == ESP_ERR_NO_MEM)
+    {
+        stream->error = ESP_OK;
+    }
+}
+
+/**
+ * @brief Open a JSON object ('{') at the current position.
+ */
+void json_stream_object_begin(json_stream_t *stream)
+{
+    _separator(stream);
+    if (stream->depth + 1 >= JSON_STREAM_MAX_DEPTH)
+    {
+        stream->error = ESP_ERR_INVALID_STATE;
+        return;
+    }
+    _append_char(stream, '{');
+    stream->depth++;
+    stream->first_mask |= (1U << stream->depth);
+}
+
+/**
+ * @brief Close the innermost JSON object ('}').
+ */
+void json_stream_object_end(json_stream_t *stream)
+{
+    if (stream->depth == 0)
+    {
+        stream->error = ESP_ERR_INVALID_STATE;
+        return;
+    }
+    stream->first_mask &= ~(1U << stream->depth);
+    stream->depth--;
+    _append_char(stream, '}');
+}
+
+/**
+ * @brief Open a JSON array ('[') at the current position.
+ */
+void json_stream_array_begin(json_stream_t *stream)
+{
+    _separator(stream);
+    if (stream->depth + 1 >= JSON_STREAM_MAX_DEPTH)
+    {
+        stream->error = ESP_ERR_INVALID_STATE;
+        return;
+    }
+    _append_char(stream, '[');
+    stream->depth++;
+    stream->first_mask |= (1U << stream->depth);
+}
+
+/**
+ * @brief Close the innermost JSON array (']').
+ */
+void json_stream_array_end(json_stream_t *stream)
+{
+    if (stream->depth == 0)
+    {
+        stream->error = ESP_ERR_INVALID_STATE;
+        return;
+    }
+    stream->first_mask &= ~(1U << stream->depth);
+    stream->depth--;
+    _append_char(stream, ']');
+}
+
+/**
+ * @brief Write an object key; the next write is its value.
+ */
+void json_stream_key(json_stream_t *stream, const char *key)
+{
+    _separator(stream);
+    _append_quoted(stream, (key != NULL) ? key : "");
+    _append_char(stream, ':');
+    stream->after_key = true;
+}
+
+/**
+ * @brief Write an escaped string value (NULL is written as null).
+ */
+void json_stream_string(json_stream_t *stream, const char *value)
+{
+    if (value == NULL)
+    {
+        json_stream_null(stream);
+        return;
+    }
+    _separator(stream);
+    _append_quoted(stream, value);
+}
+
+/**
+ * @brief Write an unsigned integer value.
+ */
+void json_stream_uint(json_stream_t *stream, uint32_t value)
+{
+    _separator(stream);
+    _append_uint(stream, value, 1);
+}
+
+/**
+ * @brief Write a 64-bit unsigned integer value (e.g. a microsecond timestamp).
+ */
+void json_stream_uint64(json_stream_t *stream, uint64_t value)
+{
+    _separator(stream);
+    _append_uint(stream, value, 1);
+}
+
+/**
+ * @brief Write a signed integer value.
+ */
+void json_stream_int(json_stream_t *stream, int32_t value)
+{
+    _separator(stream);
+    if (value < 0)
+    {
+        _append_char(stream, '-');
+        _append_uint(stream, (uint64_t)(-(int64_t)value), 1);
+    }
+    else
+    {
+        _append_uint(stream, (uint64_t)value, 1);
+    }
+}
+
+/**
+ * @brief Write a boolean value.
+ */
+void json_stream_bool(json_stream_t *stream, bool value)
+{
+    _separator(stream);
+    if (value)
+    {
+        _append(stream, "true", 4);
+    }
+    else
+    {
+        _append(stream, "false", 5);
+    }
+}
+
+/**
+ * @brief Write a null value.
+ */
+void json_stream_null(json_stream_t *stream)
+{
+    _separator(stream);
+    _append(stream, "null", 4);
+}
+
+/**
+ * @brief Write an already-serialized JSON value (e.g. a cached cJSON_PrintUnformatted() string).
+ */
+void json_stream_value_raw(json_stream_t *stream, const char *json)
+{
+    _separator(stream);
+    if (json == NULL)
+    {
+        _append(stream, "null", 4);
+        return;
+    }
+    _append(stream, json, strlen(json));
+}
+
+/**
+ * @brief Write a number rounded to a fixed number of decimals, trailing zeros trimmed.
+ *
+ * @param stream Writer state.
+ * @param value Value to write (non-finite values and values too large to scale are written as null).
+ * @param decimals Number of decimal places (clamped to 0-6).
+ */
+void json_stream_fixed(json_stream_t *stream, double value, int decimals)
+{
+    if (decimals < 0)
+    {
+        decimals = 0;
+    }
+    if (decimals > 6)
+    {
+        decimals = 6;
+    }
+
+    uint32_t scale = s_pow10[decimals];
+    bool negative = value < 0.0;
+    double magnitude = negative ? -value : value;
+    if (!isfinite(value) || magnitude * (double)scale >= JSON_FIXED_MAX_SCALED)
+    {
+        json_stream_null(stream);
+        return;
+    }
+
+    _separator(stream);
+
+    uint64_t scaled = (uint64_t)llround(magnitude * (double)scale);
+
+    uint64_t integer_part  = scaled / scale;
+    uint32_t fraction_part = (uint32_t)(scaled % scale);
+
+    // Avoid "-0" for values that round to zero
+    if (negative && scaled != 0U)
+    {
+        _append_char(stream, '-');
+    }
+    _append_uint(stream, integer_part, 1);
+
+    if (fraction_part != 0U)
+    {
+        // Trim trailing zeros so 12.50 is written as 12.5
+        int digits = decimals;
+        while (fraction_part % 10U == 0U)
+        {
+            fraction_part /= 10U;
+            digits--;
+        }
+        _append_char(stream, '.');
+        _append_uint(stream, fraction_part, digits);
+    }
+}
+
+// Object member helpers: key followed by value
+
+void json_stream_add_string(json_stream_t *stream, const char *key, const char *value)
+{
+    json_stream_key(stream, key);
+    json_stream_string(stream, value);
+}
+
+void json_stream_add_uint(json_stream_t *stream, const char *key, uint32_t value)
+{
+    json_stream_key(stream, key);
+    json_stream_uint(stream, value);
+}
+
+void json_stream_add_uint64(json_stream_t *stream, const char *key, uint64_t value)
+{
+    json_stream_key(stream, key);
+    json_stream_uint64(stream, value);
+}
+
+void json_stream_add_int(json_stream_t *stream, const char *key, int32_t value)
+{
+    json_stream_key(stream, key);
+    json_stream_int(stream, value);
+}
+
+void json_stream_add_bool(json_stream_t *stream, const char *key, bool value)
+{
+    json_stream_key(stream, key);
+    json_stream_bool(stream, value);
+}
+
+void json_stream_add_null(json_stream_t *stream, const char *key)
+{
+    json_stream_key(stream, key);
+    json_stream_null(stream);
+}
+
+void json_stream_add_fixed(json_stream_t *stream, const char *key, double value, int decimals)
+{
+    json_stream_key(stream, key);
+    json_stream_fixed(stream, value, decimals);
+}
+
+void json_stream_add_value_raw(json_stream_t *stream, const char *key, const char *json)
+{
+    json_stream_key(stream, key);
+    json_stream_value_raw(stream, json);
+}
@@ -0,0 +1,447 @@
+/**
+ * @file sysmon_metrics.c
+ * @brief OpenMetrics text exposition of the latest sample (/metrics).
+ *
+ * This file implements the /metrics endpoint described in sysmon_metrics.h.
+ * Each line is formatted into a small stack buffer and appended to the chunk
+ * buffer of the streaming writer, which sends it as it fills.
+ */
+
+// Project-specific includes
+#include "sysmon_metrics.h"
+#include "sysmon_heap.h"
+#include "sysmon_json_stream.h"
+#include "sysmon_snapshot.h"
+#include "sysmon_utils.h"
+#include "sysmon.h"
+
+// ESP-IDF includes
+#include "freertos/FreeRTOS.h"
+
+// System includes
+#include <inttypes.h>
+#include <math.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+// Longest formatted sample line (metric name, labels, value)
+#define METRICS_LINE_SIZE 192
+
+// Size of an escaped task label ("task=\"...\"", every name character escaped)
+#define METRICS_TASK_LABEL_SIZE 80
+
+/**
+ * @brief Values of one task, copied from the snapshot for one sample line.
+ *
+ * Members:
+ * - label       : Formatted task label (task="name").
+ * - cpu_percent : CPU usage in percent.
+ * - stack_used  : Stack used in bytes.
+ * - stack_free  : Stack never used (high water mark) in bytes.
+ * - stack_size  : Registered stack size in bytes (0 if unknown).
+ * - priority    : Current priority.
+ * - heap_valid  : Whether the heap values hold accounting data (see sysmon_alloc.h).
+ * - heap_live   : Heap bytes allocated by the task and not yet freed.
+ * - heap_allocs : Allocations made by the task (cumulative, wraps).
+ */
+typedef struct
+{
+    char label[METRICS_TASK_LABEL_SIZE];
+    float cpu_percent;
+    uint32_t stack_used;
+    uint32_t stack_free;
+    uint32_t stack_size;
+    uint32_t priority;
+    bool heap_valid;
+    uint32_t heap_live;
+    uint32_t heap_allocs;
+} MetricsTaskRow;
+
+/**
+ * @brief Per-task metric families, in output order.
+ */
+typedef enum
+{
+    METRICS_TASK_CPU = 0,
+    METRICS_TASK_STACK_USED,
+    METRICS_TASK_STACK_FREE,
+    METRICS_TASK_STACK_SIZE,
+    METRICS_TASK_PRIORITY,
+#if CONFIG_SYSMON_TASK_HEAP_ACCOUNTING
+    METRICS_TASK_HEAP_LIVE,
+    METRICS_TASK_HEAP_ALLOCS,
+#endif
+    METRICS_TASK_FAMILY_COUNT
+} MetricsTaskFamily;
+
+/**
+ * @brief Name, type and help text of a per-task family.
+ *
+ * Members:
+ * - name   : Family name (without the "_total" suffix of counters).
+ * - sample : Sample name.
+ * - type   : OpenMetrics type.
+ * - help   : Help text.
+ */
+typedef struct
+{
+    const char *name;
+    const char *sample;
+    const char *type;
+    const char *help;
+} MetricsTaskFamilyInfo;
+
+static const MetricsTaskFamilyInfo s_task_families[METRICS_TASK_FAMILY_COUNT] =
+{
+    [METRICS_TASK_CPU]        = { "sysmon_task_cpu_usage_ratio", "sysmon_task_cpu_usage_ratio", "gauge",
+                                  "Task CPU usage over the last sampling interval." },
+    [METRICS_TASK_STACK_USED] = { "sysmon_task_stack_used_bytes", "sysmon_task_stack_used_bytes", "gauge",
+                                  "Peak task stack usage." },
+    [METRICS_TASK_STACK_FREE] = { "sysmon_task_stack_free_bytes", "sysmon_task_stack_free_bytes", "gauge",
+                                  "Task stack never used (high water mark)." },
+    [METRICS_TASK_STACK_SIZE] = { "sysmon_task_stack_size_bytes", "sysmon_task_stack_size_bytes", "gauge",
+                                  "Registered task stack size." },
+    [METRICS_TASK_PRIORITY]   = { "sysmon_task_priority", "sysmon_task_priority", "gauge",
+                                  "Current task priority." },
+#if CONFIG_SYSMON_TASK_HEAP_ACCOUNTING
+    [METRICS_TASK_HEAP_LIVE]  = { "sysmon_task_heap_live_bytes", "sysmon_task_heap_live_bytes", "gauge",
+                                  "Heap allocated by the task and not yet freed." },
+    [METRICS_TASK_HEAP_ALLOCS] = { "sysmon_task_heap_allocations", "sysmon_task_heap_allocations_total", "counter",
+                                   "Heap allocations made by the task." },
+#endif
+};
+
+// ============================================================================
+// Internal Helper Functions
+// ============================================================================
+
+/**
+ * @brief Write the TYPE and HELP lines of a metric family.
+ *
+ * @param stream Chunked response writer.
+ * @param name Family name (without the "_total" suffix of counters).
+ * @param type OpenMetrics type ("gauge" or "counter").
+ * @param help Help text.
+ */
+static void _metrics_family(json_stream_t *stream, const char *name, const char *type, const char *help)
+{
+    char line[METRICS_LINE_SIZE];
+    int len = snprintf(line, sizeof(line), "# TYPE %s %s\n# HELP %s %s\n", name, type, name, help);
+    if (len > 0)
+    {
+        json_stream_raw(stream, line, ((size_t)len < sizeof(line)) ? (size_t)len : sizeof(line) - 1U);
+    }
+}
+
+/**
+ * @brief Write one sample line with an unsigned integer value.
+ *
+ * @param stream Chunked response writer.
+ * @param name Sample name.
+ * @param labels Formatted labels without braces, or NULL.
+ * @param value Value.
+ */
+static void _metrics_uint(json_stream_t *stream, const char *name, const char *labels, uint64_t value)
+{
+    char line[METRICS_LINE_SIZE];
+    int len = (labels != NULL)
+            ? snprintf(line, sizeof(line), "%s{%s} %" PRIu64 "\n", name, labels, value)
+            : snprintf(line, sizeof(line), "%s %" PRIu64 "\n", name, value);
+    if (len > 0)
+    {
+        json_stream_raw(stream, line, ((size_t)len < sizeof(line)) ? (size_t)len : sizeof(line) - 1U);
+    }
+}
+
+/**
+ * @brief Write one sample line with a percentage converted to a ratio.
+ *
+ * @param stream Chunked response writer.
+ * @param name Sample name.
+ * @param labels Formatted labels without braces, or NULL.
+ * @param percent Value in percent (written as a ratio with 4 decimals).
+ */
+static void _metrics_ratio(json_stream_t *stream, const char *name, const char *labels, float percent)
+{
+    // Fixed point: hundredths of a percent are ten-thousandths of the ratio
+    uint32_t scaled = 0U;
+    if (isfinite(percent) && percent > 0.0f)
+    {
+        scaled = (uint32_t)lroundf(percent * 100.0f);
+    }
+
+    char line[METRICS_LINE_SIZE];
+    int len = (labels != NULL)
+            ? snprintf(line, sizeof(line), "%s{%s} %" PRIu32 ".%04" PRIu32 "\n",
+                       name, labels, scaled / 10000U, scaled % 10000U)
+            : snprintf(line, sizeof(line), "%s %" PRIu32 ".%04" PRIu32 "\n",
+                       name, scaled / 10000U, scaled % 10000U);
+    if (len > 0)
+    {
+        json_stream_raw(stream, line, ((size_t)len < sizeof(line)) ? (size_t)len : sizeof(line) - 1U);
+    }
+}
+
+/**
+ * @brief Format a label with an escaped value.
+ *
+ * @param buffer Output buffer.
+ * @param size Size of the buffer.
+ * @param name Label name.
+ * @param value Label value (backslash, double quote and newline are escaped).
+ */
+static void _metrics_label(char *buffer, size_t size, const char *name, const char *value)
+{
+    int len = snprintf(buffer, size, "%s=\"", name);
+    size_t pos = (len > 0) ? (size_t)len : 0U;
+
+    // Keep room for up to two bytes per character plus the closing quote and NUL
+    for (const char *c = value; *c != '\0' && pos + 4U <= size; c++)
+    {
+        if (*c == '\\' || *c == '"')
+        {
+            buffer[pos++] = '\\';
+            buffer[pos++] = *c;
+        }
+        else if (*c == '\n')
+        {
+            buffer[pos++] = '\\';
+            buffer[pos++] = 'n';
+        }
+        else
+        {
+            buffer[pos++] = *c;
+        }
+    }
+    buffer[pos++] = '"';
+    buffer[pos]   = '\0';
+}
+
+/**
+ * @brief Fill a row from a task copy.
+ *
+ * @param row Output row.
+ * @param task Task copy (from _snapshot_read_task()).
+ */
+static void _metrics_fill_row(MetricsTaskRow *row, const TaskUsageSample *task)
+{
+    char key_buffer[32];
+    _metrics_label(row->label, sizeof(row->label), "task",
+                   _get_task_display_key(task->task_name, task->name_ordinal,
+                                         key_buffer, sizeof(key_buffer)));
+    row->cpu_percent = task->usage_percent;
+    row->stack_used  = task->stack_used_bytes;
+    row->stack_free  = task->stack_high_water_mark * sizeof(StackType_t);
+    row->stack_size  = task->stack_size_bytes;
+    row->priority    = (uint32_t)task->current_priority;
+    row->heap_valid  = task->heap_valid;
+    row->heap_live   = task->heap_live_bytes;
+    row->heap_allocs = task->heap_alloc_count;
+}
+
+/**
+ * @brief Write the system-wide CPU, heap and sampler families.
+ *
+ * @param stream Chunked response writer.
+ * @param sample Latest system-wide sample.
+ */
+static void _metrics_write_system(json_stream_t *stream, const SysMonSeriesSample *sample)
+{
+    char labels[16];
+
+    _metrics_family(stream, "sysmon_cpu_usage_ratio", "gauge", "CPU usage per core over the last sampling interval.");
+    for (int core = 0; core < SYSMON_CORE_COUNT; core++)
+    {
+        snprintf(labels, sizeof(labels), "core=\"%d\"", core);
+        _metrics_ratio(stream, "sysmon_cpu_usage_ratio", labels, sample->cpu_core_percent[core]);
+    }
+#if CONFIG_SYSMON_ISR_MONITOR
+    _metrics_family(stream, "sysmon_isr_usage_ratio", "gauge",
+                    "Share of each core spent in interrupt handlers over the last sampling interval.");
+    for (int core = 0; core < SYSMON_CORE_COUNT; core++)
+    {
+        snprintf(labels, sizeof(labels), "core=\"%d\"", core);
+        _metrics_ratio(stream, "sysmon_isr_usage_ratio", labels, sample->isr_core_percent[core]);
+    }
+#endif
+    _metrics_family(stream, "sysmon_cpu_overall_usage_ratio", "gauge", "CPU usage averaged over all cores.");
+    _metrics_ratio(stream, "sysmon_cpu_overall_usage_ratio", NULL, sample->cpu_overall_percent);
+
+    const char *dram  = "region=\"dram\"";
+    const char *psram = "region=\"psram\"";
+    _metrics_family(stream, "sysmon_heap_free_bytes", "gauge", "Free heap.");
+    _metrics_uint(stream, "sysmon_heap_free_bytes", dram, sample->dram_free);
+    if (sample->psram_seen)
+    {
+        _metrics_uint(stream, "sysmon_heap_free_bytes", psram, sample->psram_free);
+    }
+    _metrics_family(stream, "sysmon_heap_total_bytes", "gauge", "Total heap.");
+    _metrics_uint(stream, "sysmon_heap_total_bytes", dram, sample->dram_total);
+    if (sample->psram_seen)
+    {
+        _metrics_uint(stream, "sysmon_heap_total_bytes", psram, sample->psram_total);
+    }
+    _metrics_family(stream, "sysmon_heap_largest_free_block_bytes", "gauge", "Largest free heap block.");
+    _metrics_uint(stream, "sysmon_heap_largest_free_block_bytes", dram, sample->dram_largest_block);
+    _metrics_family(stream, "sysmon_heap_min_free_bytes", "gauge", "Lowest free heap since boot.");
+    _metrics_uint(stream, "sysmon_heap_min_free_bytes", dram, sample->dram_min_free);
+    _metrics_family(stream, "sysmon_heap_fragmentation_ratio", "gauge",
+                    "1 - largest free block / free heap.");
+    _metrics_ratio(stream, "sysmon_heap_fragmentation_ratio", dram, sample->dram_frag_percent);
+
+    _metrics_family(stream, "sysmon_samples", "counter", "Samples taken since boot.");
+    _metrics_uint(stream, "sysmon_samples_total", NULL, sample->sequence);
+    _metrics_family(stream, "sysmon_sample_overruns", "counter", "Samples that started late.");
+    _metrics_uint(stream, "sysmon_sample_overruns_total", NULL, sample->overruns);
+    _metrics_family(stream, "sysmon_sample_skipped", "counter", "Sampling slots dropped.");
+    _metrics_uint(stream, "sysmon_sample_skipped_total", NULL, sample->skipped);
+}
+
+/**
+ * @brief Write the per-capability heap families from the latest heap scan.
+ *
+ * @param stream Chunked response writer.
+ * @param report Latest per-capability scan.
+ */
+static void _metrics_write_heap_caps(json_stream_t *stream, const sysmon_heap_report_t *report)
+{
+    char labels[SYSMON_HEAP_CAPS_COUNT][24];
+    for (int caps = 0; caps < SYSMON_HEAP_CAPS_COUNT; caps++)
+    {
+        _metrics_label(labels[caps], sizeof(labels[caps]), "caps", _heap_caps_name((sysmon_heap_caps_t)caps));
+    }
+
+    _metrics_family(stream, "sysmon_heap_caps_free_bytes", "gauge", "Free heap per capability.");
+    for (int caps = 0; caps < SYSMON_HEAP_CAPS_COUNT; caps++)
+    {
+        _metrics_uint(stream, "sysmon_heap_caps_free_bytes", labels[caps], report->caps[caps].free_bytes);
+    }
+    _metrics_family(stream, "sysmon_heap_caps_largest_free_block_bytes", "gauge",
+                    "Largest free heap block per capability.");
+    for (int caps = 0; caps < SYSMON_HEAP_CAPS_COUNT; caps++)
+    {
+        _metrics_uint(stream, "sysmon_heap_caps_largest_free_block_bytes", labels[caps], report->caps[caps].largest_free);
+    }
+    _metrics_family(stream, "sysmon_heap_caps_min_free_bytes", "gauge", "Lowest free heap since boot per capability.");
+    for (int caps = 0; caps < SYSMON_HEAP_CAPS_COUNT; caps++)
+    {
+        _metrics_uint(stream, "sysmon_heap_caps_min_free_bytes", labels[caps], report->caps[caps].minimum_free);
+    }
+}
+
+/**
+ * @brief Write the sample line of one task for a per-task family.
+ *
+ * @param stream Chunked response writer.
+ * @param family Family.
+ * @param row Task values.
+ */
+static void _metrics_task_line(json_stream_t *stream, MetricsTaskFamily family, const MetricsTaskRow *row)
+{
+    const char *sample = s_task_families[family].sample;
+    switch (family)
+    {
+        case METRICS_TASK_CPU:
+            _metrics_ratio(stream, sample, row->label, row->cpu_percent);
+            break;
+        case METRICS_TASK_STACK_USED:
+            _metrics_uint(stream, sample, row->label, row->stack_used);
+            break;
+        case METRICS_TASK_STACK_FREE:
+            _metrics_uint(stream, sample, row->label, row->stack_free);
+            break;
+        case METRICS_TASK_STACK_SIZE:
+            if (row->stack_size > 0U)
+            {
+                _metrics_uint(stream, sample, row->label, row->stack_size);
+            }
+            break;
+        case METRICS_TASK_PRIORITY:
+            _metrics_uint(stream, sample, row->label, row->priority);
+            break;
+#if CONFIG_SYSMON_TASK_HEAP_ACCOUNTING
+        case METRICS_TASK_HEAP_LIVE:
+            if (row->heap_valid)
+            {
+                _metrics_uint(stream, sample, row->label, row->heap_live);
+            }
+            break;
+        case METRICS_TASK_HEAP_ALLOCS:
+            if (row->heap_valid)
+            {
+                _metrics_uint(stream, sample, row->label, row->heap_allocs);
+            }
+            break;
+#endif
+        default:
+            break;
+    }
+}
+
+/**
+ * @brief Write the per-task families.
+ *
+ * Each family is one pass over the snapshot that streams every active task
+ * through a single reusable row, so the memory used does not grow with the
+ * number of tasks.
+ *
+ * @param stream Chunked response writer.
+ * @param task Reader-owned task copy (from _snapshot_alloc_task()).
+ */
+static void _metrics_write_tasks(json_stream_t *stream, TaskUsageSample *task)
+{
+    MetricsTaskRow row;
+    for (int family = 0; family < METRICS_TASK_FAMILY_COUNT && stream->error == ESP_OK; family++)
+    {
+        _metrics_family(stream, s_task_families[family].name, s_task_families[family].type,
+                        s_task_families[family].help);
+
+        sysmon_view_t view;
+        _snapshot_acquire_view(&view);
+        for (int i = 0; i < view.task_capacity && stream->error == ESP_OK; i++)
+        {
+            if (_snapshot_read_task(&view, i, task, NULL))
+            {
+                _metrics_fill_row(&row, task);
+                _metrics_task_line(stream, (MetricsTaskFamily)family, &row);
+            }
+        }
+        _snapshot_release_view(&view);
+    }
+}
+
+// ============================================================================
+// Public API Functions
+// ============================================================================
+
+/**
+ * @brief Write the latest sample in the OpenMetrics text format.
+ *
+ * @param stream Chunked response writer (headers already set by the caller).
+ * @return ESP_OK on success, or the first error raised while streaming.
+ */
+esp_err_t _write_metrics_text(json_stream_t *stream)
+{
+    TaskUsageSample *task = _snapshot_alloc_task(0U);
+    if (task == NULL)
+    {
+        return ESP_ERR_NO_MEM;
+    }
+
+    SysMonSeriesSample sample;
+    _snapshot_read_series(&sample);
+    _metrics_write_system(stream, &sample);
+    sysmon_heap_report_t report;
+    if (_heap_caps_read(&report))
+    {
+        _metrics_write_heap_caps(stream, &report);
+    }
+    _metrics_write_tasks(stream, task);
+    json_stream_raw(stream, "# EOF\n", 6U);
+
+    free(task);
+    return stream->error;
+}
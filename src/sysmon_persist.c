@@ -0,0 +1,662 @@
+/**
+ * @file sysmon_persist.c
+ * @brief Latest samples kept across resets in RTC memory.
+ *
+ * This file implements the RTC_NOINIT sample ring described in
+ * sysmon_persist.h. The sampler task is the ring's only writer; the copy of
+ * the previous boot's samples is made once by _persist_start() and is
+ * read-only afterwards, so /history?boot=previous needs no lock.
+ */
+
+// Project-specific includes
+#include "sysmon_persist.h"
+#include "sysmon.h"
+#include "sysmon_json_stream.h"
+#include "sysmon_snapshot.h"
+#include "sysmon_utils.h"
+
+// ESP-IDF includes
+#include "esp_attr.h"
+#include "esp_heap_caps.h"
+#include "esp_log.h"
+#include "esp_system.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+
+// System includes
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+
+#if CONFIG_SYSMON_PERSIST_HISTORY
+
+// Logger tag for this module
+static const char *LOG_TAG = "sysmon_persist";
+
+#define PERSIST_MAGIC          0x52504D53U     // "SMPR"
+#define PERSIST_VERSION        1
+#define PERSIST_NAMES          (CONFIG_SYSMON_PERSIST_TASKS * 4)
+#define PERSIST_STACK_UNKNOWN  0xFFU
+#define PERSIST_CHECK_SEED     0xA5A5U
+
+/**
+ * @brief Task figures of one record.
+ *
+ * Members:
+ * - ref        : 1 + index into the name table (0 for an unused entry).
+ * - stack_pct  : Stack usage in percent (PERSIST_STACK_UNKNOWN if the stack is not registered).
+ * - cpu        : CPU usage in hundredths of a percent.
+ * - stack_free : Stack never used since creation in bytes (saturated).
+ */
+typedef struct
+{
+    uint8_t ref;
+    uint8_t stack_pct;
+    uint16_t cpu;
+    uint16_t stack_free;
+} PersistTask;
+
+/**
+ * @brief One sample.
+ *
+ * Members:
+ * - seq           : Sample sequence number.
+ * - time_ms       : Sample start, milliseconds since boot.
+ * - dram_free     : Free internal heap.
+ * - dram_min_free : Lowest free internal heap since boot.
+ * - dram_largest  : Largest free internal heap block.
+ * - psram_free    : Free PSRAM (0 without PSRAM).
+ * - cpu           : Overall CPU usage in hundredths of a percent.
+ * - core          : CPU usage per core in hundredths of a percent.
+ * - tasks         : Tasks with the highest CPU or stack usage of the sample.
+ * - check         : Checksum of the fields above (see _persist_checksum()).
+ */
+typedef struct
+{
+    uint32_t seq;
+    uint32_t time_ms;
+    uint32_t dram_free;
+    uint32_t dram_min_free;
+    uint32_t dram_largest;
+    uint32_t psram_free;
+    uint16_t cpu;
+    uint16_t core[SYSMON_CORE_COUNT];
+    PersistTask tasks[CONFIG_SYSMON_PERSIST_TASKS];
+    uint16_t check;
+} PersistRecord;
+
+/**
+ * @brief Name table entry.
+ *
+ * Members:
+ * - key       : Task key ("" for a free entry).
+ * - since_seq : First sample recorded with this key; older references belong to a previous key.
+ * - last_seq  : Latest sample recorded with this key (for reuse of the least recently used entry).
+ */
+typedef struct
+{
+    char key[20];
+    uint32_t since_seq;
+    uint32_t last_seq;
+} PersistName;
+
+/**
+ * @brief Ring in RTC_NOINIT memory (layout checked on recovery).
+ *
+ * Members:
+ * - magic       : PERSIST_MAGIC once initialized.
+ * - version     : PERSIST_VERSION.
+ * - record_size : sizeof(PersistRecord).
+ * - capacity    : Number of records (CONFIG_SYSMON_PERSIST_SAMPLES).
+ * - name_count  : Number of name table entries.
+ * - boot_count  : Boots since the ring was last initialized from scratch.
+ * - interval_ms : Sampling interval of the boot that wrote the ring.
+ * - head        : Next record to write.
+ * - count       : Written records (at most capacity).
+ * - names       : Name table.
+ * - records     : Records (cyclic).
+ */
+typedef struct
+{
+    uint32_t magic;
+    uint16_t version;
+    uint16_t record_size;
+    uint16_t capacity;
+    uint16_t name_count;
+    uint32_t boot_count;
+    uint32_t interval_ms;
+    uint32_t head;
+    uint32_t count;
+    PersistName names[PERSIST_NAMES];
+    PersistRecord records[CONFIG_SYSMON_PERSIST_SAMPLES];
+} PersistRing;
+
+/**
+ * @brief Copy of the previous boot's ring.
+ *
+ * Members:
+ * - boot_count  : Boot number of the previous boot.
+ * - reason      : Reset reason that ended it.
+ * - interval_ms : Its sampling interval.
+ * - count       : Valid records, oldest first.
+ * - names       : Its name table.
+ * - records     : Its valid records.
+ */
+typedef struct
+{
+    uint32_t boot_count;
+    esp_reset_reason_t reason;
+    uint32_t interval_ms;
+    uint32_t count;
+    PersistName names[PERSIST_NAMES];
+    PersistRecord records[CONFIG_SYSMON_PERSIST_SAMPLES];
+} PersistPrevious;
+
+static RTC_NOINIT_ATTR PersistRing s_ring;
+static PersistPrevious *s_previous = NULL;
+static bool s_started = false;
+#endif
+
+// ============================================================================
+// Internal Helper Functions
+// ============================================================================
+
+#if CONFIG_SYSMON_PERSIST_HISTORY
+
+/**
+ * @brief Checksum of a record (Fletcher-16 over every field before check).
+ *
+ * @param record Record.
+ * @return Checksum, never 0 for an all-zero record.
+ */
+static uint16_t _persist_checksum(const PersistRecord *record)
+{
+    const uint8_t *bytes = (const uint8_t *)record;
+    uint32_t sum1 = 0;
+    uint32_t sum2 = 0;
+    for (size_t i = 0; i < offsetof(PersistRecord, check); i++)
+    {
+        sum1 = (sum1 + bytes[i]) % 255U;
+        sum2 = (sum2 + sum1) % 255U;
+    }
+    return (uint16_t)(((sum2 << 8) | sum1) ^ PERSIST_CHECK_SEED);
+}
+
+/**
+ * @brief Encode a percentage in hundredths.
+ *
+ * @param percent Percentage.
+ * @return Hundredths of a percent, clamped to 0..10000.
+ */
+static uint16_t _persist_encode_percent(float percent)
+{
+    if (percent <= 0.0f)
+    {
+        return 0U;
+    }
+    if (percent >= 100.0f)
+    {
+        return 10000U;
+    }
+    return (uint16_t)(percent * 100.0f + 0.5f);
+}
+
+/**
+ * @brief Short name of a reset reason.
+ *
+ * @param reason Reset reason.
+ * @return Name ("panic", "task_wdt", ...).
+ */
+static const char *_persist_reason_name(esp_reset_reason_t reason)
+{
+    switch (reason)
+    {
+        case ESP_RST_POWERON:   return "poweron";
+        case ESP_RST_EXT:       return "external";
+        case ESP_RST_SW:        return "software";
+        case ESP_RST_PANIC:     return "panic";
+        case ESP_RST_INT_WDT:   return "int_wdt";
+        case ESP_RST_TASK_WDT:  return "task_wdt";
+        case ESP_RST_WDT:       return "wdt";
+        case ESP_RST_DEEPSLEEP: return "deepsleep";
+        case ESP_RST_BROWNOUT:  return "brownout";
+        case ESP_RST_SDIO:      return "sdio";
+        default:                return "unknown";
+    }
+}
+
+/**
+ * @brief Whether the ring holds data written with this firmware's layout.
+ *
+ * @return true if the header is intact and matches this build.
+ */
+static bool _persist_layout_valid(void)
+{
+    return s_ring.magic == PERSIST_MAGIC && s_ring.version == PERSIST_VERSION &&
+           s_ring.record_size == sizeof(PersistRecord) && s_ring.capacity == CONFIG_SYSMON_PERSIST_SAMPLES &&
+           s_ring.name_count == PERSIST_NAMES && s_ring.head < CONFIG_SYSMON_PERSIST_SAMPLES &&
+           s_ring.count <= CONFIG_SYSMON_PERSIST_SAMPLES;
+}
+
+/**
+ * @brief Copy the valid records of the ring, oldest first.
+ *
+ * @param previous Output copy (names and records).
+ *
+ * Records with a bad checksum (torn by the reset) or out of sequence are skipped.
+ */
+static void _persist_copy_ring(PersistPrevious *previous)
+{
+    memcpy(previous->names, s_ring.names, sizeof(previous->names));
+    for (int m = 0; m < PERSIST_NAMES; m++)
+    {
+        previous->names[m].key[sizeof(previous->names[m].key) - 1] = '\0';
+    }
+
+    uint32_t start    = (s_ring.head + CONFIG_SYSMON_PERSIST_SAMPLES - s_ring.count) % CONFIG_SYSMON_PERSIST_SAMPLES;
+    uint32_t last_seq = 0;
+    previous->count   = 0;
+    for (uint32_t n = 0; n < s_ring.count; n++)
+    {
+        const PersistRecord *record = &s_ring.records[(start + n) % CONFIG_SYSMON_PERSIST_SAMPLES];
+        if (record->check != _persist_checksum(record) || (previous->count > 0 && record->seq <= last_seq))
+        {
+            continue;
+        }
+        previous->records[previous->count++] = *record;
+        last_seq = record->seq;
+    }
+}
+
+/**
+ * @brief Name table reference of a task key, claiming an entry for a new key.
+ *
+ * @param key Task key.
+ * @param seq Sequence number of the sample being recorded.
+ * @return 1 + index into the name table.
+ *
+ * A new key takes the least recently recorded entry; entries used by the
+ * sample being recorded are never taken, as the table has four entries per
+ * recorded task.
+ */
+static uint8_t _persist_name_ref(const char *key, uint32_t seq)
+{
+    int lru = -1;
+    for (int m = 0; m < PERSIST_NAMES; m++)
+    {
+        PersistName *name = &s_ring.names[m];
+        if (name->key[0] == '\0')
+        {
+            // Free entries go first, then the least recently recorded one
+            if (lru < 0 || s_ring.names[lru].key[0] != '\0')
+            {
+                lru = m;
+            }
+            continue;
+        }
+        if (strncmp(name->key, key, sizeof(name->key) - 1) == 0)
+        {
+            name->last_seq = seq;
+            return (uint8_t)(m + 1);
+        }
+        if (lru < 0 || (s_ring.names[lru].key[0] != '\0' && name->last_seq < s_ring.names[lru].last_seq))
+        {
+            lru = m;
+        }
+    }
+
+    PersistName *name = &s_ring.names[lru];
+    memset(name->key, 0, sizeof(name->key));
+    strncpy(name->key, key, sizeof(name->key) - 1);
+    name->since_seq = seq;
+    name->last_seq  = seq;
+    return (uint8_t)(lru + 1);
+}
+
+/**
+ * @brief Pick the tasks with the highest CPU or stack usage (sampler task only).
+ *
+ * @param picked Output: task indices, highest score first.
+ * @return Number of tasks picked (at most CONFIG_SYSMON_PERSIST_TASKS).
+ */
+static int _persist_pick_tasks(int picked[CONFIG_SYSMON_PERSIST_TASKS])
+{
+    float scores[CONFIG_SYSMON_PERSIST_TASKS];
+    int count = 0;
+    for (int i = 0; i < self.task_capacity; i++)
+    {
+        const TaskUsageSample *task = &self.tasks[i];
+        if (!task->is_active || task->consecutive_zero_samples > 0)
+        {
+            continue;
+        }
+        float score = (task->stack_used_percent > task->usage_percent) ? task->stack_used_percent
+                                                                       : task->usage_percent;
+        if (count == CONFIG_SYSMON_PERSIST_TASKS && score <= scores[count - 1])
+        {
+            continue;
+        }
+
+        // Insertion into the short sorted list
+        int pos = (count < CONFIG_SYSMON_PERSIST_TASKS) ? count++ : count - 1;
+        while (pos > 0 && scores[pos - 1] < score)
+        {
+            scores[pos] = scores[pos - 1];
+            picked[pos] = picked[pos - 1];
+            pos--;
+        }
+        scores[pos] = score;
+        picked[pos] = i;
+    }
+    return count;
+}
+
+/**
+ * @brief Write one system-wide series of the previous boot as a JSON array.
+ *
+ * @param stream Chunked response writer.
+ * @param key JSON key.
+ * @param field Byte offset of a uint32_t field in PersistRecord.
+ */
+static void _persist_write_uint_series(json_stream_t *stream, const char *key, size_t field)
+{
+    json_stream_key(stream, key);
+    json_stream_array_begin(stream);
+    for (uint32_t n = 0; n < s_previous->count; n++)
+    {
+        uint32_t value;
+        memcpy(&value, (const uint8_t *)&s_previous->records[n] + field, sizeof(value));
+        json_stream_uint(stream, value);
+    }
+    json_stream_array_end(stream);
+}
+
+/**
+ * @brief Write the series of one task of the previous boot.
+ *
+ * @param stream Chunked response writer.
+ * @param ref Name table reference of the task.
+ *
+ * Samples in which the task was not among the recorded ones are null.
+ */
+static void _persist_write_task(json_stream_t *stream, uint8_t ref)
+{
+    const PersistName *name = &s_previous->names[ref - 1];
+    static const char *const keys[] = { "cpu", "stackPct", "stackFree" };
+
+    json_stream_key(stream, name->key);
+    json_stream_object_begin(stream);
+    for (int k = 0; k < 3; k++)
+    {
+        json_stream_key(stream, keys[k]);
+        json_stream_array_begin(stream);
+        for (uint32_t n = 0; n < s_previous->count; n++)
+        {
+            const PersistRecord *record = &s_previous->records[n];
+            const PersistTask *entry    = NULL;
+            for (int t = 0; t < CONFIG_SYSMON_PERSIST_TASKS && record->seq >= name->since_seq; t++)
+            {
+                if (record->tasks[t].ref == ref)
+                {
+                    entry = &record->tasks[t];
+                    break;
+                }
+            }
+            if (entry == NULL || (k == 1 && entry->stack_pct == PERSIST_STACK_UNKNOWN))
+            {
+                json_stream_null(stream);
+            }
+            else if (k == 0)
+            {
+                json_stream_fixed(stream, entry->cpu / 100.0, 1);
+            }
+            else if (k == 1)
+            {
+                json_stream_uint(stream, entry->stack_pct);
+            }
+            else
+            {
+                json_stream_uint(stream, entry->stack_free);
+            }
+        }
+        json_stream_array_end(stream);
+    }
+    json_stream_object_end(stream);
+}
+
+/**
+ * @brief Whether any record of the previous boot references a name table entry.
+ *
+ * @param ref Name table reference.
+ * @return true if the task has at least one sample.
+ */
+static bool _persist_task_recorded(uint8_t ref)
+{
+    const PersistName *name = &s_previous->names[ref - 1];
+    if (name->key[0] == '\0')
+    {
+        return false;
+    }
+    for (uint32_t n = 0; n < s_previous->count; n++)
+    {
+        const PersistRecord *record = &s_previous->records[n];
+        for (int t = 0; t < CONFIG_SYSMON_PERSIST_TASKS && record->seq >= name->since_seq; t++)
+        {
+            if (record->tasks[t].ref == ref)
+            {
+                return true;
+            }
+        }
+    }
+    return false;
+}
+#endif
+
+// ============================================================================
+// Public API Functions
+// ============================================================================
+
+/**
+ * @brief Recover the previous boot's samples and start a new ring.
+ *
+ * @return ESP_OK on success (or if persistence is disabled), ESP_ERR_NO_MEM if
+ *         the recovered samples could not be copied (the ring is still restarted).
+ */
+esp_err_t _persist_start(void)
+{
+#if CONFIG_SYSMON_PERSIST_HISTORY
+    if (s_started)
+    {
+        return ESP_OK;
+    }
+
+    // RTC_NOINIT memory is undefined after power-on; the magic alone could match by chance
+    esp_reset_reason_t reason = esp_reset_reason();
+    bool recover      = (reason != ESP_RST_POWERON) && _persist_layout_valid();
+    uint32_t boot     = recover ? s_ring.boot_count + 1U : 1U;
+    esp_err_t err     = ESP_OK;
+    if (recover && s_ring.count > 0)
+    {
+#if CONFIG_SYSMON_HISTORY_IN_PSRAM
+        s_previous = (PersistPrevious *)heap_caps_malloc_prefer(sizeof(PersistPrevious), 2,
+                                                                MALLOC_CAP_SPIRAM | MALLOC_CAP_8BIT, MALLOC_CAP_8BIT);
+#else
+        s_previous = (PersistPrevious *)heap_caps_malloc(sizeof(PersistPrevious), MALLOC_CAP_8BIT);
+#endif
+        if (s_previous != NULL)
+        {
+            s_previous->boot_count  = s_ring.boot_count;
+            s_previous->reason      = reason;
+            s_previous->interval_ms = s_ring.interval_ms;
+            _persist_copy_ring(s_previous);
+            ESP_LOGW(LOG_TAG, "Recovered %lu samples of boot %lu (reset reason: %s)",
+                     (unsigned long)s_previous->count, (unsigned long)s_previous->boot_count,
+                     _persist_reason_name(reason));
+        }
+        else
+        {
+            ESP_LOGE(LOG_TAG, "Failed to allocate %u bytes for the previous boot's samples",
+                     (unsigned)sizeof(PersistPrevious));
+            err = ESP_ERR_NO_MEM;
+        }
+    }
+
+    memset(&s_ring, 0, sizeof(s_ring));
+    s_ring.version     = PERSIST_VERSION;
+    s_ring.record_size = sizeof(PersistRecord);
+    s_ring.capacity    = CONFIG_SYSMON_PERSIST_SAMPLES;
+    s_ring.name_count  = PERSIST_NAMES;
+    s_ring.boot_count  = boot;
+    s_ring.interval_ms = CONFIG_SYSMON_CPU_SAMPLING_INTERVAL_MS;
+    s_ring.magic       = PERSIST_MAGIC;
+    s_started = true;
+    return err;
+#else
+    return ESP_OK;
+#endif
+}
+
+/**
+ * @brief Append the sample just published to the ring (sampler task only).
+ *
+ * @param timestamp_us Timestamp of the sample.
+ *
+ * Order of writes: name table entries, record fields, checksum, then head and
+ * count, so a reset at any point leaves every counted record either intact or
+ * detectable by its checksum.
+ */
+void _persist_record(int64_t timestamp_us)
+{
+#if CONFIG_SYSMON_PERSIST_HISTORY
+    if (!s_started || self.history_depth <= 0)
+    {
+        return;
+    }
+    int latest   = (self.series_write_index + self.history_depth - 1) % self.history_depth;
+    uint32_t seq = _snapshot_read_sequence();
+
+    PersistRecord *record = &s_ring.records[s_ring.head];
+    record->check         = 0U;
+    record->seq           = seq;
+    record->time_ms       = (uint32_t)(timestamp_us / 1000);
+    record->dram_free     = self.dram_free[latest];
+    record->dram_min_free = self.dram_min_free[latest];
+    record->dram_largest  = self.dram_largest_block[latest];
+    record->psram_free    = self.psram_free[latest];
+    record->cpu           = _persist_encode_percent(self.cpu_overall_percent[latest]);
+    for (int core = 0; core < SYSMON_CORE_COUNT; core++)
+    {
+        record->core[core] = _persist_encode_percent(self.cpu_core_percent[core][latest]);
+    }
+
+    int picked[CONFIG_SYSMON_PERSIST_TASKS];
+    int count = _persist_pick_tasks(picked);
+    char key[32];
+    for (int t = 0; t < CONFIG_SYSMON_PERSIST_TASKS; t++)
+    {
+        PersistTask *entry = &record->tasks[t];
+        if (t >= count)
+        {
+            memset(entry, 0, sizeof(*entry));
+            continue;
+        }
+        const TaskUsageSample *task = &self.tasks[picked[t]];
+        uint32_t stack_free = task->stack_high_water_mark * sizeof(StackType_t);
+        entry->ref        = _persist_name_ref(_get_task_display_key(task->task_name, task->name_ordinal,
+                                                                    key, sizeof(key)), seq);
+        entry->cpu        = _persist_encode_percent(task->usage_percent);
+        entry->stack_pct  = (task->stack_size_bytes > 0U)
+                                ? (uint8_t)((_persist_encode_percent(task->stack_used_percent) + 50U) / 100U)
+                                : PERSIST_STACK_UNKNOWN;
+        entry->stack_free = (uint16_t)((stack_free > UINT16_MAX) ? UINT16_MAX : stack_free);
+    }
+    record->check = _persist_checksum(record);
+
+    s_ring.head = (s_ring.head + 1U) % CONFIG_SYSMON_PERSIST_SAMPLES;
+    if (s_ring.count < CONFIG_SYSMON_PERSIST_SAMPLES)
+    {
+        s_ring.count++;
+    }
+#else
+    (void)timestamp_us;
+#endif
+}
+
+/**
+ * @brief Write the previous boot's samples (/history?boot=previous).
+ *
+ * @param stream Chunked response writer.
+ * @return ESP_OK on success, or the first error raised while streaming.
+ *
+ * Details:
+ *   - Output: {"boot":"previous","enabled":true,"available":B,"resetReason":R,
+ *     "bootCount":N,"intervalMs":I,"samples":C,"system":{series:[..]},
+ *     "tasks":{key:{"cpu":[..],"stackPct":[..],"stackFree":[..]}}}, oldest first.
+ *   - "resetReason" is the reason of the reset that ended the previous boot;
+ *     without a previous boot ("available": false) only it is written.
+ *   - Task arrays have one entry per sample, null where the task was not
+ *     among the recorded tasks (or its stack is not registered, for stackPct).
+ */
+esp_err_t _write_persist_json(json_stream_t *stream)
+{
+    json_stream_object_begin(stream);
+    json_stream_add_string(stream, "boot", "previous");
+    json_stream_add_bool(stream, "enabled", CONFIG_SYSMON_PERSIST_HISTORY);
+#if CONFIG_SYSMON_PERSIST_HISTORY
+    json_stream_add_bool(stream, "available", s_previous != NULL);
+    json_stream_add_string(stream, "resetReason", _persist_reason_name(esp_reset_reason()));
+    if (s_previous != NULL)
+    {
+        json_stream_add_uint(stream, "bootCount", s_previous->boot_count);
+        json_stream_add_uint(stream, "intervalMs", s_previous->interval_ms);
+        json_stream_add_uint(stream, "samples", s_previous->count);
+
+        json_stream_key(stream, "system");
+        json_stream_object_begin(stream);
+        _persist_write_uint_series(stream, "seq", offsetof(PersistRecord, seq));
+        json_stream_key(stream, "timeUs");
+        json_stream_array_begin(stream);
+        for (uint32_t n = 0; n < s_previous->count; n++)
+        {
+            json_stream_uint64(stream, (uint64_t)s_previous->records[n].time_ms * 1000U);
+        }
+        json_stream_array_end(stream);
+        for (int series = -1; series < SYSMON_CORE_COUNT; series++)
+        {
+            char key[12] = "cpu";
+            if (series >= 0)
+            {
+                snprintf(key, sizeof(key), "core%d", series);
+            }
+            json_stream_key(stream, key);
+            json_stream_array_begin(stream);
+            for (uint32_t n = 0; n < s_previous->count; n++)
+            {
+                const PersistRecord *record = &s_previous->records[n];
+                json_stream_fixed(stream, ((series < 0) ? record->cpu : record->core[series]) / 100.0, 1);
+            }
+            json_stream_array_end(stream);
+        }
+        _persist_write_uint_series(stream, "dramFree", offsetof(PersistRecord, dram_free));
+        _persist_write_uint_series(stream, "dramMinFree", offsetof(PersistRecord, dram_min_free));
+        _persist_write_uint_series(stream, "dramLargest", offsetof(PersistRecord, dram_largest));
+        _persist_write_uint_series(stream, "psramFree", offsetof(PersistRecord, psram_free));
+        json_stream_object_end(stream);
+
+        json_stream_key(stream, "tasks");
+        json_stream_object_begin(stream);
+        for (int m = 0; m < PERSIST_NAMES && stream->error == ESP_OK; m++)
+        {
+            if (_persist_task_recorded((uint8_t)(m + 1)))
+            {
+                _persist_write_task(stream, (uint8_t)(m + 1));
+            }
+        }
+        json_stream_object_end(stream);
+    }
+#endif
+    json_stream_object_end(stream);
+    return stream->error;
+}
@@ -0,0 +1,331 @@
+/**
+ * @file sysmon_profile.c
+ * @brief Self-profiling of the sysmon sampler phases and HTTP handlers.
+ *
+ * This file keeps the per-phase statistics described in sysmon_profile.h.
+ * Phases are recorded by the sampler task and the HTTP server task, so each
+ * update and each copy for /sysmon/self takes a short spinlock.
+ */
+
+// Project-specific includes
+#include "sysmon_profile.h"
+#include "sysmon.h"
+
+// ESP-IDF includes
+#include "esp_system.h"
+#include "esp_timer.h"
+#include "freertos/FreeRTOS.h"
+
+// System includes
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+
+/**
+ * @brief JSON location of a phase (see _profile_phase_name()).
+ */
+typedef struct
+{
+    const char *group;
+    const char *name;
+} ProfilePhaseInfo;
+
+static const ProfilePhaseInfo s_phase_info[SYSMON_PROFILE_PHASE_COUNT] =
+{
+    [SYSMON_PROFILE_SAMPLE]            = { NULL, "total" },
+    [SYSMON_PROFILE_CAPACITY]          = { NULL, "capacity" },
+    [SYSMON_PROFILE_TASK_STATES]       = { NULL, "taskStates" },
+    [SYSMON_PROFILE_TASK_UPDATE]       = { NULL, "taskUpdate" },
+    [SYSMON_PROFILE_MEMORY]            = { NULL, "memory" },
+    [SYSMON_PROFILE_SERIES]            = { NULL, "series" },
+    [SYSMON_PROFILE_PUSH]              = { NULL, "push" },
+    [SYSMON_PROFILE_HEAP_CAPS]         = { NULL, "heapCaps" },
+    [SYSMON_PROFILE_ALERTS]            = { NULL, "alerts" },
+    [SYSMON_PROFILE_TASKS_BUILD]       = { "/tasks", "build" },
+    [SYSMON_PROFILE_TASKS_SEND]        = { "/tasks", "send" },
+    [SYSMON_PROFILE_HISTORY_BUILD]     = { "/history", "build" },
+    [SYSMON_PROFILE_HISTORY_SEND]      = { "/history", "send" },
+    [SYSMON_PROFILE_HISTORY_BIN_BUILD] = { "/history.bin", "build" },
+    [SYSMON_PROFILE_HISTORY_BIN_SEND]  = { "/history.bin", "send" },
+    [SYSMON_PROFILE_TELEMETRY_BUILD]   = { "/telemetry", "build" },
+    [SYSMON_PROFILE_TELEMETRY_SEND]    = { "/telemetry", "send" },
+    [SYSMON_PROFILE_HARDWARE_BUILD]    = { "/hardware", "build" },
+    [SYSMON_PROFILE_HARDWARE_SEND]     = { "/hardware", "send" },
+    [SYSMON_PROFILE_METRICS_BUILD]     = { "/metrics", "build" },
+    [SYSMON_PROFILE_METRICS_SEND]      = { "/metrics", "send" },
+    [SYSMON_PROFILE_HEAP_BUILD]        = { "/heap", "build" },
+    [SYSMON_PROFILE_HEAP_SEND]         = { "/heap", "send" },
+    [SYSMON_PROFILE_BURST_BUILD]       = { "/burst", "build" },
+    [SYSMON_PROFILE_BURST_SEND]        = { "/burst", "send" },
+    [SYSMON_PROFILE_BURST_BIN_BUILD]   = { "/burst.bin", "build" },
+    [SYSMON_PROFILE_BURST_BIN_SEND]    = { "/burst.bin", "send" },
+    [SYSMON_PROFILE_ALERTS_BUILD]      = { "/alerts", "build" },
+    [SYSMON_PROFILE_ALERTS_SEND]       = { "/alerts", "send" },
+    [SYSMON_PROFILE_INTERRUPTS_BUILD]  = { "/interrupts", "build" },
+    [SYSMON_PROFILE_INTERRUPTS_SEND]   = { "/interrupts", "send" },
+    [SYSMON_PROFILE_BUNDLE_BUILD]      = { "/bundle", "build" },
+    [SYSMON_PROFILE_BUNDLE_SEND]       = { "/bundle", "send" },
+    [SYSMON_PROFILE_SELF_BUILD]        = { "/sysmon/self", "build" },
+    [SYSMON_PROFILE_SELF_SEND]         = { "/sysmon/self", "send" },
+    [SYSMON_PROFILE_PUSH_SEND]         = { "/telemetry/ws", "send" },
+};
+
+#if CONFIG_SYSMON_SELF_PROFILE
+static sysmon_profile_stats_t s_stats[SYSMON_PROFILE_PHASE_COUNT];
+static int64_t s_started_us = 0;
+static portMUX_TYPE s_profile_lock = portMUX_INITIALIZER_UNLOCKED;
+#endif
+
+// ============================================================================
+// Internal Helper Functions
+// ============================================================================
+
+#if CONFIG_SYSMON_SELF_PROFILE
+/**
+ * @brief Histogram bucket of a duration (two buckets per octave).
+ *
+ * @param duration_us Duration in microseconds.
+ * @return Bucket index (durations beyond the last bucket saturate into it).
+ */
+static int _profile_bucket(uint32_t duration_us)
+{
+    if (duration_us < 2U)
+    {
+        return (int)duration_us;
+    }
+    int octave = 31 - __builtin_clz(duration_us);
+    int index  = 2 * octave + (int)((duration_us >> (octave - 1)) & 1U);
+    return (index < SYSMON_PROFILE_BUCKETS) ? index : (SYSMON_PROFILE_BUCKETS - 1);
+}
+#endif
+
+/**
+ * @brief Largest duration that falls into a histogram bucket.
+ *
+ * @param index Bucket index.
+ * @return Upper bound in microseconds.
+ */
+static uint32_t _profile_bucket_upper_us(int index)
+{
+    if (index < 2)
+    {
+        return (uint32_t)index;
+    }
+    int octave = index / 2;
+    uint32_t next_lower = (uint32_t)(3 + (index % 2)) << (octave - 1);
+    return next_lower - 1U;
+}
+
+#if CONFIG_SYSMON_SELF_PROFILE
+/**
+ * @brief Add one call to the statistics of a phase.
+ *
+ * @param phase Phase.
+ * @param duration_us Duration of the call.
+ * @param heap_delta Free heap before minus after the call.
+ * @param end_us End time of the call.
+ */
+static void _profile_add(sysmon_profile_phase_t phase, int64_t duration_us, int32_t heap_delta, int64_t end_us)
+{
+    if ((unsigned)phase >= SYSMON_PROFILE_PHASE_COUNT)
+    {
+        return;
+    }
+    uint32_t duration = (duration_us < 0) ? 0U : ((duration_us > UINT32_MAX) ? UINT32_MAX : (uint32_t)duration_us);
+    int bucket = _profile_bucket(duration);
+
+    portENTER_CRITICAL(&s_profile_lock);
+    sysmon_profile_stats_t *stats = &s_stats[phase];
+    if (s_started_us == 0)
+    {
+        s_started_us = end_us - duration_us;
+    }
+    if (stats->count == 0U || duration < stats->min_us)
+    {
+        stats->min_us = duration;
+    }
+    if (duration > stats->max_us)
+    {
+        stats->max_us = duration;
+    }
+    if (stats->count == 0U || heap_delta > stats->heap_delta_max)
+    {
+        stats->heap_delta_max = heap_delta;
+    }
+    stats->count++;
+    stats->total_us         += duration;
+    stats->heap_delta_total += heap_delta;
+
+    // Halve the whole histogram when a bucket saturates (keeps the distribution's shape)
+    if (stats->buckets[bucket] == UINT16_MAX)
+    {
+        for (int i = 0; i < SYSMON_PROFILE_BUCKETS; i++)
+        {
+            stats->buckets[i] /= 2U;
+        }
+    }
+    stats->buckets[bucket]++;
+    portEXIT_CRITICAL(&s_profile_lock);
+}
+#endif
+
+// ============================================================================
+// Public API Functions
+// ============================================================================
+
+/**
+ * @brief Mark the start of a phase.
+ *
+ * @param mark Output: start time and free heap.
+ */
+void _profile_begin(sysmon_profile_mark_t *mark)
+{
+#if CONFIG_SYSMON_SELF_PROFILE
+    mark->free_bytes = esp_get_free_heap_size();
+    mark->start_us   = esp_timer_get_time();
+#else
+    (void)mark;
+#endif
+}
+
+/**
+ * @brief Record a phase that started at mark.
+ *
+ * @param phase Phase.
+ * @param mark Start of the phase (from _profile_begin()).
+ */
+void _profile_end(sysmon_profile_phase_t phase, const sysmon_profile_mark_t *mark)
+{
+#if CONFIG_SYSMON_SELF_PROFILE
+    int64_t now_us = esp_timer_get_time();
+    int32_t heap_delta = (int32_t)(mark->free_bytes - esp_get_free_heap_size());
+    _profile_add(phase, now_us - mark->start_us, heap_delta, now_us);
+#else
+    (void)phase;
+    (void)mark;
+#endif
+}
+
+/**
+ * @brief Record an HTTP response split into build and send time.
+ *
+ * @param build_phase Build phase of the endpoint (its send phase follows it).
+ * @param mark Start of the response (from _profile_begin()).
+ * @param send_us Part of the response time spent sending.
+ */
+void _profile_end_response(sysmon_profile_phase_t build_phase, const sysmon_profile_mark_t *mark, int64_t send_us)
+{
+#if CONFIG_SYSMON_SELF_PROFILE
+    int64_t now_us = esp_timer_get_time();
+    int32_t heap_delta = (int32_t)(mark->free_bytes - esp_get_free_heap_size());
+    int64_t total_us = now_us - mark->start_us;
+    if (send_us > total_us)
+    {
+        send_us = total_us;
+    }
+    _profile_add(build_phase, total_us - send_us, heap_delta, now_us);
+    _profile_add((sysmon_profile_phase_t)(build_phase + 1), send_us, 0, now_us);
+#else
+    (void)build_phase;
+    (void)mark;
+    (void)send_us;
+#endif
+}
+
+/**
+ * @brief Copy the statistics of a phase.
+ *
+ * @param phase Phase.
+ * @param out Output statistics.
+ * @return true on success, false if profiling is disabled or phase is invalid.
+ */
+bool _profile_read(sysmon_profile_phase_t phase, sysmon_profile_stats_t *out)
+{
+#if CONFIG_SYSMON_SELF_PROFILE
+    if ((unsigned)phase >= SYSMON_PROFILE_PHASE_COUNT)
+    {
+        return false;
+    }
+    portENTER_CRITICAL(&s_profile_lock);
+    *out = s_stats[phase];
+    portEXIT_CRITICAL(&s_profile_lock);
+    return true;
+#else
+    (void)phase;
+    (void)out;
+    return false;
+#endif
+}
+
+/**
+ * @brief Time of the first recorded phase.
+ *
+ * @return esp_timer_get_time() of the first record, 0 if nothing was recorded yet.
+ */
+int64_t _profile_started_us(void)
+{
+#if CONFIG_SYSMON_SELF_PROFILE
+    portENTER_CRITICAL(&s_profile_lock);
+    int64_t started_us = s_started_us;
+    portEXIT_CRITICAL(&s_profile_lock);
+    return started_us;
+#else
+    return 0;
+#endif
+}
+
+/**
+ * @brief Estimate a duration percentile from a phase histogram.
+ *
+ * @param stats Phase statistics.
+ * @param per_mille Percentile in thousandths (e.g. 990 for p99).
+ * @return Upper bound of the bucket holding the percentile, capped at max_us (0 without calls).
+ */
+uint32_t _profile_percentile_us(const sysmon_profile_stats_t *stats, uint32_t per_mille)
+{
+    uint32_t total = 0U;
+    for (int i = 0; i < SYSMON_PROFILE_BUCKETS; i++)
+    {
+        total += stats->buckets[i];
+    }
+    if (total == 0U)
+    {
+        return 0U;
+    }
+
+    // Rank of the percentile, rounded up (1-based)
+    uint32_t rank = (uint32_t)(((uint64_t)total * per_mille + 999U) / 1000U);
+    if (rank == 0U)
+    {
+        rank = 1U;
+    }
+    uint32_t seen = 0U;
+    for (int i = 0; i < SYSMON_PROFILE_BUCKETS; i++)
+    {
+        seen += stats->buckets[i];
+        if (seen >= rank)
+        {
+            uint32_t upper_us = _profile_bucket_upper_us(i);
+            return (upper_us < stats->max_us) ? upper_us : stats->max_us;
+        }
+    }
+    return stats->max_us;
+}
+
+/**
+ * @brief JSON location of a phase.
+ *
+ * @param phase Phase.
+ * @param group Output: URI of the endpoint, or NULL for sampler phases.
+ * @return Key of the phase within its group.
+ */
+const char *_profile_phase_name(sysmon_profile_phase_t phase, const char **group)
+{
+    if ((unsigned)phase >= SYSMON_PROFILE_PHASE_COUNT)
+    {
+        *group = NULL;
+        return "unknown";
+    }
+    *group = s_phase_info[phase].group;
+    return s_phase_info[phase].name;
+}
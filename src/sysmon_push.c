@@ -0,0 +1,326 @@
+/**
+ * @file sysmon_push.c
+ * @brief Live telemetry push to WebSocket subscribers.
+ *
+ * This file implements the /telemetry/ws endpoint described in sysmon_push.h.
+ * The subscriber list is only touched from the HTTP server task (the WebSocket
+ * handler and the queued send work both run there); the sampler only reads
+ * the subscriber count and hands over one frame at a time through s_frame_busy.
+ */
+
+// Project-specific includes
+#include "sysmon_push.h"
+#include "sysmon_json.h"
+#include "sysmon_json_stream.h"
+#include "sysmon_profile.h"
+#include "sysmon.h"
+
+// ESP-IDF includes
+#include "esp_log.h"
+#include "esp_http_server.h"
+
+// System includes
+#include <stdbool.h>
+#include <stdlib.h>
+#include <string.h>
+
+#ifdef CONFIG_HTTPD_WS_SUPPORT
+
+// Logger tag for this module
+static const char *LOG_TAG = "sysmon_push";
+
+// Frame buffer grows by doubling from the initial size up to the limit
+#define PUSH_FRAME_INITIAL_SIZE 2048U
+#define PUSH_FRAME_MAX_SIZE     32768U
+
+// Largest client message accepted (clients are not expected to send anything)
+#define PUSH_MAX_RX_FRAME 128U
+
+// Subscriber sockets (HTTP server task only, except the count)
+static int s_clients[CONFIG_SYSMON_PUSH_MAX_CLIENTS];
+static int s_client_count = 0;
+
+// Serialized frame, owned by the sampler while s_frame_busy is false and by the send work while true
+static char *s_frame           = NULL;
+static size_t s_frame_capacity = 0;
+static size_t s_frame_length   = 0;
+static bool s_frame_busy       = false;
+
+// Server the pending send work was queued on
+static httpd_handle_t s_server = NULL;
+
+// ============================================================================
+// Internal Helper Functions
+// ============================================================================
+
+/**
+ * @brief Add a subscriber socket (HTTP server task only).
+ *
+ * @param fd Socket descriptor of the WebSocket connection.
+ * @return true if the socket is subscribed, false if the subscriber list is full.
+ */
+static bool _add_client(int fd)
+{
+    for (int i = 0; i < s_client_count; i++)
+    {
+        if (s_clients[i] == fd)
+        {
+            return true;
+        }
+    }
+
+    if (s_client_count >= CONFIG_SYSMON_PUSH_MAX_CLIENTS)
+    {
+        return false;
+    }
+
+    s_clients[s_client_count] = fd;
+    __atomic_store_n(&s_client_count, s_client_count + 1, __ATOMIC_RELAXED);
+    return true;
+}
+
+/**
+ * @brief Remove the subscriber at a list position (HTTP server task only).
+ *
+ * @param index Position in s_clients.
+ */
+static void _remove_client(int index)
+{
+    int last = s_client_count - 1;
+    s_clients[index] = s_clients[last];
+    __atomic_store_n(&s_client_count, last, __ATOMIC_RELAXED);
+}
+
+/**
+ * @brief Send the pending frame to every subscriber (queued on the HTTP server task).
+ *
+ * @param arg Unused.
+ *
+ * Subscribers whose socket is closed, reused for plain HTTP, or failing to
+ * send are dropped; the browser reconnects on its own.
+ */
+static void _push_send_work(void *arg)
+{
+    (void)arg;
+
+    sysmon_profile_mark_t mark;
+    _profile_begin(&mark);
+    httpd_ws_frame_t frame =
+    {
+        .final   = true,
+        .type    = HTTPD_WS_TYPE_TEXT,
+        .payload = (uint8_t *)s_frame,
+        .len     = s_frame_length
+    };
+
+    for (int i = s_client_count - 1; i >= 0; i--)
+    {
+        int fd = s_clients[i];
+        if (httpd_ws_get_fd_info(s_server, fd) != HTTPD_WS_CLIENT_WEBSOCKET)
+        {
+            _remove_client(i);
+            continue;
+        }
+
+        esp_err_t err = httpd_ws_send_frame_async(s_server, fd, &frame);
+        if (err != ESP_OK)
+        {
+            ESP_LOGW(LOG_TAG, "Dropping subscriber fd %d: %s (0x%x)", fd, esp_err_to_name(err), err);
+            _remove_client(i);
+            httpd_sess_trigger_close(s_server, fd);
+        }
+    }
+
+    // Hand the frame buffer back to the sampler
+    __atomic_store_n(&s_frame_busy, false, __ATOMIC_RELEASE);
+    _profile_end(SYSMON_PROFILE_PUSH_SEND, &mark);
+}
+
+/**
+ * @brief Serialize the latest sample into the frame buffer (sampler task only).
+ *
+ * @return true if s_frame holds a complete frame.
+ *
+ * The buffer starts at PUSH_FRAME_INITIAL_SIZE and doubles whenever the
+ * telemetry document does not fit, up to PUSH_FRAME_MAX_SIZE.
+ */
+static bool _build_frame(void)
+{
+    for (;;)
+    {
+        if (s_frame == NULL || s_frame_capacity == 0)
+        {
+            s_frame = (char *)malloc(PUSH_FRAME_INITIAL_SIZE);
+            if (s_frame == NULL)
+            {
+                ESP_LOGE(LOG_TAG, "Failed to allocate %u byte frame buffer", PUSH_FRAME_INITIAL_SIZE);
+                return false;
+            }
+            s_frame_capacity = PUSH_FRAME_INITIAL_SIZE;
+        }
+
+        json_stream_t stream;
+        json_stream_init_memory(&stream, s_frame, s_frame_capacity);
+        esp_err_t err = _write_telemetry_json(&stream);
+        if (err == ESP_OK)
+        {
+            s_frame_length = stream.length;
+            return true;
+        }
+
+        // Only a document overflow (not a failed scratch allocation) is fixed by growing
+        if (stream.error != ESP_ERR_NO_MEM || s_frame_capacity >= PUSH_FRAME_MAX_SIZE)
+        {
+            ESP_LOGW(LOG_TAG, "Failed to serialize telemetry frame: %s (0x%x)", esp_err_to_name(err), err);
+            return false;
+        }
+
+        char *grown = (char *)realloc(s_frame, s_frame_capacity * 2U);
+        if (grown == NULL)
+        {
+            ESP_LOGE(LOG_TAG, "Failed to grow frame buffer to %u bytes", (unsigned)(s_frame_capacity * 2U));
+            return false;
+        }
+        s_frame = grown;
+        s_frame_capacity *= 2U;
+    }
+}
+
+/**
+ * @brief Handle the telemetry WebSocket.
+ *
+ * @param request HTTP request (the handshake, or an incoming data frame).
+ * @return ESP_OK to keep the connection open, or an error to close it.
+ */
+static esp_err_t _push_handle_ws(httpd_req_t *request)
+{
+    int fd = httpd_req_to_sockfd(request);
+
+    // Handshake completed: subscribe the socket
+    if (request->method == HTTP_GET)
+    {
+        if (!_add_client(fd))
+        {
+            ESP_LOGW(LOG_TAG, "Subscriber limit (%d) reached, closing fd %d", CONFIG_SYSMON_PUSH_MAX_CLIENTS, fd);
+            return ESP_FAIL;
+        }
+        ESP_LOGI(LOG_TAG, "Subscriber fd %d connected (%d total)", fd, s_client_count);
+        return ESP_OK;
+    }
+
+    // Data frame: clients are not expected to send anything; drain and ignore it
+    httpd_ws_frame_t frame;
+    memset(&frame, 0, sizeof(frame));
+    esp_err_t err = httpd_ws_recv_frame(request, &frame, 0);
+    if (err != ESP_OK || frame.len > PUSH_MAX_RX_FRAME)
+    {
+        return (err != ESP_OK) ? err : ESP_ERR_INVALID_SIZE;
+    }
+    if (frame.len > 0)
+    {
+        uint8_t payload[PUSH_MAX_RX_FRAME];
+        frame.payload = payload;
+        err = httpd_ws_recv_frame(request, &frame, frame.len);
+    }
+    return err;
+}
+
+#endif  // CONFIG_HTTPD_WS_SUPPORT
+
+// ============================================================================
+// Public API Functions
+// ============================================================================
+
+/**
+ * @brief Register the telemetry WebSocket handler.
+ *
+ * @param server Running HTTP server.
+ * @return ESP_OK on success (or if WebSocket support is disabled), error code otherwise.
+ */
+esp_err_t _push_register(httpd_handle_t server)
+{
+#ifdef CONFIG_HTTPD_WS_SUPPORT
+    httpd_uri_t uri_config =
+    {
+        .uri          = SYSMON_PUSH_URI,
+        .method       = HTTP_GET,
+        .handler      = _push_handle_ws,
+        .user_ctx     = NULL,
+        .is_websocket = true
+    };
+
+    esp_err_t err = httpd_register_uri_handler(server, &uri_config);
+    if (err != ESP_OK)
+    {
+        ESP_LOGE(LOG_TAG, "Failed to register %s handler: %s", SYSMON_PUSH_URI, esp_err_to_name(err));
+    }
+    return err;
+#else
+    (void)server;
+    return ESP_OK;
+#endif
+}
+
+/**
+ * @brief Number of URI handlers _push_register() adds (for httpd_config_t.max_uri_handlers).
+ *
+ * @return 1 with WebSocket support, 0 otherwise.
+ */
+size_t _push_handler_count(void)
+{
+#ifdef CONFIG_HTTPD_WS_SUPPORT
+    return 1;
+#else
+    return 0;
+#endif
+}
+
+/**
+ * @brief Send the sample just published to all subscribers (sampler task only).
+ */
+void _push_publish(void)
+{
+#ifdef CONFIG_HTTPD_WS_SUPPORT
+    httpd_handle_t server = self.httpd;
+    if (server == NULL || __atomic_load_n(&s_client_count, __ATOMIC_RELAXED) == 0)
+    {
+        return;
+    }
+
+    // Previous frame still being sent: skip this sample rather than wait
+    if (__atomic_load_n(&s_frame_busy, __ATOMIC_ACQUIRE))
+    {
+        return;
+    }
+
+    if (!_build_frame())
+    {
+        return;
+    }
+
+    s_server = server;
+    __atomic_store_n(&s_frame_busy, true, __ATOMIC_RELEASE);
+    esp_err_t err = httpd_queue_work(server, _push_send_work, NULL);
+    if (err != ESP_OK)
+    {
+        ESP_LOGW(LOG_TAG, "httpd_queue_work() failed: %s (0x%x)", esp_err_to_name(err), err);
+        __atomic_store_n(&s_frame_busy, false, __ATOMIC_RELEASE);
+    }
+#endif
+}
+
+/**
+ * @brief Forget all subscribers and free the frame buffer (after httpd_stop()).
+ */
+void _push_cleanup(void)
+{
+#ifdef CONFIG_HTTPD_WS_SUPPORT
+    __atomic_store_n(&s_client_count, 0, __ATOMIC_RELAXED);
+    free(s_frame);
+    s_frame          = NULL;
+    s_frame_capacity = 0;
+    s_frame_length   = 0;
+    s_server         = NULL;
+    __atomic_store_n(&s_frame_busy, false, __ATOMIC_RELEASE);
+#endif
+}
@@ -0,0 +1,301 @@
+/**
+ * @file sysmon_rollup.c
+ * @brief Downsampled (min/avg/max) history tiers for long lookback.
+ *
+ * This file implements the cascading rollup rings described in sysmon_rollup.h.
+ * Open buckets are kept as float min/max/sum accumulators; closed buckets are
+ * stored in fixed point (hundredths of a percent, whole bytes) to save memory.
+ */
+
+// Project-specific includes
+#include "sysmon_rollup.h"
+#include "sysmon_snapshot.h"
+#include "sysmon.h"
+
+// System includes
+#include <math.h>
+#include <stdbool.h>
+#include <stdint.h>
+
+// ============================================================================
+// Internal Helper Functions
+// ============================================================================
+
+/**
+ * @brief Add one input to an open bucket.
+ *
+ * @param acc Accumulator of the open bucket.
+ * @param first true for the first input of the bucket (resets the accumulator).
+ * @param min Minimum of the input.
+ * @param max Maximum of the input.
+ * @param value Value added to the sum (the sample, or the average of a lower-tier bucket).
+ */
+static void _accumulate(RollupAccumulator *acc, bool first, float min, float max, float value)
+{
+    if (first)
+    {
+        acc->min = min;
+        acc->max = max;
+        acc->sum = value;
+        return;
+    }
+    acc->min = fminf(acc->min, min);
+    acc->max = fmaxf(acc->max, max);
+    acc->sum += value;
+}
+
+/**
+ * @brief Convert a percentage to hundredths of a percent, saturating.
+ *
+ * @param percent Percentage.
+ * @return Fixed-point value.
+ */
+static uint16_t _percent_to_fixed(float percent)
+{
+    if (!(percent > 0.0f))
+    {
+        return 0U;
+    }
+    float scaled = percent * 100.0f + 0.5f;
+    return (scaled >= (float)UINT16_MAX) ? UINT16_MAX : (uint16_t)scaled;
+}
+
+/**
+ * @brief Convert a byte count accumulator value to an integer, saturating.
+ *
+ * @param bytes Byte count.
+ * @return Rounded byte count.
+ */
+static uint32_t _bytes_to_fixed(float bytes)
+{
+    if (!(bytes > 0.0f))
+    {
+        return 0U;
+    }
+    float rounded = bytes + 0.5f;
+    return (rounded >= 4294967040.0f) ? UINT32_MAX : (uint32_t)rounded;
+}
+
+/**
+ * @brief Turn an accumulator into a closed percentage bucket.
+ *
+ * @param acc Accumulator of the bucket.
+ * @param inputs Number of inputs of the bucket.
+ * @return Closed bucket.
+ */
+static RollupPercentBucket _close_percent(const RollupAccumulator *acc, uint32_t inputs)
+{
+    RollupPercentBucket bucket =
+    {
+        .min = _percent_to_fixed(acc->min),
+        .avg = _percent_to_fixed(acc->sum / (float)inputs),
+        .max = _percent_to_fixed(acc->max)
+    };
+    return bucket;
+}
+
+/**
+ * @brief Turn an accumulator into a closed byte count bucket.
+ *
+ * @param acc Accumulator of the bucket.
+ * @param inputs Number of inputs of the bucket.
+ * @return Closed bucket.
+ */
+static RollupBytesBucket _close_bytes(const RollupAccumulator *acc, uint32_t inputs)
+{
+    RollupBytesBucket bucket =
+    {
+        .min = _bytes_to_fixed(acc->min),
+        .avg = _bytes_to_fixed(acc->sum / (float)inputs),
+        .max = _bytes_to_fixed(acc->max)
+    };
+    return bucket;
+}
+
+/**
+ * @brief Close bucket number n of a tier for one task and feed it into the next tier.
+ *
+ * The bucket is closed over the inputs the task actually contributed, which are
+ * fewer than the tier's bucket size if the task appeared mid-bucket.
+ *
+ * @param rollup Rollup state of the task.
+ * @param tier Tier of the bucket.
+ * @param number Bucket number (1-based).
+ */
+static void _close_task_bucket(TaskRollup *rollup, int tier, uint32_t number)
+{
+    uint32_t inputs = rollup->acc_inputs[tier];
+    if (inputs == 0U)
+    {
+        return;
+    }
+    int index = (int)((number - 1U) % CONFIG_SYSMON_ROLLUP_DEPTH);
+
+    RollupPercentBucket cpu = _close_percent(&rollup->cpu_acc[tier], inputs);
+    rollup->cpu[tier][index]       = cpu;
+    rollup->stack_max[tier][index] = rollup->stack_max_acc[tier];
+    rollup->acc_inputs[tier]       = 0U;
+
+    if (tier + 1 < SYSMON_ROLLUP_TIERS)
+    {
+        const RollupAccumulator *acc = &rollup->cpu_acc[tier];
+        bool next_first = (rollup->acc_inputs[tier + 1] == 0U);
+        _accumulate(&rollup->cpu_acc[tier + 1], next_first, acc->min, acc->max, acc->sum / (float)inputs);
+        if (next_first || rollup->stack_max_acc[tier] > rollup->stack_max_acc[tier + 1])
+        {
+            rollup->stack_max_acc[tier + 1] = rollup->stack_max_acc[tier];
+        }
+        rollup->acc_inputs[tier + 1]++;
+    }
+}
+
+/**
+ * @brief Close bucket number n of a tier for the system-wide series and feed it into the next tier.
+ *
+ * @param tier Tier of the bucket.
+ * @param number Bucket number (1-based).
+ * @param next_first true if the bucket is the first input of the next tier's open bucket.
+ */
+static void _close_system_bucket(int tier, uint32_t number, bool next_first)
+{
+    SysMonRollup *rollup = &self.rollup;
+    uint32_t inputs = (tier == 0) ? SYSMON_ROLLUP_TIER0_SAMPLES : SYSMON_ROLLUP_TIER1_BUCKETS;
+    int index = (int)((number - 1U) % CONFIG_SYSMON_ROLLUP_DEPTH);
+
+    for (int s = 0; s < SYSMON_ROLLUP_PERCENT_SERIES; s++)
+    {
+        const RollupAccumulator *acc = &rollup->percent_acc[tier][s];
+        rollup->percent[tier][s][index] = _close_percent(acc, inputs);
+        if (tier + 1 < SYSMON_ROLLUP_TIERS)
+        {
+            _accumulate(&rollup->percent_acc[tier + 1][s], next_first, acc->min, acc->max, acc->sum / (float)inputs);
+        }
+    }
+
+    for (int s = 0; s < SYSMON_ROLLUP_BYTES_SERIES; s++)
+    {
+        const RollupAccumulator *acc = &rollup->bytes_acc[tier][s];
+        rollup->bytes[tier][s][index] = _close_bytes(acc, inputs);
+        if (tier + 1 < SYSMON_ROLLUP_TIERS)
+        {
+            _accumulate(&rollup->bytes_acc[tier + 1][s], next_first, acc->min, acc->max, acc->sum / (float)inputs);
+        }
+    }
+}
+
+/**
+ * @brief Close one tier's bucket for every active task and the system-wide series.
+ *
+ * @param tier Tier of the bucket.
+ * @param number Bucket number (1-based).
+ */
+static void _close_tier(int tier, uint32_t number)
+{
+    // First input of the next tier's bucket if this bucket starts a new group
+    bool next_first = ((number - 1U) % SYSMON_ROLLUP_TIER1_BUCKETS) == 0U;
+
+    for (int i = 0; i < self.task_capacity; i++)
+    {
+        if (self.tasks[i].is_active)
+        {
+            _close_task_bucket(self.tasks[i].rollup, tier, number);
+        }
+    }
+    _close_system_bucket(tier, number, next_first);
+}
+
+// ============================================================================
+// Public API Functions
+// ============================================================================
+
+/**
+ * @brief Add the current sample of one task to its open tier 0 bucket.
+ *
+ * @param rollup Rollup state of the task.
+ * @param cpu_percent CPU usage of the task in this sample.
+ * @param stack_used_bytes Stack usage of the task in this sample (0 if unregistered).
+ */
+void _rollup_feed_task(TaskRollup *rollup, float cpu_percent, uint32_t stack_used_bytes)
+{
+    // Counted per task: a slot bound mid-bucket starts its bucket with its own first sample
+    bool first = (rollup->acc_inputs[0] == 0U);
+
+    _accumulate(&rollup->cpu_acc[0], first, cpu_percent, cpu_percent, cpu_percent);
+    if (first || stack_used_bytes > rollup->stack_max_acc[0])
+    {
+        rollup->stack_max_acc[0] = stack_used_bytes;
+    }
+    rollup->acc_inputs[0]++;
+}
+
+/**
+ * @brief Add the current system-wide sample to the open tier 0 buckets.
+ *
+ * @param percent Values of the percentage series (indexed by sysmon_rollup_percent_t).
+ * @param bytes Values of the byte count series (indexed by sysmon_rollup_bytes_t).
+ */
+void _rollup_feed_system(const float percent[SYSMON_ROLLUP_PERCENT_SERIES],
+                         const uint32_t bytes[SYSMON_ROLLUP_BYTES_SERIES])
+{
+    bool first = ((_snapshot_write_sequence() - 1U) % SYSMON_ROLLUP_TIER0_SAMPLES) == 0U;
+
+    for (int s = 0; s < SYSMON_ROLLUP_PERCENT_SERIES; s++)
+    {
+        _accumulate(&self.rollup.percent_acc[0][s], first, percent[s], percent[s], percent[s]);
+    }
+    for (int s = 0; s < SYSMON_ROLLUP_BYTES_SERIES; s++)
+    {
+        float value = (float)bytes[s];
+        _accumulate(&self.rollup.bytes_acc[0][s], first, value, value, value);
+    }
+}
+
+/**
+ * @brief Close the buckets that end with the current sample and cascade them into the next tier.
+ */
+void _rollup_end_sample(void)
+{
+    uint32_t sequence = _snapshot_write_sequence();
+    if (sequence % SYSMON_ROLLUP_TIER0_SAMPLES != 0U)
+    {
+        return;
+    }
+
+    uint32_t tier0_number = sequence / SYSMON_ROLLUP_TIER0_SAMPLES;
+    _close_tier(0, tier0_number);
+
+    if (tier0_number % SYSMON_ROLLUP_TIER1_BUCKETS == 0U)
+    {
+        _close_tier(1, tier0_number / SYSMON_ROLLUP_TIER1_BUCKETS);
+    }
+}
+
+/**
+ * @brief Number of samples summarized by one bucket of a tier.
+ *
+ * @param tier Tier index (0 .. SYSMON_ROLLUP_TIERS - 1).
+ * @return Samples per bucket.
+ */
+uint32_t _rollup_samples_per_bucket(int tier)
+{
+    return (tier == 0) ? SYSMON_ROLLUP_TIER0_SAMPLES
+                       : SYSMON_ROLLUP_TIER0_SAMPLES * SYSMON_ROLLUP_TIER1_BUCKETS;
+}
+
+/**
+ * @brief Find the tier whose buckets span a given duration.
+ *
+ * @param bucket_ms Bucket duration in milliseconds.
+ * @return Tier index, or -1 if no tier matches.
+ */
+int _rollup_tier_for_bucket_ms(uint32_t bucket_ms)
+{
+    for (int tier = 0; tier < SYSMON_ROLLUP_TIERS; tier++)
+    {
+        if (_rollup_samples_per_bucket(tier) * CONFIG_SYSMON_CPU_SAMPLING_INTERVAL_MS == bucket_ms)
+        {
+            return tier;
+        }
+    }
+    return -1;
+}
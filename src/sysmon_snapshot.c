@@ -0,0 +1,638 @@
+/**
+ * @file sysmon_snapshot.c
+ * @brief Lock-free publication of sampler state to HTTP readers.
+ *
+ * This module implements the sequence lock around each sample and the
+ * reader-pinned lifetime of the task array (see sysmon_snapshot.h).
+ */
+
+// Project-specific includes
+#include "sysmon_snapshot.h"
+#include "sysmon.h"
+
+// ESP-IDF includes
+#include "esp_log.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+
+// System includes
+#include <stdlib.h>
+#include <string.h>
+
+// Logger tag for this module
+static const char *LOG_TAG = "sysmon_snapshot";
+
+// Busy retries before a reader yields to let a preempted sampler finish its sample
+#define SNAPSHOT_SPIN_LIMIT 16
+
+// Guards the task array pointer, the reader counts and the retired array
+static portMUX_TYPE s_snapshot_lock = portMUX_INITIALIZER_UNLOCKED;
+
+/**
+ * @brief Begin a sequence-locked read.
+ *
+ * @param attempt Number of attempts made so far (used to back off).
+ * @return Even sequence value observed before the read.
+ */
+static uint32_t _read_begin(int attempt)
+{
+    for (;;)
+    {
+        if (attempt >= SNAPSHOT_SPIN_LIMIT)
+        {
+            vTaskDelay(1);
+        }
+        uint32_t seq = __atomic_load_n(&self.sample_seq, __ATOMIC_ACQUIRE);
+        if ((seq & 1U) == 0U)
+        {
+            return seq;
+        }
+        attempt++;
+    }
+}
+
+/**
+ * @brief Check whether a sequence-locked read must be retried.
+ *
+ * @param seq Sequence value returned by _read_begin().
+ * @return true if the sampler published or started a sample during the read.
+ */
+static bool _read_retry(uint32_t seq)
+{
+    __atomic_thread_fence(__ATOMIC_ACQUIRE);
+    return __atomic_load_n(&self.sample_seq, __ATOMIC_RELAXED) != seq;
+}
+
+/**
+ * @brief Copy a window of consecutive samples out of a ring (inside a sequence-locked read).
+ *
+ * @param ring Ring buffer (self.history_depth elements).
+ * @param element_size Size of one element in bytes.
+ * @param write_index Ring write index at the sample being read (index of the oldest element).
+ * @param newest Sequence number of the sample being read.
+ * @param first Sequence number of the first sample to copy (<= newest).
+ * @param count Number of samples to copy.
+ * @param out Output buffer (count * element_size bytes).
+ * @return Number of leading samples already overwritten (not copied).
+ */
+static int _copy_window(const uint8_t *ring, size_t element_size, int write_index, uint32_t newest,
+                        uint32_t first, int count, uint8_t *out)
+{
+    int missing = 0;
+    for (int k = 0; k < count; k++)
+    {
+        uint32_t age = newest - (first + (uint32_t)k);
+        if (age >= (uint32_t)self.history_depth)
+        {
+            missing = k + 1;
+            continue;
+        }
+        int index = (write_index - 1 - (int)age + 2 * self.history_depth) % self.history_depth;
+        memcpy(out + (size_t)k * element_size, ring + (size_t)index * element_size, element_size);
+    }
+    return missing;
+}
+
+/**
+ * @brief Mark the start of a sample update (sampler task only).
+ */
+void _snapshot_write_begin(void)
+{
+    uint32_t seq = __atomic_load_n(&self.sample_seq, __ATOMIC_RELAXED);
+    __atomic_store_n(&self.sample_seq, seq + 1U, __ATOMIC_RELAXED);
+    __atomic_thread_fence(__ATOMIC_RELEASE);
+}
+
+/**
+ * @brief Publish the sample written since _snapshot_write_begin() (sampler task only).
+ */
+void _snapshot_write_end(void)
+{
+    uint32_t seq = __atomic_load_n(&self.sample_seq, __ATOMIC_RELAXED);
+    __atomic_store_n(&self.sample_seq, seq + 1U, __ATOMIC_RELEASE);
+}
+
+/**
+ * @brief Get the sequence number the sample being written will be published under (sampler task only).
+ *
+ * @return Sequence number of the current sample (valid between write begin and end).
+ */
+uint32_t _snapshot_write_sequence(void)
+{
+    return (__atomic_load_n(&self.sample_seq, __ATOMIC_RELAXED) + 1U) >> 1;
+}
+
+/**
+ * @brief Replace the task array with a larger one (sampler task only).
+ *
+ * @param new_tasks New task array (ownership is transferred).
+ * @param new_capacity Number of slots in new_tasks.
+ * @return true if the array was replaced, false if a previously retired array
+ *         is still pinned by a reader (caller keeps ownership of new_tasks).
+ */
+bool _snapshot_replace_tasks(TaskUsageSample *new_tasks, int new_capacity)
+{
+    TaskUsageSample *to_free = NULL;
+
+    portENTER_CRITICAL(&s_snapshot_lock);
+    if (self.retired_tasks != NULL)
+    {
+        // Only one array can be retired at a time; try again next sample
+        portEXIT_CRITICAL(&s_snapshot_lock);
+        return false;
+    }
+
+    if (self.tasks != NULL && self.reader_count > 0)
+    {
+        // The current readers move with the array; later views pin the new one
+        self.retired_tasks   = self.tasks;
+        self.retired_readers = self.reader_count;
+        self.reader_count    = 0;
+    }
+    else
+    {
+        to_free = self.tasks;
+    }
+    self.tasks         = new_tasks;
+    self.task_capacity = new_capacity;
+    portEXIT_CRITICAL(&s_snapshot_lock);
+
+    free(to_free);
+    return true;
+}
+
+/**
+ * @brief Free the task array and any retired array (called during sysmon_deinit).
+ */
+void _snapshot_cleanup(void)
+{
+    portENTER_CRITICAL(&s_snapshot_lock);
+    TaskUsageSample *tasks   = self.tasks;
+    TaskUsageSample *retired = self.retired_tasks;
+    if (self.reader_count + self.retired_readers > 0)
+    {
+        ESP_LOGW(LOG_TAG, "Cleanup with %d active readers", self.reader_count + self.retired_readers);
+    }
+    self.tasks           = NULL;
+    self.retired_tasks   = NULL;
+    self.retired_readers = 0;
+    self.task_capacity   = 0;
+    portEXIT_CRITICAL(&s_snapshot_lock);
+
+    free(tasks);
+    free(retired);
+}
+
+/**
+ * @brief Pin the current task array for reading.
+ *
+ * @param view Output view; must be released with _snapshot_release_view().
+ */
+void _snapshot_acquire_view(sysmon_view_t *view)
+{
+    portENTER_CRITICAL(&s_snapshot_lock);
+    self.reader_count++;
+    view->tasks         = self.tasks;
+    view->task_capacity = (self.tasks != NULL) ? self.task_capacity : 0;
+    view->depth         = self.history_depth;
+    portEXIT_CRITICAL(&s_snapshot_lock);
+}
+
+/**
+ * @brief Release a view obtained from _snapshot_acquire_view().
+ *
+ * @param view View to release (cleared on return).
+ */
+void _snapshot_release_view(sysmon_view_t *view)
+{
+    TaskUsageSample *to_free = NULL;
+
+    portENTER_CRITICAL(&s_snapshot_lock);
+    if (view->tasks != NULL && view->tasks == self.retired_tasks)
+    {
+        self.retired_readers--;
+        if (self.retired_readers == 0)
+        {
+            to_free = self.retired_tasks;
+            self.retired_tasks = NULL;
+        }
+    }
+    else if (self.reader_count > 0)
+    {
+        self.reader_count--;
+    }
+    portEXIT_CRITICAL(&s_snapshot_lock);
+
+    free(to_free);
+    view->tasks         = NULL;
+    view->task_capacity = 0;
+    view->depth         = 0;
+}
+
+/**
+ * @brief Get the sequence number of the latest published sample.
+ *
+ * @return Number of samples published since boot (0 before the first sample).
+ */
+uint32_t _snapshot_read_sequence(void)
+{
+    // Odd while a sample is being written; dropping bit 0 yields the last published sample
+    return __atomic_load_n(&self.sample_seq, __ATOMIC_ACQUIRE) >> 1;
+}
+
+/**
+ * @brief Allocate a reader-owned task copy for _snapshot_read_task().
+ *
+ * @param parts SNAPSHOT_COPY_* flags.
+ * @return Task copy (release with free()), or NULL on allocation failure.
+ */
+TaskUsageSample *_snapshot_alloc_task(uint32_t parts)
+{
+    size_t cpu_bytes = (size_t)self.history_depth * sizeof(sysmon_cpu_sample_t);
+    size_t stack_bytes = (size_t)self.history_depth * sizeof(sysmon_stack_sample_t);
+    size_t heap_bytes = CONFIG_SYSMON_TASK_HEAP_ACCOUNTING ? (size_t)self.history_depth * sizeof(uint32_t) : 0U;
+    size_t size = sizeof(TaskUsageSample);
+    if (parts & SNAPSHOT_COPY_HISTORY)
+    {
+        size += cpu_bytes + stack_bytes + heap_bytes;
+    }
+    if (parts & SNAPSHOT_COPY_ROLLUP)
+    {
+        size += sizeof(TaskRollup);
+    }
+
+    TaskUsageSample *task = (TaskUsageSample *)malloc(size);
+    if (task == NULL)
+    {
+        return NULL;
+    }
+    memset(task, 0, sizeof(TaskUsageSample));
+
+    // Buffers follow the struct: rollup, heap and stack columns (4-byte aligned) before the CPU column
+    uint8_t *buffer = (uint8_t *)(task + 1);
+    if (parts & SNAPSHOT_COPY_ROLLUP)
+    {
+        task->rollup = (TaskRollup *)(void *)buffer;
+        buffer += sizeof(TaskRollup);
+    }
+    if (parts & SNAPSHOT_COPY_HISTORY)
+    {
+        if (heap_bytes > 0U)
+        {
+            task->heap_live_history = (uint32_t *)(void *)buffer;
+            buffer += heap_bytes;
+        }
+        task->stack_usage_bytes_history = (sysmon_stack_sample_t *)(void *)buffer;
+        task->usage_percent_history     = (sysmon_cpu_sample_t *)(void *)(buffer + stack_bytes);
+    }
+    return task;
+}
+
+/**
+ * @brief Get a slot of the current task array for a reader holding a view.
+ *
+ * A retired array is no longer written: its metadata (write index, identity,
+ * latest values) is frozen while its history columns, shared with the current
+ * array, keep moving. Readers therefore always read the slot of the current
+ * array. The view keeps it alive too: while a retired array is pinned, the
+ * current one cannot be replaced, and it is never smaller than the view's.
+ *
+ * @param view Pinned view.
+ * @param index Slot index (0 .. view->task_capacity - 1).
+ * @return Slot, or NULL if the index is out of range.
+ */
+static const TaskUsageSample *_current_slot(const sysmon_view_t *view, int index)
+{
+    if (view->tasks == NULL || index < 0 || index >= view->task_capacity)
+    {
+        return NULL;
+    }
+
+    const TaskUsageSample *src = NULL;
+    portENTER_CRITICAL(&s_snapshot_lock);
+    if (self.tasks != NULL && index < self.task_capacity)
+    {
+        src = &self.tasks[index];
+    }
+    portEXIT_CRITICAL(&s_snapshot_lock);
+    return src;
+}
+
+/**
+ * @brief Copy one task slot as of a single published sample.
+ *
+ * Copies the metadata, plus the history columns and rollup tiers for which
+ * out has buffers (see _snapshot_alloc_task()).
+ *
+ * @param view Pinned view.
+ * @param index Slot index (0 .. view->task_capacity - 1).
+ * @param out Output copy of the slot (from _snapshot_alloc_task()).
+ * @param sequence Output: sequence number of the newest sample in the copy (may be NULL).
+ * @return true if the slot holds an active task, false otherwise.
+ */
+bool _snapshot_read_task(const sysmon_view_t *view, int index, TaskUsageSample *out, uint32_t *sequence)
+{
+    const TaskUsageSample *src = _current_slot(view, index);
+    if (src == NULL)
+    {
+        return false;
+    }
+
+    // The copy keeps its own buffers; the slot's pointers lead into the history arena
+    sysmon_cpu_sample_t *usage_history   = out->usage_percent_history;
+    sysmon_stack_sample_t *stack_history = out->stack_usage_bytes_history;
+    uint32_t *heap_history               = out->heap_live_history;
+    TaskRollup *rollup                   = out->rollup;
+
+    // Metadata and history columns come from the same slot within one sequence-locked read
+    for (int attempt = 0;; attempt++)
+    {
+        uint32_t seq = _read_begin(attempt);
+        memcpy(out, src, sizeof(TaskUsageSample));
+        if (out->is_active && usage_history != NULL && out->usage_percent_history != NULL)
+        {
+            memcpy(usage_history, out->usage_percent_history, (size_t)view->depth * sizeof(sysmon_cpu_sample_t));
+            memcpy(stack_history, out->stack_usage_bytes_history, (size_t)view->depth * sizeof(sysmon_stack_sample_t));
+        }
+        if (out->is_active && heap_history != NULL && out->heap_live_history != NULL)
+        {
+            memcpy(heap_history, out->heap_live_history, (size_t)view->depth * sizeof(uint32_t));
+        }
+        if (out->is_active && rollup != NULL && out->rollup != NULL)
+        {
+            memcpy(rollup, out->rollup, sizeof(TaskRollup));
+        }
+        if (!_read_retry(seq))
+        {
+            if (sequence != NULL)
+            {
+                *sequence = seq >> 1;
+            }
+            break;
+        }
+    }
+
+    out->usage_percent_history     = usage_history;
+    out->stack_usage_bytes_history = stack_history;
+    out->heap_live_history         = heap_history;
+    out->rollup                    = rollup;
+    return out->is_active;
+}
+
+/**
+ * @brief Copy only the name of one task slot, to decide whether to copy the whole slot.
+ *
+ * @param view Pinned view.
+ * @param index Slot index (0 .. view->task_capacity - 1).
+ * @param name Output: task name (at least sizeof(TaskUsageSample.task_name) bytes).
+ * @param name_ordinal Output: duplicate ordinal of the name (see _get_task_display_key()).
+ * @return true if the slot holds an active task, false otherwise.
+ */
+bool _snapshot_read_task_name(const sysmon_view_t *view, int index, char *name, uint8_t *name_ordinal)
+{
+    const TaskUsageSample *src = _current_slot(view, index);
+    if (src == NULL)
+    {
+        return false;
+    }
+
+    bool is_active = false;
+    for (int attempt = 0;; attempt++)
+    {
+        uint32_t seq = _read_begin(attempt);
+        memcpy(name, src->task_name, sizeof(src->task_name));
+        *name_ordinal = src->name_ordinal;
+        is_active     = src->is_active;
+        if (!_read_retry(seq))
+        {
+            break;
+        }
+    }
+    name[sizeof(src->task_name) - 1] = '\0';
+    return is_active;
+}
+
+/**
+ * @brief Copy the most recent published system-wide sample.
+ *
+ * @param out Output sample.
+ */
+void _snapshot_read_series(SysMonSeriesSample *out)
+{
+    for (int attempt = 0;; attempt++)
+    {
+        uint32_t seq = _read_begin(attempt);
+
+        int read_index = (self.series_write_index - 1 + self.history_depth) % self.history_depth;
+        out->cpu_overall_percent = self.cpu_overall_percent[read_index];
+        for (int core = 0; core < SYSMON_CORE_COUNT; core++)
+        {
+            out->cpu_core_percent[core] = self.cpu_core_percent[core][read_index];
+            out->isr_core_percent[core] = (self.isr_core_percent[core] != NULL)
+                                          ? self.isr_core_percent[core][read_index] : 0.0f;
+        }
+        out->dram_free           = self.dram_free[read_index];
+        out->dram_min_free       = self.dram_min_free[read_index];
+        out->dram_largest_block  = self.dram_largest_block[read_index];
+        out->dram_total          = self.dram_total[read_index];
+        out->dram_used_percent   = self.dram_used_percent[read_index];
+        out->dram_frag_percent   = self.dram_frag_percent[read_index];
+        out->psram_free          = self.psram_free[read_index];
+        out->psram_total         = self.psram_total[read_index];
+        out->psram_used_percent  = self.psram_used_percent[read_index];
+        out->psram_seen          = self.psram_seen;
+        out->timestamp_us        = self.sample_time_us[read_index];
+        out->jitter_us           = self.sample_jitter_us[read_index];
+        out->jitter_max_us       = self.sample_jitter_max_us;
+        out->overruns            = self.sample_overruns;
+        out->skipped             = self.sample_skipped;
+        out->stack_scan_age      = self.stack_scan_age;
+        for (int core = 0; core < SYSMON_CORE_COUNT; core++)
+        {
+            out->core_switches[core] = self.core_switches[core];
+        }
+        out->sched_interval_us   = self.sched_interval_us;
+        out->sequence            = seq >> 1;
+
+        if (!_read_retry(seq))
+        {
+            break;
+        }
+    }
+}
+
+/**
+ * @brief Copy one system-wide ring buffer (e.g. self.dram_free) as of a single published sample.
+ *
+ * @param ring Ring buffer of self (self.history_depth elements).
+ * @param element_size Size of one element in bytes.
+ * @param out Output buffer (self.history_depth * element_size bytes).
+ * @param write_index Output: ring write index at that sample (index of the oldest element).
+ * @param sequence Output: sequence number of the newest element (may be NULL).
+ */
+void _snapshot_read_ring(const void *ring, size_t element_size, void *out, int *write_index, uint32_t *sequence)
+{
+    for (int attempt = 0;; attempt++)
+    {
+        uint32_t seq = _read_begin(attempt);
+        memcpy(out, ring, element_size * (size_t)self.history_depth);
+        *write_index = self.series_write_index;
+        if (!_read_retry(seq))
+        {
+            if (sequence != NULL)
+            {
+                *sequence = seq >> 1;
+            }
+            break;
+        }
+    }
+}
+
+/**
+ * @brief Copy the newest samples of several system-wide ring buffers as of a single published sample.
+ *
+ * @param rings Ring buffers of self (self.history_depth elements each; NULL ones are copied as zeros).
+ * @param ring_count Number of rings.
+ * @param element_size Size of one element in bytes (the same for every ring).
+ * @param count Number of newest samples to copy per ring (at most the samples published so far
+ *              and self.history_depth).
+ * @param out Output buffer (ring_count * count elements): ring after ring, oldest sample first.
+ * @param sequence Output: sequence number of the newest sample copied.
+ */
+void _snapshot_read_rings(const void *const rings[], int ring_count, size_t element_size, int count,
+                          void *out, uint32_t *sequence)
+{
+    size_t column_bytes = (size_t)count * element_size;
+    for (int attempt = 0;; attempt++)
+    {
+        uint32_t seq = _read_begin(attempt);
+        uint8_t *column = (uint8_t *)out;
+        for (int r = 0; r < ring_count; r++, column += column_bytes)
+        {
+            if (rings[r] == NULL)
+            {
+                memset(column, 0, column_bytes);
+                continue;
+            }
+            _copy_window((const uint8_t *)rings[r], element_size, self.series_write_index, seq >> 1,
+                         (seq >> 1) - (uint32_t)count + 1U, count, column);
+        }
+        if (!_read_retry(seq))
+        {
+            *sequence = seq >> 1;
+            break;
+        }
+    }
+}
+
+/**
+ * @brief Copy samples first .. first + count - 1 of a system-wide ring buffer as of a single published sample.
+ *
+ * @param ring Ring buffer of self (self.history_depth elements, may be NULL).
+ * @param element_size Size of one element in bytes.
+ * @param first Sequence number of the first sample (at most the latest published one).
+ * @param count Number of samples, up to the latest published one.
+ * @param out Output buffer (count * element_size bytes), oldest sample first.
+ * @return Number of leading samples no longer held by the ring (count if ring is NULL).
+ */
+int _snapshot_read_ring_window(const void *ring, size_t element_size, uint32_t first, int count, void *out)
+{
+    if (ring == NULL)
+    {
+        return count;
+    }
+
+    int missing = 0;
+    for (int attempt = 0;; attempt++)
+    {
+        uint32_t seq = _read_begin(attempt);
+        missing = _copy_window((const uint8_t *)ring, element_size, self.series_write_index, seq >> 1,
+                               first, count, (uint8_t *)out);
+        if (!_read_retry(seq))
+        {
+            break;
+        }
+    }
+    return missing;
+}
+
+/**
+ * @brief Copy samples first .. first + count - 1 of one task's history column as of a single published sample.
+ *
+ * @param view Pinned view (keeps the arrays alive).
+ * @param index Slot index (0 .. view->task_capacity - 1).
+ * @param task_id Task the slot must hold (TaskUsageSample.task_id of an earlier copy).
+ * @param column Column to copy.
+ * @param first Sequence number of the first sample (at most the latest published one).
+ * @param count Number of samples, up to the latest published one.
+ * @param out Output buffer (count elements of the column's type), oldest sample first.
+ * @return Number of leading samples no longer held (count if the slot holds another
+ *         task or has no such column).
+ */
+int _snapshot_read_task_window(const sysmon_view_t *view, int index, UBaseType_t task_id,
+                               sysmon_snapshot_column_t column, uint32_t first, int count, void *out)
+{
+    const TaskUsageSample *src = _current_slot(view, index);
+    if (src == NULL)
+    {
+        return count;
+    }
+
+    int missing = count;
+    for (int attempt = 0;; attempt++)
+    {
+        uint32_t seq = _read_begin(attempt);
+        const uint8_t *ring = NULL;
+        size_t element_size = 0U;
+        switch (column)
+        {
+            case SNAPSHOT_COLUMN_CPU:
+                ring         = (const uint8_t *)src->usage_percent_history;
+                element_size = sizeof(sysmon_cpu_sample_t);
+                break;
+            case SNAPSHOT_COLUMN_STACK:
+                ring         = (const uint8_t *)src->stack_usage_bytes_history;
+                element_size = sizeof(sysmon_stack_sample_t);
+                break;
+            default:
+                ring         = (const uint8_t *)src->heap_live_history;
+                element_size = sizeof(uint32_t);
+                break;
+        }
+        missing = count;
+        if (src->is_active && src->task_id == task_id && ring != NULL)
+        {
+            missing = _copy_window(ring, element_size, src->write_index, seq >> 1, first, count, (uint8_t *)out);
+        }
+        if (!_read_retry(seq))
+        {
+            break;
+        }
+    }
+    return missing;
+}
+
+/**
+ * @brief Copy a block of sampler state (e.g. one rollup ring) as of a single published sample.
+ *
+ * @param source Memory inside self.
+ * @param size Number of bytes to copy.
+ * @param out Output buffer (size bytes).
+ * @param sequence Output: sequence number of the sample the copy belongs to (may be NULL).
+ */
+void _snapshot_read_block(const void *source, size_t size, void *out, uint32_t *sequence)
+{
+    for (int attempt = 0;; attempt++)
+    {
+        uint32_t seq = _read_begin(attempt);
+        memcpy(out, source, size);
+        if (!_read_retry(seq))
+        {
+            if (sequence != NULL)
+            {
+                *sequence = seq >> 1;
+            }
+            break;
+        }
+    }
+}
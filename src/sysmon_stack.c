@@ -4,11 +4,16 @@
  *
  * This module manages stack size registration for tasks to enable accurate
  * stack usage percentage calculations in the sysmon monitoring system.
+ * The sampler caches each task's registered size in its slot (looked up when
+ * the task is bound and after new registrations) and drops the registration
+ * once the task is gone, so the registry does not grow with task churn and a
+ * new task reusing a freed TCB address does not inherit the old stack size.
  */
 
 // Project-specific includes
 #include "sysmon_stack.h"
 #include "sysmon.h"
+#include "sysmon_index.h"
 
 // ESP-IDF includes
 #include "esp_log.h"
@@ -22,17 +27,13 @@
 // Logger tag for this module
 static const char *LOG_TAG = "sysmon_stack";
 
-typedef struct
-{
-    TaskHandle_t handle;
-    uint32_t     depth_bytes;
-    bool         is_valid;
-} TaskStackRecord;
-
-static TaskStackRecord *s_stack_records = NULL;
-static int s_stack_records_capacity = 0;
+// Registered stack sizes, keyed by task handle (value is the stack depth in bytes)
+static sysmon_index_t s_stack_index = { 0 };
 static portMUX_TYPE s_stack_records_lock = portMUX_INITIALIZER_UNLOCKED;
 
+// Number of registrations so far (under s_stack_records_lock), see _stack_generation()
+static uint32_t s_stack_generation = 0;
+
 /**
  * @brief Register a task's stack size for accurate monitoring.
  *
@@ -66,63 +67,58 @@ void sysmon_stack_register(TaskHandle_t task_handle, uint32_t stack_size_bytes)
         task_name = "unknown";
     }
 
-    // Store or update the stack record
-    portENTER_CRITICAL(&s_stack_records_lock);
-    
     // Determine required capacity (use task_capacity if set, otherwise use a reasonable initial size)
-    int required_capacity = (self.task_capacity > 0) ? self.task_capacity : 32;
-    
-    // Ensure capacity matches task capacity (grow if needed)
-    if (s_stack_records_capacity < required_capacity)
+    portENTER_CRITICAL(&s_stack_records_lock);
+    uint32_t required_items = s_stack_index.count + 1U;
+    bool needs_grow = _index_needs_grow(&s_stack_index, required_items);
+    portEXIT_CRITICAL(&s_stack_records_lock);
+
+    // Allocate outside the critical section; the heap must not be used with interrupts disabled
+    sysmon_index_entry_t *spare_entries = NULL;
+    uint32_t new_capacity = 0U;
+    if (needs_grow)
     {
-        int new_capacity = required_capacity;
-        TaskStackRecord *new_records = (TaskStackRecord *)calloc(new_capacity, sizeof(TaskStackRecord));
-        if (new_records == NULL)
+        uint32_t initial_items = (self.task_capacity > 0) ? (uint32_t)self.task_capacity : 32U;
+        new_capacity  = _index_capacity_for((required_items > initial_items) ? required_items : initial_items);
+        spare_entries = (sysmon_index_entry_t *)calloc(new_capacity, sizeof(sysmon_index_entry_t));
+        if (spare_entries == NULL)
         {
-            portEXIT_CRITICAL(&s_stack_records_lock);
-            ESP_LOGE(LOG_TAG, "Failed to allocate stack records (capacity: %d)", new_capacity);
+            ESP_LOGE(LOG_TAG, "Failed to allocate stack records (capacity: %lu)", (unsigned long)new_capacity);
             return;
         }
-        
-        // Copy existing records
-        if (s_stack_records != NULL)
-        {
-            memcpy(new_records, s_stack_records, s_stack_records_capacity * sizeof(TaskStackRecord));
-            free(s_stack_records);
-        }
-        
-        s_stack_records = new_records;
-        s_stack_records_capacity = new_capacity;
     }
-    
-    // Update existing record
-    for (int i = 0; i < s_stack_records_capacity; i++)
+
+    // Store or update the stack record
+    portENTER_CRITICAL(&s_stack_records_lock);
+    if (spare_entries != NULL && new_capacity > s_stack_index.capacity)
     {
-        if (s_stack_records[i].is_valid && s_stack_records[i].handle == task_handle)
-        {
-            s_stack_records[i].depth_bytes = stack_size_bytes;
-            portEXIT_CRITICAL(&s_stack_records_lock);
-            ESP_LOGI(LOG_TAG, "Updated stack size for task '%s': %lu bytes", 
-                     task_name, (unsigned long)stack_size_bytes);
-            return;
-        }
+        // Swap in the larger table; the old one is freed below
+        spare_entries = _index_rehash(&s_stack_index, spare_entries, new_capacity);
     }
-
-    // Create new record
-    for (int i = 0; i < s_stack_records_capacity; i++)
+    bool was_registered = _index_find(&s_stack_index, task_handle, NULL);
+    bool stored = _index_insert(&s_stack_index, task_handle, stack_size_bytes);
+    if (stored)
     {
-        if (!s_stack_records[i].is_valid)
-        {
-            s_stack_records[i].handle      = task_handle;
-            s_stack_records[i].depth_bytes = stack_size_bytes;
-            s_stack_records[i].is_valid    = true;
-            break;
-        }
+        s_stack_generation++;
     }
-    
     portEXIT_CRITICAL(&s_stack_records_lock);
-    ESP_LOGI(LOG_TAG, "Registered stack size for task '%s': %lu bytes", 
-             task_name, (unsigned long)stack_size_bytes);
+
+    free(spare_entries);
+
+    if (!stored)
+    {
+        ESP_LOGE(LOG_TAG, "Stack records full, cannot register task '%s'", task_name);
+    }
+    else if (was_registered)
+    {
+        ESP_LOGI(LOG_TAG, "Updated stack size for task '%s': %lu bytes", 
+                 task_name, (unsigned long)stack_size_bytes);
+    }
+    else
+    {
+        ESP_LOGI(LOG_TAG, "Registered stack size for task '%s': %lu bytes", 
+                 task_name, (unsigned long)stack_size_bytes);
+    }
 }
 
 /**
@@ -139,37 +135,62 @@ bool sysmon_stack_get_size(TaskHandle_t task_handle, uint32_t *stack_size_bytes)
         return false;
     }
 
+    uint32_t depth_bytes = 0U;
     portENTER_CRITICAL(&s_stack_records_lock);
-    if (s_stack_records != NULL)
-    {
-        for (int i = 0; i < s_stack_records_capacity; i++)
-        {
-            if (s_stack_records[i].is_valid && s_stack_records[i].handle == task_handle)
-            {
-                *stack_size_bytes = s_stack_records[i].depth_bytes;
-                portEXIT_CRITICAL(&s_stack_records_lock);
-                return true;
-            }
-        }
-    }
+    bool found = _index_find(&s_stack_index, task_handle, &depth_bytes);
     portEXIT_CRITICAL(&s_stack_records_lock);
     
-    *stack_size_bytes = 0;
-    return false;
+    *stack_size_bytes = found ? depth_bytes : 0U;
+    return found;
 }
 
 /**
- * @brief Clean up stack records (called during sysmon_deinit).
+ * @brief Get the number of stack registrations so far (sampler task only).
+ *
+ * @return Registration count (wraps).
  */
-void sysmon_stack_cleanup(void)
+uint32_t _stack_generation(void)
 {
     portENTER_CRITICAL(&s_stack_records_lock);
-    if (s_stack_records != NULL)
+    uint32_t generation = s_stack_generation;
+    portEXIT_CRITICAL(&s_stack_records_lock);
+    return generation;
+}
+
+/**
+ * @brief Drop the registration of a task that no longer exists (sampler task only).
+ *
+ * @param task_handle Handle the deleted task had.
+ * @param generation _stack_generation() read before the last scan that still saw the task.
+ * @return true if the handle has no registration left, false if it was kept because
+ *         a registration happened since (possibly of a new task at the same address).
+ */
+bool _stack_forget(TaskHandle_t task_handle, uint32_t generation)
+{
+    if (task_handle == NULL)
     {
-        free(s_stack_records);
-        s_stack_records = NULL;
-        s_stack_records_capacity = 0;
+        return true;
+    }
+
+    portENTER_CRITICAL(&s_stack_records_lock);
+    bool unchanged = (s_stack_generation == generation);
+    if (unchanged)
+    {
+        _index_remove(&s_stack_index, task_handle);
     }
     portEXIT_CRITICAL(&s_stack_records_lock);
+    return unchanged;
 }
 
+/**
+ * @brief Clean up stack records (called during sysmon_deinit).
+ */
+void sysmon_stack_cleanup(void)
+{
+    portENTER_CRITICAL(&s_stack_records_lock);
+    sysmon_index_entry_t *entries = _index_release(&s_stack_index);
+    s_stack_generation = 0;
+    portEXIT_CRITICAL(&s_stack_records_lock);
+
+    free(entries);
+}
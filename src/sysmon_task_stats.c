@@ -0,0 +1,149 @@
+/**
+ * @file sysmon_task_stats.c
+ * @brief Lifetime per-task CPU percentiles and stack minimum.
+ *
+ * This file implements the per-task histograms described in sysmon_task_stats.h.
+ * Buckets 0..19 are 0.5 % wide (0 to 10 %), buckets 20.. are 2.5 % wide.
+ */
+
+// Project-specific includes
+#include "sysmon_task_stats.h"
+#include "sysmon.h"
+
+// System includes
+#include <stdint.h>
+
+// Fine buckets cover 0 % .. SYSMON_TASK_STATS_FINE_LIMIT
+#define SYSMON_TASK_STATS_FINE_WIDTH    0.5f
+#define SYSMON_TASK_STATS_FINE_LIMIT    10.0f
+#define SYSMON_TASK_STATS_FINE_BUCKETS  20
+#define SYSMON_TASK_STATS_COARSE_WIDTH  2.5f
+
+// ============================================================================
+// Internal Helper Functions
+// ============================================================================
+
+/**
+ * @brief Histogram bucket of a CPU usage.
+ *
+ * @param cpu_percent CPU usage (%).
+ * @return Bucket index (usage beyond the last bucket saturates into it).
+ */
+static int _task_stats_bucket(float cpu_percent)
+{
+    if (!(cpu_percent > 0.0f))
+    {
+        return 0;
+    }
+    int index;
+    if (cpu_percent < SYSMON_TASK_STATS_FINE_LIMIT)
+    {
+        index = (int)(cpu_percent / SYSMON_TASK_STATS_FINE_WIDTH);
+    }
+    else
+    {
+        index = SYSMON_TASK_STATS_FINE_BUCKETS +
+                (int)((cpu_percent - SYSMON_TASK_STATS_FINE_LIMIT) / SYSMON_TASK_STATS_COARSE_WIDTH);
+    }
+    return (index < SYSMON_TASK_STATS_BUCKETS) ? index : (SYSMON_TASK_STATS_BUCKETS - 1);
+}
+
+/**
+ * @brief Largest CPU usage that falls into a histogram bucket.
+ *
+ * @param index Bucket index.
+ * @return Upper bound of the bucket (%).
+ */
+static float _task_stats_bucket_upper(int index)
+{
+    if (index < SYSMON_TASK_STATS_FINE_BUCKETS)
+    {
+        return (float)(index + 1) * SYSMON_TASK_STATS_FINE_WIDTH;
+    }
+    return SYSMON_TASK_STATS_FINE_LIMIT +
+           (float)(index - SYSMON_TASK_STATS_FINE_BUCKETS + 1) * SYSMON_TASK_STATS_COARSE_WIDTH;
+}
+
+// ============================================================================
+// Public API Functions
+// ============================================================================
+
+/**
+ * @brief Add the current sample of one task (sampler task only).
+ *
+ * @param stats Statistics of the task entry.
+ * @param cpu_percent CPU usage of the task in this sample.
+ * @param stack_free_bytes Stack high water mark of the task in bytes.
+ */
+void _task_stats_feed(TaskStats *stats, float cpu_percent, uint32_t stack_free_bytes)
+{
+    if (stats->samples == 0U)
+    {
+        stats->cpu_max        = cpu_percent;
+        stats->stack_min_free = stack_free_bytes;
+    }
+    else
+    {
+        if (cpu_percent > stats->cpu_max)
+        {
+            stats->cpu_max = cpu_percent;
+        }
+        if (stack_free_bytes < stats->stack_min_free)
+        {
+            stats->stack_min_free = stack_free_bytes;
+        }
+    }
+    if (stats->samples < UINT32_MAX)
+    {
+        stats->samples++;
+    }
+
+    // Halve the whole histogram when a bucket saturates (keeps the distribution's shape)
+    int bucket = _task_stats_bucket(cpu_percent);
+    if (stats->cpu_buckets[bucket] == UINT16_MAX)
+    {
+        for (int i = 0; i < SYSMON_TASK_STATS_BUCKETS; i++)
+        {
+            stats->cpu_buckets[i] /= 2U;
+        }
+    }
+    stats->cpu_buckets[bucket]++;
+}
+
+/**
+ * @brief Estimate a CPU usage percentile from a task's histogram.
+ *
+ * @param stats Statistics of the task entry.
+ * @param per_mille Percentile in thousandths (e.g. 990 for p99).
+ * @return Upper bound of the bucket holding the percentile, capped at cpu_max (0 without samples).
+ */
+float _task_stats_cpu_percentile(const TaskStats *stats, uint32_t per_mille)
+{
+    uint32_t total = 0U;
+    for (int i = 0; i < SYSMON_TASK_STATS_BUCKETS; i++)
+    {
+        total += stats->cpu_buckets[i];
+    }
+    if (total == 0U)
+    {
+        return 0.0f;
+    }
+
+    // Rank of the percentile, rounded up (1-based)
+    uint32_t rank = (uint32_t)(((uint64_t)total * per_mille + 999U) / 1000U);
+    if (rank == 0U)
+    {
+        rank = 1U;
+    }
+    uint32_t seen = 0U;
+    for (int i = 0; i < SYSMON_TASK_STATS_BUCKETS; i++)
+    {
+        seen += stats->cpu_buckets[i];
+        if (seen >= rank)
+        {
+            float upper = _task_stats_bucket_upper(i);
+            return (upper < stats->cpu_max) ? upper : stats->cpu_max;
+        }
+    }
+    return stats->cpu_max;
+}
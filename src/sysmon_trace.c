@@ -0,0 +1,494 @@
+/**
+ * @file sysmon_trace.c
+ * @brief Per-core task run time and core migrations from FreeRTOS trace hooks.
+ *
+ * This file implements the trace table described in sysmon_trace.h. The hook
+ * functions run inside the scheduler on every context switch, so they live in
+ * IRAM, touch only the static table and never block.
+ */
+
+// Project-specific includes
+#include "sysmon_trace.h"
+#include "sysmon_trace_hooks.h"
+#include "sysmon.h"
+
+// ESP-IDF includes
+#include "esp_attr.h"
+#include "esp_timer.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+
+// System includes
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+
+#if CONFIG_SYSMON_TRACE_HOOKS
+
+// Table size: twice the tracked task count keeps probe chains short
+#define TRACE_TABLE_SIZE (2U * CONFIG_SYSMON_TRACE_MAX_TASKS)
+
+// Key markers besides real TCB addresses (TCBs are word aligned, never 1 or 2)
+#define TRACE_KEY_FREED    ((void *)1)   // Released by a deleted task; probing continues past it
+#define TRACE_KEY_CLAIMING ((void *)2)   // Being initialized by a switch-in hook
+
+/**
+ * @brief Trace counters of one task.
+ *
+ * Members:
+ * - tcb        : Key (TCB address), NULL if never used, or a TRACE_KEY_* marker.
+ * - run_time   : Cumulative run time per core (run time counter units, wraps).
+ * - migrations : Number of switch-ins on a different core than the previous one.
+ * - last_core  : Core of the latest switch-in (-1 before the first).
+ * - ready_at   : esp_timer time (us, truncated, never 0) the task was made ready, 0 if not waiting.
+ * - sched      : Switch-in count and ready-to-run latency statistics (see sysmon_trace_sched_t).
+ */
+typedef struct
+{
+    void *tcb;
+    uint32_t run_time[SYSMON_CORE_COUNT];
+    uint32_t migrations;
+    int32_t last_core;
+#if CONFIG_SYSMON_TRACE_SCHED_STATS
+    uint32_t ready_at;
+    sysmon_trace_sched_t sched;
+#endif
+} TraceEntry;
+
+static TraceEntry s_entries[TRACE_TABLE_SIZE];
+static uint32_t s_switched_in_at[SYSMON_CORE_COUNT];
+static uint32_t s_untracked_switches = 0;
+static uint32_t s_task_generation = 0;
+#if CONFIG_SYSMON_TRACE_SCHED_STATS
+static uint32_t s_core_switches[SYSMON_CORE_COUNT];
+#endif
+
+// ============================================================================
+// Internal Helper Functions
+// ============================================================================
+
+/**
+ * @brief Hash a TCB address to its home entry.
+ *
+ * @param tcb TCB address.
+ * @return Home entry index.
+ */
+static inline IRAM_ATTR uint32_t _trace_slot(const void *tcb)
+{
+    // Same Fibonacci hash as sysmon_index.c
+    uint32_t h = (uint32_t)((uintptr_t)tcb >> 2);
+    h *= 2654435761U;
+    return (h ^ (h >> 16)) % TRACE_TABLE_SIZE;
+}
+
+/**
+ * @brief Find the entry of a task, optionally claiming one for it.
+ *
+ * @param tcb TCB address.
+ * @param insert Claim a free entry if the task has none.
+ * @return Entry, or NULL if not found (or the table is full).
+ *
+ * Only the hooks of the task itself insert its key, and a task is switched on
+ * one core at a time, so a key is never inserted twice; claims of different
+ * keys racing for the same entry are resolved by compare-and-swap.
+ */
+static IRAM_ATTR TraceEntry *_trace_entry(void *tcb, bool insert)
+{
+    uint32_t home = _trace_slot(tcb);
+
+    for (;;)
+    {
+        TraceEntry *candidate = NULL;
+        for (uint32_t i = 0; i < TRACE_TABLE_SIZE; i++)
+        {
+            TraceEntry *entry = &s_entries[(home + i) % TRACE_TABLE_SIZE];
+            void *key = __atomic_load_n(&entry->tcb, __ATOMIC_ACQUIRE);
+            if (key == tcb)
+            {
+                return entry;
+            }
+            if (key == TRACE_KEY_FREED && candidate == NULL)
+            {
+                candidate = entry;
+            }
+            if (key == NULL)
+            {
+                // End of the probe chain
+                if (candidate == NULL)
+                {
+                    candidate = entry;
+                }
+                break;
+            }
+        }
+
+        if (!insert || candidate == NULL)
+        {
+            return NULL;
+        }
+
+        void *expected = __atomic_load_n(&candidate->tcb, __ATOMIC_RELAXED);
+        if ((expected == NULL || expected == TRACE_KEY_FREED) &&
+            __atomic_compare_exchange_n(&candidate->tcb, &expected, TRACE_KEY_CLAIMING,
+                                        false, __ATOMIC_ACQUIRE, __ATOMIC_RELAXED))
+        {
+            memset(candidate->run_time, 0, sizeof(candidate->run_time));
+            candidate->migrations = 0U;
+            candidate->last_core  = -1;
+#if CONFIG_SYSMON_TRACE_SCHED_STATS
+            candidate->ready_at = 0U;
+            memset(&candidate->sched, 0, sizeof(candidate->sched));
+#endif
+            __atomic_store_n(&candidate->tcb, tcb, __ATOMIC_RELEASE);
+            return candidate;
+        }
+        // Lost the entry to another core's claim; probe again
+    }
+}
+
+#if CONFIG_SYSMON_TRACE_SCHED_STATS
+/**
+ * @brief Histogram bucket of a ready-to-run latency.
+ *
+ * @param latency_us Latency in microseconds.
+ * @return Bucket index: bucket i holds latencies below 8 us * 4^i, the last one the rest.
+ */
+static inline IRAM_ATTR int _trace_latency_bucket(uint32_t latency_us)
+{
+    int index = 0;
+    uint32_t bound = 8U;
+    while (index < SYSMON_TRACE_LATENCY_BUCKETS - 1 && latency_us >= bound)
+    {
+        bound <<= 2;
+        index++;
+    }
+    return index;
+}
+
+/**
+ * @brief Account a switch-in: count it and close the task's ready-to-run wait, if any.
+ *
+ * @param entry Trace entry of the task switched in.
+ */
+static inline IRAM_ATTR void _trace_sched_switched_in(TraceEntry *entry)
+{
+    entry->sched.switches++;
+
+    uint32_t ready_at = __atomic_exchange_n(&entry->ready_at, 0U, __ATOMIC_RELAXED);
+    if (ready_at == 0U)
+    {
+        return;
+    }
+    uint32_t latency_us = (uint32_t)esp_timer_get_time() - ready_at;
+    entry->sched.ready_total_us += latency_us;
+    entry->sched.ready_buckets[_trace_latency_bucket(latency_us)]++;
+    if (latency_us > entry->sched.ready_max_us)
+    {
+        entry->sched.ready_max_us = latency_us;
+    }
+}
+#endif
+
+// ============================================================================
+// Trace Hooks (scheduler context)
+// ============================================================================
+
+/**
+ * @brief Trace hook: a task was switched in on the calling core (scheduler context).
+ *
+ * @param tcb TCB (task handle) of the task switched in.
+ */
+void IRAM_ATTR sysmon_trace_task_switched_in(void *tcb)
+{
+    int core = (int)xPortGetCoreID();
+    s_switched_in_at[core] = (uint32_t)portGET_RUN_TIME_COUNTER_VALUE();
+#if CONFIG_SYSMON_TRACE_SCHED_STATS
+    // Only this core writes its counter
+    __atomic_store_n(&s_core_switches[core], s_core_switches[core] + 1U, __ATOMIC_RELAXED);
+#endif
+
+    TraceEntry *entry = _trace_entry(tcb, true);
+    if (entry == NULL)
+    {
+        __atomic_fetch_add(&s_untracked_switches, 1U, __ATOMIC_RELAXED);
+        return;
+    }
+#if CONFIG_SYSMON_TRACE_SCHED_STATS
+    _trace_sched_switched_in(entry);
+#endif
+
+    if (entry->last_core != core)
+    {
+        if (entry->last_core >= 0)
+        {
+            entry->migrations++;
+        }
+        entry->last_core = core;
+    }
+}
+
+/**
+ * @brief Trace hook: a task is being switched out on the calling core (scheduler context).
+ *
+ * @param tcb TCB (task handle) of the task switched out.
+ */
+void IRAM_ATTR sysmon_trace_task_switched_out(void *tcb)
+{
+    int core = (int)xPortGetCoreID();
+    TraceEntry *entry = _trace_entry(tcb, false);
+    if (entry != NULL)
+    {
+        uint32_t now = (uint32_t)portGET_RUN_TIME_COUNTER_VALUE();
+        entry->run_time[core] += now - s_switched_in_at[core];
+#if CONFIG_SYSMON_TRACE_SCHED_STATS
+        // A ready time recorded while the task ran (not for a wait) must not reach its next switch-in
+        __atomic_store_n(&entry->ready_at, 0U, __ATOMIC_RELAXED);
+#endif
+    }
+}
+
+/**
+ * @brief Trace hook: a task was created.
+ *
+ * @param tcb TCB (task handle) of the new task.
+ */
+void IRAM_ATTR sysmon_trace_task_created(void *tcb)
+{
+    (void)tcb;
+    __atomic_add_fetch(&s_task_generation, 1U, __ATOMIC_RELEASE);
+}
+
+/**
+ * @brief Trace hook: a task is being deleted.
+ *
+ * @param tcb TCB (task handle) of the deleted task.
+ *
+ * Runs before the kernel frees the TCB, so a generation read after it tells the
+ * reader that handles it kept may be stale.
+ */
+void IRAM_ATTR sysmon_trace_task_deleted(void *tcb)
+{
+    __atomic_add_fetch(&s_task_generation, 1U, __ATOMIC_RELEASE);
+    TraceEntry *entry = _trace_entry(tcb, false);
+    if (entry != NULL)
+    {
+        __atomic_store_n(&entry->tcb, TRACE_KEY_FREED, __ATOMIC_RELEASE);
+    }
+}
+
+#if CONFIG_SYSMON_TRACE_SCHED_STATS
+/**
+ * @brief Trace hook: a task was moved to the ready list (scheduler or ISR context, any core).
+ *
+ * @param tcb TCB (task handle) of the task made ready.
+ *
+ * Never claims an entry (only a task's own switch-in does, see _trace_entry()), so a
+ * new task's first wait is not measured. Keeps the earliest ready time if the task
+ * is made ready again before it runs.
+ */
+void IRAM_ATTR sysmon_trace_task_ready(void *tcb)
+{
+    TraceEntry *entry = _trace_entry(tcb, false);
+    if (entry == NULL)
+    {
+        return;
+    }
+    uint32_t now = (uint32_t)esp_timer_get_time();
+    uint32_t expected = 0U;
+    __atomic_compare_exchange_n(&entry->ready_at, &expected, (now != 0U) ? now : 1U,
+                                false, __ATOMIC_RELAXED, __ATOMIC_RELAXED);
+}
+#endif
+
+#endif  // CONFIG_SYSMON_TRACE_HOOKS
+
+// ============================================================================
+// Public API Functions
+// ============================================================================
+
+/**
+ * @brief Read a task's cumulative per-core run time and migration count (sampler task only).
+ *
+ * @param handle Task handle.
+ * @param run_time Output: run time per core, in run time counter units (wraps).
+ * @param migrations Output: number of switch-ins on a different core than the previous one.
+ * @return true if the task is tracked, false if tracing is disabled or the table is full.
+ */
+bool _trace_read_task(TaskHandle_t handle, uint32_t run_time[SYSMON_CORE_COUNT], uint32_t *migrations)
+{
+#if CONFIG_SYSMON_TRACE_HOOKS
+    TraceEntry *entry = _trace_entry((void *)handle, false);
+    if (entry == NULL)
+    {
+        return false;
+    }
+    for (int core = 0; core < SYSMON_CORE_COUNT; core++)
+    {
+        run_time[core] = __atomic_load_n(&entry->run_time[core], __ATOMIC_RELAXED);
+    }
+    *migrations = __atomic_load_n(&entry->migrations, __ATOMIC_RELAXED);
+    return true;
+#else
+    (void)handle;
+    (void)run_time;
+    (void)migrations;
+    return false;
+#endif
+}
+
+/**
+ * @brief Number of switch-ins of tasks that found the trace table full.
+ *
+ * @return Untracked switch-in count since boot (0 if tracing is disabled).
+ */
+uint32_t _trace_untracked_switches(void)
+{
+#if CONFIG_SYSMON_TRACE_HOOKS
+    return __atomic_load_n(&s_untracked_switches, __ATOMIC_RELAXED);
+#else
+    return 0U;
+#endif
+}
+
+/**
+ * @brief Read the task generation counter.
+ *
+ * @param generation Output: number of task creations and deletions since boot (wraps).
+ * @return true on success, false if tracing is disabled.
+ */
+bool _trace_task_generation(uint32_t *generation)
+{
+#if CONFIG_SYSMON_TRACE_HOOKS
+    *generation = __atomic_load_n(&s_task_generation, __ATOMIC_ACQUIRE);
+    return true;
+#else
+    (void)generation;
+    return false;
+#endif
+}
+
+/**
+ * @brief Read the run time counter of a kept task handle if it is still valid.
+ *
+ * @param handle Task handle kept since generation was read.
+ * @param generation Task generation read when the handle was obtained.
+ * @param run_time Output: run time counter of the task.
+ * @return true if read, false if the generation changed or tracing is disabled.
+ */
+bool _trace_task_run_time(TaskHandle_t handle, uint32_t generation, uint32_t *run_time)
+{
+#if CONFIG_SYSMON_TRACE_HOOKS
+    if (__atomic_load_n(&s_task_generation, __ATOMIC_ACQUIRE) != generation)
+    {
+        return false;
+    }
+    uint32_t value = ulTaskGetRunTimeCounter(handle);
+    
+    // A deletion on the other core between the check and the read bumps the generation
+    // before the TCB is freed, so a value read from a freed TCB is caught here
+    __atomic_thread_fence(__ATOMIC_ACQUIRE);
+    if (__atomic_load_n(&s_task_generation, __ATOMIC_RELAXED) != generation)
+    {
+        return false;
+    }
+    *run_time = value;
+    return true;
+#else
+    (void)handle;
+    (void)generation;
+    (void)run_time;
+    return false;
+#endif
+}
+
+/**
+ * @brief Read and reset a task's scheduling counters (sampler task only).
+ *
+ * @param handle Task handle.
+ * @param sched Output: counters of the task; ready_max_us starts over after the read.
+ * @return true if the task is tracked, false if the scheduling statistics are disabled
+ *         or the task is not in the trace table.
+ */
+bool _trace_read_sched(TaskHandle_t handle, sysmon_trace_sched_t *sched)
+{
+#if CONFIG_SYSMON_TRACE_HOOKS && CONFIG_SYSMON_TRACE_SCHED_STATS
+    TraceEntry *entry = _trace_entry((void *)handle, false);
+    if (entry == NULL)
+    {
+        return false;
+    }
+    sched->switches       = __atomic_load_n(&entry->sched.switches, __ATOMIC_RELAXED);
+    sched->ready_total_us = __atomic_load_n(&entry->sched.ready_total_us, __ATOMIC_RELAXED);
+    sched->ready_max_us   = __atomic_exchange_n(&entry->sched.ready_max_us, 0U, __ATOMIC_RELAXED);
+    for (int i = 0; i < SYSMON_TRACE_LATENCY_BUCKETS; i++)
+    {
+        sched->ready_buckets[i] = __atomic_load_n(&entry->sched.ready_buckets[i], __ATOMIC_RELAXED);
+    }
+    return true;
+#else
+    (void)handle;
+    (void)sched;
+    return false;
+#endif
+}
+
+/**
+ * @brief Read the per-core context switch counters.
+ *
+ * @param switches Output: switch-ins per core since boot (wraps).
+ * @return true on success, false if the scheduling statistics are disabled.
+ */
+bool _trace_read_core_switches(uint32_t switches[SYSMON_CORE_COUNT])
+{
+#if CONFIG_SYSMON_TRACE_HOOKS && CONFIG_SYSMON_TRACE_SCHED_STATS
+    for (int core = 0; core < SYSMON_CORE_COUNT; core++)
+    {
+        switches[core] = __atomic_load_n(&s_core_switches[core], __ATOMIC_RELAXED);
+    }
+    return true;
+#else
+    (void)switches;
+    return false;
+#endif
+}
+
+/**
+ * @brief Estimate a ready-to-run latency percentile from a histogram.
+ *
+ * @param buckets Latency histogram (see sysmon_trace_sched_t).
+ * @param max_us Longest latency the histogram holds (bounds the last bucket).
+ * @param per_mille Percentile in thousandths (e.g. 990 for p99).
+ * @return Upper bound of the bucket holding the percentile in microseconds, capped at max_us
+ *         (0 without latencies).
+ */
+uint32_t _trace_latency_percentile_us(const uint32_t buckets[SYSMON_TRACE_LATENCY_BUCKETS], uint32_t max_us,
+                                      uint32_t per_mille)
+{
+    uint64_t total = 0U;
+    for (int i = 0; i < SYSMON_TRACE_LATENCY_BUCKETS; i++)
+    {
+        total += buckets[i];
+    }
+    if (total == 0U)
+    {
+        return 0U;
+    }
+
+    // Rank of the percentile, rounded up (1-based)
+    uint64_t rank = (total * per_mille + 999U) / 1000U;
+    if (rank == 0U)
+    {
+        rank = 1U;
+    }
+    uint64_t seen = 0U;
+    uint32_t upper_us = 8U;
+    for (int i = 0; i < SYSMON_TRACE_LATENCY_BUCKETS - 1; i++, upper_us <<= 2)
+    {
+        seen += buckets[i];
+        if (seen >= rank)
+        {
+            return (upper_us < max_us) ? upper_us : max_us;
+        }
+    }
+    return max_us;
+}
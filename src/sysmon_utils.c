@@ -3,8 +3,8 @@
  * @brief Utility functions for sysmon HTTP module.
  *
  * This file implements utility functions used across the sysmon HTTP
- * subsystem for content type detection, task name formatting, and JSON
- * cleanup operations.
+ * subsystem for content type detection, task name formatting, query
+ * parameter parsing, and JSON cleanup operations.
  */
 
 // Project-specific includes
@@ -17,9 +17,11 @@
 #include "esp_netif.h"
 
 // System includes
+#include <ctype.h>
 #include <stdarg.h>
-#include <string.h>
 #include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
 
 // Logger tag for this module
 static const char *LOG_TAG = "sysmon_utils";
@@ -40,6 +42,26 @@ const char *_get_task_display_name(const char *task_name)
     return task_name;
 }
 
+/**
+ * @brief Get the JSON key for a task, telling apart tasks that share a name.
+ *
+ * @param task_name Original task name.
+ * @param name_ordinal 0 for the first task with this name, 1.. for duplicates.
+ * @param buffer Scratch buffer for the suffixed key.
+ * @param buffer_size Size of the buffer.
+ * @return Display name, or "name#N" (N = name_ordinal + 1) for duplicates.
+ */
+const char *_get_task_display_key(const char *task_name, uint8_t name_ordinal, char *buffer, size_t buffer_size)
+{
+    const char *display_name = _get_task_display_name(task_name);
+    if (name_ordinal == 0 || buffer == NULL || buffer_size == 0)
+    {
+        return display_name;
+    }
+    snprintf(buffer, buffer_size, "%s#%u", display_name, (unsigned)name_ordinal + 1U);
+    return buffer;
+}
+
 /**
  * @brief Determine content type from URI path.
  *
@@ -74,6 +96,175 @@ const char *_get_content_type_from_uri(const char *uri)
     return "application/octet-stream";
 }
 
+/**
+ * @brief Get the value of a URL query parameter.
+ *
+ * @param request HTTP request (may be NULL, e.g. when only sizing a response).
+ * @param key Query parameter name.
+ * @param value Buffer for the NUL-terminated value.
+ * @param value_size Size of the value buffer.
+ * @return true if the parameter is present and fits in the buffer.
+ */
+bool _get_query_param(httpd_req_t *request, const char *key, char *value, size_t value_size)
+{
+    if (request == NULL || value == NULL || value_size == 0)
+    {
+        return false;
+    }
+
+    size_t query_len = httpd_req_get_url_query_len(request);
+    if (query_len == 0)
+    {
+        return false;
+    }
+
+    char *query = (char *)malloc(query_len + 1);
+    if (query == NULL)
+    {
+        ESP_LOGE(LOG_TAG, "Failed to allocate %u bytes for query string", (unsigned)(query_len + 1));
+        return false;
+    }
+
+    bool found = httpd_req_get_url_query_str(request, query, query_len + 1) == ESP_OK &&
+                 httpd_query_key_value(query, key, value, value_size) == ESP_OK;
+    free(query);
+    return found;
+}
+
+/**
+ * @brief Get the URL-decoded value of a query parameter of any length.
+ *
+ * @param request HTTP request (may be NULL).
+ * @param key Query parameter name.
+ * @return Decoded value (release with free()), or NULL if the parameter is absent
+ *         or memory is short. "+" and %XX escapes are decoded.
+ */
+char *_get_query_param_dup(httpd_req_t *request, const char *key)
+{
+    // No value can be longer than the whole query
+    size_t query_len = (request != NULL) ? httpd_req_get_url_query_len(request) : 0U;
+    if (query_len == 0)
+    {
+        return NULL;
+    }
+
+    char *value = (char *)malloc(query_len + 1);
+    if (value == NULL)
+    {
+        ESP_LOGE(LOG_TAG, "Failed to allocate %u bytes for query parameter", (unsigned)(query_len + 1));
+        return NULL;
+    }
+    if (!_get_query_param(request, key, value, query_len + 1))
+    {
+        free(value);
+        return NULL;
+    }
+
+    // Decode in place (the result is never longer)
+    char *out = value;
+    for (const char *in = value; *in != '\0'; in++)
+    {
+        unsigned int byte = 0;
+        if (*in == '+')
+        {
+            *out++ = ' ';
+        }
+        else if (*in == '%' && isxdigit((unsigned char)in[1]) && isxdigit((unsigned char)in[2]) &&
+                 sscanf(in + 1, "%2x", &byte) == 1)
+        {
+            *out++ = (char)byte;
+            in += 2;
+        }
+        else
+        {
+            *out++ = *in;
+        }
+    }
+    *out = '\0';
+    return value;
+}
+
+/**
+ * @brief Get an unsigned decimal URL query parameter.
+ *
+ * @param request HTTP request (may be NULL).
+ * @param key Query parameter name.
+ * @param value Output value (left unchanged if the parameter is absent or invalid).
+ * @return true if the parameter is present and a valid 32-bit unsigned number.
+ */
+bool _get_query_uint(httpd_req_t *request, const char *key, uint32_t *value)
+{
+    char buffer[12];
+    if (!_get_query_param(request, key, buffer, sizeof(buffer)) || buffer[0] < '0' || buffer[0] > '9')
+    {
+        return false;
+    }
+
+    char *end = NULL;
+    unsigned long parsed = strtoul(buffer, &end, 10);
+    if (*end != '\0' || parsed > UINT32_MAX)
+    {
+        return false;
+    }
+
+    *value = (uint32_t)parsed;
+    return true;
+}
+
+/**
+ * @brief Get a duration URL query parameter in milliseconds.
+ *
+ * @param request HTTP request (may be NULL).
+ * @param key Query parameter name.
+ * @param value_ms Output duration (left unchanged if the parameter is absent or invalid).
+ * @return true if the parameter is present and a valid duration.
+ *
+ * Accepts a decimal number with an optional unit: "ms", "s" (default), "m" or "h",
+ * e.g. "500ms", "10s", "10", "1m".
+ */
+bool _get_query_duration_ms(httpd_req_t *request, const char *key, uint32_t *value_ms)
+{
+    char buffer[16];
+    if (!_get_query_param(request, key, buffer, sizeof(buffer)) || buffer[0] < '0' || buffer[0] > '9')
+    {
+        return false;
+    }
+
+    char *unit = NULL;
+    unsigned long parsed = strtoul(buffer, &unit, 10);
+
+    uint64_t scale = 0;
+    if (*unit == '\0' || strcmp(unit, "s") == 0)
+    {
+        scale = 1000U;
+    }
+    else if (strcmp(unit, "ms") == 0)
+    {
+        scale = 1U;
+    }
+    else if (strcmp(unit, "m") == 0)
+    {
+        scale = 60U * 1000U;
+    }
+    else if (strcmp(unit, "h") == 0)
+    {
+        scale = 60U * 60U * 1000U;
+    }
+    else
+    {
+        return false;
+    }
+
+    uint64_t duration = (uint64_t)parsed * scale;
+    if (duration > UINT32_MAX)
+    {
+        return false;
+    }
+
+    *value_ms = (uint32_t)duration;
+    return true;
+}
+
 /**
  * @brief Clean up multiple cJSON objects.
  *
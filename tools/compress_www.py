@@ -0,0 +1,89 @@
+#!/usr/bin/env python3
+"""Pre-compress the sysmon web assets and derive their ETags.
+
+Run by CMakeLists.txt at configure time. For every asset it writes
+<out>/<file name>.gz (gzip level 9, no timestamp, so builds are
+reproducible) and one header, <out>/sysmon_www_etags.h, with a strong
+ETag per asset and encoding:
+
+    SYSMON_WWW_ETAG_<symbol>       identity representation
+    SYSMON_WWW_ETAG_GZIP_<symbol>  gzip representation
+
+<symbol> is the file name mangled the way target_add_binary_data() names
+its symbols (e.g. app.js -> app_js), so STATIC_FILE_ENTRY() can paste it.
+
+--bundle NAME=SRC,SRC,... (repeatable) first concatenates the sources, in
+order and separated by a newline, into <out>/NAME, which is then handled
+like any other asset. The dashboard loads one script and one stylesheet
+this way instead of nine files, each needing its own request and socket.
+"""
+
+import argparse
+import gzip
+import hashlib
+import os
+import re
+import sys
+
+
+def symbol_name(path):
+    return re.sub(r'[^A-Za-z0-9_]', '_', os.path.basename(path))
+
+
+def write_if_changed(path, data):
+    # Leave unchanged outputs alone so their timestamps do not force relinks
+    try:
+        with open(path, 'rb') as f:
+            if f.read() == data:
+                return
+    except OSError:
+        pass
+    with open(path, 'wb') as f:
+        f.write(data)
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    parser.add_argument('--out', required=True, help='output directory')
+    parser.add_argument('--bundle', action='append', default=[], metavar='NAME=SRC,SRC,...',
+                        help='concatenate the sources into <out>/NAME and compress it too')
+    parser.add_argument('assets', nargs='*', help='asset files to compress')
+    args = parser.parse_args()
+
+    os.makedirs(args.out, exist_ok=True)
+    assets = list(args.assets)
+    for bundle in args.bundle:
+        name, sep, sources = bundle.partition('=')
+        if not sep or not name or not sources:
+            parser.error('--bundle expects NAME=SRC,SRC,...: %s' % bundle)
+        parts = []
+        for source in sources.split(','):
+            with open(source, 'rb') as f:
+                parts.append(f.read().rstrip(b'\n'))
+        path = os.path.join(args.out, name)
+        write_if_changed(path, b'\n'.join(parts) + b'\n')
+        assets.append(path)
+    lines = [
+        '// Generated by tools/compress_www.py - do not edit.',
+        '#pragma once',
+        '',
+    ]
+
+    for asset in assets:
+        with open(asset, 'rb') as f:
+            raw = f.read()
+        compressed = gzip.compress(raw, compresslevel=9, mtime=0)
+        write_if_changed(os.path.join(args.out, os.path.basename(asset) + '.gz'), compressed)
+
+        digest = hashlib.sha256(raw).hexdigest()[:16]
+        name = symbol_name(asset)
+        lines.append('#define SYSMON_WWW_ETAG_%s "\\"%s\\""' % (name, digest))
+        lines.append('#define SYSMON_WWW_ETAG_GZIP_%s "\\"%s-gz\\""' % (name, digest))
+        print('%s: %d -> %d bytes gzip' % (asset, len(raw), len(compressed)))
+
+    write_if_changed(os.path.join(args.out, 'sysmon_www_etags.h'), ('\n'.join(lines) + '\n').encode())
+    return 0
+
+
+if __name__ == '__main__':
+    sys.exit(main())
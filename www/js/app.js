@@ -26,7 +26,8 @@ function updateStatusPopup()
     showStatusPopup(STATUS_TYPES.PAUSED);
     return;
   }
-  if (AppState.ui.isHoveringCpu || AppState.ui.isHoveringMemory)
+  if (AppState.ui.isHoveringCpu || AppState.ui.isHoveringMemory || AppState.ui.isHoveringHeap ||
+      AppState.ui.isHoveringLatency)
   {
     showStatusPopup(STATUS_TYPES.CHARTS_HOVER);
     return;
@@ -118,12 +119,13 @@ async function initializeDashboard()
 
   try
   {
-    const response = await fetch(API_ROUTES.HISTORY);
-    if (response.ok)
+    const data = await fetchHistory();
+    if (data)
     {
-      const data = await response.json();
-      createCpuChart(data);
-      createMemoryChart(data); // Only includes registered tasks now
+      seedSeriesFromHistory(data);
+      createCpuChart();
+      createMemoryChart(); // Only includes registered tasks now
+      refreshCharts();     // Also creates the heap chart if the device reports per-task heap
       AppState.status.lastTelemetrySuccess = Date.now();
       AppState.status.consecutiveFailures = 0;
     }
@@ -156,6 +158,7 @@ async function initializeDashboard()
   {
     hideCheckbox.addEventListener('change', () => {
       AppState.filters.hideLowUsage = hideCheckbox.checked;
+      scheduleChartRefresh();
     });
   }
 
@@ -166,6 +169,7 @@ async function initializeDashboard()
       if (Number.isFinite(value))
       {
         AppState.filters.thresholdPercent = value;
+        scheduleChartRefresh();
       }
     });
     // Initialize threshold from input value
@@ -190,77 +194,19 @@ async function initializeDashboard()
       AppState.filters.hideSystemTasks = false;
     }
 
-    hideSystemTasksToggle.addEventListener('change', async () => {
+    // System task samples are kept in the task series while hidden, so toggling only redraws
+    hideSystemTasksToggle.addEventListener('change', () => {
       if (hideSystemTasksToggle.checked)
       {
         taskTable.classList.add('hide-system-tasks');
         AppState.filters.hideSystemTasks = true;
-        // Remove system task datasets from chart when filter is enabled
-        if (AppState.charts.cpu)
-        {
-          AppState.charts.cpu.data.datasets = AppState.charts.cpu.data.datasets.filter(dataset => {
-            const isSystemTask = SYSTEM_TASKS.hasOwnProperty(dataset.label);
-            return !(AppState.filters.hideSystemTasks && isSystemTask);
-          });
-          AppState.charts.cpu.update('none');
-        }
       }
       else
       {
         taskTable.classList.remove('hide-system-tasks');
         AppState.filters.hideSystemTasks = false;
-        // When disabled, fetch history to get system task data and add them to the chart
-        if (AppState.charts.cpu)
-        {
-          try
-          {
-            const response = await fetch(API_ROUTES.HISTORY);
-            if (response.ok)
-            {
-              const historyData = await response.json();
-              // Add system task datasets from history
-              for (const [taskName, taskData] of Object.entries(historyData))
-              {
-                const isSystemTask = SYSTEM_TASKS.hasOwnProperty(taskName);
-                if (isSystemTask)
-                {
-                  // Check if dataset already exists
-                  let dataset = AppState.charts.cpu.data.datasets.find(d => d.label === taskName);
-                  if (!dataset)
-                  {
-                    // Extract CPU history array from task data object
-                    const cpuHistoryArray = taskData && typeof taskData === 'object' && Array.isArray(taskData.cpu)
-                      ? taskData.cpu
-                      : [];
-
-                    // Pad or truncate to match current chart length
-                    const currentLength = AppState.charts.cpu.data.labels.length;
-                    let paddedData = [...cpuHistoryArray];
-                    if (paddedData.length < currentLength)
-                    {
-                      // Pad with zeros at the beginning
-                      paddedData = Array(currentLength - paddedData.length).fill(0).concat(paddedData);
-                    }
-                    else if (paddedData.length > currentLength)
-                    {
-                      // Truncate from the beginning
-                      paddedData = paddedData.slice(-currentLength);
-                    }
-
-                    dataset = createChartDataset(taskName, paddedData);
-                    AppState.charts.cpu.data.datasets.push(dataset);
-                  }
-                }
-              }
-              AppState.charts.cpu.update('none');
-            }
-          }
-          catch (error)
-          {
-            console.warn("Failed to fetch history for system tasks:", error);
-          }
-        }
       }
+      scheduleChartRefresh();
     });
   }
 
@@ -293,8 +239,7 @@ async function initializeDashboard()
         // Immediately update charts with accumulated data when unpausing
         if (AppState.charts.cpu && AppState.charts.memory)
         {
-          AppState.charts.cpu.update('none');
-          AppState.charts.memory.update('none');
+          refreshCharts();
         }
       }
       
@@ -311,9 +256,78 @@ async function initializeDashboard()
     });
   }
 
-  // Keep updating charts, summary, and table
+  // Keep updating charts, summary, and table (telemetry polling pauses while push is connected)
+  connectTelemetryPush();
   setInterval(updateDashboard, CHART_TELEMETRY_UPDATE_INTERVAL_MS);
-  setInterval(updateTable, CHART_TASK_TABLE_UPDATE_INTERVAL_MS);
+  // While polling, the task table arrives with the /bundle poll instead
+  setInterval(() => { if (AppState.push.connected) updateTable(); }, CHART_TASK_TABLE_UPDATE_INTERVAL_MS);
+  updateSelfProfile();
+  setInterval(updateSelfProfile, CHART_TASK_TABLE_UPDATE_INTERVAL_MS);
+}
+
+/**
+ * Push chart points for samples published between two telemetry polls.
+ *
+ * When a poll is late (slow network, background tab) the device may have taken
+ * several samples since the last one charted. Those samples are fetched with
+ * /history?since= and charted in order, so chart time stays in step with the device.
+ * A /bundle poll already carries them, so no extra request is made then.
+ *
+ * @param {number} lastSeq - Sequence number of the last sample charted.
+ * @param {number} seq - Sequence number of the telemetry about to be charted.
+ * @param {Set} currentTaskNames - Set of task names present in current telemetry.
+ * @param {Object} [prefetchedHistory] - /history?since=<lastSeq> document from the same /bundle poll.
+ */
+async function backfillMissedSamples(lastSeq, seq, currentTaskNames, prefetchedHistory)
+{
+  const missed = Math.min(seq - lastSeq - 1, CHART_SAMPLE_COUNT);
+  if (missed <= 0)
+  {
+    return;
+  }
+
+  try
+  {
+    const history = prefetchedHistory || await fetchHistorySince(seq - 1 - missed);
+    if (!history || !history.tasks)
+    {
+      return;
+    }
+
+    for (let n = seq - missed; n < seq; n++)
+    {
+      // Position of sample n in the returned arrays (which start at history.since + 1)
+      const offset = n - history.since - 1;
+      if (offset < 0)
+      {
+        continue;
+      }
+
+      const sampleCurrent = {};
+      for (const taskName of currentTaskNames)
+      {
+        const series = history.tasks[taskName];
+        const cpu    = series && series.cpu ? series.cpu[offset] : null;
+        const entry  = { cpu: typeof cpu === 'number' ? cpu : 0 };
+
+        const info = AppState.data.taskInfo[taskName];
+        if (series && series.stack && info && info.stackSize > 0 && typeof series.stack[offset] === 'number')
+        {
+          entry.stackPct = (series.stack[offset] / info.stackSize) * 100;
+        }
+        if (series && series.heap && typeof series.heap[offset] === 'number')
+        {
+          entry.heap = series.heap[offset];
+        }
+        sampleCurrent[taskName] = entry;
+      }
+      updateCharts(sampleCurrent);
+    }
+  }
+  catch (error)
+  {
+    console.warn("Failed to backfill missed samples:", error);
+  }
 }
 
 /**
@@ -323,18 +337,46 @@ async function initializeDashboard()
  * uses it to update the summary badges, progress bars, and time series chart datasets in the 
  * UI. Handles server communication with timeouts, updates AppState with success or failure, 
  * and visually refreshes the main dashboard metrics to reflect the most recent device measurements.
+ * Skipped while the live push channel is connected (see connectTelemetryPush()).
+ *
+ * One /bundle request carries the telemetry, the samples missed since the last poll and,
+ * every CHART_TASK_TABLE_UPDATE_INTERVAL_MS, the task table, so polling keeps a single
+ * connection busy instead of three.
  */
 async function updateDashboard()
 {
+  // Samples arrive over the push channel while it is open
+  if (AppState.push.connected)
+  {
+    return;
+  }
+
   try
   {
     // By default, fetch() does not support a timeout natively.
     // To enforce a timeout, we use AbortController to cancel the request if it takes too long.
     const controller = new AbortController();
     const timeoutId = setTimeout(() => controller.abort(), TELEMETRY_TIMEOUT_MS);
+    const lastSeq   = AppState.data.lastSeq;
+    const tableDue  = AppState.status.lastTableSuccess === null ||
+                      (Date.now() - AppState.status.lastTableSuccess) >= CHART_TASK_TABLE_UPDATE_INTERVAL_MS;
+    const parts     = ['telemetry'];
+    if (tableDue)
+    {
+      parts.push('tasks');
+    }
+    if (lastSeq !== null)
+    {
+      parts.push('history');
+    }
+    let url = `${API_ROUTES.BUNDLE}?parts=${parts.join(',')}`;
+    if (lastSeq !== null)
+    {
+      url += `&since=${lastSeq}`;
+    }
     let response;
     try {
-      response = await fetch(API_ROUTES.TELEMETRY, { signal: controller.signal });
+      response = await fetch(url, { signal: controller.signal });
     } finally {
       clearTimeout(timeoutId);
     }
@@ -344,210 +386,334 @@ async function updateDashboard()
       updateStatusPopup();
       return;
     }
-    const telemetryData = await response.json();
-    AppState.status.lastTelemetrySuccess = Date.now();
-    AppState.status.consecutiveFailures = 0;
+    const bundle = await response.json();
+    if (bundle.tasks)
+    {
+      applyTaskInfo(bundle.tasks);
+    }
+    await applyTelemetry(bundle.telemetry, bundle.history);
+  }
+  catch (error)
+  {
+    AppState.status.consecutiveFailures++;
+    updateStatusPopup();
+  }
+}
 
-    // Compute current task names once for both paused and active paths
-    const currentTaskNames = new Set(Object.keys(telemetryData.current));
+/**
+ * Apply one telemetry sample to the dashboard.
+ *
+ * Shared by the /telemetry poll and the /telemetry/ws push channel: updates
+ * the summary badges, progress bars and charts from a /telemetry JSON document.
+ *
+ * @param {Object} telemetryData - Parsed /telemetry document.
+ * @param {Object} [history] - /history?since=<last charted seq> document from the same /bundle poll.
+ */
+async function applyTelemetry(telemetryData, history)
+{
+  AppState.status.lastTelemetrySuccess = Date.now();
+  AppState.status.consecutiveFailures = 0;
 
-    // Skip visual updates if paused (data collection continues)
-    if (!AppState.ui.isPaused)
-    {
-      // Update summary badges with progress bars
-      const cpuOverall    = document.getElementById('cpuOverall');
-      const cpuC0         = document.getElementById('cpuC0');
-      const cpuC1         = document.getElementById('cpuC1');
-      const cpuOverallBar = document.getElementById('cpuOverallBar');
-      const cpuC0Bar      = document.getElementById('cpuC0Bar');
-      const cpuC1Bar      = document.getElementById('cpuC1Bar');
-
-      const overallValue = telemetryData.summary.cpu.overall;
-    const core0Value   = telemetryData.summary.cpu.cores[0];
-    const core1Value   = telemetryData.summary.cpu.cores[1];
-
-    cpuOverall.textContent = `${overallValue.toFixed(1)} %`;
-    cpuC0.textContent      = `${core0Value.toFixed(1)} %`;
-    cpuC1.textContent      = `${core1Value.toFixed(1)} %`;
-
-    // Update progress bars with color coding
-    updateCpuProgressBar(cpuOverallBar, overallValue);
-    updateCpuProgressBar(cpuC0Bar, core0Value);
+  // Compute current task names once for both paused and active paths
+  const currentTaskNames = new Set(Object.keys(telemetryData.current));
+
+  // Chart each device sample once: skip repeats, backfill samples missed between polls
+  const seq         = telemetryData.seq;
+  const lastSeq     = AppState.data.lastSeq;
+  const isNewSample = typeof seq !== 'number' || lastSeq === null || seq !== lastSeq;
+  if (typeof seq === 'number' && lastSeq !== null && seq > lastSeq + 1)
+  {
+    await backfillMissedSamples(lastSeq, seq, currentTaskNames, history);
+  }
+  AppState.data.lastSeq = typeof seq === 'number' ? seq : null;
+
+  // Skip visual updates if paused (data collection continues)
+  if (!AppState.ui.isPaused)
+  {
+    // Update summary badges with progress bars
+    const cpuOverall    = document.getElementById('cpuOverall');
+    const cpuC0         = document.getElementById('cpuC0');
+    const cpuC1         = document.getElementById('cpuC1');
+    const cpuOverallBar = document.getElementById('cpuOverallBar');
+    const cpuC0Bar      = document.getElementById('cpuC0Bar');
+    const cpuC1Bar      = document.getElementById('cpuC1Bar');
+
+    const overallValue = telemetryData.summary.cpu.overall;
+  const core0Value   = telemetryData.summary.cpu.cores[0];
+  const core1Value   = telemetryData.summary.cpu.cores[1];
+  const hasCore1     = typeof core1Value === 'number';
+
+  // Single-core chips report one entry in cores[]
+  const cpuC1Row = cpuC1 ? cpuC1.closest('.info-row') : null;
+  if (cpuC1Row)
+  {
+    cpuC1Row.classList.toggle('hidden', !hasCore1);
+  }
+
+  cpuOverall.textContent = `${overallValue.toFixed(1)} %`;
+  cpuC0.textContent      = `${core0Value.toFixed(1)} %`;
+  if (hasCore1)
+  {
+    cpuC1.textContent    = `${core1Value.toFixed(1)} %`;
+  }
+
+  // Update progress bars with color coding
+  updateCpuProgressBar(cpuOverallBar, overallValue);
+  updateCpuProgressBar(cpuC0Bar, core0Value);
+  if (hasCore1)
+  {
     updateCpuProgressBar(cpuC1Bar, core1Value);
+  }
 
-    // Update tooltips on containers (containers are always full width and hoverable)
-    const cpuOverallContainer = cpuOverallBar ? cpuOverallBar.closest('.progress-container') : null;
-    const cpuC0Container = cpuC0Bar ? cpuC0Bar.closest('.progress-container') : null;
-    const cpuC1Container = cpuC1Bar ? cpuC1Bar.closest('.progress-container') : null;
+  // Update tooltips on containers (containers are always full width and hoverable)
+  const cpuOverallContainer = cpuOverallBar ? cpuOverallBar.closest('.progress-container') : null;
+  const cpuC0Container = cpuC0Bar ? cpuC0Bar.closest('.progress-container') : null;
+  const cpuC1Container = cpuC1Bar ? cpuC1Bar.closest('.progress-container') : null;
 
-    if (cpuOverallContainer)
-    {
-      cpuOverallContainer.setAttribute('aria-label', `Overall CPU: ${overallValue.toFixed(1)}%`);
-      cpuOverallContainer.setAttribute('role', 'tooltip');
-      cpuOverallContainer.setAttribute('data-microtip-position', 'bottom');
-    }
-    if (cpuC0Container)
-    {
-      cpuC0Container.setAttribute('aria-label', `Core 0: ${core0Value.toFixed(1)}%`);
-      cpuC0Container.setAttribute('role', 'tooltip');
-      cpuC0Container.setAttribute('data-microtip-position', 'bottom');
-    }
-    if (cpuC1Container)
+  if (cpuOverallContainer)
+  {
+    cpuOverallContainer.setAttribute('aria-label', `Overall CPU: ${overallValue.toFixed(1)}%`);
+    cpuOverallContainer.setAttribute('role', 'tooltip');
+    cpuOverallContainer.setAttribute('data-microtip-position', 'bottom');
+  }
+  if (cpuC0Container)
+  {
+    cpuC0Container.setAttribute('aria-label', `Core 0: ${core0Value.toFixed(1)}%`);
+    cpuC0Container.setAttribute('role', 'tooltip');
+    cpuC0Container.setAttribute('data-microtip-position', 'bottom');
+  }
+  if (cpuC1Container && hasCore1)
+  {
+    cpuC1Container.setAttribute('aria-label', `Core 1: ${core1Value.toFixed(1)}%`);
+    cpuC1Container.setAttribute('role', 'tooltip');
+    cpuC1Container.setAttribute('data-microtip-position', 'bottom');
+  }
+
+  // Interrupt load per core (only with the interrupt monitor)
+  const isrLoads = telemetryData.summary.cpu.isr;
+  const coreIsrLoad = document.getElementById('coreIsrLoad');
+  if (coreIsrLoad && Array.isArray(isrLoads))
+  {
+    coreIsrLoad.textContent = 'Interrupts: ' +
+      isrLoads.map((load, core) => `${load.toFixed(1)}% (core ${core})`).join(', ');
+    coreIsrLoad.classList.remove('hidden');
+  }
+
+  // Context switches per core (only with the scheduling trace statistics)
+  const switchRates = telemetryData.summary.cpu.switchesPerSec;
+  const coreSwitchRate = document.getElementById('coreSwitchRate');
+  if (coreSwitchRate && Array.isArray(switchRates))
+  {
+    coreSwitchRate.textContent = 'Context switches: ' +
+      switchRates.map((rate, core) => `${rate}/s (core ${core})`).join(', ');
+  }
+
+  // Update DRAM visualizations
+  const dramTotal   = telemetryData.summary.mem.dram.total;
+  const dramFree    = telemetryData.summary.mem.dram.free;
+  const dramUsed    = dramTotal - dramFree;
+  const dramUsedPct = telemetryData.summary.mem.dram.usedPct;
+  const dramLargest = telemetryData.summary.mem.dram.largest;
+
+  // Update text elements
+  const dramUsedPctEl = document.getElementById('dramUsedPct');
+  const dramFreeEl    = document.getElementById('dramFree');
+  const dramUsedEl    = document.getElementById('dramUsed');
+  const dramLargestEl = document.getElementById('dramLargest');
+  const dramTotalEl   = document.getElementById('dramTotal');
+
+  dramUsedPctEl.textContent = `${dramUsedPct.toFixed(1)} %`;
+  dramFreeEl.textContent    = formatSize(dramFree, 'kb', true);
+  dramFreeEl.setAttribute('aria-label', formatSize(dramFree, 'bytes', true));
+  dramFreeEl.setAttribute('role', 'tooltip');
+  dramFreeEl.setAttribute('data-microtip-position', 'bottom');
+  dramUsedEl.textContent    = formatSize(dramUsed, 'kb', true);
+  dramUsedEl.setAttribute('aria-label', formatSize(dramUsed, 'bytes', true));
+  dramUsedEl.setAttribute('role', 'tooltip');
+  dramUsedEl.setAttribute('data-microtip-position', 'bottom');
+  dramLargestEl.textContent = formatSize(dramLargest, 'kb', true);
+  dramLargestEl.setAttribute('aria-label', formatSize(dramLargest, 'bytes', true));
+  dramLargestEl.setAttribute('role', 'tooltip');
+  dramLargestEl.setAttribute('data-microtip-position', 'bottom');
+  dramTotalEl.textContent   = formatSize(dramTotal, 'kb', true);
+  dramTotalEl.setAttribute('aria-label', formatSize(dramTotal, 'bytes', true));
+  dramTotalEl.setAttribute('role', 'tooltip');
+  dramTotalEl.setAttribute('data-microtip-position', 'bottom-left');
+
+  // Update WiFi RSSI icon if available in telemetry
+  if (telemetryData.summary && telemetryData.summary.wifiRssi !== undefined)
+  {
+    updateWifiRssi(telemetryData.summary.wifiRssi);
+  }
+
+  // Update usage progress bar (green for used, grey background for free)
+  const dramUsedBar = document.getElementById('dramUsedBar');
+  const dramUsedContainer = dramUsedBar ? dramUsedBar.closest('.progress-container') : null;
+  if (dramUsedBar)
+  {
+    updateDramProgressBar(dramUsedBar, dramUsedPct);
+    // Update tooltip with used/free/total on container
+    if (dramUsedContainer)
     {
-      cpuC1Container.setAttribute('aria-label', `Core 1: ${core1Value.toFixed(1)}%`);
-      cpuC1Container.setAttribute('role', 'tooltip');
-      cpuC1Container.setAttribute('data-microtip-position', 'bottom');
+      dramUsedContainer.setAttribute('aria-label', `DRAM: ${formatSize(dramUsed, 'bytes', true)} used (${dramUsedPct.toFixed(1)}%), ${formatSize(dramFree, 'bytes', true)} free, ${formatSize(dramTotal, 'bytes', true)} total`);
+      dramUsedContainer.setAttribute('role', 'tooltip');
+      dramUsedContainer.setAttribute('data-microtip-position', 'bottom');
     }
+  }
+
+  // Update fragmentation bar (largest block as percentage of total, positioned from right)
+  const dramFragmentationBar = document.getElementById('dramFragmentationBar');
+  if (dramFragmentationBar && dramTotal > 0)
+  {
+    // Show largest block as a percentage of total, positioned from the right edge
+    const largestPct = (dramLargest / dramTotal) * 100;
+    dramFragmentationBar.style.width = `${largestPct}%`;
+    dramFragmentationBar.style.display = (largestPct > 0 && largestPct <= 100) ? 'block' : 'none';
+  }
+
+  // Update PSRAM visualizations
+  const psramSection = document.getElementById('psramSection');
+  if (telemetryData.summary.mem.psram.present)
+  {
+    const psramTotal   = telemetryData.summary.mem.psram.total;
+    const psramFree    = telemetryData.summary.mem.psram.free;
+    const psramUsed    = psramTotal - psramFree;
+    const psramUsedPct = telemetryData.summary.mem.psram.usedPct;
 
-    // Update DRAM visualizations
-    const dramTotal   = telemetryData.summary.mem.dram.total;
-    const dramFree    = telemetryData.summary.mem.dram.free;
-    const dramUsed    = dramTotal - dramFree;
-    const dramUsedPct = telemetryData.summary.mem.dram.usedPct;
-    const dramLargest = telemetryData.summary.mem.dram.largest;
+    // Show PSRAM section
+    psramSection.classList.remove('hidden');
 
     // Update text elements
-    const dramUsedPctEl = document.getElementById('dramUsedPct');
-    const dramFreeEl    = document.getElementById('dramFree');
-    const dramUsedEl    = document.getElementById('dramUsed');
-    const dramLargestEl = document.getElementById('dramLargest');
-    const dramTotalEl   = document.getElementById('dramTotal');
-
-    dramUsedPctEl.textContent = `${dramUsedPct.toFixed(1)} %`;
-    dramFreeEl.textContent    = formatSize(dramFree, 'kb', true);
-    dramFreeEl.setAttribute('aria-label', formatSize(dramFree, 'bytes', true));
-    dramFreeEl.setAttribute('role', 'tooltip');
-    dramFreeEl.setAttribute('data-microtip-position', 'bottom');
-    dramUsedEl.textContent    = formatSize(dramUsed, 'kb', true);
-    dramUsedEl.setAttribute('aria-label', formatSize(dramUsed, 'bytes', true));
-    dramUsedEl.setAttribute('role', 'tooltip');
-    dramUsedEl.setAttribute('data-microtip-position', 'bottom');
-    dramLargestEl.textContent = formatSize(dramLargest, 'kb', true);
-    dramLargestEl.setAttribute('aria-label', formatSize(dramLargest, 'bytes', true));
-    dramLargestEl.setAttribute('role', 'tooltip');
-    dramLargestEl.setAttribute('data-microtip-position', 'bottom');
-    dramTotalEl.textContent   = formatSize(dramTotal, 'kb', true);
-    dramTotalEl.setAttribute('aria-label', formatSize(dramTotal, 'bytes', true));
-    dramTotalEl.setAttribute('role', 'tooltip');
-    dramTotalEl.setAttribute('data-microtip-position', 'bottom-left');
-
-    // Update WiFi RSSI icon if available in telemetry
-    if (telemetryData.summary && telemetryData.summary.wifiRssi !== undefined)
-    {
-      updateWifiRssi(telemetryData.summary.wifiRssi);
-    }
+    const psramUsedPctEl = document.getElementById('psramUsedPct');
+    const psramFreeEl    = document.getElementById('psramFree');
+    const psramUsedEl    = document.getElementById('psramUsed');
+    const psramTotalEl   = document.getElementById('psramTotal');
+
+    psramUsedPctEl.textContent = `${psramUsedPct.toFixed(1)} %`;
+    psramFreeEl.textContent    = formatSize(psramFree, 'kb', true);
+    psramFreeEl.setAttribute('aria-label', formatSize(psramFree, 'bytes', true));
+    psramFreeEl.setAttribute('role', 'tooltip');
+    psramFreeEl.setAttribute('data-microtip-position', 'bottom');
+    psramUsedEl.textContent    = formatSize(psramUsed, 'kb', true);
+    psramUsedEl.setAttribute('aria-label', formatSize(psramUsed, 'bytes', true));
+    psramUsedEl.setAttribute('role', 'tooltip');
+    psramUsedEl.setAttribute('data-microtip-position', 'bottom');
+    psramTotalEl.textContent   = formatSize(psramTotal, 'kb', true);
+    psramTotalEl.setAttribute('aria-label', formatSize(psramTotal, 'bytes', true));
+    psramTotalEl.setAttribute('role', 'tooltip');
+    psramTotalEl.setAttribute('data-microtip-position', 'bottom-left');
 
     // Update usage progress bar (green for used, grey background for free)
-    const dramUsedBar = document.getElementById('dramUsedBar');
-    const dramUsedContainer = dramUsedBar ? dramUsedBar.closest('.progress-container') : null;
-    if (dramUsedBar)
+    const psramUsedBar = document.getElementById('psramUsedBar');
+    const psramUsedContainer = psramUsedBar ? psramUsedBar.closest('.progress-container') : null;
+    if (psramUsedBar)
     {
-      updateDramProgressBar(dramUsedBar, dramUsedPct);
+      updatePsramProgressBar(psramUsedBar, psramUsedPct);
       // Update tooltip with used/free/total on container
-      if (dramUsedContainer)
+      if (psramUsedContainer)
       {
-        dramUsedContainer.setAttribute('aria-label', `DRAM: ${formatSize(dramUsed, 'bytes', true)} used (${dramUsedPct.toFixed(1)}%), ${formatSize(dramFree, 'bytes', true)} free, ${formatSize(dramTotal, 'bytes', true)} total`);
-        dramUsedContainer.setAttribute('role', 'tooltip');
-        dramUsedContainer.setAttribute('data-microtip-position', 'bottom');
+        psramUsedContainer.setAttribute('aria-label', `PSRAM: ${formatSize(psramUsed, 'bytes', true)} used (${psramUsedPct.toFixed(1)}%), ${formatSize(psramFree, 'bytes', true)} free, ${formatSize(psramTotal, 'bytes', true)} total`);
+        psramUsedContainer.setAttribute('role', 'tooltip');
+        psramUsedContainer.setAttribute('data-microtip-position', 'bottom');
       }
     }
+  }
+  else
+  {
+    psramSection.classList.add('hidden');
+  }
 
-    // Update fragmentation bar (largest block as percentage of total, positioned from right)
-    const dramFragmentationBar = document.getElementById('dramFragmentationBar');
-    if (dramFragmentationBar && dramTotal > 0)
-    {
-      // Show largest block as a percentage of total, positioned from the right edge
-      const largestPct = (dramLargest / dramTotal) * 100;
-      dramFragmentationBar.style.width = `${largestPct}%`;
-      dramFragmentationBar.style.display = (largestPct > 0 && largestPct <= 100) ? 'block' : 'none';
-    }
+  // Detect task changes: if new tasks appeared or tasks disappeared, refresh table immediately
+  const previousTaskNames = AppState.data.lastTelemetryTaskNames;
+  const hasNewTasks       = [...currentTaskNames].some(name => !previousTaskNames.has(name));
+  const hasRemovedTasks   = [...previousTaskNames].some(name => !currentTaskNames.has(name));
 
-    // Update PSRAM visualizations
-    const psramSection = document.getElementById('psramSection');
-    if (telemetryData.summary.mem.psram.present)
-    {
-      const psramTotal   = telemetryData.summary.mem.psram.total;
-      const psramFree    = telemetryData.summary.mem.psram.free;
-      const psramUsed    = psramTotal - psramFree;
-      const psramUsedPct = telemetryData.summary.mem.psram.usedPct;
-
-      // Show PSRAM section
-      psramSection.classList.remove('hidden');
-
-      // Update text elements
-      const psramUsedPctEl = document.getElementById('psramUsedPct');
-      const psramFreeEl    = document.getElementById('psramFree');
-      const psramUsedEl    = document.getElementById('psramUsed');
-      const psramTotalEl   = document.getElementById('psramTotal');
-
-      psramUsedPctEl.textContent = `${psramUsedPct.toFixed(1)} %`;
-      psramFreeEl.textContent    = formatSize(psramFree, 'kb', true);
-      psramFreeEl.setAttribute('aria-label', formatSize(psramFree, 'bytes', true));
-      psramFreeEl.setAttribute('role', 'tooltip');
-      psramFreeEl.setAttribute('data-microtip-position', 'bottom');
-      psramUsedEl.textContent    = formatSize(psramUsed, 'kb', true);
-      psramUsedEl.setAttribute('aria-label', formatSize(psramUsed, 'bytes', true));
-      psramUsedEl.setAttribute('role', 'tooltip');
-      psramUsedEl.setAttribute('data-microtip-position', 'bottom');
-      psramTotalEl.textContent   = formatSize(psramTotal, 'kb', true);
-      psramTotalEl.setAttribute('aria-label', formatSize(psramTotal, 'bytes', true));
-      psramTotalEl.setAttribute('role', 'tooltip');
-      psramTotalEl.setAttribute('data-microtip-position', 'bottom-left');
-
-      // Update usage progress bar (green for used, grey background for free)
-      const psramUsedBar = document.getElementById('psramUsedBar');
-      const psramUsedContainer = psramUsedBar ? psramUsedBar.closest('.progress-container') : null;
-      if (psramUsedBar)
-      {
-        updatePsramProgressBar(psramUsedBar, psramUsedPct);
-        // Update tooltip with used/free/total on container
-        if (psramUsedContainer)
-        {
-          psramUsedContainer.setAttribute('aria-label', `PSRAM: ${formatSize(psramUsed, 'bytes', true)} used (${psramUsedPct.toFixed(1)}%), ${formatSize(psramFree, 'bytes', true)} free, ${formatSize(psramTotal, 'bytes', true)} total`);
-          psramUsedContainer.setAttribute('role', 'tooltip');
-          psramUsedContainer.setAttribute('data-microtip-position', 'bottom');
-        }
-      }
-    }
-    else
-    {
-      psramSection.classList.add('hidden');
-    }
+  if (hasNewTasks || hasRemovedTasks)
+  {
+    // Task was added or removed - refresh table immediately to show current state
+    updateTable();
+  }
 
-    // Detect task changes: if new tasks appeared or tasks disappeared, refresh table immediately
-    const previousTaskNames = AppState.data.lastTelemetryTaskNames;
-    const hasNewTasks       = [...currentTaskNames].some(name => !previousTaskNames.has(name));
-    const hasRemovedTasks   = [...previousTaskNames].some(name => !currentTaskNames.has(name));
+  // Update tracked task names for next comparison
+  AppState.data.lastTelemetryTaskNames = new Set(currentTaskNames);
 
-    if (hasNewTasks || hasRemovedTasks)
+    // Update charts with new telemetry data
+    if (isNewSample)
     {
-      // Task was added or removed - refresh table immediately to show current state
-      updateTable();
+      updateCharts(telemetryData.current);
     }
 
-    // Update tracked task names for next comparison
-    AppState.data.lastTelemetryTaskNames = new Set(currentTaskNames);
-
-      // Update charts with new telemetry data
-      updateCharts(telemetryData.current, currentTaskNames);
-
-      // Update table rows for registered tasks with telemetry data
-      updateTableRowsFromTelemetry(telemetryData.current);
-    }
-    else
+    // Update table rows for registered tasks with telemetry data
+    updateTableRowsFromTelemetry(telemetryData.current);
+  }
+  else
+  {
+    // When paused, still update chart data but don't trigger visual update
+    // This allows data to accumulate in the background
+    if (isNewSample)
     {
-      // When paused, still update chart data but don't trigger visual update
-      // This allows data to accumulate in the background
-      updateCharts(telemetryData.current, currentTaskNames);
+      updateCharts(telemetryData.current);
     }
+  }
 
-    updateStatusPopup();
+  updateStatusPopup();
+}
+
+/**
+ * Open the live telemetry push channel.
+ *
+ * The device sends every new sample over the /telemetry/ws WebSocket as soon
+ * as it is taken, so the dashboard does not have to poll /telemetry. While the
+ * socket is closed (firmware without WebSocket support, network loss) the
+ * regular poll takes over and the connection is retried with backoff.
+ */
+function connectTelemetryPush()
+{
+  if (typeof WebSocket === 'undefined')
+  {
+    return;
+  }
+
+  const scheme = window.location.protocol === 'https:' ? 'wss' : 'ws';
+  let socket;
+  try
+  {
+    socket = new WebSocket(`${scheme}://${window.location.host}${API_ROUTES.TELEMETRY_WS}`);
   }
   catch (error)
   {
-    AppState.status.consecutiveFailures++;
-    updateStatusPopup();
+    console.warn("Live telemetry push unavailable:", error);
+    return;
   }
+
+  socket.onopen = () => {
+    AppState.push.connected = true;
+    AppState.push.failures  = 0;
+  };
+
+  socket.onmessage = (event) => {
+    let telemetryData;
+    try
+    {
+      telemetryData = JSON.parse(event.data);
+    }
+    catch (error)
+    {
+      console.warn("Ignoring malformed telemetry frame:", error);
+      return;
+    }
+    // Handle samples one at a time (backfilling may await a /history request)
+    AppState.push.pending = AppState.push.pending
+      .then(() => applyTelemetry(telemetryData))
+      .catch(error => console.warn("Failed to apply pushed telemetry:", error));
+  };
+
+  socket.onclose = () => {
+    AppState.push.connected = false;
+    const delay = Math.min(PUSH_RECONNECT_MAX_MS, PUSH_RECONNECT_BASE_MS * 2 ** AppState.push.failures);
+    AppState.push.failures++;
+    setTimeout(connectTelemetryPush, delay);
+  };
 }
 
 // Application startup (entry point)
@@ -122,6 +122,27 @@ function getMajorTickIntervalSamples()
   return Math.round(majorTickIntervalSeconds / intervalSeconds);
 }
 
+/**
+ * Check whether a chart point carries a major (5-second) tick.
+ *
+ * With decimation a point covers several samples, so it is major when any of
+ * them falls on a major tick.
+ *
+ * @param {number} labelValue - Point label: sample offset of its newest sample (0 for the newest).
+ * @param {number} [step=1] - Samples per point (see getDecimationStep()).
+ * @returns {boolean} True if the point covers a multiple of the major tick interval.
+ */
+function isMajorTickLabel(labelValue, step = 1)
+{
+  const majorTickInterval = getMajorTickIntervalSamples();
+  if (!(majorTickInterval > 0))
+  {
+    return false;
+  }
+  // The point covers samples (labelValue - step, labelValue]
+  return Math.floor(labelValue / majorTickInterval) * majorTickInterval > labelValue - step;
+}
+
 /**
  * Generate time-based labels for chart x-axis.
  *
@@ -279,6 +300,10 @@ function getBaseChartOptions(yAxisConfig, tooltipCallbacks, chartType)
       mode      : 'index',
       intersect : false
     },
+    // The decimation step follows the plot width
+    onResize: () => {
+      scheduleChartRefresh();
+    },
     onHover: (event, activeElements) => {
       // Update status popup when hovering (hover state is managed by mouseenter/mouseleave)
       updateStatusPopup();
@@ -287,22 +312,20 @@ function getBaseChartOptions(yAxisConfig, tooltipCallbacks, chartType)
       x: {
         grid: {
           color: (context) => {
-            // Convert index to actual label value (negative numbers from -99 to 0)
-            const labelValue = context.tick.value - (CHART_SAMPLE_COUNT - 1);
-            const majorTickInterval = getMajorTickIntervalSamples();
+            // Look up the point's label (sample offset, negative numbers up to 0)
+            const labelValue = context.chart.data.labels[context.tick.value];
             // Make grid lines at 5-second intervals more visible (major ticks)
-            if (majorTickInterval > 0 && labelValue % majorTickInterval === 0)
+            if (isMajorTickLabel(labelValue, context.chart.decimationStep))
             {
               return CONFIG.COLORS.UI.GRID_COLOR_MAJOR;
             }
             return CONFIG.COLORS.UI.GRID_COLOR;
           },
           lineWidth: (context) => {
-            // Convert index to actual label value (negative numbers from -99 to 0)
-            const labelValue = context.tick.value - (CHART_SAMPLE_COUNT - 1);
-            const majorTickInterval = getMajorTickIntervalSamples();
+            // Look up the point's label (sample offset, negative numbers up to 0)
+            const labelValue = context.chart.data.labels[context.tick.value];
             // Make grid lines at 5-second intervals thicker (major ticks)
-            if (majorTickInterval > 0 && labelValue % majorTickInterval === 0)
+            if (isMajorTickLabel(labelValue, context.chart.decimationStep))
             {
               return 1.5;
             }
@@ -316,11 +339,10 @@ function getBaseChartOptions(yAxisConfig, tooltipCallbacks, chartType)
 
           callback: function(value, index, ticks)
           {
-            // Get the actual label value (negative numbers from -99 to 0)
+            // Get the actual label value (negative numbers up to 0)
             const labelValue = this.getLabelForValue(value);
-            const majorTickInterval = getMajorTickIntervalSamples();
             // Only show labels for major ticks (every 5 seconds)
-            if (majorTickInterval > 0 && labelValue % majorTickInterval === 0)
+            if (isMajorTickLabel(labelValue, this.chart.decimationStep))
             {
               // Convert sample count to seconds for display
               const intervalSeconds = CHART_TELEMETRY_UPDATE_INTERVAL_MS / 1000;
@@ -405,40 +427,17 @@ Chart.register(verticalHoverLinePlugin);
 /**
  * Create and initialize the CPU usage chart.
  *
- * Builds the Chart.js CPU usage line chart using the provided initial history data.
- * Filters datasets according to the "hide system tasks" UI filter, formats tooltips,
- * applies theme-aware styling for dark/light modes, and registers the chart in AppState.
- * This function should be called with complete CPU/task usage history on dashboard load,
- * and can be called again to recreate the chart with new or filtered data.
+ * Builds the Chart.js CPU usage line chart with theme-aware styling and tooltips
+ * and registers it in AppState. The chart starts without datasets: refreshCharts()
+ * fills them from the task series (AppState.data.series, see series.js), following
+ * the "hide system tasks" and low usage filters.
  *
- * @param {Object} initialData - CPU history in the form: { taskName: { cpu: [percent, ...], ... }, ... }
  * @returns {void}
  */
-function createCpuChart(initialData)
+function createCpuChart()
 {
-  const CONFIG = getChartConfig();
   const canvasContext = document.getElementById('cpuChart').getContext('2d');
 
-  // Handle empty or missing initial data
-  // Expected format: { taskName: { cpu: [array of CPU % values], stack: [...] } }
-  const datasets = initialData && typeof initialData === 'object' 
-    ? Object.entries(initialData)
-        .filter(([taskName, taskData]) => {
-          // Filter out system tasks if hideSystemTasks is enabled
-          const isSystemTask = SYSTEM_TASKS.hasOwnProperty(taskName);
-          return !(AppState.filters.hideSystemTasks && isSystemTask);
-        })
-        .map(([taskName, taskData]) => {
-        // Extract CPU history array from task data object
-        // taskData should be an object with a 'cpu' property containing an array
-        const cpuHistoryArray = taskData && typeof taskData === 'object' && Array.isArray(taskData.cpu)
-          ? taskData.cpu
-          : []; // Fallback to empty array if structure is unexpected
-        
-        return createChartDataset(taskName, cpuHistoryArray);
-      })
-    : [];
-
   // CPU table specific tooltip generation
   const tooltipCallbacks = createTooltipCallbacks(function(context)
   {
@@ -464,7 +463,7 @@ function createCpuChart(initialData)
     type: 'line',
     data: {
       labels  : generateTimeLabels(),
-      datasets: datasets
+      datasets: []
     },
     options: getBaseChartOptions(yAxisConfig, tooltipCallbacks, 'cpu')
   });
@@ -479,61 +478,28 @@ function createCpuChart(initialData)
   cpuCanvas.addEventListener('mouseleave', () => 
   {
     AppState.ui.isHoveringCpu = false;
-    // Immediately update both charts with accumulated data if neither is now hovered and app is not paused
-    if (!AppState.ui.isHoveringMemory && !AppState.ui.isPaused)
+    // Immediately update all charts with accumulated data if none is now hovered and app is not paused
+    if (!AppState.ui.isHoveringMemory && !AppState.ui.isHoveringHeap && !AppState.ui.isHoveringLatency &&
+        !AppState.ui.isPaused)
     {
-      AppState.charts.cpu.update('none');
-      AppState.charts.memory.update('none');
+      refreshCharts();
     }
     updateStatusPopup();
   });
 }
 
 /**
- * Create the Memory usage chart with initial history.
+ * Create the Memory usage chart.
  *
  * Constructs a non-stacked line chart showing memory (stack) usage percentages for
- * registered tasks. Uses the initial history from the server to populate the chart datasets.
- * Excludes system tasks without registered stack sizes. Handles unexpected or missing
- * input data gracefully. This chart displays each task's stack usage as a percentage
- * of its total stack size over the sample history window.
- *
- * @param {Object} initialData - Object containing per-task initial stack/history arrays, e.g.:
- *   { taskName: { cpu: [...], stack: [...] }, ... }
+ * registered tasks (those with known stack sizes). The chart starts without datasets:
+ * refreshCharts() fills them from the task series, where each task's stack usage is
+ * kept as a percentage of its total stack size.
  */
-function createMemoryChart(initialData)
+function createMemoryChart()
 {
   const canvasContext = document.getElementById('memoryChart').getContext('2d');
 
-  // Only include registered tasks (those with known stack sizes)
-  // Handle empty or missing initial data
-  // Expected format: { taskName: { cpu: [...], stack: [array of stack bytes] } }
-  const datasets = initialData && typeof initialData === 'object'
-    ? Object.entries(initialData)
-        .filter(([taskName, taskData]) => AppState.data.registeredTasks.has(taskName))
-        .map(([taskName, taskData]) => {
-          // Extract stack history array from task data object
-          // taskData should be an object with a 'stack' property containing an array of bytes
-          const stackDataBytes = taskData && typeof taskData === 'object' && Array.isArray(taskData.stack)
-            ? taskData.stack
-            : []; // Fallback to empty array if structure is unexpected
-          
-          // Get the registered stack size for this task (needed to calculate percentages)
-          const stackSize = AppState.data.taskInfo[taskName]?.stackSize || 0;
-          
-          // Convert stack bytes to percentages for display
-          const percentageData = stackDataBytes.map(bytes => {
-            if (stackSize > 0 && Number.isFinite(bytes))
-            {
-              return (bytes / stackSize) * 100;
-            }
-            return 0;
-          });
-          
-          return createChartDataset(taskName, percentageData);
-        })
-    : [];
-
   const tooltipCallbacks = createTooltipCallbacks(function(context)
   {
     const label = context.dataset.label || '';
@@ -558,7 +524,7 @@ function createMemoryChart(initialData)
     type: 'line',
     data: {
       labels  : generateTimeLabels(),
-      datasets: datasets
+      datasets: []
     },
     options: getBaseChartOptions(yAxisConfig, tooltipCallbacks, 'memory')
   });
@@ -573,185 +539,300 @@ function createMemoryChart(initialData)
   memoryCanvas.addEventListener('mouseleave', () => 
   {
     AppState.ui.isHoveringMemory = false;
-    // Immediately update both charts with accumulated data if neither is now hovered and app is not paused
-    if (!AppState.ui.isHoveringCpu && !AppState.ui.isPaused)
+    // Immediately update all charts with accumulated data if none is now hovered and app is not paused
+    if (!AppState.ui.isHoveringCpu && !AppState.ui.isHoveringHeap && !AppState.ui.isHoveringLatency &&
+        !AppState.ui.isPaused)
     {
-      AppState.charts.cpu.update('none');
-      AppState.charts.memory.update('none');
+      refreshCharts();
     }
     updateStatusPopup();
   });
 }
 
 /**
- * Update chart datasets with new telemetry data.
+ * Create the Task Heap chart.
  *
- * Updates both CPU and Memory chart datasets with the latest telemetry data,
- * handles task filtering (system tasks, low usage), manages dataset lifecycle
- * (add/remove tasks), and updates chart labels. Only updates visual display if
- * charts are not being hovered.
- *
- * @param {Object} telemetryCurrent - The current telemetry data for tasks.
- * @param {Set} currentTaskNames - Set of task names present in current telemetry.
+ * Shows the heap each task has allocated and not yet freed, in KB. The device
+ * only reports it with per-task heap accounting enabled
+ * (CONFIG_SYSMON_TASK_HEAP_ACCOUNTING), so refreshCharts() only creates the chart,
+ * and unhides its panel, once a task series carries heap values.
  */
-function updateCharts(telemetryCurrent, currentTaskNames)
+function createHeapChart()
 {
-  if (!AppState.charts.cpu || !AppState.charts.memory)
+  if (AppState.charts.heap)
   {
     return;
   }
+  document.getElementById('heapChartBox').classList.remove('hidden');
+
+  const canvasContext = document.getElementById('heapChart').getContext('2d');
 
-  // Update CPU chart datasets
-  // Expected format: { taskName: { cpu: <number>, stack: <number>, stackPct: <number>, ... } }
-  for (const [taskName, taskCurrent] of Object.entries(telemetryCurrent))
+  const tooltipCallbacks = createTooltipCallbacks(function(context)
   {
-    // Skip system tasks if hideSystemTasks filter is enabled
-    const isSystemTask = SYSTEM_TASKS.hasOwnProperty(taskName);
-    if (AppState.filters.hideSystemTasks && isSystemTask)
+    const label = context.dataset.label || '';
+    const value = context.parsed.y;
+    if (value === null || value === undefined)
     {
-      continue;
+      return label;
     }
+    const sizeString = value.toFixed(1) + ' KB';
+    return label
+      ? `(${sizeString}) ${label}`
+      : `(${sizeString})`;
+  });
 
-    // Extract CPU usage percentage value from task data object
-    // taskCurrent should be an object with a 'cpu' property containing a number
-    const cpuValue = taskCurrent && typeof taskCurrent === 'object' && typeof taskCurrent.cpu === 'number'
-      ? taskCurrent.cpu
-      : 0; // Fallback to 0 if CPU value is missing or invalid
-    let dataset = AppState.charts.cpu.data.datasets.find(d => d.label === taskName);
-    if (!dataset)
-    {
-      dataset = createChartDataset(
-        taskName,
-        Array(AppState.charts.cpu.data.labels.length - 1).fill(0)
-      );
-      AppState.charts.cpu.data.datasets.push(dataset);
-    }
-    dataset.data.push(cpuValue);
-    if (dataset.data.length > CHART_SAMPLE_COUNT)
-    {
-      dataset.data.shift();
-    }
+  const yAxisConfig = {
+    max  : undefined,
+    label: 'Task Heap (KB)'
+  };
+
+  AppState.charts.heap = window.heapChartInstance = new Chart(canvasContext, {
+    type: 'line',
+    data: {
+      labels  : generateTimeLabels(),
+      datasets: []
+    },
+    options: getBaseChartOptions(yAxisConfig, tooltipCallbacks, 'heap')
+  });
 
-    // Calculate average usage over all data points in the dataset
-    let averageUsage = 0.0;
-    if (dataset.data.length > 0)
+  // Add mouseenter/mouseleave detection to manage hover state
+  const heapCanvas = document.getElementById('heapChart');
+  heapCanvas.addEventListener('mouseenter', () => 
+  {
+    AppState.ui.isHoveringHeap = true;
+    updateStatusPopup();
+  });
+  heapCanvas.addEventListener('mouseleave', () => 
+  {
+    AppState.ui.isHoveringHeap = false;
+    if (!AppState.ui.isHoveringCpu && !AppState.ui.isHoveringMemory && !AppState.ui.isHoveringLatency &&
+        !AppState.ui.isPaused)
     {
-      const validValues = dataset.data.filter(v => Number.isFinite(v));
-      if (validValues.length > 0)
-      {
-        const sum = validValues.reduce((acc, val) => acc + val, 0);
-        averageUsage = sum / validValues.length;
-      }
+      refreshCharts();
     }
+    updateStatusPopup();
+  });
+}
 
-    // Hide dataset if average usage is below threshold
-    const isLowUsage = averageUsage < AppState.filters.thresholdPercent;
-    dataset.hidden = AppState.filters.hideLowUsage && isLowUsage;
+/**
+ * Create the Ready Latency chart.
+ *
+ * Shows, per task, the longest wait between being made ready and running
+ * during each sample interval, in microseconds. The device only reports it
+ * with the scheduling trace statistics enabled (CONFIG_SYSMON_TRACE_SCHED_STATS),
+ * and there is no history for it, so refreshCharts() creates the chart on the
+ * first telemetry sample that carries "readyMaxUs" values.
+ */
+function createLatencyChart()
+{
+  if (AppState.charts.latency)
+  {
+    return;
   }
+  document.getElementById('latencyChartBox').classList.remove('hidden');
+
+  const canvasContext = document.getElementById('latencyChart').getContext('2d');
 
-  // Remove CPU chart datasets for tasks that no longer exist
-  // Also remove system tasks if hideSystemTasks filter is enabled
-  const removedCpuTasks = new Set();
-  AppState.charts.cpu.data.datasets = AppState.charts.cpu.data.datasets.filter(dataset => {
-    // Remove if task no longer exists
-    if (!currentTaskNames.has(dataset.label))
+  const tooltipCallbacks = createTooltipCallbacks(function(context)
+  {
+    const label = context.dataset.label || '';
+    const value = context.parsed.y;
+    if (value === null || value === undefined)
     {
-      removedCpuTasks.add(dataset.label);
-      return false;
+      return label;
     }
-    // Remove if it's a system task and filter is enabled
-    const isSystemTask = SYSTEM_TASKS.hasOwnProperty(dataset.label);
-    if (AppState.filters.hideSystemTasks && isSystemTask)
+    const latencyString = value.toFixed(0) + ' µs';
+    return label
+      ? `(${latencyString}) ${label}`
+      : `(${latencyString})`;
+  });
+
+  const yAxisConfig = {
+    max  : undefined,
+    label: 'Ready Latency (µs)'
+  };
+
+  AppState.charts.latency = window.latencyChartInstance = new Chart(canvasContext, {
+    type: 'line',
+    data: {
+      labels  : generateTimeLabels(),
+      datasets: []
+    },
+    options: getBaseChartOptions(yAxisConfig, tooltipCallbacks, 'latency')
+  });
+
+  // Add mouseenter/mouseleave detection to manage hover state
+  const latencyCanvas = document.getElementById('latencyChart');
+  latencyCanvas.addEventListener('mouseenter', () => 
+  {
+    AppState.ui.isHoveringLatency = true;
+    updateStatusPopup();
+  });
+  latencyCanvas.addEventListener('mouseleave', () => 
+  {
+    AppState.ui.isHoveringLatency = false;
+    if (!AppState.ui.isHoveringCpu && !AppState.ui.isHoveringMemory && !AppState.ui.isHoveringHeap &&
+        !AppState.ui.isPaused)
     {
-      removedCpuTasks.add(dataset.label);
-      return false;
+      refreshCharts();
     }
-    return true;
+    updateStatusPopup();
   });
+}
 
-  // Update Memory chart datasets (non-stacked, showing percentages) - only for registered tasks
-  const currentRegisteredTaskNames = new Set();
-  for (const [taskName, taskCurrent] of Object.entries(telemetryCurrent))
+/**
+ * Fill a chart's datasets from one metric of the task series.
+ *
+ * Keeps the existing dataset objects (and their colors) of tasks that stay,
+ * creates datasets for new tasks and drops the others. Points are decimated to
+ * the plot width (see fillDecimatedSeries()), written into the datasets' arrays
+ * in place, and the x axis labels are regenerated only when the step changes.
+ *
+ * @param {Chart} chart - Chart.js instance.
+ * @param {string} metric - Series metric (see SERIES_METRICS).
+ * @param {Function} includeTask - (taskName, series) => true if the task is charted.
+ * @param {number} [scale=1] - Factor applied to every point.
+ * @returns {Set} Task names removed from the chart.
+ */
+function renderChartSeries(chart, metric, includeTask, scale = 1)
+{
+  const pixelWidth = chart.chartArea ? chart.chartArea.width : chart.width;
+  const step       = getDecimationStep(CHART_SAMPLE_COUNT, pixelWidth);
+  if (chart.decimationStep !== step || chart.data.labels.length !== Math.ceil(CHART_SAMPLE_COUNT / step))
   {
-    // Skip non-registered tasks - we only chart tasks with known stack sizes
-    if (!AppState.data.registeredTasks.has(taskName))
+    chart.decimationStep = step;
+    chart.data.labels    = generateDecimatedTimeLabels(step);
+  }
+
+  const existing = new Map(chart.data.datasets.map(dataset => [dataset.label, dataset]));
+  const datasets = [];
+  for (const [taskName, series] of AppState.data.series)
+  {
+    if (!includeTask(taskName, series))
     {
       continue;
     }
+    const dataset = existing.get(taskName) || createChartDataset(taskName, []);
+    existing.delete(taskName);
+    fillDecimatedSeries(series[metric], dataset.data, step, scale);
+    datasets.push(dataset);
+  }
+  chart.data.datasets = datasets;
+  return new Set(existing.keys());
+}
 
-    currentRegisteredTaskNames.add(taskName);
+/**
+ * Redraw every chart with the data accumulated since the last redraw.
+ *
+ * Rebuilds the datasets from the task series, so filters (system tasks, low
+ * usage) apply immediately and without refetching history, creates the Task
+ * Heap and Ready Latency charts once the device reports their values, and
+ * releases the colors of tasks no chart shows anymore.
+ */
+function refreshCharts()
+{
+  if (!AppState.charts.cpu || !AppState.charts.memory)
+  {
+    return;
+  }
 
-    // Use stack percentage (available for registered tasks)
-    let stackPct = 0;
-    if (taskCurrent.stackPct !== undefined && taskCurrent.stackPct > 0)
-    {
-      stackPct = taskCurrent.stackPct;
-    }
-    
-    let dataset = AppState.charts.memory.data.datasets.find(d => d.label === taskName);
-    if (!dataset)
-    {
-      dataset = createChartDataset(
-        taskName,
-        Array(AppState.charts.memory.data.labels.length - 1).fill(0)
-      );
-      AppState.charts.memory.data.datasets.push(dataset);
-    }
-    dataset.data.push(stackPct);
-    if (dataset.data.length > CHART_SAMPLE_COUNT)
-    {
-      dataset.data.shift();
-    }
+  const isShown = (taskName) => !(AppState.filters.hideSystemTasks && SYSTEM_TASKS.hasOwnProperty(taskName));
+  const removedTasks = new Set();
+  const addRemoved = (names) => names.forEach(name => removedTasks.add(name));
+
+  addRemoved(renderChartSeries(AppState.charts.cpu, 'cpu', isShown));
+  for (const dataset of AppState.charts.cpu.data.datasets)
+  {
+    // Hide dataset if average usage over the window is below threshold
+    const averageUsage = AppState.data.series.get(dataset.label).cpu.average();
+    dataset.hidden = AppState.filters.hideLowUsage && averageUsage < AppState.filters.thresholdPercent;
   }
 
-  // Remove Memory chart datasets for tasks that no longer exist or are no longer registered
-  const removedMemoryTasks = new Set();
-  AppState.charts.memory.data.datasets = AppState.charts.memory.data.datasets.filter(dataset => {
-    if (currentRegisteredTaskNames.has(dataset.label))
-    {
-      return true;
-    }
-    // Task no longer exists or is no longer registered - remove it
-    removedMemoryTasks.add(dataset.label);
-    return false;
-  });
+  addRemoved(renderChartSeries(AppState.charts.memory, 'stackPct',
+                               (taskName) => AppState.data.registeredTasks.has(taskName)));
 
-  // Release colors for tasks that are removed from both charts
-  // A task might be in one chart but not the other, so only release if removed from both
-  const allRemovedTasks = new Set([...removedCpuTasks, ...removedMemoryTasks]);
-  for (const taskName of allRemovedTasks)
+  // Task heap and ready latency are only charted for tasks whose latest sample carries them
+  const hasHeap    = (taskName, series) => isShown(taskName) && Number.isFinite(series.heap.latest());
+  const hasLatency = (taskName, series) => isShown(taskName) && Number.isFinite(series.readyMaxUs.latest());
+  const allSeries  = [...AppState.data.series.values()];
+  if (!AppState.charts.heap && allSeries.some(series => Number.isFinite(series.heap.latest())))
+  {
+    createHeapChart();
+  }
+  if (AppState.charts.heap)
   {
-    // Only release if task is removed from both charts (or not in either)
-    const inCpuChart = AppState.charts.cpu.data.datasets.some(d => d.label === taskName);
-    const inMemoryChart = AppState.charts.memory.data.datasets.some(d => d.label === taskName);
-    if (!inCpuChart && !inMemoryChart)
+    addRemoved(renderChartSeries(AppState.charts.heap, 'heap', hasHeap, 1 / 1024));
+  }
+  if (!AppState.charts.latency && allSeries.some(series => Number.isFinite(series.readyMaxUs.latest())))
+  {
+    createLatencyChart();
+  }
+  if (AppState.charts.latency)
+  {
+    addRemoved(renderChartSeries(AppState.charts.latency, 'readyMaxUs', hasLatency));
+  }
+
+  // Release colors for tasks that are removed from every chart
+  // A task might be in one chart but not another, so only release if removed from all
+  const charts = [AppState.charts.cpu, AppState.charts.memory, AppState.charts.heap, AppState.charts.latency]
+    .filter(chart => chart !== null);
+  for (const taskName of removedTasks)
+  {
+    if (!charts.some(chart => chart.data.datasets.some(d => d.label === taskName)))
     {
       releaseTaskColor(taskName);
     }
   }
-  
-  AppState.charts.cpu.data.labels.push(AppState.charts.cpu.data.labels.length);
-  if (AppState.charts.cpu.data.labels.length > CHART_SAMPLE_COUNT)
-  {
-    AppState.charts.cpu.data.labels.shift();
-  }
-  AppState.charts.cpu.data.labels = generateTimeLabels();
 
-  // Update memory chart labels
-  AppState.charts.memory.data.labels.push(AppState.charts.memory.data.labels.length);
-  if (AppState.charts.memory.data.labels.length > CHART_SAMPLE_COUNT)
+  for (const chart of charts)
   {
-    AppState.charts.memory.data.labels.shift();
+    chart.update('none');
   }
-  AppState.charts.memory.data.labels = generateTimeLabels();
-  
-  // Only update visual display if neither chart is being hovered and not paused
-  const isAnyChartHovered = AppState.ui.isHoveringCpu || AppState.ui.isHoveringMemory || AppState.ui.isPaused;
-  if (!isAnyChartHovered)
+}
+
+/**
+ * Redraw the charts at the next animation frame.
+ *
+ * Samples that arrive together (a backfill after a late poll, a burst of pushed
+ * frames) cost one redraw, and background tabs, which get no animation frames,
+ * do not redraw at all. Skipped while a chart is hovered or updates are paused;
+ * the data keeps accumulating and is drawn when that ends.
+ */
+function scheduleChartRefresh()
+{
+  if (AppState.ui.chartRefreshPending)
   {
-    AppState.charts.cpu.update('none');
-    AppState.charts.memory.update('none');
+    return;
   }
+  AppState.ui.chartRefreshPending = true;
+  requestAnimationFrame(() => {
+    AppState.ui.chartRefreshPending = false;
+    const isAnyChartHovered = AppState.ui.isHoveringCpu || AppState.ui.isHoveringMemory ||
+                              AppState.ui.isHoveringHeap || AppState.ui.isHoveringLatency ||
+                              AppState.ui.isPaused;
+    if (!isAnyChartHovered)
+    {
+      refreshCharts();
+    }
+  });
 }
 
+/**
+ * Add one device sample to the charts.
+ *
+ * Appends the sample to the task series (one ring buffer per task and metric,
+ * see series.js) and schedules a redraw. Appending is O(1) per task; only the
+ * redraw touches the chart data, decimated to the plot width.
+ *
+ * @param {Object} telemetryCurrent - The current telemetry data for tasks.
+ */
+function updateCharts(telemetryCurrent)
+{
+  if (!AppState.charts.cpu || !AppState.charts.memory)
+  {
+    return;
+  }
 
+  appendSeriesSample(telemetryCurrent);
+  scheduleChartRefresh();
+}
@@ -1,13 +1,21 @@
 // API and networking constants
 const API_ROUTES = {
-  HISTORY   : '/history',
-  TELEMETRY : '/telemetry',
-  TASKS     : '/tasks',
-  HARDWARE  : '/hardware'
+  HISTORY      : '/history',
+  HISTORY_BIN  : '/history.bin',
+  TELEMETRY    : '/telemetry',
+  TELEMETRY_WS : '/telemetry/ws',
+  BUNDLE       : '/bundle',
+  TASKS        : '/tasks',
+  HARDWARE     : '/hardware',
+  SELF         : '/sysmon/self'
 };
 
 const TELEMETRY_TIMEOUT_MS = 4000;
 
+// Live push (WebSocket) reconnect backoff; polling is used while disconnected
+const PUSH_RECONNECT_BASE_MS = 2000;
+const PUSH_RECONNECT_MAX_MS  = 60000;
+
 // Chart configuration constants (defaults, will be overridden from hardware endpoint)
 let CHART_SAMPLE_COUNT                  = 100;
 let CHART_TELEMETRY_UPDATE_INTERVAL_MS  = 1000;
@@ -172,7 +180,9 @@ const PARTITION_DESCRIPTIONS = {
 const AppState = {
   charts: {
     cpu   : null,  // Chart.js instance for CPU
-    memory: null   // Chart.js instance for Memory
+    memory: null,  // Chart.js instance for Memory
+    heap   : null, // Chart.js instance for task heap (only with per-task heap accounting)
+    latency: null  // Chart.js instance for ready latency (only with the scheduling trace statistics)
   },
   filters: {
     hideLowUsage    : true, // Whether to hide low-utilization datasets
@@ -182,16 +192,27 @@ const AppState = {
   data: {
     registeredTasks: new Set(), // Set of registered task names (those with known stack sizes)
     taskInfo       : {},         // Cached task info data for calculating percentages
-    lastTelemetryTaskNames: new Set() // Track task names from last telemetry to detect changes
+    lastTelemetryTaskNames: new Set(), // Track task names from last telemetry to detect changes
+    lastSeq        : null,       // Sample sequence number of the last telemetry charted
+    series         : new Map()   // Chart samples per task: { cpu, stackPct, heap, readyMaxUs } rings (see series.js)
+  },
+  push: {
+    connected: false,            // True while the /telemetry/ws WebSocket is open (polling is suspended)
+    failures : 0,                // Consecutive failed connection attempts (for reconnect backoff)
+    pending  : Promise.resolve() // Serializes handling of pushed samples
   },
   ui: {
     tableSorter: {
       tasks     : null,  // Tablesort instance for task table
       partitions: null   // Tablesort instance for partitions table
     },
-    isHoveringCpu    : false, // True when mouse is over CPU chart
-    isHoveringMemory : false, // True when mouse is over memory chart
-    isPaused         : false  // True when updates are paused
+    isHoveringCpu      : false, // True when mouse is over CPU chart
+    isHoveringMemory   : false, // True when mouse is over memory chart
+    isHoveringHeap     : false, // True when mouse is over task heap chart
+    isHoveringLatency  : false, // True when mouse is over ready latency chart
+    isPaused           : false, // True when updates are paused
+    chartRefreshPending: false, // True while a chart redraw waits for the next animation frame
+    taskRows           : null   // Task table rows by task name (rebuilt after the task list changes)
   },
   status: {
     lastTelemetrySuccess: null,  // Timestamp of last successful telemetry fetch
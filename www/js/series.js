@@ -0,0 +1,272 @@
+/**
+ * Fixed-capacity ring buffer of numeric samples.
+ *
+ * Samples live in a Float32Array, so appending one never allocates and the
+ * oldest sample is overwritten once the ring is full. A running sum makes the
+ * average O(1); it is recomputed whenever the ring wraps, so rounding errors
+ * of the incremental updates cannot pile up. Missing samples are stored as NaN
+ * and left out of the average.
+ */
+class SeriesRing
+{
+  /**
+   * @param {number} capacity - Number of samples kept.
+   */
+  constructor(capacity)
+  {
+    this.values = new Float32Array(Math.max(1, capacity));
+    this.start  = 0;  // Index of the oldest sample
+    this.length = 0;  // Number of samples stored
+    this.sum    = 0;  // Sum of the finite samples stored
+    this.count  = 0;  // Number of finite samples stored
+  }
+
+  /**
+   * Append a sample, overwriting the oldest one when full.
+   *
+   * @param {number} value - Sample value (anything but a finite number is stored as NaN).
+   */
+  push(value)
+  {
+    const capacity = this.values.length;
+    const sample   = Number.isFinite(value) ? value : NaN;
+    let index;
+    if (this.length < capacity)
+    {
+      index = (this.start + this.length) % capacity;
+      this.length++;
+    }
+    else
+    {
+      index = this.start;
+      const evicted = this.values[index];
+      if (Number.isFinite(evicted))
+      {
+        this.sum -= evicted;
+        this.count--;
+      }
+      this.start = (this.start + 1) % capacity;
+    }
+    this.values[index] = sample;
+    // Read back the stored (float32) value so the sum matches what is evicted later
+    if (Number.isFinite(sample))
+    {
+      this.sum += this.values[index];
+      this.count++;
+    }
+    if (this.start === 0 && this.length === capacity)
+    {
+      this.recomputeSum();
+    }
+  }
+
+  /**
+   * Sample at a position counted from the oldest one.
+   *
+   * @param {number} position - 0 for the oldest sample, length - 1 for the newest.
+   * @returns {number} Sample value (NaN if missing).
+   */
+  at(position)
+  {
+    return this.values[(this.start + position) % this.values.length];
+  }
+
+  /**
+   * Newest sample.
+   *
+   * @returns {number} Sample value (NaN if missing or the ring is empty).
+   */
+  latest()
+  {
+    return this.length > 0 ? this.at(this.length - 1) : NaN;
+  }
+
+  /**
+   * Average of the finite samples stored.
+   *
+   * @returns {number} Average (0 without samples).
+   */
+  average()
+  {
+    return this.count > 0 ? this.sum / this.count : 0;
+  }
+
+  /**
+   * Recompute the running sum from the stored samples.
+   */
+  recomputeSum()
+  {
+    this.sum   = 0;
+    this.count = 0;
+    for (let position = 0; position < this.length; position++)
+    {
+      const value = this.at(position);
+      if (Number.isFinite(value))
+      {
+        this.sum += value;
+        this.count++;
+      }
+    }
+  }
+}
+
+/**
+ * Series kept per task, one ring each, all appended once per device sample.
+ */
+const SERIES_METRICS = ['cpu', 'stackPct', 'heap', 'readyMaxUs'];
+
+/**
+ * Get the rings of a task, creating them on first use.
+ *
+ * @param {string} taskName - Task key as in /telemetry.
+ * @returns {Object} Rings keyed by metric name (see SERIES_METRICS).
+ */
+function getTaskSeries(taskName)
+{
+  let series = AppState.data.series.get(taskName);
+  if (!series)
+  {
+    series = {};
+    for (const metric of SERIES_METRICS)
+    {
+      series[metric] = new SeriesRing(CHART_SAMPLE_COUNT);
+    }
+    AppState.data.series.set(taskName, series);
+  }
+  return series;
+}
+
+/**
+ * Seed the task rings from a /history document.
+ *
+ * Stack samples are converted to percent of the registered stack size, so call
+ * this after the task info has been fetched. There is no latency history.
+ *
+ * @param {Object} historyData - { taskName: { cpu: [...], stack: [...], heap: [...] }, ... }
+ */
+function seedSeriesFromHistory(historyData)
+{
+  if (!historyData || typeof historyData !== 'object')
+  {
+    return;
+  }
+  for (const [taskName, taskData] of Object.entries(historyData))
+  {
+    if (!taskData || typeof taskData !== 'object' || !Array.isArray(taskData.cpu))
+    {
+      continue;
+    }
+    const series    = getTaskSeries(taskName);
+    const stackSize = AppState.data.taskInfo[taskName]?.stackSize || 0;
+    const hasHeap   = Array.isArray(taskData.heap);
+    for (let index = 0; index < taskData.cpu.length; index++)
+    {
+      series.cpu.push(taskData.cpu[index]);
+      const stackBytes = Array.isArray(taskData.stack) ? taskData.stack[index] : NaN;
+      series.stackPct.push(stackSize > 0 && Number.isFinite(stackBytes) ? (stackBytes / stackSize) * 100 : 0);
+      series.heap.push(hasHeap ? taskData.heap[index] : NaN);
+    }
+  }
+}
+
+/**
+ * Append one device sample to the task rings.
+ *
+ * Every task present in the sample gets one value per metric (NaN where the
+ * device reports none), so all rings of a task stay aligned on the newest
+ * sample. Tasks missing from the sample have ended; their rings are dropped.
+ *
+ * @param {Object} telemetryCurrent - The "current" object of a /telemetry document.
+ */
+function appendSeriesSample(telemetryCurrent)
+{
+  for (const taskName of AppState.data.series.keys())
+  {
+    if (!telemetryCurrent[taskName])
+    {
+      AppState.data.series.delete(taskName);
+    }
+  }
+  for (const [taskName, taskCurrent] of Object.entries(telemetryCurrent))
+  {
+    if (!taskCurrent || typeof taskCurrent !== 'object')
+    {
+      continue;
+    }
+    const series = getTaskSeries(taskName);
+    series.cpu.push(typeof taskCurrent.cpu === 'number' ? taskCurrent.cpu : 0);
+    series.stackPct.push(AppState.data.registeredTasks.has(taskName) && taskCurrent.stackPct > 0
+      ? taskCurrent.stackPct
+      : 0);
+    series.heap.push(taskCurrent.heap);
+    series.readyMaxUs.push(taskCurrent.readyMaxUs);
+  }
+}
+
+/**
+ * Samples per plotted point so a chart draws at most one point per pixel.
+ *
+ * @param {number} sampleCount - Samples on the x axis.
+ * @param {number} pixelWidth - Width of the plot area in CSS pixels.
+ * @returns {number} Samples per point (1 when every sample fits).
+ */
+function getDecimationStep(sampleCount, pixelWidth)
+{
+  if (!(pixelWidth > 0) || sampleCount <= pixelWidth)
+  {
+    return 1;
+  }
+  return Math.ceil(sampleCount / pixelWidth);
+}
+
+/**
+ * Fill a chart dataset array from a ring, decimated to one point per step samples.
+ *
+ * The x axis always spans CHART_SAMPLE_COUNT samples ending at the newest one;
+ * a ring holding fewer samples (a task that appeared recently) is padded with
+ * zeros at the start. Each point is the largest sample of its step, so short
+ * spikes stay visible at any zoom.
+ *
+ * @param {SeriesRing} ring - Source samples.
+ * @param {Array<number>} out - Dataset array to fill (reused, resized in place).
+ * @param {number} step - Samples per point (see getDecimationStep()).
+ * @param {number} [scale=1] - Factor applied to every point (e.g. 1 / 1024 for KB).
+ * @returns {Array<number>} The filled array.
+ */
+function fillDecimatedSeries(ring, out, step, scale = 1)
+{
+  const sampleCount = CHART_SAMPLE_COUNT;
+  const points      = Math.ceil(sampleCount / step);
+  const padding     = sampleCount - ring.length;
+  out.length = points;
+  for (let point = 0; point < points; point++)
+  {
+    // Point (points - 1) ends at the newest sample; the first point may cover fewer samples
+    const last  = sampleCount - 1 - (points - 1 - point) * step;
+    const first = Math.max(0, last - step + 1);
+    let value = -Infinity;
+    for (let sample = first; sample <= last; sample++)
+    {
+      const ringPosition = sample - padding;
+      const sampleValue  = ringPosition >= 0 ? ring.at(ringPosition) : 0;
+      if (sampleValue > value)
+      {
+        value = sampleValue;
+      }
+    }
+    out[point] = Number.isFinite(value) ? value * scale : 0;
+  }
+  return out;
+}
+
+/**
+ * Generate x axis labels for a decimated chart.
+ *
+ * @param {number} step - Samples per point (see getDecimationStep()).
+ * @returns {Array<number>} Sample offset of each point's newest sample (negative, 0 for the newest).
+ */
+function generateDecimatedTimeLabels(step)
+{
+  const points = Math.ceil(CHART_SAMPLE_COUNT / step);
+  return Array.from({ length: points }, (_, point) => (point - points + 1) * step);
+}
@@ -1,3 +1,21 @@
+// Telemetry values last written to each table row ({ cpu, stack } keys), so unchanged cells are not touched
+const tableRowValues = new WeakMap();
+
+/**
+ * Set a cell's text only if it differs, so unchanged cells cause no DOM mutation or relayout.
+ *
+ * @param {HTMLElement} cell - The table cell to update.
+ * @param {string|number} text - The text to show.
+ */
+function setCellText(cell, text)
+{
+  const value = String(text);
+  if (cell.textContent !== value)
+  {
+    cell.textContent = value;
+  }
+}
+
 /**
  * Update CPU-related columns in a table row from telemetry data.
  *
@@ -18,7 +36,7 @@ function updateTableRowCpu(row, taskCurrent)
   const cpuPctCell = row.querySelector('[data-column="cpu-pct"]');
   if (cpuPctCell)
   {
-    cpuPctCell.textContent = cpuPct === '-' ? '-' : `${cpuPct} %`;
+    setCellText(cpuPctCell, cpuPct === '-' ? '-' : `${cpuPct} %`);
   }
 
   // Update CPU Usage progress bar
@@ -141,6 +159,48 @@ function updateTableRowStack(row, taskCurrent, taskName)
   }
 }
 
+/**
+ * Update the lifetime statistics columns in a table row from task information.
+ *
+ * Updates the CPU percentile and maximum cells and the lowest free stack cell
+ * from the /tasks endpoint data. The device keeps these since the task was first
+ * seen, so they cover more than the charts' history.
+ *
+ * @param {HTMLElement} row - The table row element to update.
+ * @param {Object} taskInfo - The task information object from the /tasks endpoint.
+ */
+function updateTableRowStats(row, taskInfo)
+{
+  const hasStats = taskInfo.statSamples !== undefined && taskInfo.statSamples > 0;
+  const cpuColumns = [
+    ['cpu-p95', taskInfo.cpuP95],
+    ['cpu-p99', taskInfo.cpuP99],
+    ['cpu-max', taskInfo.cpuMax],
+  ];
+  for (const [column, value] of cpuColumns)
+  {
+    const cell = row.querySelector(`[data-column="${column}"]`);
+    if (cell)
+    {
+      cell.textContent = hasStats && typeof value === 'number' ? `${value.toFixed(1)} %` : '-';
+    }
+  }
+
+  const stackMinFreeCell = row.querySelector('[data-column="stack-min-free"]');
+  if (stackMinFreeCell)
+  {
+    stackMinFreeCell.textContent = hasStats && typeof taskInfo.stackMinFree === 'number'
+      ? formatSize(taskInfo.stackMinFree, 'bytes', true)
+      : '-';
+    if (hasStats)
+    {
+      stackMinFreeCell.setAttribute('aria-label', `Lowest stack never used over ${taskInfo.statSamples} samples`);
+      stackMinFreeCell.setAttribute('role', 'tooltip');
+      stackMinFreeCell.setAttribute('data-microtip-position', 'bottom');
+    }
+  }
+}
+
 /**
  * Create a new table row for a task.
  *
@@ -229,6 +289,15 @@ function createTableRow(taskName, taskInfo)
   cpuPctCell.textContent = '-';
   row.appendChild(cpuPctCell);
 
+  // Lifetime CPU statistics cells (filled by updateTableRowStats below)
+  for (const column of ['cpu-p95', 'cpu-p99', 'cpu-max'])
+  {
+    const statCell = document.createElement('td');
+    statCell.className = 'panel-table-cell text-right';
+    statCell.setAttribute('data-column', column);
+    row.appendChild(statCell);
+  }
+
   // Stack Usage cell (progress bar) - only create if we have valid stack usage data
   const hasValidStackUsage = stackPct.display !== '-';
   if (hasValidStackUsage)
@@ -283,13 +352,22 @@ function createTableRow(taskName, taskInfo)
   usagePctCell.textContent = stackPct.display;
   row.appendChild(usagePctCell);
 
+  // Lowest free stack cell
+  const stackMinFreeCell = document.createElement('td');
+  stackMinFreeCell.className = 'panel-table-cell text-right';
+  stackMinFreeCell.setAttribute('data-column', 'stack-min-free');
+  row.appendChild(stackMinFreeCell);
+
+  updateTableRowStats(row, taskInfo);
+
   return row;
 }
 
 /**
  * Update an existing table row with new task information.
  *
- * Updates only the cells that come from the /tasks endpoint data.
+ * Updates only the cells that come from the /tasks endpoint data, including the
+ * lifetime CPU percentiles, CPU maximum and lowest free stack.
  * Does not update CPU % or CPU Usage (those come from telemetry).
  * Does not update stack usage % if it has a telemetry value (preserves it).
  *
@@ -320,7 +398,11 @@ function updateTableRow(row, taskName, taskInfo)
 
   // Update task name cell (handle abbr element)
   const taskNameCell = row.querySelector('[data-column="task-name"]');
-  if (taskNameCell)
+  const taskNameAbbr = taskNameCell ? taskNameCell.querySelector('abbr') : null;
+  const taskNameSame = taskNameCell && taskNameCell.textContent === taskName &&
+                       (taskNameAbbr ? taskNameAbbr.getAttribute('aria-label') === systemTaskDescription
+                                     : !systemTaskDescription);
+  if (taskNameCell && !taskNameSame)
   {
     taskNameCell.innerHTML = '';
     if (systemTaskDescription)
@@ -342,14 +424,14 @@ function updateTableRow(row, taskName, taskInfo)
   const coreCell = row.querySelector('[data-column="core"]');
   if (coreCell)
   {
-    coreCell.textContent = coreDisplay;
+    setCellText(coreCell, coreDisplay);
   }
 
   // Update priority cell
   const prioCell = row.querySelector('[data-column="priority"]');
   if (prioCell)
   {
-    prioCell.textContent = taskInfo.prio;
+    setCellText(prioCell, taskInfo.prio);
   }
 
   // CPU % and CPU Usage are NOT updated here - they come from telemetry
@@ -378,65 +460,86 @@ function updateTableRow(row, taskName, taskInfo)
 
   // Stack Usage progress bar is NOT updated here - it comes from telemetry
   // It will be updated by updateTableRowsFromTelemetry()
+
+  // Lifetime statistics come from the /tasks endpoint
+  updateTableRowStats(row, taskInfo);
 }
 
 /**
  * Update all table rows from telemetry data.
  *
- * Updates all table rows with the latest telemetry data.
- * This function should be called periodically to keep the table up to date.
+ * Diffs each row against the values last written to it and only touches the
+ * cells whose value changed. Rows are looked up by task name from a map that is
+ * rebuilt after the task list changes (see applyTaskInfo()). Rows hidden by the
+ * "hide system tasks" filter are skipped until they are shown again.
  *
  * @param {Object} telemetryCurrent - The telemetry data for all tasks.
  */
 function updateTableRowsFromTelemetry(telemetryCurrent)
 {
-  const tbody = document.querySelector('#taskTable tbody');
-  if (!tbody)
+  if (!AppState.ui.taskRows)
   {
-    return;
-  }
-
-  const rows = tbody.querySelectorAll('tr');
-  for (const row of rows)
-  {
-    // Get task name from task-name data column
-    const taskNameCell = row.querySelector('[data-column="task-name"]');
-    if (!taskNameCell)
+    const tbody = document.querySelector('#taskTable tbody');
+    if (!tbody)
     {
-      continue;
+      return;
     }
-    const taskName = taskNameCell.textContent.trim();
-    if (!taskName)
+    AppState.ui.taskRows = new Map();
+    for (const row of tbody.querySelectorAll('tr'))
     {
-      continue;
+      const taskNameCell = row.querySelector('[data-column="task-name"]');
+      const taskName = taskNameCell ? taskNameCell.textContent.trim() : '';
+      if (taskName)
+      {
+        AppState.ui.taskRows.set(taskName, row);
+      }
     }
+  }
 
+  for (const [taskName, row] of AppState.ui.taskRows)
+  {
     // Get telemetry data for this task
     const taskCurrent = telemetryCurrent[taskName];
-    if (!taskCurrent)
+    if (!taskCurrent || (AppState.filters.hideSystemTasks && SYSTEM_TASKS.hasOwnProperty(taskName)))
     {
       continue;
     }
 
+    let lastValues = tableRowValues.get(row);
+    if (!lastValues)
+    {
+      lastValues = { cpu: null, stack: null };
+      tableRowValues.set(row, lastValues);
+    }
+
     // Update CPU columns for all tasks (including system tasks)
-    updateTableRowCpu(row, taskCurrent);
+    const cpuKey = typeof taskCurrent.cpu === 'number' ? taskCurrent.cpu.toFixed(1) : '-';
+    if (cpuKey !== lastValues.cpu)
+    {
+      updateTableRowCpu(row, taskCurrent);
+      lastValues.cpu = cpuKey;
+    }
 
     // Only update stack-related columns for registered tasks
     if (AppState.data.registeredTasks.has(taskName))
     {
-      updateTableRowStack(row, taskCurrent, taskName);
+      const stackSize = AppState.data.taskInfo[taskName] ? AppState.data.taskInfo[taskName].stackSize : undefined;
+      const stackKey  = `${taskCurrent.stackPct}|${taskCurrent.stackRemaining}|${taskCurrent.stackUsed}|${stackSize}`;
+      if (stackKey !== lastValues.stack)
+      {
+        updateTableRowStack(row, taskCurrent, taskName);
+        lastValues.stack = stackKey;
+      }
     }
   }
 }
 
 /**
- * Periodically refresh task info table.
+ * Refresh the task info table from the device.
  *
- * Periodically fetches the latest task information from the server and updates the task info table in the UI.
- * Uses incremental updates to preserve telemetry values and avoid unnecessary DOM operations.
- * Also updates the set of registered tasks, detects removed or added tasks, and refreshes the displayed stack usage,
- * warning classes, and associated tooltips for each task row accordingly. Handles communication errors and keeps
- * internal state in sync with the actual task list on the device.
+ * Fetches the latest task information from the server and applies it with applyTaskInfo().
+ * While the dashboard polls, the task information normally arrives with the /bundle poll
+ * instead (see updateDashboard()).
  */
 async function updateTable()
 {
@@ -449,140 +552,157 @@ async function updateTable()
       updateStatusPopup();
       throw new Error("Fetch failed");
     }
-    const taskData = await response.json();
-    AppState.status.lastTableSuccess = Date.now();
-    AppState.status.consecutiveFailures = 0;
-
-    // Sync registeredTasks set and taskInfo with current task list
-    // Remove tasks that no longer exist
-    const currentTaskNames = new Set(Object.keys(taskData));
-    const tasksToRemove = [];
-    
-    // Find tasks that are no longer present
-    for (const taskName of AppState.data.registeredTasks)
-    {
-      if (!currentTaskNames.has(taskName))
-      {
-        tasksToRemove.push(taskName);
-      }
-    }
-    
-    // Remove tasks that no longer exist
-    for (const taskName of tasksToRemove)
+    applyTaskInfo(await response.json());
+  }
+  catch (error)
+  {
+    console.error("updateTable error:", error);
+    AppState.status.consecutiveFailures++;
+    updateStatusPopup();
+  }
+}
+
+/**
+ * Apply a /tasks document to the task info table.
+ *
+ * Uses incremental updates to preserve telemetry values and avoid unnecessary DOM operations.
+ * Also updates the set of registered tasks, detects removed or added tasks, and refreshes the displayed stack usage,
+ * warning classes, and associated tooltips for each task row accordingly, keeping internal state in sync with the
+ * actual task list on the device.
+ *
+ * @param {Object} taskData - Parsed /tasks document.
+ */
+function applyTaskInfo(taskData)
+{
+  AppState.status.lastTableSuccess = Date.now();
+  AppState.status.consecutiveFailures = 0;
+
+  // Sync registeredTasks set and taskInfo with current task list
+  // Remove tasks that no longer exist
+  const currentTaskNames = new Set(Object.keys(taskData));
+  const tasksToRemove = [];
+  
+  // Find tasks that are no longer present
+  for (const taskName of AppState.data.registeredTasks)
+  {
+    if (!currentTaskNames.has(taskName))
     {
-      AppState.data.registeredTasks.delete(taskName);
-      delete AppState.data.taskInfo[taskName];
+      tasksToRemove.push(taskName);
     }
-    
-    // Update taskInfo and registeredTasks for current tasks
-    AppState.data.taskInfo = {};
-    AppState.data.registeredTasks.clear();
-    for (const [taskName, taskInfo] of Object.entries(taskData))
+  }
+  
+  // Remove tasks that no longer exist
+  for (const taskName of tasksToRemove)
+  {
+    AppState.data.registeredTasks.delete(taskName);
+    delete AppState.data.taskInfo[taskName];
+  }
+  
+  // Update taskInfo and registeredTasks for current tasks
+  AppState.data.taskInfo = {};
+  AppState.data.registeredTasks.clear();
+  for (const [taskName, taskInfo] of Object.entries(taskData))
+  {
+    AppState.data.taskInfo[taskName] = taskInfo;
+    if (taskInfo.stackSize !== undefined && taskInfo.stackSize > 0)
     {
-      AppState.data.taskInfo[taskName] = taskInfo;
-      if (taskInfo.stackSize !== undefined && taskInfo.stackSize > 0)
-      {
-        AppState.data.registeredTasks.add(taskName);
-      }
+      AppState.data.registeredTasks.add(taskName);
     }
+  }
 
-    const tbody = document.querySelector('#taskTable tbody');
-    if (!tbody)
-    {
-      return;
-    }
+  const tbody = document.querySelector('#taskTable tbody');
+  if (!tbody)
+  {
+    return;
+  }
 
-    // Build a map of existing rows by task name
-    const existingRows = tbody.querySelectorAll('tr');
-    const rowMap = new Map();
-    for (const row of existingRows)
+  // Build a map of existing rows by task name
+  const existingRows = tbody.querySelectorAll('tr');
+  const rowMap = new Map();
+  for (const row of existingRows)
+  {
+    const taskNameCell = row.querySelector('[data-column="task-name"]');
+    if (taskNameCell)
     {
-      const taskNameCell = row.querySelector('[data-column="task-name"]');
-      if (taskNameCell)
+      const taskName = taskNameCell.textContent.trim();
+      if (taskName)
       {
-        const taskName = taskNameCell.textContent.trim();
-        if (taskName)
-        {
-          rowMap.set(taskName, row);
-        }
+        rowMap.set(taskName, row);
       }
     }
+  }
 
-    // Separate tasks into system and non-system tasks
-    const nonSystemTasks = [];
-    const systemTasks = [];
-    for (const [taskName, taskInfo] of Object.entries(taskData))
+  // Separate tasks into system and non-system tasks
+  const nonSystemTasks = [];
+  const systemTasks = [];
+  for (const [taskName, taskInfo] of Object.entries(taskData))
+  {
+    const isSystemTask = SYSTEM_TASKS.hasOwnProperty(taskName);
+    if (isSystemTask)
     {
-      const isSystemTask = SYSTEM_TASKS.hasOwnProperty(taskName);
-      if (isSystemTask)
-      {
-        systemTasks.push([taskName, taskInfo]);
-      }
-      else
-      {
-        nonSystemTasks.push([taskName, taskInfo]);
-      }
+      systemTasks.push([taskName, taskInfo]);
     }
+    else
+    {
+      nonSystemTasks.push([taskName, taskInfo]);
+    }
+  }
 
-    // Combine both non-system and system tasks into one array with a flag
-    const allTasks = [
-      ...nonSystemTasks.map(([taskName, taskInfo]) => ({ taskName, taskInfo, isSystem: false })),
-      ...systemTasks.map(([taskName, taskInfo]) => ({ taskName, taskInfo, isSystem: true })),
-    ];
+  // Combine both non-system and system tasks into one array with a flag
+  const allTasks = [
+    ...nonSystemTasks.map(([taskName, taskInfo]) => ({ taskName, taskInfo, isSystem: false })),
+    ...systemTasks.map(([taskName, taskInfo]) => ({ taskName, taskInfo, isSystem: true })),
+  ];
 
-    for (const { taskName, taskInfo, isSystem } of allTasks)
+  for (const { taskName, taskInfo, isSystem } of allTasks)
+  {
+    const existingRow = rowMap.get(taskName);
+    if (existingRow)
     {
-      const existingRow = rowMap.get(taskName);
-      if (existingRow)
-      {
-        // Row exists - update it incrementally
-        updateTableRow(existingRow, taskName, taskInfo);
+      // Row exists - update it incrementally
+      updateTableRow(existingRow, taskName, taskInfo);
 
-        // For system tasks, move the row to the bottom if it's not already there
-        if (isSystem)
-        {
-          existingRow.remove();
-          tbody.appendChild(existingRow);
-        }
-        // Remove from map so we know it's been processed
-        rowMap.delete(taskName);
-      }
-      else
+      // For system tasks, move the row to the bottom if it's not already there
+      if (isSystem)
       {
-        // Row doesn't exist - create a new one (at the bottom for both)
-        const newRow = createTableRow(taskName, taskInfo);
-        tbody.appendChild(newRow);
+        existingRow.remove();
+        tbody.appendChild(existingRow);
       }
+      // Remove from map so we know it's been processed
+      rowMap.delete(taskName);
     }
+    else
+    {
+      // Row doesn't exist - create a new one (at the bottom for both)
+      const newRow = createTableRow(taskName, taskInfo);
+      tbody.appendChild(newRow);
+    }
+  }
 
 
-    // Remove rows for tasks that no longer exist
-    for (const [taskName, row] of rowMap.entries())
+  // Remove rows for tasks that no longer exist
+  for (const [taskName, row] of rowMap.entries())
+  {
+    row.remove();
+  }
+
+  // Rows were added, removed or moved: rebuild the telemetry lookup on the next sample
+  AppState.ui.taskRows = null;
+
+  // Initialize or refresh Tablesort
+  const tableElement = document.getElementById('taskTable');
+  if (tableElement && typeof Tablesort !== 'undefined')
+  {
+    if (!AppState.ui.tableSorter.tasks)
     {
-      row.remove();
+      AppState.ui.tableSorter.tasks = new Tablesort(tableElement);
     }
-
-    // Initialize or refresh Tablesort
-    const tableElement = document.getElementById('taskTable');
-    if (tableElement && typeof Tablesort !== 'undefined')
+    else
     {
-      if (!AppState.ui.tableSorter.tasks)
-      {
-        AppState.ui.tableSorter.tasks = new Tablesort(tableElement);
-      }
-      else
-      {
-        AppState.ui.tableSorter.tasks.refresh();
-      }
+      AppState.ui.tableSorter.tasks.refresh();
     }
-    
-    updateStatusPopup();
-  }
-  catch (error)
-  {
-    console.error("updateTable error:", error);
-    AppState.status.consecutiveFailures++;
-    updateStatusPopup();
   }
+  
+  updateStatusPopup();
 }
 
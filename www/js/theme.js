@@ -102,7 +102,7 @@
   // Define updateChartColors first so it can be called by applyTheme
   const updateChartColors = () =>
   {
-    [window.chartInstance, window.memoryChartInstance].forEach(chart =>
+    [window.chartInstance, window.memoryChartInstance, window.heapChartInstance].forEach(chart =>
     {
       if (chart)
       {
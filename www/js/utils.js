@@ -866,6 +866,118 @@ async function updateHardwareInfo()
   }
 }
 
+/**
+ * Format a duration in microseconds for the self-profiling table.
+ *
+ * @function formatDurationUs
+ * @param {number} us - Duration in microseconds.
+ * @returns {string} Duration in us below 1 ms, otherwise in ms.
+ */
+function formatDurationUs(us)
+{
+  if (us === undefined)
+  {
+    return '-';
+  }
+  return us < 1000 ? `${Math.round(us)} us` : `${(us / 1000).toFixed(2)} ms`;
+}
+
+/**
+ * Fetch and display SysMon's own overhead (/sysmon/self).
+ *
+ * Shows the share of one core spent by the sampler and the HTTP handlers, and
+ * one table row per profiled phase with its call count, average, p99 and
+ * maximum duration and average free heap change. The panel stays hidden when
+ * the firmware was built without self-profiling.
+ *
+ * @function updateSelfProfile
+ * @returns {Promise<void>}
+ */
+async function updateSelfProfile()
+{
+  const box = document.getElementById('selfProfileBox');
+  const tbody = document.querySelector('#selfProfileTable tbody');
+  if (!box || !tbody)
+  {
+    return;
+  }
+
+  try
+  {
+    const response = await fetch(API_ROUTES.SELF);
+    if (!response.ok)
+    {
+      return;
+    }
+    const profile = await response.json();
+    if (!profile.enabled)
+    {
+      box.classList.add('hidden');
+      return;
+    }
+    box.classList.remove('hidden');
+
+    const busy = profile.busyPct || {};
+    const busyFields = {
+      selfSamplerBusy  : busy.sampler,
+      selfHttpBuildBusy: busy.httpBuild,
+      selfHttpSendBusy : busy.httpSend
+    };
+    for (const [id, value] of Object.entries(busyFields))
+    {
+      const element = document.getElementById(id);
+      if (element)
+      {
+        element.textContent = value !== undefined ? `${value.toFixed(3)} %` : '-';
+      }
+    }
+
+    // One row per phase that has been called at least once
+    const rows = [];
+    for (const [name, stats] of Object.entries(profile.sampler || {}))
+    {
+      rows.push([`sampler ${name}`, stats]);
+    }
+    for (const [uri, phases] of Object.entries(profile.http || {}))
+    {
+      for (const [name, stats] of Object.entries(phases))
+      {
+        rows.push([`${uri} ${name}`, stats]);
+      }
+    }
+
+    tbody.replaceChildren();
+    for (const [label, stats] of rows)
+    {
+      if (!stats || !stats.count)
+      {
+        continue;
+      }
+      const row = document.createElement('tr');
+      const cells = [
+        label,
+        stats.count.toLocaleString('en-US'),
+        formatDurationUs(stats.avgUs),
+        formatDurationUs(stats.p99Us),
+        formatDurationUs(stats.maxUs),
+        `${Math.round(stats.heapDeltaAvg || 0).toLocaleString('en-US')} bytes`
+      ];
+      for (const text of cells)
+      {
+        const cell = document.createElement('td');
+        cell.className = 'panel-table-cell';
+        cell.textContent = text;
+        row.appendChild(cell);
+      }
+      tbody.appendChild(row);
+    }
+  }
+  catch (error)
+  {
+    console.warn("Failed to fetch self-profiling data:", error);
+  }
+}
+
 /**
  * Update WiFi information display in the header.
  *
@@ -988,3 +1100,161 @@ function updateWifiInfo(wifiData)
     }
   }
 }
+
+/**
+ * Decode a /history.bin payload (see sysmon_history_bin.h for the layout).
+ *
+ * The payload is a list of named columns, each a series of zigzag varint deltas
+ * of fixed-point values. Column names are "sys/<series>" for system-wide
+ * series and "task/<key>/<series>" for per-task series. Every column ends at
+ * sample `seq`; a task column may be shorter than `sampleCount`.
+ *
+ * @param {ArrayBuffer} buffer - Raw response body.
+ * @returns {{seq: number, sampleCount: number, intervalMs: number, system: Object, tasks: Object}}
+ *   Decoded history. `tasks` has the same shape as the /history JSON
+ *   ({taskName: {cpu: number[], stack?: number[]}}), `system` maps series names to arrays.
+ * @throws {Error} If the payload is truncated or has an unknown magic/version.
+ */
+function decodeHistoryBin(buffer)
+{
+  const bytes = new Uint8Array(buffer);
+  const decoder = new TextDecoder();
+  let offset = 0;
+
+  const readByte = () =>
+  {
+    if (offset >= bytes.length)
+    {
+      throw new Error('history.bin: truncated payload');
+    }
+    return bytes[offset++];
+  };
+
+  // Unsigned LEB128; multiplication keeps values exact up to 2^53
+  const readVarint = () =>
+  {
+    let value = 0;
+    let scale = 1;
+    let byte;
+    do
+    {
+      byte = readByte();
+      value += (byte & 0x7f) * scale;
+      scale *= 128;
+    } while (byte & 0x80);
+    return value;
+  };
+
+  const readZigzag = () =>
+  {
+    const raw = readVarint();
+    return (raw % 2 === 0) ? raw / 2 : -(raw + 1) / 2;
+  };
+
+  const magic = decoder.decode(bytes.subarray(0, 4));
+  offset = 4;
+  const version = readByte();
+  if (magic !== 'SMHB' || version !== 2)
+  {
+    throw new Error(`history.bin: unsupported format ${magic} v${version}`);
+  }
+
+  const result = {
+    seq        : readVarint(),
+    sampleCount: readVarint(),
+    intervalMs : readVarint(),
+    system     : {},
+    tasks      : {}
+  };
+
+  for (;;)
+  {
+    const nameLength = readVarint();
+    if (nameLength === 0)
+    {
+      break;
+    }
+    if (offset + nameLength > bytes.length)
+    {
+      throw new Error('history.bin: truncated column name');
+    }
+    const name = decoder.decode(bytes.subarray(offset, offset + nameLength));
+    offset += nameLength;
+
+    const divisor = Math.pow(10, readByte());
+    const count = readVarint();
+    const values = new Array(count);
+    let quantized = 0;
+    for (let i = 0; i < count; i++)
+    {
+      quantized += readZigzag();
+      values[i] = quantized / divisor;
+    }
+
+    if (name.startsWith('sys/'))
+    {
+      result.system[name.slice(4)] = values;
+    }
+    else if (name.startsWith('task/'))
+    {
+      // Task keys may contain '/', so split on the last separator
+      const separator = name.lastIndexOf('/');
+      const taskName = name.slice(5, separator);
+      const series = name.slice(separator + 1);
+      if (!result.tasks[taskName])
+      {
+        result.tasks[taskName] = {};
+      }
+      result.tasks[taskName][series] = values;
+    }
+  }
+
+  return result;
+}
+
+/**
+ * Fetch per-task history, preferring the compact binary endpoint.
+ *
+ * Falls back to the JSON /history endpoint if /history.bin is unavailable
+ * or cannot be decoded.
+ *
+ * @returns {Promise<Object|null>} History in /history JSON shape, or null on failure.
+ */
+async function fetchHistory()
+{
+  try
+  {
+    const response = await fetch(API_ROUTES.HISTORY_BIN);
+    if (response.ok)
+    {
+      return decodeHistoryBin(await response.arrayBuffer()).tasks;
+    }
+  }
+  catch (error)
+  {
+    console.warn("Failed to fetch binary history, falling back to JSON:", error);
+  }
+
+  const response = await fetch(API_ROUTES.HISTORY);
+  if (!response.ok)
+  {
+    return null;
+  }
+  return response.json();
+}
+
+/**
+ * Fetch the history samples published after a given sample sequence number.
+ *
+ * @param {number} since - Last sample sequence number already charted.
+ * @returns {Promise<Object|null>} {seq, since, tasks, system} from /history?since=, or null on failure.
+ */
+async function fetchHistorySince(since)
+{
+  const response = await fetch(`${API_ROUTES.HISTORY}?since=${since}`);
+  if (!response.ok)
+  {
+    return null;
+  }
+  return response.json();
+}